@@ -33,6 +33,10 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <Eigen/Core>
 
 // STL
+#include <atomic>
+#include <exception>
+#include <future>
+#include <mutex>
 #include <string>
 
 // CppAD
@@ -82,7 +86,7 @@ class CppAdInterface {
   CppAdInterface(ad_function_t adFunction, size_t variableDim, std::string modelName, std::string folderName = "/tmp/ocs2",
                  std::vector<std::string> compileFlags = {"-O3", "-g", "-march=native", "-mtune=native", "-ffast-math"});
 
-  ~CppAdInterface() = default;
+  ~CppAdInterface();
 
   /**
    * Copy constructor. Models are reloaded if available.
@@ -95,12 +99,15 @@ class CppAdInterface {
   CppAdInterface& operator=(CppAdInterface&& rhs) = delete;
 
   /**
-   * Loads earlier created model from disk
+   * Loads earlier created model from disk. The library is identified by the hash of the taped operation sequence and the compile flags.
    */
   void loadModels(bool verbose = true);
 
   /**
-   * Creates models, compiles them, and saves them to disk
+   * Creates models, compiles them, and saves them to disk.
+   *
+   * The sources are generated before returning, while the compiler runs in the background such that the models of several interfaces
+   * are compiled in parallel. The models are loaded on first use, or by calling waitForModels().
    *
    * @param approximationOrder : Order of derivatives to generate
    * @param verbose : Print out extra information
@@ -108,13 +115,22 @@ class CppAdInterface {
   void createModels(ApproximationOrder approximationOrder = ApproximationOrder::Second, bool verbose = true);
 
   /**
-   * Load models if they are available on disk. Creates a new library otherwise.
+   * Load models if they are available on disk. Creates a new library otherwise, see createModels().
+   *
+   * The library name contains the hash of the taped operation sequence and the compile flags, such that a library of a modified model
+   * is never loaded.
    *
    * @param approximationOrder : Order of derivatives to generate
    * @param verbose : Print out extra information
    */
   void loadModelsIfAvailable(ApproximationOrder approximationOrder = ApproximationOrder::Second, bool verbose = true);
 
+  /**
+   * Blocks until the background compilation started by createModels() or loadModelsIfAvailable() is finished and loads the models.
+   * Rethrows the error of a failed compilation, on this and on every later access to the models.
+   */
+  void waitForModels() const;
+
   /**
    * @param x : input vector of size variableDim
    * @param p : parameter vector of size parameterDim
@@ -165,12 +181,99 @@ class CppAdInterface {
    */
   matrix_t getHessian(const vector_t& w, const vector_t& x, const vector_t& p = vector_t(0)) const;
 
+  /**
+   * Batched version of getFunctionValue(). The evaluation buffers are shared between the points and the values are written in place.
+   *
+   * @param X : matrix of size variableDim x N, with one point per column
+   * @param P : parameters of size parameterDim x N, or a single column that is used for all points
+   * @param [out] values : matrix of size rangeDim x N with f(x,p) of each point in the columns. Only resized if the size does not match.
+   */
+  void getFunctionValues(const matrix_t& X, const matrix_t& P, matrix_t& values) const;
+
+  /**
+   * Batched version of getJacobian(). The evaluation buffers and the sparsity pattern are shared between the points.
+   *
+   * @param X : matrix of size variableDim x N, with one point per column
+   * @param P : parameters of size parameterDim x N, or a single column that is used for all points
+   * @param [out] jacobians : d/dx( f(x,p) ) of each point. The matrices are only reallocated if their size does not match.
+   */
+  void getJacobians(const matrix_t& X, const matrix_t& P, std::vector<matrix_t>& jacobians) const;
+
+  /**
+   * Batched version of getGaussNewtonApproximation(). The evaluation buffers and the sparsity pattern are shared between the points.
+   *
+   * @param X : matrix of size variableDim x N, with one point per column
+   * @param P : parameters of size parameterDim x N, or a single column that is used for all points
+   * @param [out] approximations : Gauss-Newton approximation of each point. Only reallocated if the sizes do not match.
+   */
+  void getGaussNewtonApproximations(const matrix_t& X, const matrix_t& P,
+                                    std::vector<ScalarFunctionQuadraticApproximation>& approximations) const;
+
+  /**
+   * Structural sparsity of the Jacobian w.r.t. the variables x, as taped in the loaded model. Returns a dense pattern if the model does
+   * not provide the sparsity.
+   *
+   * @return Sparsity pattern with one set of non-zero columns per output.
+   */
+  cppad_sparsity::SparsityPattern getJacobianSparsityPattern() const;
+
  private:
   /**
    * Defines library folder names
    */
   void setFolderNames();
 
+  /**
+   * Sets the hash that identifies the library on disk
+   */
+  void setLibraryHash(const std::string& hash);
+
+  /**
+   * Records and optimizes the operation sequence of the function
+   * @param [out] fun : taped ad function
+   */
+  void tapeFunction(ad_fun_t& fun);
+
+  /**
+   * Hash of the taped operation sequence, the dimensions and the compile flags
+   * @param fun : taped ad function
+   * @return hash in hexadecimal representation
+   */
+  std::string getOperationSequenceHash(ad_fun_t& fun) const;
+
+  /**
+   * Generates the sources of the taped function and starts their compilation in the background
+   * @param fun : taped ad function
+   * @param approximationOrder : Order of derivatives to generate
+   * @param verbose : Print out extra information
+   */
+  void compileModels(ad_fun_t& fun, ApproximationOrder approximationOrder, bool verbose);
+
+  /**
+   * Checks if the loaded model provides the derivatives of the given order
+   */
+  bool isApproximationOrderAvailable(ApproximationOrder approximationOrder) const;
+
+  /**
+   * Loads the models if a background compilation is pending. The flag is only cleared once the models are published, and stays set
+   * after a failed compilation such that every access rethrows its error.
+   */
+  void ensureModelsLoaded() const {
+    if (isCompilationPending_.load(std::memory_order_acquire)) {
+      waitForModels();
+    }
+  }
+
+  /**
+   * Waits for a pending background compilation and drops its result, including its error.
+   */
+  void discardPendingCompilation();
+
+  /**
+   * Removes the libraries of this model with a different hash from the library folder, except the ones loaded in this process.
+   */
+  void removeStaleLibraries() const;
+
   /**
    * Creates folders on disk
    */
@@ -205,7 +308,7 @@ class CppAdInterface {
   /**
    * Stores the sparisty nonzeros
    */
-  void setSparsityNonzeros();
+  void setSparsityNonzeros() const;
 
   /**
    * Creates sparsity pattern for the Jacobian that will be generated
@@ -221,8 +324,30 @@ class CppAdInterface {
    */
   cppad_sparsity::SparsityPattern createHessianSparsity(ad_fun_t& fun) const;
 
-  std::unique_ptr<CppAD::cg::DynamicLib<scalar_t>> dynamicLib_;
-  std::unique_ptr<CppAD::cg::GenericModel<scalar_t>> model_;
+  /**
+   * Checks the sizes of the points and parameters of a batched evaluation
+   * @return number of points
+   */
+  size_t checkBatchSize(const matrix_t& X, const matrix_t& P) const;
+
+  /**
+   * Fills the Gauss-Newton approximation from the function value and the sparse Jacobian
+   * @param value : function value
+   * @param sparseJacobian : non-zeros of the Jacobian, ordered by row
+   * @param rows : row of each non-zero
+   * @param cols : column of each non-zero
+   * @param [out] gnApprox : Gauss-Newton approximation, dfdx and dfdxx must be of the right size
+   */
+  void fillGaussNewtonApproximation(const vector_t& value, const std::vector<scalar_t>& sparseJacobian, size_t const* rows,
+                                    size_t const* cols, ScalarFunctionQuadraticApproximation& gnApprox) const;
+
+  // Mutable since the models are loaded on first use after a background compilation
+  mutable std::unique_ptr<CppAD::cg::DynamicLib<scalar_t>> dynamicLib_;
+  mutable std::unique_ptr<CppAD::cg::GenericModel<scalar_t>> model_;
+  mutable std::future<std::unique_ptr<CppAD::cg::DynamicLib<scalar_t>>> compiledLibrary_;
+  mutable std::mutex compilationMutex_;
+  mutable std::atomic<bool> isCompilationPending_{false};
+  mutable std::exception_ptr compilationError_;
   ad_parameterized_function_t adFunction_;
   std::vector<std::string> compileFlags_;
 
@@ -230,8 +355,8 @@ class CppAdInterface {
   size_t variableDim_;
   size_t parameterDim_;
   size_t rangeDim_ = 0;
-  size_t nnzJacobian_ = 0;
-  size_t nnzHessian_ = 0;
+  mutable size_t nnzJacobian_ = 0;
+  mutable size_t nnzHessian_ = 0;
 
   // Names
   std::string modelName_;
@@ -239,6 +364,7 @@ class CppAdInterface {
   std::string libraryFolder_;
   std::string tmpName_;
   std::string tmpFolder_;
+  std::string libraryHash_;
   std::string libraryName_;
 };
 
@@ -54,6 +54,18 @@ class ControllerBase {
    */
   virtual vector_t computeInput(scalar_t t, const vector_t& x) = 0;
 
+  /**
+   * @brief Computes the control command at a given time and state, without allocating memory once the input has the correct size.
+   * The time lookup starts at the given index hint such that consecutive queries with increasing time take constant time.
+   * @note The default implementation falls back to computeInput(t, x), which allocates.
+   *
+   * @param [in] t: Current time.
+   * @param [in] x: Current state.
+   * @param [out] u: Current input.
+   * @param [in, out] timeIndexHint: Lookup index of the previous query, initialize with 0.
+   */
+  virtual void computeInputRealTime(scalar_t t, const vector_t& x, vector_t& u, int& timeIndexHint) { u = computeInput(t, x); }
+
   /**
    * @brief Merges this controller with another controller that comes active later in time
    * This method is typically used to merge controllers from multiple time partitions.
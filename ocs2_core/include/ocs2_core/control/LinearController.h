@@ -79,6 +79,8 @@ class LinearController final : public ControllerBase {
 
   vector_t computeInput(scalar_t t, const vector_t& x) override;
 
+  void computeInputRealTime(scalar_t t, const vector_t& x, vector_t& u, int& timeIndexHint) override;
+
   void concatenate(const ControllerBase* nextController, int index, int length) override;
 
   int size() const override;
@@ -105,6 +107,9 @@ class LinearController final : public ControllerBase {
  private:
   void flattenSingle(scalar_t time, std::vector<float>& flatArray) const;
 
+  int timeIndexHint_ = 0;  // lookup hint of computeInput()
+  matrix_t gainBuffer_;    // interpolated gain of computeInputRealTime()
+
  public:
   scalar_array_t timeStamp_;
   vector_array_t biasArray_;
@@ -64,6 +64,8 @@ class StateBasedLinearController final : public ControllerBase {
 
   vector_t computeInput(scalar_t t, const vector_t& x) override;
 
+  void computeInputRealTime(scalar_t t, const vector_t& x, vector_t& u, int& timeIndexHint) override;
+
   void concatenate(const ControllerBase* nextController, int index, int length) override;
 
   int size() const override;
@@ -79,6 +81,9 @@ class StateBasedLinearController final : public ControllerBase {
   StateBasedLinearController* clone() const override;
 
  private:
+  /** Query time of the underlying controller, which is moved across the designed event times based on the mode in the state. */
+  static scalar_t getTrajectorySpreadingTime(scalar_t t, const vector_t& x, const scalar_array_t& ctrlEventTimes);
+
   ControllerBase* ctrlPtr_ = nullptr;
   scalar_array_t ctrlEventTimes_{0};
 };
@@ -0,0 +1,192 @@
+/******************************************************************************
+Copyright (c) 2020, Farbod Farshidian. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#pragma once
+
+#include <stdexcept>
+
+#include <ocs2_core/cost/StateCost.h>
+#include <ocs2_core/cost/StateInputCost.h>
+#include <ocs2_core/misc/LinearInterpolation.h>
+
+namespace ocs2 {
+
+/**
+ * Computes value - target(time) on a fixed-size vector, where the target is linearly interpolated as in
+ * TargetTrajectories::getDesiredState(). Contrary to getDesiredState(), the interpolated target is not stored in a temporary.
+ *
+ * @param [in] time: The enquiry time.
+ * @param [in] value: The value, e.g. the state or input.
+ * @param [in] timeTrajectory: The time trajectory of the target.
+ * @param [in] targetTrajectory: The target trajectory, e.g. the desired state or input trajectory.
+ * @return The deviation from the target.
+ */
+template <int DIM>
+Eigen::Matrix<scalar_t, DIM, 1> fixedSizeDeviationFromTarget(scalar_t time, const vector_t& value, const scalar_array_t& timeTrajectory,
+                                                             const vector_array_t& targetTrajectory) {
+  if (timeTrajectory.empty() || targetTrajectory.empty()) {
+    throw std::runtime_error("[fixedSizeDeviationFromTarget] The target trajectory is empty!");
+  }
+
+  Eigen::Matrix<scalar_t, DIM, 1> deviation = value;
+  if (targetTrajectory.size() > 1) {
+    const auto indexAlpha = LinearInterpolation::timeSegment(time, timeTrajectory);
+    const scalar_t alpha = indexAlpha.second;
+    const auto& lhs = targetTrajectory[indexAlpha.first];
+    const auto& rhs = targetTrajectory[indexAlpha.first + 1];
+    if (LinearInterpolation::areSameSize(lhs, rhs)) {
+      deviation -= alpha * lhs + (scalar_t(1.0) - alpha) * rhs;
+    } else {
+      deviation -= (alpha > 0.5) ? lhs : rhs;
+    }
+  } else {
+    deviation -= targetTrajectory.front();
+  }
+  return deviation;
+}
+
+/**
+ * The fixed-size counterpart of QuadraticStateInputCost for small systems with compile-time dimensions:
+ * \f$ L = 0.5(x-x_{n})' Q (x-x_{n}) + 0.5(u-u_{n})' R (u-u_{n}) + (u-u_{n})' P (x-x_{n}) \f$
+ * Only the returned approximation is dynamic-size, as required by the StateInputCost interface.
+ *
+ * @tparam STATE_DIM: The state dimension.
+ * @tparam INPUT_DIM: The input dimension.
+ */
+template <int STATE_DIM, int INPUT_DIM>
+class FixedSizeQuadraticStateInputCost final : public StateInputCost {
+ public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  using state_vector_t = Eigen::Matrix<scalar_t, STATE_DIM, 1>;
+  using input_vector_t = Eigen::Matrix<scalar_t, INPUT_DIM, 1>;
+  using state_matrix_t = Eigen::Matrix<scalar_t, STATE_DIM, STATE_DIM>;
+  using input_matrix_t = Eigen::Matrix<scalar_t, INPUT_DIM, INPUT_DIM>;
+  using input_state_matrix_t = Eigen::Matrix<scalar_t, INPUT_DIM, STATE_DIM>;
+
+  FixedSizeQuadraticStateInputCost(const state_matrix_t& Q, const input_matrix_t& R,
+                                   const input_state_matrix_t& P = input_state_matrix_t::Zero())
+      : Q_(Q), R_(R), P_(P) {}
+  ~FixedSizeQuadraticStateInputCost() override = default;
+  FixedSizeQuadraticStateInputCost* clone() const override { return new FixedSizeQuadraticStateInputCost(*this); }
+
+  /** Get cost term value */
+  scalar_t getValue(scalar_t time, const vector_t& state, const vector_t& input, const TargetTrajectories& targetTrajectories,
+                    const PreComputation&) const override {
+    const state_vector_t dx = stateDeviation(time, state, targetTrajectories);
+    const input_vector_t du = inputDeviation(time, input, targetTrajectories);
+    return 0.5 * dx.dot(Q_ * dx) + 0.5 * du.dot(R_ * du) + du.dot(P_ * dx);
+  }
+
+  /** Get cost term quadratic approximation */
+  ScalarFunctionQuadraticApproximation getQuadraticApproximation(scalar_t time, const vector_t& state, const vector_t& input,
+                                                                 const TargetTrajectories& targetTrajectories,
+                                                                 const PreComputation&) const override {
+    const state_vector_t dx = stateDeviation(time, state, targetTrajectories);
+    const input_vector_t du = inputDeviation(time, input, targetTrajectories);
+    const input_vector_t Pdx = P_ * dx;
+    const state_vector_t dfdx = Q_ * dx + P_.transpose() * du;
+    const input_vector_t dfdu = R_ * du + Pdx;
+
+    ScalarFunctionQuadraticApproximation L;
+    L.f = 0.5 * dx.dot(Q_ * dx) + 0.5 * du.dot(R_ * du) + du.dot(Pdx);
+    L.dfdx = dfdx;
+    L.dfdu = dfdu;
+    L.dfdxx = Q_;
+    L.dfduu = R_;
+    L.dfdux = P_;
+    return L;
+  }
+
+ private:
+  FixedSizeQuadraticStateInputCost(const FixedSizeQuadraticStateInputCost& rhs) = default;
+
+  static state_vector_t stateDeviation(scalar_t time, const vector_t& state, const TargetTrajectories& targetTrajectories) {
+    return fixedSizeDeviationFromTarget<STATE_DIM>(time, state, targetTrajectories.timeTrajectory, targetTrajectories.stateTrajectory);
+  }
+
+  static input_vector_t inputDeviation(scalar_t time, const vector_t& input, const TargetTrajectories& targetTrajectories) {
+    return fixedSizeDeviationFromTarget<INPUT_DIM>(time, input, targetTrajectories.timeTrajectory, targetTrajectories.inputTrajectory);
+  }
+
+  state_matrix_t Q_;
+  input_matrix_t R_;
+  input_state_matrix_t P_;
+};
+
+/**
+ * The fixed-size counterpart of QuadraticStateCost for small systems with compile-time dimensions:
+ * \f$ \Phi = 0.5(x-x_{n})' Q (x-x_{n}) \f$
+ *
+ * @tparam STATE_DIM: The state dimension.
+ */
+template <int STATE_DIM>
+class FixedSizeQuadraticStateCost final : public StateCost {
+ public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  using state_vector_t = Eigen::Matrix<scalar_t, STATE_DIM, 1>;
+  using state_matrix_t = Eigen::Matrix<scalar_t, STATE_DIM, STATE_DIM>;
+
+  explicit FixedSizeQuadraticStateCost(const state_matrix_t& Q) : Q_(Q) {}
+  ~FixedSizeQuadraticStateCost() override = default;
+  FixedSizeQuadraticStateCost* clone() const override { return new FixedSizeQuadraticStateCost(*this); }
+
+  /** Get cost term value */
+  scalar_t getValue(scalar_t time, const vector_t& state, const TargetTrajectories& targetTrajectories,
+                    const PreComputation&) const override {
+    const state_vector_t dx = stateDeviation(time, state, targetTrajectories);
+    return 0.5 * dx.dot(Q_ * dx);
+  }
+
+  /** Get cost term quadratic approximation */
+  ScalarFunctionQuadraticApproximation getQuadraticApproximation(scalar_t time, const vector_t& state,
+                                                                 const TargetTrajectories& targetTrajectories,
+                                                                 const PreComputation&) const override {
+    const state_vector_t dx = stateDeviation(time, state, targetTrajectories);
+    const state_vector_t dfdx = Q_ * dx;
+
+    ScalarFunctionQuadraticApproximation Phi;
+    Phi.f = 0.5 * dx.dot(dfdx);
+    Phi.dfdx = dfdx;
+    Phi.dfdxx = Q_;
+    return Phi;
+  }
+
+ private:
+  FixedSizeQuadraticStateCost(const FixedSizeQuadraticStateCost& rhs) = default;
+
+  static state_vector_t stateDeviation(scalar_t time, const vector_t& state, const TargetTrajectories& targetTrajectories) {
+    return fixedSizeDeviationFromTarget<STATE_DIM>(time, state, targetTrajectories.timeTrajectory, targetTrajectories.stateTrajectory);
+  }
+
+  state_matrix_t Q_;
+};
+
+}  // namespace ocs2
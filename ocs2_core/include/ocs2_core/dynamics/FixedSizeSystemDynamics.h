@@ -0,0 +1,184 @@
+/******************************************************************************
+Copyright (c) 2020, Farbod Farshidian. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#pragma once
+
+#include <ocs2_core/dynamics/SystemDynamicsBase.h>
+
+namespace ocs2 {
+
+/**
+ * The base class for the system dynamics of small systems with compile-time state and input dimensions. The derived class
+ * implements the flow map and its linear approximation on fixed-size Eigen types, such that the computations are unrolled
+ * and stack allocated. This class maps them to the dynamic-size interface of SystemDynamicsBase, i.e. only the inputs and results
+ * of the interface are converted from and to dynamic-size types.
+ *
+ * @tparam STATE_DIM: The state dimension.
+ * @tparam INPUT_DIM: The input dimension.
+ */
+template <int STATE_DIM, int INPUT_DIM>
+class FixedSizeSystemDynamics : public SystemDynamicsBase {
+ public:
+  using state_vector_t = Eigen::Matrix<scalar_t, STATE_DIM, 1>;
+  using input_vector_t = Eigen::Matrix<scalar_t, INPUT_DIM, 1>;
+  using state_matrix_t = Eigen::Matrix<scalar_t, STATE_DIM, STATE_DIM>;
+  using state_input_matrix_t = Eigen::Matrix<scalar_t, STATE_DIM, INPUT_DIM>;
+
+  /**
+   * Constructor
+   *
+   * @param [in] preComputation: The (optional) pre-computation module, internally keeps a copy.
+   *                             @see PreComputation class documentation.
+   */
+  explicit FixedSizeSystemDynamics(const PreComputation& preComputation = PreComputation()) : SystemDynamicsBase(preComputation) {}
+
+  /** Default destructor */
+  ~FixedSizeSystemDynamics() override = default;
+
+  /** Clone */
+  FixedSizeSystemDynamics* clone() const override = 0;
+
+  /**
+   * Computes the flow map on fixed-size types.
+   *
+   * @param [in] t: The current time.
+   * @param [in] x: The current state.
+   * @param [in] u: The current input.
+   * @param [in] preComp: pre-computation module, safely ignore this parameter if not used.
+   * @param [out] dxdt: The state time derivative.
+   */
+  virtual void computeFixedSizeFlowMap(scalar_t t, const state_vector_t& x, const input_vector_t& u, const PreComputation& preComp,
+                                       state_vector_t& dxdt) = 0;
+
+  /**
+   * Computes the linear approximation of the flow map on fixed-size types.
+   *
+   * @param [in] t: The current time.
+   * @param [in] x: The current state.
+   * @param [in] u: The current input.
+   * @param [in] preComp: pre-computation module, safely ignore this parameter if not used.
+   * @param [out] f: The state time derivative.
+   * @param [out] A: The derivative of the flow map w.r.t. the state.
+   * @param [out] B: The derivative of the flow map w.r.t. the input.
+   */
+  virtual void fixedSizeLinearApproximation(scalar_t t, const state_vector_t& x, const input_vector_t& u, const PreComputation& preComp,
+                                            state_vector_t& f, state_matrix_t& A, state_input_matrix_t& B) = 0;
+
+  vector_t computeFlowMap(scalar_t t, const vector_t& x, const vector_t& u, const PreComputation& preComp) final {
+    const state_vector_t xFixed = x;
+    const input_vector_t uFixed = u;
+    state_vector_t dxdt;
+    computeFixedSizeFlowMap(t, xFixed, uFixed, preComp, dxdt);
+    return dxdt;
+  }
+
+  VectorFunctionLinearApproximation linearApproximation(scalar_t t, const vector_t& x, const vector_t& u,
+                                                        const PreComputation& preComp) final {
+    const state_vector_t xFixed = x;
+    const input_vector_t uFixed = u;
+    state_vector_t f;
+    state_matrix_t A;
+    state_input_matrix_t B;
+    fixedSizeLinearApproximation(t, xFixed, uFixed, preComp, f, A, B);
+
+    VectorFunctionLinearApproximation approximation;
+    approximation.f = f;
+    approximation.dfdx = A;
+    approximation.dfdu = B;
+    return approximation;
+  }
+
+ protected:
+  FixedSizeSystemDynamics(const FixedSizeSystemDynamics& other) = default;
+};
+
+/**
+ * The fixed-size counterpart of LinearSystemDynamics:
+ *
+ * - \f$ \dot{x} = A * x + B * u   \quad \text{for intermediate times}, \f$
+ * - \f$ x^{+} = G * x^{-}         \quad \text{for switching times}. \f$
+ *
+ * @tparam STATE_DIM: The state dimension.
+ * @tparam INPUT_DIM: The input dimension.
+ */
+template <int STATE_DIM, int INPUT_DIM>
+class FixedSizeLinearSystemDynamics final : public FixedSizeSystemDynamics<STATE_DIM, INPUT_DIM> {
+ public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  using BASE = FixedSizeSystemDynamics<STATE_DIM, INPUT_DIM>;
+  using typename BASE::input_vector_t;
+  using typename BASE::state_input_matrix_t;
+  using typename BASE::state_matrix_t;
+  using typename BASE::state_vector_t;
+
+  FixedSizeLinearSystemDynamics(const state_matrix_t& A, const state_input_matrix_t& B,
+                                const state_matrix_t& G = state_matrix_t::Identity())
+      : A_(A), B_(B), G_(G) {}
+
+  ~FixedSizeLinearSystemDynamics() override = default;
+
+  FixedSizeLinearSystemDynamics* clone() const override { return new FixedSizeLinearSystemDynamics(*this); }
+
+  void computeFixedSizeFlowMap(scalar_t t, const state_vector_t& x, const input_vector_t& u, const PreComputation&,
+                               state_vector_t& dxdt) override {
+    dxdt.noalias() = A_ * x;
+    dxdt.noalias() += B_ * u;
+  }
+
+  void fixedSizeLinearApproximation(scalar_t t, const state_vector_t& x, const input_vector_t& u, const PreComputation& preComp,
+                                    state_vector_t& f, state_matrix_t& A, state_input_matrix_t& B) override {
+    computeFixedSizeFlowMap(t, x, u, preComp, f);
+    A = A_;
+    B = B_;
+  }
+
+  vector_t computeJumpMap(scalar_t t, const vector_t& x, const PreComputation&) override {
+    const state_vector_t xFixed = x;
+    const state_vector_t xNext = G_ * xFixed;
+    return xNext;
+  }
+
+  VectorFunctionLinearApproximation jumpMapLinearApproximation(scalar_t t, const vector_t& x, const PreComputation& preComp) override {
+    VectorFunctionLinearApproximation approximation;
+    approximation.f = computeJumpMap(t, x, preComp);
+    approximation.dfdx = G_;
+    approximation.dfdu.setZero(STATE_DIM, 0);
+    return approximation;
+  }
+
+ private:
+  FixedSizeLinearSystemDynamics(const FixedSizeLinearSystemDynamics& other) = default;
+
+  state_matrix_t A_;
+  state_input_matrix_t B_;
+  state_matrix_t G_;
+};
+
+}  // namespace ocs2
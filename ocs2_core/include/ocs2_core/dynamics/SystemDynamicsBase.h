@@ -31,6 +31,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <ocs2_core/Types.h>
 #include <ocs2_core/dynamics/ControlledSystemBase.h>
+#include <ocs2_core/misc/BlockSparsity.h>
 
 namespace ocs2 {
 
@@ -113,6 +114,16 @@ class SystemDynamicsBase : public ControlledSystemBase {
    */
   virtual matrix_t dynamicsCovariance(scalar_t t, const vector_t& x, const vector_t& u);
 
+  /**
+   * Get the structural sparsity of the flow map linear approximation, i.e. the entries of dfdx and dfdu that are zero for every state
+   * and input. The default implementation does not provide it.
+   *
+   * @param [out] dfdxSparsity: Sparsity of the derivative w.r.t. the state.
+   * @param [out] dfduSparsity: Sparsity of the derivative w.r.t. the input.
+   * @return true if the sparsity is available.
+   */
+  virtual bool getFlowMapSparsity(BlockSparsity& dfdxSparsity, BlockSparsity& dfduSparsity) const { return false; }
+
   /**
    * Computes the flow map linear approximation.
    *
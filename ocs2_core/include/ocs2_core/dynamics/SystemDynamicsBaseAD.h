@@ -79,6 +79,8 @@ class SystemDynamicsBaseAD : public SystemDynamicsBase {
   /** @note: Requires linear approximation to be called before */
   vector_t flowMapDerivativeTime(scalar_t t, const vector_t& x, const vector_t& u) final;
 
+  bool getFlowMapSparsity(BlockSparsity& dfdxSparsity, BlockSparsity& dfduSparsity) const final;
+
   /** @note: Requires jump map linear approximation to be called before */
   vector_t jumpMapDerivativeTime(scalar_t t, const vector_t& x, const vector_t& u) final;
 
@@ -31,6 +31,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <ocs2_core/Types.h>
 #include <ocs2_core/dynamics/SystemDynamicsBase.h>
+#include <ocs2_core/misc/BlockSparsity.h>
 
 namespace ocs2 {
 
@@ -68,6 +69,15 @@ using DynamicsDiscretizer = std::function<vector_t(SystemDynamicsBase&, scalar_t
  */
 DynamicsDiscretizer selectDynamicsDiscretization(SensitivityIntegratorType integratorType);
 
+/**
+ * Select available integrator based on enum. Intervals longer than maxStepSize are integrated in equal sub-steps, such that coarse
+ * intervals, e.g. in the tail of a non-uniform horizon, keep the accuracy of the integrator.
+ *
+ * @param integratorType : Integrator used for each sub-step.
+ * @param maxStepSize : Largest sub-step. Non-positive values disable the sub-stepping.
+ */
+DynamicsDiscretizer selectDynamicsDiscretization(SensitivityIntegratorType integratorType, scalar_t maxStepSize);
+
 /**
  * A function handle to compute the linear approximation of the discretized system's flowmap.
  *
@@ -87,4 +97,25 @@ using DynamicsSensitivityDiscretizer =
  */
 DynamicsSensitivityDiscretizer selectDynamicsSensitivityDiscretization(SensitivityIntegratorType integratorType);
 
+/**
+ * Select available integrator based on enum, with sub-steps of at most maxStepSize. The sensitivities of the sub-steps are chained.
+ * Note that the sub-steps fill in the sparsity of the sensitivities beyond getDynamicsSensitivityDiscretizationSparsity.
+ *
+ * @param integratorType : Integrator used for each sub-step.
+ * @param maxStepSize : Largest sub-step. Non-positive values disable the sub-stepping.
+ */
+DynamicsSensitivityDiscretizer selectDynamicsSensitivityDiscretization(SensitivityIntegratorType integratorType, scalar_t maxStepSize);
+
+/**
+ * Structural sparsity of the discretized sensitivities A_{k}, B_{k} of the given integrator, see DynamicsSensitivityDiscretizer.
+ *
+ * @param [in] integratorType : Integrator used for the discretization.
+ * @param [in] dfdxSparsity : Sparsity of the continuous time flow map derivative w.r.t. the state.
+ * @param [in] dfduSparsity : Sparsity of the continuous time flow map derivative w.r.t. the input.
+ * @param [out] ASparsity : Sparsity of A_{k}.
+ * @param [out] BSparsity : Sparsity of B_{k}.
+ */
+void getDynamicsSensitivityDiscretizationSparsity(SensitivityIntegratorType integratorType, const BlockSparsity& dfdxSparsity,
+                                                  const BlockSparsity& dfduSparsity, BlockSparsity& ASparsity, BlockSparsity& BSparsity);
+
 }  // namespace ocs2
\ No newline at end of file
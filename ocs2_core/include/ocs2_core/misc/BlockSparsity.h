@@ -0,0 +1,142 @@
+/******************************************************************************
+Copyright (c) 2020, Farbod Farshidian. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#pragma once
+
+#include <set>
+#include <vector>
+
+#include <ocs2_core/Types.h>
+
+namespace ocs2 {
+
+/**
+ * Structural sparsity of a matrix. The structural non-zeros are covered by a list of dense rectangular blocks, such that matrix
+ * products only need to touch those blocks. Small gaps are absorbed into the blocks, since small dense blocks are cheaper to multiply
+ * than many scattered entries.
+ *
+ * A default constructed or Zero() sparsity has no blocks, i.e. the matrix is structurally zero. Use Dense() when nothing is known.
+ */
+class BlockSparsity {
+ public:
+  /** Dense block of a matrix */
+  struct Block {
+    int row;
+    int col;
+    int rows;
+    int cols;
+  };
+
+  /** Boolean pattern of the structural non-zeros */
+  using pattern_t = Eigen::Array<bool, Eigen::Dynamic, Eigen::Dynamic>;
+
+  /** Default constructor, creates an empty 0x0 sparsity */
+  BlockSparsity() = default;
+
+  /** Constructs from a boolean pattern of structural non-zeros */
+  explicit BlockSparsity(pattern_t pattern);
+
+  /** Structurally zero matrix */
+  static BlockSparsity Zero(int rows, int cols);
+
+  /** Structurally dense matrix */
+  static BlockSparsity Dense(int rows, int cols);
+
+  /** Structural identity matrix */
+  static BlockSparsity Identity(int size);
+
+  /** Sparsity of the non-zeros of a given matrix */
+  static BlockSparsity fromMatrix(const matrix_t& matrix);
+
+  /**
+   * Sparsity of a column range of a (CppAD) sparsity pattern, which holds one set of non-zero column indices per row.
+   *
+   * @param [in] sparsityPattern : Non-zero column indices per row.
+   * @param [in] rows : Number of rows, must be equal to the size of the sparsityPattern.
+   * @param [in] cols : Number of columns to extract.
+   * @param [in] colOffset : Column of sparsityPattern that corresponds to the first column.
+   */
+  static BlockSparsity fromSparsityPattern(const std::vector<std::set<size_t>>& sparsityPattern, int rows, int cols, int colOffset = 0);
+
+  int rows() const { return static_cast<int>(pattern_.rows()); }
+  int cols() const { return static_cast<int>(pattern_.cols()); }
+
+  /** Boolean pattern of the structural non-zeros */
+  const pattern_t& pattern() const { return pattern_; }
+
+  /** Dense blocks covering all structural non-zeros */
+  const std::vector<Block>& blocks() const { return blocks_; }
+
+  /** Fraction of the matrix that is covered by the blocks */
+  scalar_t density() const;
+
+  /** Sparsity of the transposed matrix */
+  BlockSparsity transpose() const;
+
+  /** Sparsity of the sum of two matrices of the same size */
+  BlockSparsity operator+(const BlockSparsity& rhs) const;
+
+  /** Sparsity of the product of two matrices */
+  BlockSparsity operator*(const BlockSparsity& rhs) const;
+
+  bool operator==(const BlockSparsity& rhs) const;
+  bool operator!=(const BlockSparsity& rhs) const { return !(*this == rhs); }
+
+ private:
+  /** Covers the pattern with dense blocks */
+  void updateBlocks();
+
+  pattern_t pattern_;
+  std::vector<Block> blocks_;
+};
+
+std::ostream& operator<<(std::ostream& out, const BlockSparsity& sparsity);
+
+namespace block_sparse {
+
+/**
+ * Accumulates out += A * B, using only the blocks of A.
+ * @param [in] sparsityA : Sparsity of A.
+ */
+void addProduct(const BlockSparsity& sparsityA, const matrix_t& A, const matrix_t& B, matrix_t& out);
+
+/**
+ * Accumulates out += A' * B, using only the blocks of A.
+ * @param [in] sparsityA : Sparsity of A.
+ */
+void addTransposeProduct(const BlockSparsity& sparsityA, const matrix_t& A, const matrix_t& B, matrix_t& out);
+
+/**
+ * Accumulates out += B * A, using only the blocks of A.
+ * @param [in] sparsityA : Sparsity of A.
+ */
+void addRightProduct(const matrix_t& B, const BlockSparsity& sparsityA, const matrix_t& A, matrix_t& out);
+
+}  // namespace block_sparse
+}  // namespace ocs2
@@ -35,6 +35,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <unordered_map>
 #include <vector>
 
+#include "ocs2_core/misc/TermProfiler.h"
+
 namespace ocs2 {
 
 /**
@@ -97,16 +99,36 @@ class Collection {
    */
   bool getTermIndex(const std::string& name, size_t& index) const;
 
+  /**
+   * Enables the profiling of the terms. The evaluations of each term are recorded in the profiler under the name "prefix/name", including
+   * the terms which are added later. The copies of the collection share the profiler, such that the statistics of all copies are
+   * aggregated.
+   *
+   * @param [in] profilerPtr : The profiler, profiling is disabled if nullptr.
+   * @param [in] prefix : Prefix of the term names, e.g. the role of the collection in the optimal control problem.
+   */
+  void setTermProfiler(std::shared_ptr<TermProfiler> profilerPtr, std::string prefix);
+
  protected:
   /** Copy constructor */
   Collection(const Collection& other);
 
+  /** Times the evaluation of the term with the given index for the lifetime of the returned object, if profiling is enabled. */
+  TermProfiler::ScopedTimer profileTerm(size_t termIndex) const {
+    return TermProfiler::ScopedTimer(termStatistics_.empty() ? nullptr : termStatistics_[termIndex]);
+  }
+
   //! Contains all terms in the order they were added
   std::vector<std::unique_ptr<T>> terms_;
 
  private:
   //! Lookup from cost term name to index in the cost term vector
   std::unordered_map<std::string, size_t> termNameMap_;
+
+  //! Profiling of the terms, the statistics are in the same order as the terms
+  std::shared_ptr<TermProfiler> termProfilerPtr_;
+  std::string termProfilerPrefix_;
+  std::vector<TermProfiler::Statistics*> termStatistics_;
 };
 
 /******************************************************************************************************/
@@ -116,6 +138,7 @@ template <typename T>
 void Collection<T>::clear() {
   terms_.clear();
   termNameMap_.clear();
+  termStatistics_.clear();
 }
 
 /******************************************************************************************************/
@@ -127,6 +150,9 @@ void Collection<T>::add(std::string name, std::unique_ptr<T> term) {
   auto info = termNameMap_.emplace(std::move(name), nextIndex);
   if (info.second) {
     terms_.push_back(std::move(term));
+    if (termProfilerPtr_ != nullptr) {
+      termStatistics_.push_back(&termProfilerPtr_->getStatistics(termProfilerPrefix_ + "/" + info.first->first));
+    }
   } else {
     throw std::runtime_error(std::string("[Collection::add] Term with name \"") + info.first->first + "\" already exists");
   }
@@ -160,6 +186,9 @@ std::unique_ptr<T> Collection<T>::extract(const std::string& name) {
   auto term = (std::move(terms_[termInd]));
   // remove the term
   terms_.erase(terms_.begin() + termInd);
+  if (!termStatistics_.empty()) {
+    termStatistics_.erase(termStatistics_.begin() + termInd);
+  }
 
   return term;
 }
@@ -180,7 +209,11 @@ Derived& Collection<T>::get(const std::string& name) {
 /******************************************************************************************************/
 /******************************************************************************************************/
 template <typename T>
-Collection<T>::Collection(const Collection& other) : termNameMap_(other.termNameMap_) {
+Collection<T>::Collection(const Collection& other)
+    : termNameMap_(other.termNameMap_),
+      termProfilerPtr_(other.termProfilerPtr_),
+      termProfilerPrefix_(other.termProfilerPrefix_),
+      termStatistics_(other.termStatistics_) {
   // Loop through all terms and clone. The name map can be copied directly because the order stays the same.
   terms_.reserve(other.terms_.size());
   for (const auto& term : other.terms_) {
@@ -203,6 +236,22 @@ bool Collection<T>::getTermIndex(const std::string& name, size_t& index) const {
   }
 }
 
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+template <typename T>
+void Collection<T>::setTermProfiler(std::shared_ptr<TermProfiler> profilerPtr, std::string prefix) {
+  termProfilerPtr_ = std::move(profilerPtr);
+  termProfilerPrefix_ = std::move(prefix);
+  termStatistics_.clear();
+  if (termProfilerPtr_ != nullptr) {
+    termStatistics_.resize(terms_.size());
+    for (const auto& nameIndex : termNameMap_) {
+      termStatistics_[nameIndex.second] = &termProfilerPtr_->getStatistics(termProfilerPrefix_ + "/" + nameIndex.first);
+    }
+  }
+}
+
 /**
  * Helper function for merging two vectors by moving objects.
  * @param v1 : vector to move objects to
@@ -53,6 +53,17 @@ using remove_cvref_t = typename std::remove_cv<typename std::remove_reference<T>
  */
 index_alpha_t timeSegment(scalar_t enquiryTime, const std::vector<scalar_t>& timeArray);
 
+/**
+ * Same as timeSegment(enquiryTime, timeArray), but the lookup starts at the given index hint, which is updated for the next query.
+ * Consecutive queries with increasing time take constant time.
+ *
+ * @param [in] enquiryTime: The enquiry time for interpolation.
+ * @param [in] timeArray: interpolation time array.
+ * @param [in, out] indexHint: Lookup index of the previous query, initialize with 0.
+ * @return {index, alpha}
+ */
+index_alpha_t timeSegment(scalar_t enquiryTime, const std::vector<scalar_t>& timeArray, int& indexHint);
+
 /**
  * Directly uses the index and interpolation coefficient provided by the user
  * @note If sizes in data array are not equal, the interpolation will snap to the data
@@ -72,6 +83,20 @@ index_alpha_t timeSegment(scalar_t enquiryTime, const std::vector<scalar_t>& tim
 template <typename Data, class Alloc>
 Data interpolate(index_alpha_t indexAlpha, const std::vector<Data, Alloc>& dataArray);
 
+/**
+ * Same as interpolate(indexAlpha, dataArray), but writes into the given result. No memory is allocated if the result has already the
+ * size of the data.
+ *
+ * @param [in] indexAlpha : index and interpolation coefficient (alpha) pair
+ * @param [in] dataArray: vector of data
+ * @param [out] result: The interpolation result
+ *
+ * @tparam Data: Data type
+ * @tparam Alloc: Specialized allocation class
+ */
+template <typename Data, class Alloc>
+void interpolateInto(index_alpha_t indexAlpha, const std::vector<Data, Alloc>& dataArray, Data& result);
+
 /**
  * Linearly interpolates at the given time. When duplicate values exist the lower range is selected s.t. ( ]
  * Example: t = [0.0, 1.0, 1.0, 2.0]
@@ -139,6 +164,76 @@ template <typename Data, class Alloc, class AccessFun>
 auto interpolate(scalar_t enquiryTime, const std::vector<scalar_t>& timeArray, const std::vector<Data, Alloc>& dataArray,
                  AccessFun accessFun) -> remove_cvref_t<typename std::result_of<AccessFun(const std::vector<Data, Alloc>&, size_t)>::type>;
 
+/**
+ * Interpolation cursor on a time array for a sequence of enquiry times, e.g. the steps of an integrator. The cursor remembers the
+ * segment of the previous query and gallops from it to the new segment, such that monotonic queries take constant time on average.
+ * Several data arrays which are co-indexed with the time array are interpolated at the current segment without further lookups.
+ *
+ * Usage:
+ *   TimeSegmentCursor cursor(timeTrajectory);
+ *   for (...) {
+ *     cursor.seek(time);
+ *     cursor.interpolateInto(stateTrajectory, state, inputTrajectory, input);
+ *   }
+ *
+ * @note The time array is referenced, it has to outlive the cursor.
+ */
+class TimeSegmentCursor {
+ public:
+  /** Constructor, the cursor needs to be reset to a time array before use */
+  TimeSegmentCursor() = default;
+
+  /** Constructor */
+  explicit TimeSegmentCursor(const std::vector<scalar_t>& timeArray) : timeArrayPtr_(&timeArray) {}
+
+  /** Sets the time array and moves the cursor to its start */
+  void reset(const std::vector<scalar_t>& timeArray) {
+    timeArrayPtr_ = &timeArray;
+    indexHint_ = 0;
+    indexAlpha_ = {0, scalar_t(1.0)};
+  }
+
+  /** Moves the cursor to the segment of the enquiry time and returns the {index, alpha} pair of timeSegment(). */
+  const index_alpha_t& seek(scalar_t enquiryTime) {
+    indexAlpha_ = timeSegment(enquiryTime, *timeArrayPtr_, indexHint_);
+    return indexAlpha_;
+  }
+
+  /** The {index, alpha} pair of the current segment */
+  const index_alpha_t& indexAlpha() const { return indexAlpha_; }
+
+  /** Interpolates the data array at the current segment */
+  template <typename Data, class Alloc>
+  Data interpolate(const std::vector<Data, Alloc>& dataArray) const {
+    return LinearInterpolation::interpolate(indexAlpha_, dataArray);
+  }
+
+  /** Interpolates a subfield of the data array at the current segment, see interpolate(indexAlpha, dataArray, accessFun) */
+  template <typename Data, class Alloc, class AccessFun>
+  auto interpolate(const std::vector<Data, Alloc>& dataArray, AccessFun accessFun) const
+      -> remove_cvref_t<typename std::result_of<AccessFun(const std::vector<Data, Alloc>&, size_t)>::type> {
+    return LinearInterpolation::interpolate(indexAlpha_, dataArray, accessFun);
+  }
+
+  /** Interpolates the data array at the current segment into the given result */
+  template <typename Data, class Alloc>
+  void interpolateInto(const std::vector<Data, Alloc>& dataArray, Data& result) const {
+    LinearInterpolation::interpolateInto(indexAlpha_, dataArray, result);
+  }
+
+  /** Interpolates several co-indexed data arrays at the current segment, given as pairs of (dataArray, result) */
+  template <typename Data, class Alloc, typename... Rest>
+  void interpolateInto(const std::vector<Data, Alloc>& dataArray, Data& result, Rest&&... rest) const {
+    interpolateInto(dataArray, result);
+    interpolateInto(std::forward<Rest>(rest)...);
+  }
+
+ private:
+  const std::vector<scalar_t>* timeArrayPtr_ = nullptr;
+  int indexHint_ = 0;
+  index_alpha_t indexAlpha_{0, scalar_t(1.0)};
+};
+
 }  // namespace LinearInterpolation
 }  // namespace ocs2
 
@@ -91,6 +91,44 @@ int findIndexInTimeArray(const std::vector<SCALAR>& timeArray, SCALAR time) {
   return static_cast<int>(firstLargerValueIterator - timeArray.begin());
 }
 
+/**
+ * Same as findIndexInTimeArray, but the search starts at the given index hint, e.g. the result of a previous query. The search gallops
+ * from the hint towards the result with exponentially growing steps, such that its cost is logarithmic in the distance between the hint
+ * and the result. Consecutive queries with monotonic time therefore take constant time on average.
+ *
+ * @tparam SCALAR : numerical type of time
+ * @param timeArray : sorted time array to perform the lookup in
+ * @param time : enquiry time
+ * @param indexHint : index where the search starts, it can be out of bounds
+ * @return index between [0, size(timeArray)]
+ */
+template <typename SCALAR = double>
+int findIndexInTimeArray(const std::vector<SCALAR>& timeArray, SCALAR time, int indexHint) {
+  const auto size = static_cast<int>(timeArray.size());
+  int index = std::min(std::max(indexHint, 0), size);
+  if (index < size && timeArray[index] < time) {
+    // gallop forward: the result is in (index, upper]
+    int step = 1;
+    int upper = index + 1;
+    while (upper < size && timeArray[upper] < time) {
+      index = upper;
+      step *= 2;
+      upper = std::min(index + step, size);
+    }
+    return static_cast<int>(std::lower_bound(timeArray.begin() + index + 1, timeArray.begin() + upper, time) - timeArray.begin());
+  } else {
+    // gallop backward: the result is in [lower, index]
+    int step = 1;
+    int lower = index - 1;
+    while (lower >= 0 && timeArray[lower] >= time) {
+      index = lower;
+      step *= 2;
+      lower = std::max(index - step, -1);
+    }
+    return static_cast<int>(std::lower_bound(timeArray.begin() + lower + 1, timeArray.begin() + index, time) - timeArray.begin());
+  }
+}
+
 /**
  *  Find interval into a sorted time Array
  *
@@ -0,0 +1,122 @@
+/******************************************************************************
+Copyright (c) 2020, Farbod Farshidian. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ocs2_core/Types.h"
+
+namespace ocs2 {
+
+/**
+ * Collects the evaluation time and the number of calls of named terms, e.g. the terms of the cost and constraint collections.
+ * The statistics are updated with atomics, such that a single profiler can be shared between the copies of a collection used by
+ * different worker threads.
+ */
+class TermProfiler {
+ public:
+  /** Statistics of a single term */
+  struct Statistics {
+    std::atomic<uint64_t> numCalls{0};
+    std::atomic<int64_t> totalTime{0};  // [ns]
+    std::atomic<int64_t> maxTime{0};    // [ns]
+  };
+
+  /** Snapshot of the statistics of a term */
+  struct Entry {
+    std::string name;
+    uint64_t numCalls;
+    scalar_t totalInMilliseconds;
+    scalar_t averageInMicroseconds;
+    scalar_t maxInMicroseconds;
+  };
+
+  /** Measures the lifetime of the object and adds it to the statistics. Does nothing if constructed with nullptr. */
+  class ScopedTimer {
+   public:
+    explicit ScopedTimer(Statistics* statisticsPtr)
+        : statisticsPtr_(statisticsPtr),
+          startTime_(statisticsPtr != nullptr ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point()) {}
+
+    ScopedTimer(ScopedTimer&& other) noexcept : statisticsPtr_(other.statisticsPtr_), startTime_(other.startTime_) {
+      other.statisticsPtr_ = nullptr;
+    }
+
+    ~ScopedTimer() {
+      if (statisticsPtr_ != nullptr) {
+        const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime_).count();
+        TermProfiler::addSample(*statisticsPtr_, duration);
+      }
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(ScopedTimer&&) = delete;
+
+   private:
+    Statistics* statisticsPtr_;
+    std::chrono::steady_clock::time_point startTime_;
+  };
+
+  TermProfiler() = default;
+  TermProfiler(const TermProfiler&) = delete;
+  TermProfiler& operator=(const TermProfiler&) = delete;
+
+  /**
+   * Gets the statistics of a term. The term is registered on the first call, the returned reference stays valid for the lifetime of
+   * the profiler.
+   */
+  Statistics& getStatistics(const std::string& name);
+
+  /** Adds a measured evaluation to the statistics */
+  static void addSample(Statistics& statistics, int64_t duration);
+
+  /** Resets the statistics of all terms, the terms stay registered. */
+  void reset();
+
+  /** Snapshot of the statistics of all terms which have been called, sorted by decreasing total time. */
+  std::vector<Entry> getEntries() const;
+
+  /** Table of the statistics of all terms which have been called, sorted by decreasing total time. */
+  std::string getReport() const;
+
+ private:
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, std::unique_ptr<Statistics>> statistics_;
+};
+
+}  // namespace ocs2
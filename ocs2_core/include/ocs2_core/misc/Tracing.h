@@ -0,0 +1,152 @@
+/******************************************************************************
+Copyright (c) 2020, Farbod Farshidian. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * Structured tracing of the solvers. Events are recorded as named intervals into a ring buffer owned by the recording thread, and can
+ * be exported in the Chrome trace event format, which opens in Perfetto (ui.perfetto.dev) and chrome://tracing.
+ *
+ * The instrumentation macros are compiled out unless OCS2_ENABLE_TRACING is defined, e.g. with
+ *   catkin config --cmake-args -DOCS2_ENABLE_TRACING=ON
+ *
+ * Usage:
+ *   {
+ *     OCS2_TRACE_SCOPE("sqp", "solveQp");
+ *     ...
+ *   }
+ *   ocs2::tracing::exportChromeTrace("/tmp/ocs2_trace.json");
+ */
+#ifdef OCS2_ENABLE_TRACING
+#define OCS2_TRACE_CONCAT_IMPL(a, b) a##b
+#define OCS2_TRACE_CONCAT(a, b) OCS2_TRACE_CONCAT_IMPL(a, b)
+/** Traces the enclosing scope. The category and name have to be string literals. */
+#define OCS2_TRACE_SCOPE(category, name) const ::ocs2::tracing::ScopedEvent OCS2_TRACE_CONCAT(ocs2TraceEvent, __LINE__)(category, name)
+/** Traces the enclosing scope with an index argument, e.g. the iteration or the node index. */
+#define OCS2_TRACE_SCOPE_INDEX(category, name, index) \
+  const ::ocs2::tracing::ScopedEvent OCS2_TRACE_CONCAT(ocs2TraceEvent, __LINE__)(category, name, index)
+/** Names the calling thread in the trace */
+#define OCS2_TRACE_THREAD_NAME(name) ::ocs2::tracing::setThreadName(name)
+#else
+#define OCS2_TRACE_SCOPE(category, name) static_cast<void>(0)
+#define OCS2_TRACE_SCOPE_INDEX(category, name, index) static_cast<void>(0)
+#define OCS2_TRACE_THREAD_NAME(name) static_cast<void>(0)
+#endif
+
+namespace ocs2 {
+namespace tracing {
+
+/** A traced interval */
+struct Event {
+  const char* category;  // static string
+  const char* name;      // static string
+  int64_t beginTime;     // [ns] since the start of tracing
+  int64_t duration;      // [ns]
+  int64_t index;         // optional argument, negative if not used
+};
+
+/** The events recorded by a single thread */
+struct ThreadTrace {
+  size_t threadId;
+  std::string threadName;
+  std::vector<Event> events;  // ordered by end time
+  size_t numDroppedEvents;    // overwritten in the ring buffer since the last clear()
+};
+
+/**
+ * Number of events kept per thread, older events are overwritten. The buffer of a thread is released when the thread exits without
+ * events, or otherwise on the next clear().
+ */
+constexpr size_t ringBufferCapacity = 1 << 14;
+
+/** Current time in [ns] since the start of tracing, based on the steady clock. */
+int64_t now();
+
+/**
+ * Records a completed event. Recording is lock-free, only the first event of a thread takes a lock to register its ring buffer.
+ *
+ * @param [in] category : Category of the event, has to be a string with static storage duration.
+ * @param [in] name : Name of the event, has to be a string with static storage duration.
+ * @param [in] beginTime : Start of the event, see now().
+ * @param [in] endTime : End of the event, see now().
+ * @param [in] index : Optional argument shown with the event, ignored if negative.
+ */
+void recordEvent(const char* category, const char* name, int64_t beginTime, int64_t endTime, int64_t index = -1);
+
+/** Names the calling thread in the trace */
+void setThreadName(const std::string& name);
+
+/** Enables or disables the recording at runtime. Recording is enabled by default. */
+void setEnabled(bool enabled);
+bool isEnabled();
+
+/** Discards all recorded events, and releases the ring buffers of the threads which have exited */
+void clear();
+
+/**
+ * Copies the events recorded by all threads. It can be called while other threads are recording, in which case the events that might
+ * have been overwritten during the copy are dropped.
+ */
+std::vector<ThreadTrace> collect();
+
+/** Writes the recorded events as Chrome trace event JSON */
+void writeChromeTrace(std::ostream& stream);
+
+/** Writes the recorded events as Chrome trace event JSON file */
+void exportChromeTrace(const std::string& fileName);
+
+/** Records the lifetime of the object as an event */
+class ScopedEvent {
+ public:
+  ScopedEvent(const char* category, const char* name, int64_t index = -1)
+      : category_(category), name_(name), index_(index), beginTime_(isEnabled() ? now() : -1) {}
+
+  ~ScopedEvent() {
+    if (beginTime_ >= 0) {
+      recordEvent(category_, name_, beginTime_, now(), index_);
+    }
+  }
+
+  ScopedEvent(const ScopedEvent&) = delete;
+  ScopedEvent& operator=(const ScopedEvent&) = delete;
+
+ private:
+  const char* category_;
+  const char* name_;
+  int64_t index_;
+  int64_t beginTime_;
+};
+
+}  // namespace tracing
+}  // namespace ocs2
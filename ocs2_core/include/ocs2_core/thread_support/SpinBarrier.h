@@ -0,0 +1,117 @@
+/******************************************************************************
+Copyright (c) 2020, Farbod Farshidian. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace ocs2 {
+
+/** Hints the CPU that the calling thread is in a spin-wait loop. */
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#else
+  std::this_thread::yield();
+#endif
+}
+
+/**
+ * Sense-reversing barrier for a fixed number of threads that busy-waits instead of sleeping on a condition variable. It is meant for
+ * short and frequent synchronizations, e.g. between the iterations of a parallel first-order solver, where the wake-up latency of a
+ * sleeping thread would dominate. After spinCount polls, a waiting thread falls back to sleeping on a condition variable. If there are
+ * more threads than hardware threads, the waiting threads sleep right away, since spinning would only delay the threads that still have
+ * to arrive.
+ *
+ * Usage, in each of the numThreads threads:
+ *   bool localSense = false;
+ *   while (...) {
+ *     doWork();
+ *     barrier.arriveAndWait(localSense, [&] { serialWork(); });
+ *   }
+ */
+class SpinBarrier {
+ public:
+  /**
+   * Constructor
+   * @param [in] numThreads: Number of threads that synchronize on the barrier.
+   * @param [in] spinCount: Number of busy-wait polls before a waiting thread goes to sleep.
+   */
+  explicit SpinBarrier(size_t numThreads, size_t spinCount = 1000)
+      : numThreads_(numThreads), spinCount_(numThreads <= std::thread::hardware_concurrency() ? spinCount : 0), count_(numThreads) {}
+
+  /**
+   * Blocks until all threads have arrived. The last thread to arrive calls the completion function before it releases the others, so
+   * the completion function is executed while all other threads wait and its effects are visible to all of them after the call.
+   *
+   * @param [in, out] localSense: The sense of the calling thread. Initialize it to false and keep it per thread between calls.
+   * @param [in] completion: Function that is called once per phase by the last arriving thread.
+   */
+  template <typename Completion>
+  void arriveAndWait(bool& localSense, Completion&& completion) {
+    localSense = !localSense;
+    if (count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      completion();
+      count_.store(numThreads_, std::memory_order_relaxed);
+      sense_.store(localSense);
+      if (numSleeping_.load() > 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        conditionVariable_.notify_all();
+      }
+    } else {
+      for (size_t numPolls = 0; numPolls < spinCount_; ++numPolls) {
+        if (sense_.load(std::memory_order_acquire) == localSense) {
+          return;
+        }
+        cpuRelax();
+      }
+      std::unique_lock<std::mutex> lock(mutex_);
+      ++numSleeping_;
+      conditionVariable_.wait(lock, [&] { return sense_.load() == localSense; });
+      --numSleeping_;
+    }
+  }
+
+  /** Blocks until all threads have arrived. */
+  void arriveAndWait(bool& localSense) { arriveAndWait(localSense, [] {}); }
+
+ private:
+  const size_t numThreads_;
+  const size_t spinCount_;
+  std::atomic<size_t> count_;
+  std::atomic<bool> sense_{false};
+  std::atomic<size_t> numSleeping_{0};
+  std::mutex mutex_;
+  std::condition_variable conditionVariable_;
+};
+
+}  // namespace ocs2
@@ -29,7 +29,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
+#include <functional>
 #include <future>
 #include <mutex>
 #include <queue>
@@ -48,8 +50,10 @@ class ThreadPool {
    *
    * @param [in] nThreads: Number of threads to launch in the pool
    * @param [in] priority: The worker thread priority
+   * @param [in] spinCount: Number of busy-wait iterations an idle worker polls for new tasks before it goes to sleep. Spinning removes
+   *                        the wake-up latency of back-to-back parallel sections at the cost of burning CPU while idle.
    */
-  explicit ThreadPool(size_t nThreads = 1, int priority = 0);
+  explicit ThreadPool(size_t nThreads = 1, int priority = 0, size_t spinCount = 0);
 
   /**
    * Destructor
@@ -80,6 +84,25 @@ class ThreadPool {
    */
   void runParallel(std::function<void(int)> taskFunction, int N);
 
+  /**
+   * Helper function to run a loop over the index range [begin, end) in parallel with the help of the pool and the calling thread.
+   * The range is initially split evenly over (nThreads + 1) lock-free deques, one per participating thread. Each thread consumes
+   * chunks of grainSize indices from the front of its own deque. Once its deque is empty, it steals half of the remaining indices
+   * from the back of another one.
+   * - Pool workers run with ID in [0, nThreads-1], the calling thread runs with ID = nThreads.
+   * - Each index is processed exactly once and a worker ID is never used by two threads at the same time.
+   *
+   * @note This is a blocking operation, returns when all indices are processed. The first exception thrown by taskFunction is
+   * rethrown after all threads have finished.
+   *
+   * @param [in] begin: first index of the range.
+   * @param [in] end: one past the last index of the range.
+   * @param [in] grainSize: minimum number of consecutive indices a thread processes at once. For grainSize <= 0, it is adapted to the
+   *                        range size and the number of threads.
+   * @param [in] taskFunction: task function with signature (workerIndex, index).
+   */
+  void parallelFor(int begin, int end, int grainSize, std::function<void(int, int)> taskFunction);
+
   /** Get the number of threads. */
   size_t numThreads() const { return workerThreads_.size(); }
 
@@ -104,8 +127,10 @@ class ThreadPool {
   void runTask(std::unique_ptr<TaskBase> taskPtr);
 
   bool stop_{false};  //!< flag telling all threads to stop, protected by taskQueueLock_
+  const size_t spinCount_;
 
   std::queue<std::unique_ptr<TaskBase>> taskQueue_;  // protected by taskQueueLock_
+  std::atomic_size_t numQueuedTasks_{0};             // mirrors taskQueue_.size() for lock-free polling of idle workers
   std::condition_variable taskQueueCondition_;
   std::mutex taskQueueLock_;
 
@@ -61,6 +61,7 @@ std::vector<LagrangianMetrics> StateAugmentedLagrangianCollection::getValue(scal
   termsConstraintPenalty.reserve(terms_.size());
   for (size_t i = 0; i < terms_.size(); i++) {
     if (terms_[i]->isActive(time)) {
+      const auto timer = this->profileTerm(i);
       termsConstraintPenalty.emplace_back(terms_[i]->getValue(time, state, termsMultiplier[i], preComp));
     } else {
       termsConstraintPenalty.emplace_back(0.0, vector_t());
@@ -85,11 +86,16 @@ ScalarFunctionQuadraticApproximation StateAugmentedLagrangianCollection::getQuad
 
   // initialize with first active term
   const size_t firstActiveInd = std::distance(terms_.begin(), firstActiveItr);
-  auto penalty = (*firstActiveItr)->getQuadraticApproximation(time, state, termsMultiplier[firstActiveInd], preComp);
+  ScalarFunctionQuadraticApproximation penalty;
+  {
+    const auto timer = this->profileTerm(firstActiveInd);
+    penalty = (*firstActiveItr)->getQuadraticApproximation(time, state, termsMultiplier[firstActiveInd], preComp);
+  }
 
   // accumulate terms
   for (size_t i = firstActiveInd + 1; i < terms_.size(); i++) {
     if (terms_[i]->isActive(time)) {
+      const auto timer = this->profileTerm(i);
       const auto termPenalty = terms_[i]->getQuadraticApproximation(time, state, termsMultiplier[i], preComp);
       penalty.f += termPenalty.f;
       penalty.dfdx += termPenalty.dfdx;
@@ -62,6 +62,7 @@ std::vector<LagrangianMetrics> StateInputAugmentedLagrangianCollection::getValue
   termsConstraintPenalty.reserve(terms_.size());
   for (size_t i = 0; i < terms_.size(); i++) {
     if (terms_[i]->isActive(time)) {
+      const auto timer = this->profileTerm(i);
       termsConstraintPenalty.emplace_back(terms_[i]->getValue(time, state, input, termsMultiplier[i], preComp));
     } else {
       termsConstraintPenalty.emplace_back(0.0, vector_t());
@@ -87,11 +88,16 @@ ScalarFunctionQuadraticApproximation StateInputAugmentedLagrangianCollection::ge
 
   // initialize with first active term
   const size_t firstActiveInd = std::distance(terms_.begin(), firstActiveItr);
-  auto penalty = (*firstActiveItr)->getQuadraticApproximation(time, state, input, termsMultiplier[firstActiveInd], preComp);
+  ScalarFunctionQuadraticApproximation penalty;
+  {
+    const auto timer = this->profileTerm(firstActiveInd);
+    penalty = (*firstActiveItr)->getQuadraticApproximation(time, state, input, termsMultiplier[firstActiveInd], preComp);
+  }
 
   // accumulate terms
   for (size_t i = firstActiveInd + 1; i < terms_.size(); i++) {
     if (terms_[i]->isActive(time)) {
+      const auto timer = this->profileTerm(i);
       penalty += terms_[i]->getQuadraticApproximation(time, state, input, termsMultiplier[i], preComp);
     }
   }
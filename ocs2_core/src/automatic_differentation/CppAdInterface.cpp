@@ -29,10 +29,102 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <ocs2_core/automatic_differentiation/CppAdInterface.h>
 
+#include <algorithm>
+#include <condition_variable>
+#include <iomanip>
+#include <set>
+#include <sstream>
+#include <thread>
+
+#include <boost/algorithm/string/predicate.hpp>
 #include <boost/filesystem.hpp>
 
 namespace ocs2 {
 
+namespace {
+
+/** Limits the number of compilers that run in parallel to the number of cores */
+class CompilationSlots {
+ public:
+  explicit CompilationSlots(size_t numSlots) : numAvailable_(numSlots) {}
+
+  void acquire() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    condition_.wait(lock, [this] { return numAvailable_ > 0; });
+    --numAvailable_;
+  }
+
+  void release() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++numAvailable_;
+    }
+    condition_.notify_one();
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  size_t numAvailable_;
+};
+
+CompilationSlots& getCompilationSlots() {
+  static CompilationSlots compilationSlots(std::max(1U, std::thread::hardware_concurrency()));
+  return compilationSlots;
+}
+
+/** Generates the sources of a model library in the calling thread, such that only the compiler runs in the background */
+class LibrarySourceGenerator : public CppAD::cg::ModelLibraryProcessor<scalar_t> {
+ public:
+  explicit LibrarySourceGenerator(CppAD::cg::ModelLibraryCSourceGen<scalar_t>& libraryCSourceGen)
+      : CppAD::cg::ModelLibraryProcessor<scalar_t>(libraryCSourceGen) {}
+
+  std::vector<std::map<std::string, std::string>> generateSources() {
+    std::vector<std::map<std::string, std::string>> sources;
+    for (const auto& model : this->modelLibraryHelper_->getModels()) {
+      sources.push_back(this->getSources(*model.second));
+    }
+    sources.push_back(this->getLibrarySources());
+    sources.push_back(this->modelLibraryHelper_->getCustomSources());
+    return sources;
+  }
+};
+
+/** Libraries that are loaded in this process. Copies of an interface reload them from disk, so they are never removed as stale. */
+class LoadedLibraries {
+ public:
+  void insert(const std::string& libraryFile) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    libraryFiles_.insert(libraryFile);
+  }
+
+  bool contains(const std::string& libraryFile) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return libraryFiles_.count(libraryFile) > 0;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::set<std::string> libraryFiles_;
+};
+
+LoadedLibraries& getLoadedLibraries() {
+  static LoadedLibraries loadedLibraries;
+  return loadedLibraries;
+}
+
+/** 64-bit FNV-1a hash, stable across platforms and runs */
+uint64_t fnv1aHash(const std::string& data) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (const char c : data) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+}  // unnamed namespace
+
 /******************************************************************************************************/
 /******************************************************************************************************/
 /******************************************************************************************************/
@@ -55,13 +147,27 @@ CppAdInterface::CppAdInterface(ad_function_t adFunction, size_t variableDim, std
     : CppAdInterface([adFunction](const ad_vector_t& x, const ad_vector_t& p, ad_vector_t& y) { adFunction(x, y); }, variableDim, 0,
                      std::move(modelName), std::move(folderName), std::move(compileFlags)){};
 
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+CppAdInterface::~CppAdInterface() {
+  // The background compilation accesses the members
+  if (compiledLibrary_.valid()) {
+    compiledLibrary_.wait();
+  }
+}
+
 /******************************************************************************************************/
 /******************************************************************************************************/
 /******************************************************************************************************/
 CppAdInterface::CppAdInterface(const CppAdInterface& rhs)
     : CppAdInterface(rhs.adFunction_, rhs.variableDim_, rhs.parameterDim_, rhs.modelName_, rhs.folderName_, rhs.compileFlags_) {
-  if (isLibraryAvailable()) {
-    loadModels(false);
+  rhs.waitForModels();
+  if (!rhs.libraryHash_.empty()) {
+    setLibraryHash(rhs.libraryHash_);
+    if (isLibraryAvailable()) {
+      loadModels(false);
+    }
   }
 }
 
@@ -69,65 +175,30 @@ CppAdInterface::CppAdInterface(const CppAdInterface& rhs)
 /******************************************************************************************************/
 /******************************************************************************************************/
 void CppAdInterface::createModels(ApproximationOrder approximationOrder, bool verbose) {
-  createFolderStructure();
-
-  // set and declare independent variables and start tape recording
-  ad_vector_t xp(variableDim_ + parameterDim_);
-  xp.setOnes();  // Ones are better than zero, to prevent devision by zero in taping
-  CppAD::Independent(xp);
-
-  // Split in variables and parameters
-  ad_vector_t x = xp.segment(0, variableDim_);
-  ad_vector_t p = xp.segment(variableDim_, parameterDim_);
-  // dependent variable vector
-  ad_vector_t y;
-  // the model equation
-  adFunction_(x, p, y);
-  rangeDim_ = y.rows();
-  // create f: xp -> y and stop tape recording
-  ad_fun_t fun(xp, y);
-  // Optimize the operation sequence
-  fun.optimize();
-
-  // generates source code
-  CppAD::cg::ModelCSourceGen<scalar_t> sourceGen(fun, modelName_);
-  setApproximationOrder(approximationOrder, sourceGen, fun);
-
-  // Compiler objects, compile to temporary shared library file to avoid interference between processes
-  CppAD::cg::ModelLibraryCSourceGen<scalar_t> libraryCSourceGen(sourceGen);
-  CppAD::cg::GccCompiler<scalar_t> gccCompiler;
-  CppAD::cg::DynamicModelLibraryProcessor<scalar_t> libraryProcessor(libraryCSourceGen, libraryName_ + tmpName_);
-  setCompilerOptions(gccCompiler);
-
-  if (verbose) {
-    std::cerr << "[CppAdInterface] Compiling Shared Library: "
-              << libraryName_ + tmpName_ + CppAD::cg::system::SystemInfo<>::DYNAMIC_LIB_EXTENSION << std::endl;
-  }
-
-  // Compile and store the library
-  dynamicLib_ = libraryProcessor.createDynamicLibrary(gccCompiler);
-  model_ = dynamicLib_->model(modelName_);
-
-  setSparsityNonzeros();
-
-  // Rename generated library after loading
-  if (verbose) {
-    std::cerr << "[CppAdInterface] Renaming " << libraryName_ + tmpName_ + CppAD::cg::system::SystemInfo<>::DYNAMIC_LIB_EXTENSION << " to "
-              << libraryName_ + CppAD::cg::system::SystemInfo<>::DYNAMIC_LIB_EXTENSION << std::endl;
-  }
-  boost::filesystem::rename(libraryName_ + tmpName_ + CppAD::cg::system::SystemInfo<>::DYNAMIC_LIB_EXTENSION,
-                            libraryName_ + CppAD::cg::system::SystemInfo<>::DYNAMIC_LIB_EXTENSION);
+  ad_fun_t fun;
+  tapeFunction(fun);
+  setLibraryHash(getOperationSequenceHash(fun));
+  compileModels(fun, approximationOrder, verbose);
 }
 
 /******************************************************************************************************/
 /******************************************************************************************************/
 /******************************************************************************************************/
 void CppAdInterface::loadModels(bool verbose) {
+  discardPendingCompilation();
+  if (libraryHash_.empty()) {
+    ad_fun_t fun;
+    tapeFunction(fun);
+    setLibraryHash(getOperationSequenceHash(fun));
+  }
+
   if (verbose) {
     std::cerr << "[CppAdInterface] Loading Shared Library: " << libraryName_ + CppAD::cg::system::SystemInfo<>::DYNAMIC_LIB_EXTENSION
               << std::endl;
   }
-  dynamicLib_.reset(new CppAD::cg::LinuxDynamicLib<scalar_t>(libraryName_ + CppAD::cg::system::SystemInfo<>::DYNAMIC_LIB_EXTENSION));
+  const std::string libraryFile = libraryName_ + CppAD::cg::system::SystemInfo<>::DYNAMIC_LIB_EXTENSION;
+  dynamicLib_.reset(new CppAD::cg::LinuxDynamicLib<scalar_t>(libraryFile));
+  getLoadedLibraries().insert(boost::filesystem::absolute(libraryFile).string());
   model_ = dynamicLib_->model(modelName_);
   rangeDim_ = model_->Range();
 
@@ -138,17 +209,61 @@ void CppAdInterface::loadModels(bool verbose) {
 /******************************************************************************************************/
 /******************************************************************************************************/
 void CppAdInterface::loadModelsIfAvailable(ApproximationOrder approximationOrder, bool verbose) {
+  ad_fun_t fun;
+  tapeFunction(fun);
+  setLibraryHash(getOperationSequenceHash(fun));
+
   if (isLibraryAvailable()) {
     loadModels(verbose);
-  } else {
-    createModels(approximationOrder, verbose);
+    if (isApproximationOrderAvailable(approximationOrder)) {
+      return;
+    }
+  }
+  compileModels(fun, approximationOrder, verbose);
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void CppAdInterface::waitForModels() const {
+  std::lock_guard<std::mutex> lock(compilationMutex_);
+  if (compilationError_ != nullptr) {
+    std::rethrow_exception(compilationError_);
+  }
+  if (isCompilationPending_.load(std::memory_order_acquire)) {
+    try {
+      dynamicLib_ = compiledLibrary_.get();
+      model_ = dynamicLib_->model(modelName_);
+      setSparsityNonzeros();
+    } catch (...) {
+      // Keep the flag set, such that the lock-free path of ensureModelsLoaded() rethrows the error on every access
+      compilationError_ = std::current_exception();
+      throw;
+    }
+    // Publish the models only after they are assigned
+    isCompilationPending_.store(false, std::memory_order_release);
+  }
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void CppAdInterface::discardPendingCompilation() {
+  std::lock_guard<std::mutex> lock(compilationMutex_);
+  if (compiledLibrary_.valid()) {
+    compiledLibrary_.wait();
+    compiledLibrary_ = {};
   }
+  compilationError_ = nullptr;
+  isCompilationPending_.store(false, std::memory_order_release);
 }
 
 /******************************************************************************************************/
 /******************************************************************************************************/
 /******************************************************************************************************/
 vector_t CppAdInterface::getFunctionValue(const vector_t& x, const vector_t& p) const {
+  ensureModelsLoaded();
+
   vector_t xp(variableDim_ + parameterDim_);
   xp << x, p;
 
@@ -163,6 +278,8 @@ vector_t CppAdInterface::getFunctionValue(const vector_t& x, const vector_t& p)
 /******************************************************************************************************/
 /******************************************************************************************************/
 matrix_t CppAdInterface::getJacobian(const vector_t& x, const vector_t& p) const {
+  ensureModelsLoaded();
+
   // Concatenate input
   vector_t xp(variableDim_ + parameterDim_);
   xp << x, p;
@@ -190,6 +307,8 @@ matrix_t CppAdInterface::getJacobian(const vector_t& x, const vector_t& p) const
 /******************************************************************************************************/
 /******************************************************************************************************/
 ScalarFunctionQuadraticApproximation CppAdInterface::getGaussNewtonApproximation(const vector_t& x, const vector_t& p) const {
+  ensureModelsLoaded();
+
   // Concatenate input
   vector_t xp(variableDim_ + parameterDim_);
   xp << x, p;
@@ -209,34 +328,9 @@ ScalarFunctionQuadraticApproximation CppAdInterface::getGaussNewtonApproximation
   size_t const* cols;
   model_->SparseJacobian(xpArrayView, sparseJacobianArrayView, &rows, &cols);
 
-  // Sparse evaluation of J' * f
-  gnApprox.dfdx.setZero(variableDim_);
-  for (size_t i = 0; i < nnzJacobian_; i++) {
-    gnApprox.dfdx(cols[i]) += sparseJacobian[i] * valueVector(rows[i]);
-  }
-
-  /*
-   * Sparse construction of the GN matrix, H = J' * J.
-   * H(i, j) = sum_rows { J(row, i) * J(row, j) }
-   * Because the sparse elements are ordered first by row, then by column, we process J row-by-row.
-   * For each row of J, we add the non-zero pairs (i, j) to H(i, j).
-   */
-  gnApprox.dfdxx.setZero(variableDim_, variableDim_);
-  for (size_t i = 0; i < nnzJacobian_; ++i) {
-    const size_t row_i = rows[i];
-    const size_t col_i = cols[i];
-    const scalar_t v_i = sparseJacobian[i];
-    // Diagonal element always exists:
-    gnApprox.dfdxx(col_i, col_i) += v_i * v_i;
-    // Process off-diagonals
-    size_t j = i + 1;
-    while (rows[j] == row_i) {
-      const size_t col_j = cols[j];
-      gnApprox.dfdxx(col_j, col_i) += v_i * sparseJacobian[j];
-      gnApprox.dfdxx(col_i, col_j) = gnApprox.dfdxx(col_j, col_i);  // Maintain symmetry as we go.
-      ++j;
-    }
-  }
+  gnApprox.dfdx.resize(variableDim_);
+  gnApprox.dfdxx.resize(variableDim_, variableDim_);
+  fillGaussNewtonApproximation(valueVector, sparseJacobian, rows, cols, gnApprox);
 
   assert(gnApprox.dfdx.allFinite());
   assert(gnApprox.dfdxx.allFinite());
@@ -257,6 +351,8 @@ matrix_t CppAdInterface::getHessian(size_t outputIndex, const vector_t& x, const
 /******************************************************************************************************/
 /******************************************************************************************************/
 matrix_t CppAdInterface::getHessian(const vector_t& w, const vector_t& x, const vector_t& p) const {
+  ensureModelsLoaded();
+
   // Concatenate input
   vector_t xp(variableDim_ + parameterDim_);
   xp << x, p;
@@ -285,6 +381,94 @@ matrix_t CppAdInterface::getHessian(const vector_t& w, const vector_t& x, const
   return hessian;
 }
 
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void CppAdInterface::getFunctionValues(const matrix_t& X, const matrix_t& P, matrix_t& values) const {
+  const size_t numPoints = checkBatchSize(X, P);
+  if (values.rows() != rangeDim_ || values.cols() != numPoints) {
+    values.resize(rangeDim_, numPoints);
+  }
+
+  vector_t xp(variableDim_ + parameterDim_);
+  for (size_t k = 0; k < numPoints; k++) {
+    xp.head(variableDim_) = X.col(k);
+    if (k == 0 || P.cols() > 1) {
+      xp.tail(parameterDim_) = P.col(k);
+    }
+    model_->ForwardZero(CppAD::cg::ArrayView<const scalar_t>(xp.data(), xp.size()),
+                        CppAD::cg::ArrayView<scalar_t>(values.col(k).data(), rangeDim_));
+  }
+  assert(values.allFinite());
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void CppAdInterface::getJacobians(const matrix_t& X, const matrix_t& P, std::vector<matrix_t>& jacobians) const {
+  const size_t numPoints = checkBatchSize(X, P);
+  jacobians.resize(numPoints);
+
+  vector_t xp(variableDim_ + parameterDim_);
+  std::vector<scalar_t> sparseJacobian(nnzJacobian_);
+  size_t const* rows;
+  size_t const* cols;
+  for (size_t k = 0; k < numPoints; k++) {
+    xp.head(variableDim_) = X.col(k);
+    if (k == 0 || P.cols() > 1) {
+      xp.tail(parameterDim_) = P.col(k);
+    }
+    model_->SparseJacobian(CppAD::cg::ArrayView<const scalar_t>(xp.data(), xp.size()), CppAD::cg::ArrayView<scalar_t>(sparseJacobian),
+                           &rows, &cols);
+
+    auto& jacobian = jacobians[k];
+    if (jacobian.rows() != rangeDim_ || jacobian.cols() != variableDim_) {
+      jacobian.resize(rangeDim_, variableDim_);
+    }
+    jacobian.setZero();
+    for (size_t i = 0; i < nnzJacobian_; i++) {
+      jacobian(rows[i], cols[i]) = sparseJacobian[i];
+    }
+    assert(jacobian.allFinite());
+  }
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void CppAdInterface::getGaussNewtonApproximations(const matrix_t& X, const matrix_t& P,
+                                                  std::vector<ScalarFunctionQuadraticApproximation>& approximations) const {
+  const size_t numPoints = checkBatchSize(X, P);
+  approximations.resize(numPoints);
+
+  vector_t xp(variableDim_ + parameterDim_);
+  vector_t valueVector(rangeDim_);
+  std::vector<scalar_t> sparseJacobian(nnzJacobian_);
+  size_t const* rows;
+  size_t const* cols;
+  for (size_t k = 0; k < numPoints; k++) {
+    xp.head(variableDim_) = X.col(k);
+    if (k == 0 || P.cols() > 1) {
+      xp.tail(parameterDim_) = P.col(k);
+    }
+    const CppAD::cg::ArrayView<const scalar_t> xpArrayView(xp.data(), xp.size());
+    model_->ForwardZero(xpArrayView, CppAD::cg::ArrayView<scalar_t>(valueVector.data(), valueVector.size()));
+    model_->SparseJacobian(xpArrayView, CppAD::cg::ArrayView<scalar_t>(sparseJacobian), &rows, &cols);
+
+    auto& gnApprox = approximations[k];
+    gnApprox.f = 0.5 * valueVector.squaredNorm();
+    if (gnApprox.dfdx.size() != variableDim_) {
+      gnApprox.dfdx.resize(variableDim_);
+    }
+    if (gnApprox.dfdxx.rows() != variableDim_ || gnApprox.dfdxx.cols() != variableDim_) {
+      gnApprox.dfdxx.resize(variableDim_, variableDim_);
+    }
+    fillGaussNewtonApproximation(valueVector, sparseJacobian, rows, cols, gnApprox);
+    assert(gnApprox.dfdx.allFinite());
+    assert(gnApprox.dfdxx.allFinite());
+  }
+}
+
 /******************************************************************************************************/
 /******************************************************************************************************/
 /******************************************************************************************************/
@@ -296,7 +480,132 @@ void CppAdInterface::setFolderNames() {
   }
   tmpName_ = getUniqueTemporaryName();
   tmpFolder_ = libraryFolder_ + "/" + tmpName_;
-  libraryName_ = libraryFolder_ + "/" + modelName_ + "_lib";
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void CppAdInterface::setLibraryHash(const std::string& hash) {
+  libraryHash_ = hash;
+  libraryName_ = libraryFolder_ + "/" + modelName_ + "_lib_" + libraryHash_;
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void CppAdInterface::tapeFunction(ad_fun_t& fun) {
+  // set and declare independent variables and start tape recording
+  ad_vector_t xp(variableDim_ + parameterDim_);
+  xp.setOnes();  // Ones are better than zero, to prevent devision by zero in taping
+  CppAD::Independent(xp);
+
+  // Split in variables and parameters
+  ad_vector_t x = xp.segment(0, variableDim_);
+  ad_vector_t p = xp.segment(variableDim_, parameterDim_);
+  // dependent variable vector
+  ad_vector_t y;
+  // the model equation
+  adFunction_(x, p, y);
+  rangeDim_ = y.rows();
+  // create f: xp -> y and stop tape recording
+  fun.Dependent(xp, y);
+  // Optimize the operation sequence
+  fun.optimize();
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+std::string CppAdInterface::getOperationSequenceHash(ad_fun_t& fun) const {
+  // Zero order source of the optimized operation sequence
+  CppAD::cg::CodeHandler<scalar_t> handler;
+  CppAD::vector<ad_base_t> xp(fun.Domain());
+  handler.makeVariables(xp);
+  CppAD::vector<ad_base_t> y = fun.Forward(0, xp);
+  CppAD::cg::LanguageC<scalar_t> language("double");
+  CppAD::cg::LangCDefaultVariableNameGenerator<scalar_t> nameGenerator;
+  std::ostringstream key;
+  handler.generateCode(key, language, y, nameGenerator);
+  fun.capacity_order(0);
+
+  // The split between variables and parameters and the compile flags change the library as well
+  key << variableDim_ << ' ' << parameterDim_;
+  for (const auto& flag : compileFlags_) {
+    key << ' ' << flag;
+  }
+
+  std::ostringstream hash;
+  hash << std::hex << std::setw(16) << std::setfill('0') << fnv1aHash(key.str());
+  return hash.str();
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void CppAdInterface::compileModels(ad_fun_t& fun, ApproximationOrder approximationOrder, bool verbose) {
+  discardPendingCompilation();  // A previous compilation of this interface writes to the same folder
+  createFolderStructure();
+
+  // Release the loaded library, dlopen would otherwise return its handle for the reused temporary file name
+  model_.reset();
+  dynamicLib_.reset();
+
+  // generates source code, CppAD is not thread-safe such that this can not be moved to the background
+  CppAD::cg::ModelCSourceGen<scalar_t> sourceGen(fun, modelName_);
+  setApproximationOrder(approximationOrder, sourceGen, fun);
+  CppAD::cg::ModelLibraryCSourceGen<scalar_t> libraryCSourceGen(sourceGen);
+  auto sources = LibrarySourceGenerator(libraryCSourceGen).generateSources();
+
+  // Compile to temporary shared library file to avoid interference between processes, and rename it after loading.
+  const std::string libraryFile = libraryName_ + CppAD::cg::system::SystemInfo<>::DYNAMIC_LIB_EXTENSION;
+  const std::string tmpLibraryFile = libraryName_ + tmpName_ + CppAD::cg::system::SystemInfo<>::DYNAMIC_LIB_EXTENSION;
+  auto compile = [this, sources = std::move(sources), libraryFile, tmpLibraryFile, verbose]() {
+    getCompilationSlots().acquire();
+    try {
+      if (verbose) {
+        std::cerr << "[CppAdInterface] Compiling Shared Library: " + tmpLibraryFile + "\n";
+      }
+      CppAD::cg::GccCompiler<scalar_t> gccCompiler;
+      setCompilerOptions(gccCompiler);
+      for (const auto& s : sources) {
+        gccCompiler.compileSources(s, true);
+      }
+      gccCompiler.buildDynamic(tmpLibraryFile);
+      gccCompiler.cleanup();
+
+      std::unique_ptr<CppAD::cg::DynamicLib<scalar_t>> dynamicLib(new CppAD::cg::LinuxDynamicLib<scalar_t>(tmpLibraryFile));
+      if (verbose) {
+        std::cerr << "[CppAdInterface] Renaming " + tmpLibraryFile + " to " + libraryFile + "\n";
+      }
+      boost::filesystem::rename(tmpLibraryFile, libraryFile);
+      getLoadedLibraries().insert(boost::filesystem::absolute(libraryFile).string());
+      removeStaleLibraries();
+      getCompilationSlots().release();
+      return dynamicLib;
+    } catch (...) {
+      getCompilationSlots().release();
+      throw;
+    }
+  };
+
+  std::lock_guard<std::mutex> lock(compilationMutex_);
+  compiledLibrary_ = std::async(std::launch::async, std::move(compile));
+  isCompilationPending_.store(true, std::memory_order_release);
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+bool CppAdInterface::isApproximationOrderAvailable(ApproximationOrder approximationOrder) const {
+  ensureModelsLoaded();
+  switch (approximationOrder) {
+    case ApproximationOrder::Second:
+      return model_->isSparseHessianAvailable() && model_->isSparseJacobianAvailable();
+    case ApproximationOrder::First:
+      return model_->isSparseJacobianAvailable();
+    default:
+      return true;
+  }
 }
 
 /******************************************************************************************************/
@@ -306,6 +615,30 @@ bool CppAdInterface::isLibraryAvailable() const {
   return boost::filesystem::exists(libraryName_ + CppAD::cg::system::SystemInfo<>::DYNAMIC_LIB_EXTENSION);
 }
 
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void CppAdInterface::removeStaleLibraries() const {
+  // Only libraries named <modelName>_lib_<hash>, the temporary files of compilations in other processes have a longer name
+  const std::string libraryPrefix = modelName_ + "_lib_";
+  const std::string libraryExtension = CppAD::cg::system::SystemInfo<>::DYNAMIC_LIB_EXTENSION;
+  const std::string currentLibrary = boost::filesystem::path(libraryName_ + libraryExtension).filename().string();
+
+  boost::system::error_code errorCode;
+  for (boost::filesystem::directory_iterator it(libraryFolder_, errorCode), end; !errorCode && it != end; it.increment(errorCode)) {
+    const std::string fileName = it->path().filename().string();
+    const bool isLibraryOfModel = fileName.size() == libraryPrefix.size() + libraryHash_.size() + libraryExtension.size() &&
+                                  boost::algorithm::starts_with(fileName, libraryPrefix) &&
+                                  boost::algorithm::ends_with(fileName, libraryExtension);
+    const bool isLoaded = fileName == currentLibrary || getLoadedLibraries().contains(boost::filesystem::absolute(it->path()).string());
+    if (isLibraryOfModel && !isLoaded) {
+      // Processes that have loaded the library keep their mapping, failures are not an error
+      boost::system::error_code removeErrorCode;
+      boost::filesystem::remove(it->path(), removeErrorCode);
+    }
+  }
+}
+
 /******************************************************************************************************/
 /******************************************************************************************************/
 /******************************************************************************************************/
@@ -366,7 +699,20 @@ void CppAdInterface::setApproximationOrder(ApproximationOrder approximationOrder
 /******************************************************************************************************/
 /******************************************************************************************************/
 /******************************************************************************************************/
-void CppAdInterface::setSparsityNonzeros() {
+cppad_sparsity::SparsityPattern CppAdInterface::getJacobianSparsityPattern() const {
+  ensureModelsLoaded();
+
+  if (model_->isJacobianSparsityAvailable()) {
+    return model_->JacobianSparsitySet();
+  } else {
+    return cppad_sparsity::getJacobianVariableSparsity(rangeDim_, variableDim_);
+  }
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void CppAdInterface::setSparsityNonzeros() const {
   if (model_->isJacobianSparsityAvailable()) {
     nnzJacobian_ = cppad_sparsity::getNumberOfNonZeros(model_->JacobianSparsitySet());
   }
@@ -393,4 +739,53 @@ cppad_sparsity::SparsityPattern CppAdInterface::createHessianSparsity(ad_fun_t&
   return cppad_sparsity::getIntersection(trueSparsity, variableSparsity);
 }
 
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+size_t CppAdInterface::checkBatchSize(const matrix_t& X, const matrix_t& P) const {
+  ensureModelsLoaded();
+  if (X.rows() != variableDim_) {
+    throw std::runtime_error("[CppAdInterface] The points have " + std::to_string(X.rows()) + " rows, expected " +
+                             std::to_string(variableDim_));
+  }
+  if (P.rows() != parameterDim_ || (P.cols() != 1 && P.cols() != X.cols())) {
+    throw std::runtime_error("[CppAdInterface] The parameters must be of size " + std::to_string(parameterDim_) + " x 1 or " +
+                             std::to_string(parameterDim_) + " x " + std::to_string(X.cols()));
+  }
+  return X.cols();
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void CppAdInterface::fillGaussNewtonApproximation(const vector_t& value, const std::vector<scalar_t>& sparseJacobian, size_t const* rows,
+                                                  size_t const* cols, ScalarFunctionQuadraticApproximation& gnApprox) const {
+  // Sparse evaluation of J' * f
+  gnApprox.dfdx.setZero();
+  for (size_t i = 0; i < nnzJacobian_; i++) {
+    gnApprox.dfdx(cols[i]) += sparseJacobian[i] * value(rows[i]);
+  }
+
+  /*
+   * Sparse construction of the GN matrix, H = J' * J.
+   * H(i, j) = sum_rows { J(row, i) * J(row, j) }
+   * Because the sparse elements are ordered first by row, then by column, we process J row-by-row.
+   * For each row of J, we add the non-zero pairs (i, j) to H(i, j).
+   */
+  gnApprox.dfdxx.setZero();
+  for (size_t i = 0; i < nnzJacobian_; ++i) {
+    const size_t row_i = rows[i];
+    const size_t col_i = cols[i];
+    const scalar_t v_i = sparseJacobian[i];
+    // Diagonal element always exists:
+    gnApprox.dfdxx(col_i, col_i) += v_i * v_i;
+    // Process off-diagonals
+    for (size_t j = i + 1; j < nnzJacobian_ && rows[j] == row_i; ++j) {
+      const size_t col_j = cols[j];
+      gnApprox.dfdxx(col_j, col_i) += v_i * sparseJacobian[j];
+      gnApprox.dfdxx(col_i, col_j) = gnApprox.dfdxx(col_j, col_i);  // Maintain symmetry as we go.
+    }
+  }
+}
+
 }  // namespace ocs2
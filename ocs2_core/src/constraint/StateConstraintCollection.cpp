@@ -76,6 +76,7 @@ vector_array_t StateConstraintCollection::getValue(scalar_t time, const vector_t
   vector_array_t constraintValues(this->terms_.size());
   for (size_t i = 0; i < this->terms_.size(); ++i) {
     if (this->terms_[i]->isActive(time)) {
+      const auto timer = this->profileTerm(i);
       constraintValues[i] = this->terms_[i]->getValue(time, state, preComp);
     }
   }  // end of i loop
@@ -91,8 +92,10 @@ VectorFunctionLinearApproximation StateConstraintCollection::getLinearApproximat
 
   // append linearApproximation of each constraintTerm
   size_t i = 0;
-  for (const auto& constraintTerm : this->terms_) {
+  for (size_t termIndex = 0; termIndex < this->terms_.size(); ++termIndex) {
+    const auto& constraintTerm = this->terms_[termIndex];
     if (constraintTerm->isActive(time)) {
+      const auto timer = this->profileTerm(termIndex);
       const auto constraintTermApproximation = constraintTerm->getLinearApproximation(time, state, preComp);
       const size_t nc = constraintTermApproximation.f.rows();
       linearApproximation.f.segment(i, nc) = constraintTermApproximation.f;
@@ -118,8 +121,10 @@ VectorFunctionQuadraticApproximation StateConstraintCollection::getQuadraticAppr
 
   // append quadraticApproximation of each constraintTerm
   size_t i = 0;
-  for (const auto& constraintTerm : this->terms_) {
+  for (size_t termIndex = 0; termIndex < this->terms_.size(); ++termIndex) {
+    const auto& constraintTerm = this->terms_[termIndex];
     if (constraintTerm->isActive(time)) {
+      const auto timer = this->profileTerm(termIndex);
       auto constraintTermApproximation = constraintTerm->getQuadraticApproximation(time, state, preComp);
       const size_t nc = constraintTermApproximation.f.rows();
       quadraticApproximation.f.segment(i, nc) = constraintTermApproximation.f;
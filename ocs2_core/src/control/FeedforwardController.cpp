@@ -87,7 +87,16 @@ void FeedforwardController::setController(const scalar_array_t& controllerTime,
 /******************************************************************************************************/
 /******************************************************************************************************/
 vector_t FeedforwardController::computeInput(scalar_t t, const vector_t& x) {
-  return LinearInterpolation::interpolate(t, timeStamp_, uffArray_);
+  vector_t u;
+  computeInputRealTime(t, x, u, timeIndexHint_);
+  return u;
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void FeedforwardController::computeInputRealTime(scalar_t t, const vector_t& x, vector_t& u, int& timeIndexHint) {
+  LinearInterpolation::interpolateInto(LinearInterpolation::timeSegment(t, timeStamp_, timeIndexHint), uffArray_, u);
 }
 
 /******************************************************************************************************/
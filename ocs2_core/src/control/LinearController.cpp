@@ -77,13 +77,21 @@ void LinearController::setController(const scalar_array_t& controllerTime, const
 /******************************************************************************************************/
 /******************************************************************************************************/
 vector_t LinearController::computeInput(scalar_t t, const vector_t& x) {
-  const auto indexAlpha = LinearInterpolation::timeSegment(t, timeStamp_);
+  vector_t u;
+  computeInputRealTime(t, x, u, timeIndexHint_);
+  return u;
+}
 
-  vector_t uff = LinearInterpolation::interpolate(indexAlpha, biasArray_);
-  const matrix_t k = LinearInterpolation::interpolate(indexAlpha, gainArray_);
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void LinearController::computeInputRealTime(scalar_t t, const vector_t& x, vector_t& u, int& timeIndexHint) {
+  const auto indexAlpha = LinearInterpolation::timeSegment(t, timeStamp_, timeIndexHint);
 
-  uff.noalias() += k * x;
-  return uff;
+  // the gain is interpolated into a member buffer, which only allocates on the first call or when the dimensions change
+  LinearInterpolation::interpolateInto(indexAlpha, biasArray_, u);
+  LinearInterpolation::interpolateInto(indexAlpha, gainArray_, gainBuffer_);
+  u.noalias() += gainBuffer_ * x;
 }
 
 /******************************************************************************************************/
@@ -47,42 +47,55 @@ void StateBasedLinearController::setController(ControllerBase* ctrlPtr) {
 /******************************************************************************************************/
 vector_t StateBasedLinearController::computeTrajectorySpreadingInput(scalar_t t, const vector_t& x, const scalar_array_t& ctrlEventTimes,
                                                                      ControllerBase* ctrlPtr) {
+  return ctrlPtr->computeInput(getTrajectorySpreadingTime(t, x, ctrlEventTimes), x);
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+vector_t StateBasedLinearController::computeInput(scalar_t t, const vector_t& x) {
+  return computeTrajectorySpreadingInput(t, x, ctrlEventTimes_, ctrlPtr_);
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void StateBasedLinearController::computeInputRealTime(scalar_t t, const vector_t& x, vector_t& u, int& timeIndexHint) {
+  ctrlPtr_->computeInputRealTime(getTrajectorySpreadingTime(t, x, ctrlEventTimes_), x, u, timeIndexHint);
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+scalar_t StateBasedLinearController::getTrajectorySpreadingTime(scalar_t t, const vector_t& x, const scalar_array_t& ctrlEventTimes) {
   size_t currentMode = static_cast<size_t>(x.tail(1).value());
   size_t numEvents = ctrlEventTimes.size();
 
   if (numEvents == 0)  // Simple case in which the controller does not contain any events
   {
-    return ctrlPtr->computeInput(t, x);
+    return t;
   }
 
   scalar_t tauMinus = (numEvents > currentMode) ? ctrlEventTimes[currentMode] : ctrlEventTimes.back();
   scalar_t tau = (numEvents > currentMode + 1) ? ctrlEventTimes[currentMode + 1] : ctrlEventTimes.back();
-  scalar_t tauPlus = (numEvents > currentMode + 2) ? ctrlEventTimes[currentMode + 2] : ctrlEventTimes.back();
 
   bool pastAllEvents = (currentMode >= numEvents - 1) && (t > tauMinus);
   const scalar_t eps = numeric_traits::weakEpsilon<scalar_t>();
 
   if (pastAllEvents) {
-    return ctrlPtr->computeInput(t, x);
+    return t;
     // return normal input signal
   } else if (t < tauMinus) {
     // if event happened before the event time for which the controller was designed
-    return ctrlPtr->computeInput(tauMinus + 2.0 * eps, x);
+    return tauMinus + 2.0 * eps;
     // request input 1 epsilon after the designed event time
   } else if (t > tau) {
     // if event has not happened yet at the event time for which the controller was designed
-    return ctrlPtr->computeInput(tau - eps, x);
+    return tau - eps;
     // request input 1 epsilon before the designed event time
   }
   // normal case: t > tauMinus && t < tau
-  return ctrlPtr->computeInput(t, x);
-}
-
-/******************************************************************************************************/
-/******************************************************************************************************/
-/******************************************************************************************************/
-vector_t StateBasedLinearController::computeInput(scalar_t t, const vector_t& x) {
-  return computeTrajectorySpreadingInput(t, x, ctrlEventTimes_, ctrlPtr_);
+  return t;
 }
 
 /******************************************************************************************************/
@@ -51,9 +51,10 @@ scalar_t StateCostCollection::getValue(scalar_t time, const vector_t& state, con
   scalar_t cost = 0.0;
 
   // accumulate cost terms
-  for (const auto& costTerm : this->terms_) {
-    if (costTerm->isActive(time)) {
-      cost += costTerm->getValue(time, state, targetTrajectories, preComp);
+  for (size_t i = 0; i < this->terms_.size(); ++i) {
+    if (this->terms_[i]->isActive(time)) {
+      const auto timer = this->profileTerm(i);
+      cost += this->terms_[i]->getValue(time, state, targetTrajectories, preComp);
     }
   }
 
@@ -75,15 +76,21 @@ ScalarFunctionQuadraticApproximation StateCostCollection::getQuadraticApproximat
   }
 
   // Initialize with first active term, accumulate potentially other active terms.
-  auto cost = (*firstActive)->getQuadraticApproximation(time, state, targetTrajectories, preComp);
-  std::for_each(std::next(firstActive), terms_.end(), [&](const std::unique_ptr<StateCost>& costTerm) {
-    if (costTerm->isActive(time)) {
-      const auto costTermApproximation = costTerm->getQuadraticApproximation(time, state, targetTrajectories, preComp);
+  const size_t firstActiveIndex = std::distance(terms_.begin(), firstActive);
+  ScalarFunctionQuadraticApproximation cost;
+  {
+    const auto timer = this->profileTerm(firstActiveIndex);
+    cost = (*firstActive)->getQuadraticApproximation(time, state, targetTrajectories, preComp);
+  }
+  for (size_t i = firstActiveIndex + 1; i < terms_.size(); ++i) {
+    if (terms_[i]->isActive(time)) {
+      const auto timer = this->profileTerm(i);
+      const auto costTermApproximation = terms_[i]->getQuadraticApproximation(time, state, targetTrajectories, preComp);
       cost.f += costTermApproximation.f;
       cost.dfdx += costTermApproximation.dfdx;
       cost.dfdxx += costTermApproximation.dfdxx;
     }
-  });
+  }
 
   // Make sure that input derivatives are empty
   cost.dfdu = vector_t();
@@ -51,9 +51,10 @@ scalar_t StateInputCostCollection::getValue(scalar_t time, const vector_t& state
   scalar_t cost = 0.0;
 
   // accumulate cost terms
-  for (const auto& costTerm : this->terms_) {
-    if (costTerm->isActive(time)) {
-      cost += costTerm->getValue(time, state, input, targetTrajectories, preComp);
+  for (size_t i = 0; i < this->terms_.size(); ++i) {
+    if (this->terms_[i]->isActive(time)) {
+      const auto timer = this->profileTerm(i);
+      cost += this->terms_[i]->getValue(time, state, input, targetTrajectories, preComp);
     }
   }
 
@@ -76,12 +77,18 @@ ScalarFunctionQuadraticApproximation StateInputCostCollection::getQuadraticAppro
   }
 
   // Initialize with first active term, accumulate potentially other active terms.
-  auto cost = (*firstActive)->getQuadraticApproximation(time, state, input, targetTrajectories, preComp);
-  std::for_each(std::next(firstActive), terms_.end(), [&](const std::unique_ptr<StateInputCost>& costTerm) {
-    if (costTerm->isActive(time)) {
-      cost += costTerm->getQuadraticApproximation(time, state, input, targetTrajectories, preComp);
+  const size_t firstActiveIndex = std::distance(terms_.begin(), firstActive);
+  ScalarFunctionQuadraticApproximation cost;
+  {
+    const auto timer = this->profileTerm(firstActiveIndex);
+    cost = (*firstActive)->getQuadraticApproximation(time, state, input, targetTrajectories, preComp);
+  }
+  for (size_t i = firstActiveIndex + 1; i < terms_.size(); ++i) {
+    if (terms_[i]->isActive(time)) {
+      const auto timer = this->profileTerm(i);
+      cost += terms_[i]->getQuadraticApproximation(time, state, input, targetTrajectories, preComp);
     }
-  });
+  }
 
   return cost;
 }
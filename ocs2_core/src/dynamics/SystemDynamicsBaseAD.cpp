@@ -174,6 +174,19 @@ vector_t SystemDynamicsBaseAD::flowMapDerivativeTime(scalar_t t, const vector_t&
   return flowJacobian_.leftCols(1);
 }
 
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+bool SystemDynamicsBaseAD::getFlowMapSparsity(BlockSparsity& dfdxSparsity, BlockSparsity& dfduSparsity) const {
+  // Variables are taped as [t, x, u]
+  const int stateDim = tapedTimeState_.size() - 1;
+  const int inputDim = tapedTimeStateInput_.size() - 1 - stateDim;
+  const auto sparsityPattern = flowMapADInterfacePtr_->getJacobianSparsityPattern();
+  dfdxSparsity = BlockSparsity::fromSparsityPattern(sparsityPattern, stateDim, stateDim, 1);
+  dfduSparsity = BlockSparsity::fromSparsityPattern(sparsityPattern, stateDim, inputDim, 1 + stateDim);
+  return true;
+}
+
 /******************************************************************************************************/
 /******************************************************************************************************/
 /******************************************************************************************************/
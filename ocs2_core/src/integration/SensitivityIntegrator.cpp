@@ -29,6 +29,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "ocs2_core/integration/SensitivityIntegrator.h"
 
+#include <cmath>
 #include <unordered_map>
 
 #include <ocs2_core/integration/SensitivityIntegratorImpl.h>
@@ -51,6 +52,26 @@ DynamicsDiscretizer selectDynamicsDiscretization(SensitivityIntegratorType integ
   }
 }
 
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+DynamicsDiscretizer selectDynamicsDiscretization(SensitivityIntegratorType integratorType, scalar_t maxStepSize) {
+  if (maxStepSize <= 0.0) {
+    return selectDynamicsDiscretization(integratorType);
+  }
+
+  return [discretizer = selectDynamicsDiscretization(integratorType), maxStepSize](SystemDynamicsBase& system, scalar_t t,
+                                                                                    const vector_t& x, const vector_t& u, scalar_t dt) {
+    const int numSteps = std::max(static_cast<int>(std::ceil(dt / maxStepSize)), 1);
+    const scalar_t h = dt / numSteps;
+    vector_t xNext = discretizer(system, t, x, u, h);
+    for (int i = 1; i < numSteps; ++i) {
+      xNext = discretizer(system, t + i * h, xNext, u, h);
+    }
+    return xNext;
+  };
+}
+
 /******************************************************************************************************/
 /******************************************************************************************************/
 /******************************************************************************************************/
@@ -67,6 +88,60 @@ DynamicsSensitivityDiscretizer selectDynamicsSensitivityDiscretization(Sensitivi
   }
 }
 
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+DynamicsSensitivityDiscretizer selectDynamicsSensitivityDiscretization(SensitivityIntegratorType integratorType, scalar_t maxStepSize) {
+  if (maxStepSize <= 0.0) {
+    return selectDynamicsSensitivityDiscretization(integratorType);
+  }
+
+  return [discretizer = selectDynamicsSensitivityDiscretization(integratorType), maxStepSize](
+             SystemDynamicsBase& system, scalar_t t, const vector_t& x, const vector_t& u, scalar_t dt) {
+    const int numSteps = std::max(static_cast<int>(std::ceil(dt / maxStepSize)), 1);
+    const scalar_t h = dt / numSteps;
+    VectorFunctionLinearApproximation result = discretizer(system, t, x, u, h);
+    for (int i = 1; i < numSteps; ++i) {
+      // Chain rule: x_{i+1} = A_i * x_i + B_i * u
+      const auto step = discretizer(system, t + i * h, result.f, u, h);
+      result.dfdx = step.dfdx * result.dfdx;
+      result.dfdu = step.dfdx * result.dfdu + step.dfdu;
+      result.f = step.f;
+    }
+    return result;
+  };
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void getDynamicsSensitivityDiscretizationSparsity(SensitivityIntegratorType integratorType, const BlockSparsity& dfdxSparsity,
+                                                  const BlockSparsity& dfduSparsity, BlockSparsity& ASparsity, BlockSparsity& BSparsity) {
+  int numStages;
+  switch (integratorType) {
+    case SensitivityIntegratorType::EULER:
+      numStages = 1;
+      break;
+    case SensitivityIntegratorType::RK2:
+      numStages = 2;
+      break;
+    case SensitivityIntegratorType::RK4:
+      numStages = 4;
+      break;
+    default:
+      throw std::runtime_error("Integrator of type " + sensitivity_integrator::toString(integratorType) + " not supported.");
+  }
+
+  // Each stage propagates the sensitivities through (Id + dt * dfdx): A = (Id + dfdx)^s, B = (Id + dfdx)^(s-1) * dfdu
+  const BlockSparsity stageSparsity = BlockSparsity::Identity(dfdxSparsity.rows()) + dfdxSparsity;
+  ASparsity = stageSparsity;
+  BSparsity = dfduSparsity;
+  for (int i = 1; i < numStages; ++i) {
+    ASparsity = stageSparsity * ASparsity;
+    BSparsity = stageSparsity * BSparsity;
+  }
+}
+
 namespace sensitivity_integrator {
 
 /******************************************************************************************************/
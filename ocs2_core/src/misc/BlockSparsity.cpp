@@ -0,0 +1,287 @@
+/******************************************************************************
+Copyright (c) 2020, Farbod Farshidian. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#include "ocs2_core/misc/BlockSparsity.h"
+
+#include <algorithm>
+#include <iostream>
+
+namespace ocs2 {
+
+namespace {
+// Column gaps up to this size are absorbed into a block
+constexpr int kMaxColumnGap = 4;
+// Rows are stacked into the same band as long as at most a fifth of the covered area is structurally zero ...
+constexpr int kMaxFillNumerator = 5;
+constexpr int kMaxFillDenominator = 4;
+// ... or the band stays this small anyway
+constexpr int kSmallBandArea = 16;
+
+using interval_t = std::pair<int, int>;  // [begin, end)
+
+/** Contiguous column runs of a row, merging runs that are separated by small gaps */
+std::vector<interval_t> getColumnRuns(const BlockSparsity::pattern_t& pattern, int row) {
+  std::vector<interval_t> runs;
+  for (int j = 0; j < pattern.cols(); ++j) {
+    if (pattern(row, j)) {
+      if (!runs.empty() && j - runs.back().second <= kMaxColumnGap) {
+        runs.back().second = j + 1;
+      } else {
+        runs.emplace_back(j, j + 1);
+      }
+    }
+  }
+  return runs;
+}
+
+/** Union of two sorted interval lists, merging intervals that are separated by small gaps */
+std::vector<interval_t> getUnion(const std::vector<interval_t>& lhs, const std::vector<interval_t>& rhs) {
+  std::vector<interval_t> all;
+  all.reserve(lhs.size() + rhs.size());
+  std::merge(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::back_inserter(all));
+  std::vector<interval_t> result;
+  for (const auto& interval : all) {
+    if (!result.empty() && interval.first - result.back().second <= kMaxColumnGap) {
+      result.back().second = std::max(result.back().second, interval.second);
+    } else {
+      result.push_back(interval);
+    }
+  }
+  return result;
+}
+
+int getLength(const std::vector<interval_t>& intervals) {
+  int length = 0;
+  for (const auto& interval : intervals) {
+    length += interval.second - interval.first;
+  }
+  return length;
+}
+}  // namespace
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+BlockSparsity::BlockSparsity(pattern_t pattern) : pattern_(std::move(pattern)) {
+  updateBlocks();
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+BlockSparsity BlockSparsity::Zero(int rows, int cols) {
+  return BlockSparsity(pattern_t::Constant(rows, cols, false));
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+BlockSparsity BlockSparsity::Dense(int rows, int cols) {
+  return BlockSparsity(pattern_t::Constant(rows, cols, true));
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+BlockSparsity BlockSparsity::Identity(int size) {
+  pattern_t pattern = pattern_t::Constant(size, size, false);
+  pattern.matrix().diagonal().setConstant(true);
+  return BlockSparsity(std::move(pattern));
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+BlockSparsity BlockSparsity::fromMatrix(const matrix_t& matrix) {
+  return BlockSparsity(matrix.array() != 0.0);
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+BlockSparsity BlockSparsity::fromSparsityPattern(const std::vector<std::set<size_t>>& sparsityPattern, int rows, int cols, int colOffset) {
+  if (sparsityPattern.size() != static_cast<size_t>(rows)) {
+    throw std::runtime_error("[BlockSparsity] The sparsity pattern has " + std::to_string(sparsityPattern.size()) + " rows instead of " +
+                             std::to_string(rows));
+  }
+  pattern_t pattern = pattern_t::Constant(rows, cols, false);
+  for (int i = 0; i < rows; ++i) {
+    for (const auto j : sparsityPattern[i]) {
+      const int col = static_cast<int>(j) - colOffset;
+      if (0 <= col && col < cols) {
+        pattern(i, col) = true;
+      }
+    }
+  }
+  return BlockSparsity(std::move(pattern));
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+scalar_t BlockSparsity::density() const {
+  if (pattern_.size() == 0) {
+    return 1.0;
+  }
+  int coveredArea = 0;
+  for (const auto& block : blocks_) {
+    coveredArea += block.rows * block.cols;
+  }
+  return static_cast<scalar_t>(coveredArea) / static_cast<scalar_t>(pattern_.size());
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+BlockSparsity BlockSparsity::transpose() const {
+  return BlockSparsity(pattern_.transpose());
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+BlockSparsity BlockSparsity::operator+(const BlockSparsity& rhs) const {
+  if (rows() != rhs.rows() || cols() != rhs.cols()) {
+    throw std::runtime_error("[BlockSparsity] Cannot add sparsities of different size.");
+  }
+  return BlockSparsity(pattern_ || rhs.pattern_);
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+BlockSparsity BlockSparsity::operator*(const BlockSparsity& rhs) const {
+  if (cols() != rhs.rows()) {
+    throw std::runtime_error("[BlockSparsity] Cannot multiply sparsities of incompatible size.");
+  }
+  pattern_t result = pattern_t::Constant(rows(), rhs.cols(), false);
+  for (int k = 0; k < cols(); ++k) {
+    for (int i = 0; i < rows(); ++i) {
+      if (pattern_(i, k)) {
+        result.row(i) = result.row(i) || rhs.pattern_.row(k);
+      }
+    }
+  }
+  return BlockSparsity(std::move(result));
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+bool BlockSparsity::operator==(const BlockSparsity& rhs) const {
+  return rows() == rhs.rows() && cols() == rhs.cols() && (pattern_ == rhs.pattern_).all();
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void BlockSparsity::updateBlocks() {
+  blocks_.clear();
+
+  // Greedily stack rows into bands. Each band is covered by one block per column interval.
+  int bandStart = 0;
+  int bandNonZeros = 0;
+  std::vector<interval_t> bandIntervals;
+  auto closeBand = [&](int bandEnd) {
+    for (const auto& interval : bandIntervals) {
+      blocks_.push_back({bandStart, interval.first, bandEnd - bandStart, interval.second - interval.first});
+    }
+  };
+
+  for (int i = 0; i < rows(); ++i) {
+    const auto rowRuns = getColumnRuns(pattern_, i);
+    const int rowNonZeros = pattern_.row(i).count();
+    if (rowRuns.empty()) {  // An empty row ends the band
+      closeBand(i);
+      bandIntervals.clear();
+      bandStart = i + 1;
+      bandNonZeros = 0;
+      continue;
+    }
+
+    auto mergedIntervals = getUnion(bandIntervals, rowRuns);
+    const int mergedArea = (i + 1 - bandStart) * getLength(mergedIntervals);
+    const bool acceptMerge = bandIntervals.empty() || mergedArea <= kSmallBandArea ||
+                             kMaxFillDenominator * mergedArea <= kMaxFillNumerator * (bandNonZeros + rowNonZeros);
+    if (acceptMerge) {
+      bandIntervals = std::move(mergedIntervals);
+      bandNonZeros += rowNonZeros;
+    } else {
+      closeBand(i);
+      bandStart = i;
+      bandIntervals = rowRuns;
+      bandNonZeros = rowNonZeros;
+    }
+  }
+  closeBand(rows());
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+std::ostream& operator<<(std::ostream& out, const BlockSparsity& sparsity) {
+  out << "BlockSparsity " << sparsity.rows() << "x" << sparsity.cols() << " with " << sparsity.blocks().size()
+      << " blocks, density: " << sparsity.density() << "\n";
+  for (const auto& block : sparsity.blocks()) {
+    out << "  [" << block.row << ", " << block.col << "] " << block.rows << "x" << block.cols << "\n";
+  }
+  return out;
+}
+
+namespace block_sparse {
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void addProduct(const BlockSparsity& sparsityA, const matrix_t& A, const matrix_t& B, matrix_t& out) {
+  for (const auto& b : sparsityA.blocks()) {
+    out.middleRows(b.row, b.rows).noalias() += A.block(b.row, b.col, b.rows, b.cols) * B.middleRows(b.col, b.cols);
+  }
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void addTransposeProduct(const BlockSparsity& sparsityA, const matrix_t& A, const matrix_t& B, matrix_t& out) {
+  for (const auto& b : sparsityA.blocks()) {
+    out.middleRows(b.col, b.cols).noalias() += A.block(b.row, b.col, b.rows, b.cols).transpose() * B.middleRows(b.row, b.rows);
+  }
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void addRightProduct(const matrix_t& B, const BlockSparsity& sparsityA, const matrix_t& A, matrix_t& out) {
+  for (const auto& b : sparsityA.blocks()) {
+    out.middleCols(b.col, b.cols).noalias() += B.middleCols(b.row, b.rows) * A.block(b.row, b.col, b.rows, b.cols);
+  }
+}
+
+}  // namespace block_sparse
+}  // namespace ocs2
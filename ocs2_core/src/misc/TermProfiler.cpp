@@ -0,0 +1,123 @@
+/******************************************************************************
+Copyright (c) 2020, Farbod Farshidian. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#include "ocs2_core/misc/TermProfiler.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace ocs2 {
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+TermProfiler::Statistics& TermProfiler::getStatistics(const std::string& name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& statisticsPtr = statistics_[name];
+  if (statisticsPtr == nullptr) {
+    statisticsPtr.reset(new Statistics);
+  }
+  return *statisticsPtr;
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void TermProfiler::addSample(Statistics& statistics, int64_t duration) {
+  statistics.numCalls.fetch_add(1, std::memory_order_relaxed);
+  statistics.totalTime.fetch_add(duration, std::memory_order_relaxed);
+  auto maxTime = statistics.maxTime.load(std::memory_order_relaxed);
+  while (duration > maxTime && !statistics.maxTime.compare_exchange_weak(maxTime, duration, std::memory_order_relaxed)) {
+  }
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void TermProfiler::reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& nameStatistics : statistics_) {
+    nameStatistics.second->numCalls = 0;
+    nameStatistics.second->totalTime = 0;
+    nameStatistics.second->maxTime = 0;
+  }
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+std::vector<TermProfiler::Entry> TermProfiler::getEntries() const {
+  std::vector<Entry> entries;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries.reserve(statistics_.size());
+    for (const auto& nameStatistics : statistics_) {
+      const auto& statistics = *nameStatistics.second;
+      const auto numCalls = statistics.numCalls.load(std::memory_order_relaxed);
+      if (numCalls > 0) {
+        const scalar_t totalTime = statistics.totalTime.load(std::memory_order_relaxed);
+        const scalar_t maxTime = statistics.maxTime.load(std::memory_order_relaxed);
+        entries.push_back({nameStatistics.first, numCalls, 1e-6 * totalTime, 1e-3 * totalTime / numCalls, 1e-3 * maxTime});
+      }
+    }
+  }
+
+  std::sort(entries.begin(), entries.end(), [](const Entry& lhs, const Entry& rhs) {
+    return (lhs.totalInMilliseconds != rhs.totalInMilliseconds) ? lhs.totalInMilliseconds > rhs.totalInMilliseconds
+                                                                : lhs.name < rhs.name;
+  });
+  return entries;
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+std::string TermProfiler::getReport() const {
+  const auto entries = getEntries();
+  size_t nameWidth = 4;
+  for (const auto& entry : entries) {
+    nameWidth = std::max(nameWidth, entry.name.size());
+  }
+
+  std::stringstream infoStream;
+  infoStream << std::fixed << std::setprecision(3);
+  infoStream << "\n########################################################################\n";
+  infoStream << "Term profiling:\n";
+  infoStream << '\t' << std::left << std::setw(nameWidth) << "Term" << std::right << std::setw(12) << "Calls" << std::setw(14)
+             << "Total [ms]" << std::setw(14) << "Avg [us]" << std::setw(14) << "Max [us]" << '\n';
+  for (const auto& entry : entries) {
+    infoStream << '\t' << std::left << std::setw(nameWidth) << entry.name << std::right << std::setw(12) << entry.numCalls << std::setw(14)
+               << entry.totalInMilliseconds << std::setw(14) << entry.averageInMicroseconds << std::setw(14) << entry.maxInMicroseconds
+               << '\n';
+  }
+  return infoStream.str();
+}
+
+}  // namespace ocs2
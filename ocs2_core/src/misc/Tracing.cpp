@@ -0,0 +1,314 @@
+/******************************************************************************
+Copyright (c) 2020, Farbod Farshidian. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#include "ocs2_core/misc/Tracing.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+namespace ocs2 {
+namespace tracing {
+
+namespace {
+
+/**
+ * Slot of the ring buffer. The fields are relaxed atomics, such that the exporter can copy a slot while the recording thread
+ * overwrites it. Torn copies are detected with ThreadBuffer::reserveCount and dropped.
+ */
+struct EventSlot {
+  std::atomic<const char*> category{nullptr};
+  std::atomic<const char*> name{nullptr};
+  std::atomic<int64_t> beginTime{0};
+  std::atomic<int64_t> duration{0};
+  std::atomic<int64_t> index{-1};
+};
+
+/**
+ * Single producer ring buffer of a thread. Only the owning thread writes the events and advances the counts:
+ *  - reserveCount is advanced before a slot is overwritten (followed by a release fence),
+ *  - writeCount is advanced with release semantics after the slot is written, which publishes the event to the exporter.
+ */
+struct ThreadBuffer {
+  explicit ThreadBuffer(size_t id) : threadId(id), threadName("thread_" + std::to_string(id)) {}
+
+  const size_t threadId;
+  std::string threadName;  // guarded by the registry mutex
+  bool hasExited = false;  // guarded by the registry mutex
+  std::array<EventSlot, ringBufferCapacity> events;
+  std::atomic<uint64_t> reserveCount{0};
+  std::atomic<uint64_t> writeCount{0};
+  std::atomic<uint64_t> clearCount{0};
+};
+
+struct Registry {
+  std::mutex mutex;
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+  size_t numRegisteredThreads = 0;
+};
+
+/** Never destroyed, such that threads can record until the end of the program. */
+Registry& getRegistry() {
+  static auto* registry = new Registry;
+  return *registry;
+}
+
+std::atomic_bool enabled{true};
+
+/**
+ * Registers the ring buffer of a thread on its first event. When the thread exits, its buffer is released right away if it holds no
+ * events, otherwise the events are kept for the export until the next clear().
+ */
+class ThreadBufferHandle {
+ public:
+  ThreadBuffer& get() {
+    if (bufferPtr_ == nullptr) {
+      auto& registry = getRegistry();
+      std::lock_guard<std::mutex> lock(registry.mutex);
+      registry.buffers.push_back(std::make_shared<ThreadBuffer>(registry.numRegisteredThreads++));
+      bufferPtr_ = registry.buffers.back().get();
+    }
+    return *bufferPtr_;
+  }
+
+  ~ThreadBufferHandle() {
+    if (bufferPtr_ != nullptr) {
+      auto& registry = getRegistry();
+      std::lock_guard<std::mutex> lock(registry.mutex);
+      bufferPtr_->hasExited = true;
+      if (bufferPtr_->writeCount.load(std::memory_order_relaxed) == bufferPtr_->clearCount.load(std::memory_order_relaxed)) {
+        auto& buffers = registry.buffers;
+        buffers.erase(std::remove_if(buffers.begin(), buffers.end(), [this](const auto& ptr) { return ptr.get() == bufferPtr_; }),
+                      buffers.end());
+      }
+    }
+  }
+
+ private:
+  ThreadBuffer* bufferPtr_ = nullptr;
+};
+
+ThreadBuffer& getThreadBuffer() {
+  thread_local ThreadBufferHandle handle;
+  return handle.get();
+}
+
+void writeJsonString(std::ostream& stream, const std::string& string) {
+  stream << '"';
+  for (const char c : string) {
+    switch (c) {
+      case '"':
+        stream << "\\\"";
+        break;
+      case '\\':
+        stream << "\\\\";
+        break;
+      case '\n':
+        stream << "\\n";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          stream << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec << std::setfill(' ');
+        } else {
+          stream << c;
+        }
+    }
+  }
+  stream << '"';
+}
+
+}  // unnamed namespace
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+int64_t now() {
+  static const auto epoch = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void recordEvent(const char* category, const char* name, int64_t beginTime, int64_t endTime, int64_t index) {
+  if (!isEnabled()) {
+    return;
+  }
+  auto& buffer = getThreadBuffer();
+  const auto count = buffer.writeCount.load(std::memory_order_relaxed);
+  // announce that the slot of event (count - capacity) is overwritten before touching it
+  buffer.reserveCount.store(count + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  auto& slot = buffer.events[count % ringBufferCapacity];
+  slot.category.store(category, std::memory_order_relaxed);
+  slot.name.store(name, std::memory_order_relaxed);
+  slot.beginTime.store(beginTime, std::memory_order_relaxed);
+  slot.duration.store(endTime - beginTime, std::memory_order_relaxed);
+  slot.index.store(index, std::memory_order_relaxed);
+
+  // publish the event
+  buffer.writeCount.store(count + 1, std::memory_order_release);
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void setThreadName(const std::string& name) {
+  auto& buffer = getThreadBuffer();
+  std::lock_guard<std::mutex> lock(getRegistry().mutex);
+  buffer.threadName = name;
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void setEnabled(bool enable) {
+  enabled.store(enable, std::memory_order_relaxed);
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+bool isEnabled() {
+  return enabled.load(std::memory_order_relaxed);
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void clear() {
+  auto& registry = getRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+
+  // release the buffers of the exited threads
+  auto& buffers = registry.buffers;
+  buffers.erase(std::remove_if(buffers.begin(), buffers.end(), [](const auto& ptr) { return ptr->hasExited; }), buffers.end());
+
+  for (auto& bufferPtr : buffers) {
+    bufferPtr->clearCount.store(bufferPtr->writeCount.load(std::memory_order_acquire), std::memory_order_relaxed);
+  }
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+std::vector<ThreadTrace> collect() {
+  auto& registry = getRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+
+  std::vector<ThreadTrace> traces;
+  traces.reserve(registry.buffers.size());
+  for (const auto& bufferPtr : registry.buffers) {
+    const auto clearCount = bufferPtr->clearCount.load(std::memory_order_relaxed);
+    const auto endCount = bufferPtr->writeCount.load(std::memory_order_acquire);
+    auto beginCount = std::max(clearCount, endCount > ringBufferCapacity ? endCount - ringBufferCapacity : uint64_t(0));
+
+    std::vector<Event> events;
+    events.reserve(endCount - beginCount);
+    for (auto k = beginCount; k < endCount; ++k) {
+      const auto& slot = bufferPtr->events[k % ringBufferCapacity];
+      events.push_back(Event{slot.category.load(std::memory_order_relaxed), slot.name.load(std::memory_order_relaxed),
+                             slot.beginTime.load(std::memory_order_relaxed), slot.duration.load(std::memory_order_relaxed),
+                             slot.index.load(std::memory_order_relaxed)});
+    }
+
+    // Drop the events which the recording thread might have overwritten while copying. If any copied field was written by an
+    // overwrite, the acquire fence synchronizes with the release fence of recordEvent, such that its reserveCount is visible here.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const auto lastCount = bufferPtr->reserveCount.load(std::memory_order_relaxed);
+    if (lastCount > ringBufferCapacity && lastCount - ringBufferCapacity > beginCount) {
+      const auto numOverwritten = std::min<uint64_t>(lastCount - ringBufferCapacity - beginCount, events.size());
+      events.erase(events.begin(), events.begin() + numOverwritten);
+      beginCount += numOverwritten;
+    }
+
+    traces.push_back({bufferPtr->threadId, bufferPtr->threadName, std::move(events), static_cast<size_t>(beginCount - clearCount)});
+  }
+  return traces;
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void writeChromeTrace(std::ostream& stream) {
+  const auto traces = collect();
+
+  const auto flags = stream.flags();
+  stream << std::fixed << std::setprecision(3);
+  stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  bool firstEvent = true;
+  auto separator = [&]() -> std::ostream& {
+    stream << (firstEvent ? "\n" : ",\n");
+    firstEvent = false;
+    return stream;
+  };
+
+  for (const auto& trace : traces) {
+    const auto tid = trace.threadId + 1;
+    separator() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid << ",\"args\":{\"name\":";
+    writeJsonString(stream, trace.threadName);
+    stream << "}}";
+
+    for (const auto& event : trace.events) {
+      separator() << "{\"name\":";
+      writeJsonString(stream, event.name);
+      stream << ",\"cat\":";
+      writeJsonString(stream, event.category);
+      // Chrome trace timestamps are in microseconds
+      stream << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid << ",\"ts\":" << 1e-3 * event.beginTime << ",\"dur\":" << 1e-3 * event.duration;
+      if (event.index >= 0) {
+        stream << ",\"args\":{\"index\":" << event.index << "}";
+      }
+      stream << "}";
+    }
+  }
+  stream << "\n]}\n";
+  stream.flags(flags);
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void exportChromeTrace(const std::string& fileName) {
+  std::ofstream file(fileName);
+  if (!file.is_open()) {
+    throw std::runtime_error("[tracing::exportChromeTrace] Could not open file: " + fileName);
+  }
+  writeChromeTrace(file);
+}
+
+}  // namespace tracing
+}  // namespace ocs2
@@ -27,15 +27,77 @@ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 ******************************************************************************/
 
+#include <ocs2_core/misc/Tracing.h>
 #include <ocs2_core/thread_support/SetThreadPriority.h>
+#include <ocs2_core/thread_support/SpinBarrier.h>
 #include <ocs2_core/thread_support/ThreadPool.h>
 
+#include <algorithm>
+#include <cstdint>
+
 namespace ocs2 {
 
+namespace {
+
+/**
+ * Lock-free deque of loop indices [front, back). The owner pops chunks from the front, while other threads steal from the back.
+ * Both ends are packed into a single 64-bit word such that every operation is a single compare-and-swap. The entries are padded to a
+ * cache line to avoid false sharing between the deques of different threads.
+ */
+class RangeDeque {
+ public:
+  /** Sets the range. Only called by the owner, while the deque is empty. */
+  void reset(uint32_t front, uint32_t back) { range_.store(pack(front, back), std::memory_order_release); }
+
+  /** Pops a chunk of (at most) grainSize indices from the front. */
+  bool pop(uint32_t grainSize, uint32_t& chunkBegin, uint32_t& chunkEnd) {
+    uint64_t range = range_.load(std::memory_order_acquire);
+    while (true) {
+      const uint32_t front = range >> 32;
+      const uint32_t back = range & 0xFFFFFFFF;
+      if (front >= back) {
+        return false;
+      }
+      const uint32_t chunkSize = std::min(back - front, grainSize);
+      if (range_.compare_exchange_weak(range, pack(front + chunkSize, back), std::memory_order_acq_rel, std::memory_order_acquire)) {
+        chunkBegin = front;
+        chunkEnd = front + chunkSize;
+        return true;
+      }
+    }
+  }
+
+  /** Steals half of the remaining indices (but at least grainSize) from the back. */
+  bool steal(uint32_t grainSize, uint32_t& chunkBegin, uint32_t& chunkEnd) {
+    uint64_t range = range_.load(std::memory_order_acquire);
+    while (true) {
+      const uint32_t front = range >> 32;
+      const uint32_t back = range & 0xFFFFFFFF;
+      if (front >= back) {
+        return false;
+      }
+      const uint32_t chunkSize = std::min(back - front, std::max(grainSize, (back - front + 1) / 2));
+      if (range_.compare_exchange_weak(range, pack(front, back - chunkSize), std::memory_order_acq_rel, std::memory_order_acquire)) {
+        chunkBegin = back - chunkSize;
+        chunkEnd = back;
+        return true;
+      }
+    }
+  }
+
+ private:
+  static uint64_t pack(uint32_t front, uint32_t back) { return (static_cast<uint64_t>(front) << 32) | back; }
+
+  std::atomic<uint64_t> range_{0};
+  char padding_[64 - sizeof(std::atomic<uint64_t>)];
+};
+
+}  // unnamed namespace
+
 /**************************************************************************************************/
 /**************************************************************************************************/
 /**************************************************************************************************/
-ThreadPool::ThreadPool(size_t nThreads, int priority) {
+ThreadPool::ThreadPool(size_t nThreads, int priority, size_t spinCount) : spinCount_(spinCount) {
   workerThreads_.reserve(nThreads);
   for (size_t i = 0; i < nThreads; i++) {
     workerThreads_.emplace_back(&ThreadPool::worker, this, i);
@@ -63,7 +125,14 @@ ThreadPool::~ThreadPool() {
 /**************************************************************************************************/
 /**************************************************************************************************/
 void ThreadPool::worker(int workerIndex) {
+  OCS2_TRACE_THREAD_NAME("ocs2_worker_" + std::to_string(workerIndex));
+
   while (true) {
+    // poll for new tasks before going to sleep
+    for (size_t i = 0; i < spinCount_ && numQueuedTasks_.load(std::memory_order_acquire) == 0; ++i) {
+      cpuRelax();
+    }
+
     std::unique_ptr<ThreadPool::TaskBase> taskPtr;
     {
       std::unique_lock<std::mutex> lock(taskQueueLock_);
@@ -78,6 +147,7 @@ void ThreadPool::worker(int workerIndex) {
       if (!taskQueue_.empty()) {
         taskPtr = std::move(taskQueue_.front());
         taskQueue_.pop();
+        --numQueuedTasks_;
       }
     }
 
@@ -94,6 +164,7 @@ void ThreadPool::runTask(std::unique_ptr<TaskBase> taskPtr) {
   {
     std::lock_guard<std::mutex> lock(taskQueueLock_);
     taskQueue_.push(std::move(taskPtr));
+    ++numQueuedTasks_;
   }
   taskQueueCondition_.notify_one();
 }
@@ -122,4 +193,73 @@ void ThreadPool::runParallel(std::function<void(int)> taskFunction, int N) {
   }
 }
 
+/**************************************************************************************************/
+/**************************************************************************************************/
+/**************************************************************************************************/
+void ThreadPool::parallelFor(int begin, int end, int grainSize, std::function<void(int, int)> taskFunction) {
+  if (end <= begin) {
+    return;
+  }
+
+  const auto numParticipants = static_cast<uint32_t>(numThreads()) + 1;
+  const auto numIndices = static_cast<uint32_t>(end - begin);
+  const uint32_t grain = (grainSize > 0) ? static_cast<uint32_t>(grainSize) : std::max(1U, numIndices / (8 * numParticipants));
+
+  // Initial static partitioning of the range over the participants
+  std::vector<RangeDeque> deques(numParticipants);
+  for (uint32_t k = 0; k < numParticipants; ++k) {
+    deques[k].reset(k * numIndices / numParticipants, (k + 1) * numIndices / numParticipants);
+  }
+
+  auto participate = [&](int workerIndex, uint32_t ownDeque) {
+    uint32_t chunkBegin, chunkEnd;
+    while (true) {
+      while (deques[ownDeque].pop(grain, chunkBegin, chunkEnd)) {
+        for (uint32_t i = chunkBegin; i < chunkEnd; ++i) {
+          taskFunction(workerIndex, begin + static_cast<int>(i));
+        }
+      }
+
+      // Own deque is exhausted, steal from the others
+      bool stolen = false;
+      for (uint32_t k = 1; k < numParticipants && !stolen; ++k) {
+        stolen = deques[(ownDeque + k) % numParticipants].steal(grain, chunkBegin, chunkEnd);
+      }
+      if (!stolen) {
+        return;
+      }
+      deques[ownDeque].reset(chunkBegin, chunkEnd);
+    }
+  };
+
+  // Launch participants in helper threads
+  std::vector<std::future<void>> futures;
+  futures.reserve(numParticipants - 1);
+  for (uint32_t k = 0; k + 1 < numParticipants; ++k) {
+    futures.emplace_back(run([&participate, k](int workerIndex) { participate(workerIndex, k); }));
+  }
+
+  // Participate in this thread, but wait for the helpers before propagating an exception since they refer to this stack frame.
+  std::exception_ptr exceptionPtr;
+  try {
+    participate(static_cast<int>(numThreads()), numParticipants - 1);
+  } catch (...) {
+    exceptionPtr = std::current_exception();
+  }
+
+  for (auto&& fut : futures) {
+    try {
+      fut.get();
+    } catch (...) {
+      if (!exceptionPtr) {
+        exceptionPtr = std::current_exception();
+      }
+    }
+  }
+
+  if (exceptionPtr) {
+    std::rethrow_exception(exceptionPtr);
+  }
+}
+
 }  // namespace ocs2
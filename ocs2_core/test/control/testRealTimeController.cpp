@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+
+#include <ocs2_core/control/FeedforwardController.h>
+#include <ocs2_core/control/LinearController.h>
+#include <ocs2_core/control/StateBasedLinearController.h>
+#include <ocs2_core/test/MallocHook.h>
+
+using namespace ocs2;
+
+class RealTimeControllerTest : public testing::Test {
+ protected:
+  static constexpr size_t stateDim = 13;
+  static constexpr size_t inputDim = 7;
+  static constexpr size_t numNodes = 50;
+
+  RealTimeControllerTest() {
+    for (size_t k = 0; k < numNodes; k++) {
+      time.push_back(0.01 * k);
+      bias.push_back(vector_t::Random(inputDim));
+      gain.push_back(matrix_t::Random(inputDim, stateDim));
+    }
+    // repeated time of an event
+    time[numNodes / 2] = time[numNodes / 2 - 1];
+
+    // increasing and decreasing query times, outside of the time horizon as well
+    for (scalar_t t = -0.05; t < 0.55; t += 0.0025) {
+      queryTimes.push_back(t);
+    }
+    queryTimes.push_back(time[numNodes / 2]);
+    queryTimes.push_back(0.3);
+    queryTimes.push_back(0.1);
+    queryTimes.push_back(0.42);
+  }
+
+  /** Checks that computeInputRealTime is bit-identical to computeInput, and that it does not allocate after the first call */
+  void testController(ControllerBase& controller) {
+    const vector_t x = vector_t::Random(stateDim);
+    vector_t u(inputDim);
+    int timeIndexHint = 0;
+    for (const auto t : queryTimes) {
+      const vector_t uExpected = controller.computeInput(t, x);
+      const size_t numAllocs = malloc_hook::countAllocations([&]() { controller.computeInputRealTime(t, x, u, timeIndexHint); });
+      EXPECT_EQ(numAllocs, 0) << "at time " << t;
+      EXPECT_TRUE(u == uExpected) << "at time " << t;
+    }
+  }
+
+  scalar_array_t time;
+  vector_array_t bias;
+  matrix_array_t gain;
+  scalar_array_t queryTimes;
+};
+
+constexpr size_t RealTimeControllerTest::stateDim;
+constexpr size_t RealTimeControllerTest::inputDim;
+constexpr size_t RealTimeControllerTest::numNodes;
+
+TEST_F(RealTimeControllerTest, mallocHook) {
+  const size_t numAllocs = malloc_hook::countAllocations([]() {
+    vector_t v(10);
+    v.setZero();
+  });
+  ASSERT_EQ(numAllocs, 1);
+}
+
+TEST_F(RealTimeControllerTest, feedforwardController) {
+  FeedforwardController controller(time, bias);
+  testController(controller);
+}
+
+TEST_F(RealTimeControllerTest, linearController) {
+  LinearController controller(time, bias, gain);
+  testController(controller);
+}
+
+TEST_F(RealTimeControllerTest, stateBasedLinearController) {
+  LinearController linearController(time, bias, gain);
+  StateBasedLinearController controller;
+  controller.setController(&linearController);
+  testController(controller);
+}
@@ -154,6 +154,33 @@ TEST_F(StateInputCost_TestFixture, canClone) {
   EXPECT_NEAR(cost, expectedCost, 1e-6);
 }
 
+TEST_F(StateInputCost_TestFixture, profileTerms) {
+  auto profilerPtr = std::make_shared<ocs2::TermProfiler>();
+  costCollection.setTermProfiler(profilerPtr, "cost");
+  std::unique_ptr<ocs2::StateInputCostCollection> workerCollection(costCollection.clone());
+  costCollection.get<SimpleQuadraticCost>("Another simple quadratic cost").active_ = false;
+
+  costCollection.getValue(t, x, u, targetTrajectories, {});
+  costCollection.getQuadraticApproximation(t, x, u, targetTrajectories, {});
+  workerCollection->getValue(t, x, u, targetTrajectories, {});
+
+  // the statistics of the clone are aggregated with the original
+  const auto entries = profilerPtr->getEntries();
+  ASSERT_EQ(entries.size(), 2);
+  for (const auto& entry : entries) {
+    if (entry.name == "cost/Simple quadratic cost") {
+      EXPECT_EQ(entry.numCalls, 3);
+    } else {
+      EXPECT_EQ(entry.name, "cost/Another simple quadratic cost");
+      EXPECT_EQ(entry.numCalls, 1);
+    }
+  }
+  EXPECT_NE(profilerPtr->getReport().find("cost/Simple quadratic cost"), std::string::npos);
+
+  profilerPtr->reset();
+  EXPECT_TRUE(profilerPtr->getEntries().empty());
+}
+
 class SimpleQuadraticFinalCost final : public ocs2::StateCost {
  public:
   SimpleQuadraticFinalCost(ocs2::matrix_t Q) : Q_(std::move(Q)) {}
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 
+#include <ocs2_core/cost/FixedSizeQuadraticCost.h>
 #include <ocs2_core/cost/QuadraticStateCost.h>
 #include <ocs2_core/cost/QuadraticStateInputCost.h>
 
@@ -102,3 +103,32 @@ TEST_F(testQuadraticCost, StateCostClone) {
   auto Lclone = costFunctionClone->getValue(t_, x_, targetTrajectories_, preComputation_);
   EXPECT_NEAR(L, Lclone, PRECISION);
 }
+
+TEST_F(testQuadraticCost, FixedSizeStateInputCost) {
+  QuadraticStateInputCost costFunction(Q_, R_, P_);
+  FixedSizeQuadraticStateInputCost<2, 1> fixedSizeCostFunction(Q_, R_, P_);
+  auto fixedSizeCostFunctionClone = std::unique_ptr<StateInputCost>(fixedSizeCostFunction.clone());
+
+  const auto L = costFunction.getQuadraticApproximation(t_, x_, u_, targetTrajectories_, preComputation_);
+  const auto Lfixed = fixedSizeCostFunctionClone->getQuadraticApproximation(t_, x_, u_, targetTrajectories_, preComputation_);
+  EXPECT_NEAR(fixedSizeCostFunction.getValue(t_, x_, u_, targetTrajectories_, preComputation_), expectedCost_, PRECISION);
+  EXPECT_NEAR(Lfixed.f, L.f, PRECISION);
+  EXPECT_TRUE(Lfixed.dfdx.isApprox(L.dfdx, PRECISION));
+  EXPECT_TRUE(Lfixed.dfdu.isApprox(L.dfdu, PRECISION));
+  EXPECT_TRUE(Lfixed.dfdxx.isApprox(L.dfdxx, PRECISION));
+  EXPECT_TRUE(Lfixed.dfdux.isApprox(L.dfdux, PRECISION));
+  EXPECT_TRUE(Lfixed.dfduu.isApprox(L.dfduu, PRECISION));
+}
+
+TEST_F(testQuadraticCost, FixedSizeStateCost) {
+  QuadraticStateCost costFunction(Qf_);
+  FixedSizeQuadraticStateCost<2> fixedSizeCostFunction(Qf_);
+  auto fixedSizeCostFunctionClone = std::unique_ptr<StateCost>(fixedSizeCostFunction.clone());
+
+  const auto Phi = costFunction.getQuadraticApproximation(t_, x_, targetTrajectories_, preComputation_);
+  const auto PhiFixed = fixedSizeCostFunctionClone->getQuadraticApproximation(t_, x_, targetTrajectories_, preComputation_);
+  EXPECT_NEAR(fixedSizeCostFunction.getValue(t_, x_, targetTrajectories_, preComputation_), expectedFinalCost_, PRECISION);
+  EXPECT_NEAR(PhiFixed.f, Phi.f, PRECISION);
+  EXPECT_TRUE(PhiFixed.dfdx.isApprox(Phi.dfdx, PRECISION));
+  EXPECT_TRUE(PhiFixed.dfdxx.isApprox(Phi.dfdxx, PRECISION));
+}
@@ -2,6 +2,11 @@
 
 #include <gtest/gtest.h>
 
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <ocs2_core/misc/Benchmark.h>
+
 #include "commonFixture.h"
 
 using namespace ocs2;
@@ -60,3 +65,144 @@ TEST_F(CppAdInterfaceParameterizedFixture, loadIfAvailable) {
   ASSERT_TRUE(gnApproximation.dfdx.isApprox(testJacobian(x, p).transpose() * testFun(x, p)));
   ASSERT_TRUE(gnApproximation.dfdxx.isApprox(testJacobian(x, p).transpose() * testJacobian(x, p)));
 }
+
+TEST_F(CppAdInterfaceParameterizedFixture, batchedEvaluation) {
+  ocs2::CppAdInterface adInterface(funImpl, variableDim_, parameterDim_, "testModelBatched");
+  adInterface.loadModelsIfAvailable(ocs2::CppAdInterface::ApproximationOrder::First, false);
+
+  constexpr size_t numPoints = 5;
+  const matrix_t X = matrix_t::Random(variableDim_, numPoints);
+  const matrix_t P = matrix_t::Random(parameterDim_, numPoints);
+
+  matrix_t values;
+  std::vector<matrix_t> jacobians;
+  std::vector<ScalarFunctionQuadraticApproximation> gnApproximations;
+  adInterface.getFunctionValues(X, P, values);
+  adInterface.getJacobians(X, P, jacobians);
+  adInterface.getGaussNewtonApproximations(X, P, gnApproximations);
+
+  ASSERT_EQ(values.cols(), numPoints);
+  ASSERT_EQ(jacobians.size(), numPoints);
+  ASSERT_EQ(gnApproximations.size(), numPoints);
+  for (size_t k = 0; k < numPoints; k++) {
+    const vector_t x = X.col(k);
+    const vector_t p = P.col(k);
+    ASSERT_TRUE(values.col(k).isApprox(testFun(x, p)));
+    ASSERT_TRUE(jacobians[k].isApprox(testJacobian(x, p)));
+    ASSERT_DOUBLE_EQ(gnApproximations[k].f, 0.5 * testFun(x, p).squaredNorm());
+    ASSERT_TRUE(gnApproximations[k].dfdx.isApprox(testJacobian(x, p).transpose() * testFun(x, p)));
+    ASSERT_TRUE(gnApproximations[k].dfdxx.isApprox(testJacobian(x, p).transpose() * testJacobian(x, p)));
+  }
+
+  // Shared parameters
+  const matrix_t p0 = P.col(0);
+  adInterface.getFunctionValues(X, p0, values);
+  for (size_t k = 0; k < numPoints; k++) {
+    ASSERT_TRUE(values.col(k).isApprox(testFun(X.col(k), p0)));
+  }
+
+  ASSERT_THROW(adInterface.getFunctionValues(X, matrix_t::Random(parameterDim_, 2), values), std::runtime_error);
+}
+
+TEST_F(CppAdInterfaceParameterizedFixture, contentAddressedLibrary) {
+  const std::string modelName = "testModelContentAddressed";
+  ocs2::CppAdInterface adInterface(funImpl, variableDim_, parameterDim_, modelName);
+  adInterface.loadModelsIfAvailable(ocs2::CppAdInterface::ApproximationOrder::First, false);
+
+  // Same model name, but a modified function. The library of the original function must not be loaded.
+  auto scaledFunImpl = [](const ad_vector_t& x, const ad_vector_t& p, ad_vector_t& y) {
+    funImpl(x, p, y);
+    y *= ad_scalar_t(2.0);
+  };
+  ocs2::CppAdInterface modifiedAdInterface(scaledFunImpl, variableDim_, parameterDim_, modelName);
+  modifiedAdInterface.loadModelsIfAvailable(ocs2::CppAdInterface::ApproximationOrder::First, false);
+
+  const vector_t x = vector_t::Random(variableDim_);
+  const vector_t p = vector_t::Random(parameterDim_);
+  ASSERT_TRUE(adInterface.getFunctionValue(x, p).isApprox(testFun(x, p)));
+  ASSERT_TRUE(modifiedAdInterface.getFunctionValue(x, p).isApprox(2.0 * testFun(x, p)));
+
+  // A copy loads the library of its origin
+  const ocs2::CppAdInterface modifiedAdInterfaceCopy(modifiedAdInterface);
+  ASSERT_TRUE(modifiedAdInterfaceCopy.getJacobian(x, p).isApprox(2.0 * testJacobian(x, p)));
+
+  // The second order derivatives are missing in the available library
+  modifiedAdInterface.loadModelsIfAvailable(ocs2::CppAdInterface::ApproximationOrder::Second, false);
+  ASSERT_TRUE(modifiedAdInterface.getHessian(1, x, p).isApprox(2.0 * testHessian(1, x, p)));
+}
+
+TEST_F(CppAdInterfaceParameterizedFixture, startupTime) {
+  constexpr size_t numModels = 8;
+  const std::string folderName = "/tmp/ocs2/testCppAdInterfaceStartup";
+  boost::filesystem::remove_all(folderName);
+
+  auto startup = [&]() {
+    std::vector<std::unique_ptr<ocs2::CppAdInterface>> adInterfaces;
+    for (size_t i = 0; i < numModels; i++) {
+      adInterfaces.emplace_back(new ocs2::CppAdInterface(funImpl, variableDim_, parameterDim_, "model" + std::to_string(i), folderName));
+      adInterfaces.back()->loadModelsIfAvailable(ocs2::CppAdInterface::ApproximationOrder::Second, false);
+    }
+    for (const auto& adInterface : adInterfaces) {
+      adInterface->waitForModels();
+    }
+    return adInterfaces;
+  };
+
+  ocs2::benchmark::RepeatedTimer coldTimer;
+  coldTimer.startTimer();
+  startup();
+  coldTimer.endTimer();
+
+  ocs2::benchmark::RepeatedTimer warmTimer;
+  warmTimer.startTimer();
+  const auto adInterfaces = startup();
+  warmTimer.endTimer();
+
+  const vector_t x = vector_t::Random(variableDim_);
+  const vector_t p = vector_t::Random(parameterDim_);
+  for (const auto& adInterface : adInterfaces) {
+    ASSERT_TRUE(adInterface->getFunctionValue(x, p).isApprox(testFun(x, p)));
+  }
+  std::cerr << "[CppAdInterface] startup of " << numModels << " models, cold: " << coldTimer.getLastIntervalInMilliseconds()
+            << " [ms], warm: " << warmTimer.getLastIntervalInMilliseconds() << " [ms]\n";
+}
+
+TEST_F(CppAdInterfaceParameterizedFixture, staleLibraries) {
+  const std::string modelName = "testModelStaleLibraries";
+  const std::string libraryFolder = "/tmp/ocs2/" + modelName + "/cppad_generated";
+  const std::string staleLibrary = libraryFolder + "/" + modelName + "_lib_0123456789abcdef.so";
+  boost::filesystem::create_directories(libraryFolder);
+  boost::filesystem::ofstream(staleLibrary).close();
+
+  ocs2::CppAdInterface adInterface(funImpl, variableDim_, parameterDim_, modelName);
+  adInterface.createModels(ocs2::CppAdInterface::ApproximationOrder::First, false);
+  adInterface.waitForModels();
+  ASSERT_FALSE(boost::filesystem::exists(staleLibrary));
+
+  // The library of another interface in this process is kept
+  auto scaledFunImpl = [](const ad_vector_t& x, const ad_vector_t& p, ad_vector_t& y) {
+    funImpl(x, p, y);
+    y *= ad_scalar_t(2.0);
+  };
+  ocs2::CppAdInterface modifiedAdInterface(scaledFunImpl, variableDim_, parameterDim_, modelName);
+  modifiedAdInterface.createModels(ocs2::CppAdInterface::ApproximationOrder::First, false);
+  modifiedAdInterface.waitForModels();
+  const ocs2::CppAdInterface adInterfaceCopy(adInterface);
+
+  const vector_t x = vector_t::Random(variableDim_);
+  const vector_t p = vector_t::Random(parameterDim_);
+  ASSERT_TRUE(adInterfaceCopy.getFunctionValue(x, p).isApprox(testFun(x, p)));
+}
+
+TEST_F(CppAdInterfaceParameterizedFixture, compilationError) {
+  ocs2::CppAdInterface adInterface(funImpl, variableDim_, parameterDim_, "testModelCompilationError", "/tmp/ocs2",
+                                   {"-invalid-compile-flag"});
+  adInterface.createModels(ocs2::CppAdInterface::ApproximationOrder::First, false);
+
+  // The error is rethrown on every access
+  const vector_t x = vector_t::Random(variableDim_);
+  const vector_t p = vector_t::Random(parameterDim_);
+  ASSERT_ANY_THROW(adInterface.getFunctionValue(x, p));
+  ASSERT_ANY_THROW(adInterface.getJacobian(x, p));
+  ASSERT_ANY_THROW(adInterface.waitForModels());
+}
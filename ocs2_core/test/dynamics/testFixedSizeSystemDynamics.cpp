@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <memory>
+
+#include <ocs2_core/Types.h>
+#include <ocs2_core/dynamics/FixedSizeSystemDynamics.h>
+#include <ocs2_core/dynamics/LinearSystemDynamics.h>
+#include <ocs2_core/misc/Benchmark.h>
+
+using namespace ocs2;
+
+namespace {
+constexpr int STATE_DIM = 12;
+constexpr int INPUT_DIM = 4;
+using fixed_size_dynamics_t = FixedSizeLinearSystemDynamics<STATE_DIM, INPUT_DIM>;
+}  // unnamed namespace
+
+class FixedSizeSystemDynamicsTest : public testing::Test {
+ protected:
+  FixedSizeSystemDynamicsTest()
+      : A(matrix_t::Random(STATE_DIM, STATE_DIM)),
+        B(matrix_t::Random(STATE_DIM, INPUT_DIM)),
+        G(matrix_t::Random(STATE_DIM, STATE_DIM)),
+        x(vector_t::Random(STATE_DIM)),
+        u(vector_t::Random(INPUT_DIM)),
+        dynamicsPtr(new LinearSystemDynamics(A, B, G)),
+        fixedSizeDynamicsPtr(new fixed_size_dynamics_t(A, B, G)) {}
+
+  const scalar_t t = 0.0;
+  const matrix_t A, B, G;
+  const vector_t x, u;
+  std::unique_ptr<SystemDynamicsBase> dynamicsPtr;
+  std::unique_ptr<SystemDynamicsBase> fixedSizeDynamicsPtr;
+};
+
+TEST_F(FixedSizeSystemDynamicsTest, flowMap) {
+  const vector_t f = dynamicsPtr->computeFlowMap(t, x, u);
+  const vector_t fFixed = fixedSizeDynamicsPtr->computeFlowMap(t, x, u);
+  EXPECT_TRUE(fFixed.isApprox(f));
+
+  const auto approximation = dynamicsPtr->linearApproximation(t, x, u);
+  const auto fixedSizeApproximation = fixedSizeDynamicsPtr->linearApproximation(t, x, u);
+  EXPECT_TRUE(fixedSizeApproximation.f.isApprox(approximation.f));
+  EXPECT_TRUE(fixedSizeApproximation.dfdx.isApprox(approximation.dfdx));
+  EXPECT_TRUE(fixedSizeApproximation.dfdu.isApprox(approximation.dfdu));
+}
+
+TEST_F(FixedSizeSystemDynamicsTest, jumpMap) {
+  std::unique_ptr<SystemDynamicsBase> clonePtr(fixedSizeDynamicsPtr->clone());
+  EXPECT_TRUE(clonePtr->computeJumpMap(t, x).isApprox(dynamicsPtr->computeJumpMap(t, x)));
+
+  const auto approximation = dynamicsPtr->jumpMapLinearApproximation(t, x);
+  const auto fixedSizeApproximation = clonePtr->jumpMapLinearApproximation(t, x);
+  EXPECT_TRUE(fixedSizeApproximation.f.isApprox(approximation.f));
+  EXPECT_TRUE(fixedSizeApproximation.dfdx.isApprox(approximation.dfdx));
+  EXPECT_EQ(fixedSizeApproximation.dfdu.rows(), STATE_DIM);
+  EXPECT_EQ(fixedSizeApproximation.dfdu.cols(), 0);
+}
+
+TEST_F(FixedSizeSystemDynamicsTest, benchmark) {
+  constexpr size_t numEvaluations = 100000;
+  const PreComputation preComp;
+
+  // linear approximation through the dynamic-size interface, as called by the solvers
+  auto timeLinearApproximation = [&](SystemDynamicsBase& dynamics, matrix_t& dfdxSum) {
+    benchmark::RepeatedTimer timer;
+    dfdxSum.setZero(STATE_DIM, STATE_DIM);
+    timer.startTimer();
+    for (size_t i = 0; i < numEvaluations; i++) {
+      dfdxSum += 1e-6 * dynamics.linearApproximation(t, x, u, preComp).dfdx;
+    }
+    timer.endTimer();
+    return timer.getTotalInMilliseconds();
+  };
+  matrix_t dfdxSum, fixedSizeDfdxSum;
+  const auto dynamicSizeInterfaceTime = timeLinearApproximation(*dynamicsPtr, dfdxSum);
+  const auto fixedSizeInterfaceTime = timeLinearApproximation(*fixedSizeDynamicsPtr, fixedSizeDfdxSum);
+  EXPECT_TRUE(fixedSizeDfdxSum.isApprox(dfdxSum));
+
+  // the fixed-size kernel alone
+  auto& fixedSizeDynamics = static_cast<fixed_size_dynamics_t&>(*fixedSizeDynamicsPtr);
+  const fixed_size_dynamics_t::state_vector_t xFixed = x;
+  const fixed_size_dynamics_t::input_vector_t uFixed = u;
+  fixed_size_dynamics_t::state_vector_t f;
+  fixed_size_dynamics_t::state_matrix_t A;
+  fixed_size_dynamics_t::state_input_matrix_t B;
+  fixed_size_dynamics_t::state_matrix_t kernelDfdxSum = fixed_size_dynamics_t::state_matrix_t::Zero();
+  benchmark::RepeatedTimer kernelTimer;
+  kernelTimer.startTimer();
+  for (size_t i = 0; i < numEvaluations; i++) {
+    fixedSizeDynamics.fixedSizeLinearApproximation(t, xFixed, uFixed, preComp, f, A, B);
+    kernelDfdxSum += 1e-6 * A;
+  }
+  kernelTimer.endTimer();
+  EXPECT_TRUE(kernelDfdxSum.isApprox(dfdxSum));
+
+  std::cerr << "[FixedSizeSystemDynamicsTest] " << numEvaluations << " linear approximations (" << STATE_DIM << " states, " << INPUT_DIM
+            << " inputs)\n  dynamic-size interface: " << dynamicSizeInterfaceTime << " [ms]\n  fixed-size interface:   "
+            << fixedSizeInterfaceTime << " [ms]\n  fixed-size kernel:      " << kernelTimer.getTotalInMilliseconds() << " [ms]\n";
+}
@@ -0,0 +1,80 @@
+/******************************************************************************
+Copyright (c) 2017, Farbod Farshidian. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+
+/**
+ * Malloc hook for tests: replaces malloc, calloc and realloc of the test executable to count the allocations of the current thread.
+ * @note Include this header in exactly one translation unit of a test executable.
+ */
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t num, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+}
+
+namespace ocs2 {
+namespace malloc_hook {
+namespace internal {
+thread_local bool countAllocations = false;
+thread_local size_t numAllocations = 0;
+}  // namespace internal
+
+/** Returns the number of allocations of the current thread during the call of the given function. */
+template <typename Fun>
+size_t countAllocations(Fun&& fun) {
+  internal::numAllocations = 0;
+  internal::countAllocations = true;
+  fun();
+  internal::countAllocations = false;
+  return internal::numAllocations;
+}
+
+}  // namespace malloc_hook
+}  // namespace ocs2
+
+extern "C" {
+void* malloc(size_t size) {
+  ocs2::malloc_hook::internal::numAllocations += ocs2::malloc_hook::internal::countAllocations ? 1 : 0;
+  return __libc_malloc(size);
+}
+
+void* calloc(size_t num, size_t size) {
+  ocs2::malloc_hook::internal::numAllocations += ocs2::malloc_hook::internal::countAllocations ? 1 : 0;
+  return __libc_calloc(num, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+  ocs2::malloc_hook::internal::numAllocations += ocs2::malloc_hook::internal::countAllocations ? 1 : 0;
+  return __libc_realloc(ptr, size);
+}
+}
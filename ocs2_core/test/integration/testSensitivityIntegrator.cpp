@@ -210,3 +210,65 @@ TEST(test_sensitivity_integrator, vsBoostRK4) {
   // Check
   ASSERT_TRUE(rk4ForwardDynamics.isApprox(boostRk4ForwardDynamics));
 }
+
+TEST(test_sensitivity_integrator, sensitivitySparsity) {
+  // Chain of integrators, x0 <- x1 <- x2 <- u, with a decoupled state x3
+  const int nx = 4;
+  ocs2::matrix_t A = ocs2::matrix_t::Zero(nx, nx);
+  A(0, 1) = 1.0;
+  A(1, 2) = 1.0;
+  A(3, 3) = -1.0;
+  ocs2::matrix_t B = ocs2::matrix_t::Zero(nx, 1);
+  B(2, 0) = 1.0;
+  ocs2::LinearSystemDynamics system(A, B);
+
+  const ocs2::vector_t x = ocs2::vector_t::Random(nx);
+  const ocs2::vector_t u = ocs2::vector_t::Random(1);
+  for (const auto type : {ocs2::SensitivityIntegratorType::EULER, ocs2::SensitivityIntegratorType::RK2,
+                          ocs2::SensitivityIntegratorType::RK4}) {
+    ocs2::BlockSparsity ASparsity;
+    ocs2::BlockSparsity BSparsity;
+    ocs2::getDynamicsSensitivityDiscretizationSparsity(type, ocs2::BlockSparsity::fromMatrix(A), ocs2::BlockSparsity::fromMatrix(B),
+                                                       ASparsity, BSparsity);
+    const auto discreteDynamics = ocs2::selectDynamicsSensitivityDiscretization(type)(system, 0.0, x, u, 0.1);
+
+    // All non-zeros of the discretization are part of the structural sparsity
+    ASSERT_TRUE((ASparsity.pattern() || (discreteDynamics.dfdx.array() == 0.0)).all());
+    ASSERT_TRUE((BSparsity.pattern() || (discreteDynamics.dfdu.array() == 0.0)).all());
+
+    // The decoupled state is never affected by the chain
+    ASSERT_FALSE(ASparsity.pattern().row(3).head(3).any());
+    ASSERT_FALSE(BSparsity.pattern()(3, 0));
+  }
+}
+
+TEST(test_sensitivity_integrator, subSteps) {
+  auto type = ocs2::SensitivityIntegratorType::RK2;
+  auto discretization = ocs2::selectDynamicsDiscretization(type);
+  auto sensitivityDiscretization = ocs2::selectDynamicsSensitivityDiscretization(type);
+  auto subStepDiscretization = ocs2::selectDynamicsDiscretization(type, 0.04);
+  auto subStepSensitivityDiscretization = ocs2::selectDynamicsSensitivityDiscretization(type, 0.04);
+
+  auto system = getSystem();
+  ocs2::scalar_t t = 0.5;
+  ocs2::vector_t x = ocs2::vector_t::Random(2);
+  ocs2::vector_t u = ocs2::vector_t::Random(1);
+  ocs2::scalar_t dt = 0.1;
+
+  // Three sub-steps of dt / 3
+  const ocs2::scalar_t h = dt / 3.0;
+  const auto step1 = sensitivityDiscretization(*system, t, x, u, h);
+  const auto step2 = sensitivityDiscretization(*system, t + h, step1.f, u, h);
+  const auto step3 = sensitivityDiscretization(*system, t + 2.0 * h, step2.f, u, h);
+  const ocs2::matrix_t A = step3.dfdx * step2.dfdx * step1.dfdx;
+  const ocs2::matrix_t B = step3.dfdx * (step2.dfdx * step1.dfdu + step2.dfdu) + step3.dfdu;
+
+  ASSERT_TRUE(subStepDiscretization(*system, t, x, u, dt).isApprox(step3.f));
+  const auto linearizedDynamics = subStepSensitivityDiscretization(*system, t, x, u, dt);
+  ASSERT_TRUE(linearizedDynamics.f.isApprox(step3.f));
+  ASSERT_TRUE(linearizedDynamics.dfdx.isApprox(A));
+  ASSERT_TRUE(linearizedDynamics.dfdu.isApprox(B));
+
+  // Short intervals are integrated in one step
+  ASSERT_TRUE(subStepDiscretization(*system, t, x, u, 0.03).isApprox(discretization(*system, t, x, u, 0.03)));
+}
@@ -0,0 +1,120 @@
+/******************************************************************************
+Copyright (c) 2020, Farbod Farshidian. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <ocs2_core/Types.h>
+#include <ocs2_core/misc/BlockSparsity.h>
+
+namespace {
+/** Random matrix with a random structural sparsity */
+ocs2::matrix_t getRandomSparseMatrix(int rows, int cols, ocs2::scalar_t density) {
+  const ocs2::matrix_t mask = 0.5 * (ocs2::matrix_t::Random(rows, cols).array() + 1.0);
+  return (mask.array() < density).select(ocs2::matrix_t::Random(rows, cols), 0.0);
+}
+
+/** Checks that all non-zeros of the matrix are covered by the blocks */
+bool isCovered(const ocs2::BlockSparsity& sparsity, const ocs2::matrix_t& matrix) {
+  ocs2::matrix_t uncovered = matrix;
+  for (const auto& b : sparsity.blocks()) {
+    uncovered.block(b.row, b.col, b.rows, b.cols).setZero();
+  }
+  return uncovered.isZero(0.0);
+}
+}  // namespace
+
+TEST(testBlockSparsity, blocksCoverPattern) {
+  for (const auto density : {0.0, 0.05, 0.2, 0.5, 1.0}) {
+    const ocs2::matrix_t A = getRandomSparseMatrix(24, 30, density);
+    const auto sparsity = ocs2::BlockSparsity::fromMatrix(A);
+    ASSERT_TRUE(isCovered(sparsity, A));
+    ASSERT_LE(sparsity.density(), 1.0);
+  }
+
+  EXPECT_TRUE(ocs2::BlockSparsity::Zero(5, 3).blocks().empty());
+  EXPECT_EQ(ocs2::BlockSparsity::Dense(5, 3).blocks().size(), 1);
+  EXPECT_DOUBLE_EQ(ocs2::BlockSparsity::Dense(5, 3).density(), 1.0);
+  EXPECT_TRUE(isCovered(ocs2::BlockSparsity::Identity(24), ocs2::matrix_t::Identity(24, 24)));
+  EXPECT_LT(ocs2::BlockSparsity::Identity(24).density(), 0.5);
+}
+
+TEST(testBlockSparsity, fromSparsityPattern) {
+  // Pattern of a function of 3 outputs and variables [t, x0, x1, u0]
+  const std::vector<std::set<size_t>> pattern{{0, 1}, {2, 3}, {}};
+  const auto dfdx = ocs2::BlockSparsity::fromSparsityPattern(pattern, 3, 2, 1);
+  const auto dfdu = ocs2::BlockSparsity::fromSparsityPattern(pattern, 3, 1, 3);
+
+  ocs2::BlockSparsity::pattern_t expectedDfdx(3, 2);
+  expectedDfdx << true, false, false, true, false, false;
+  ocs2::BlockSparsity::pattern_t expectedDfdu(3, 1);
+  expectedDfdu << false, true, false;
+  EXPECT_TRUE(dfdx == ocs2::BlockSparsity(expectedDfdx));
+  EXPECT_TRUE(dfdu == ocs2::BlockSparsity(expectedDfdu));
+  EXPECT_ANY_THROW(ocs2::BlockSparsity::fromSparsityPattern(pattern, 4, 2, 1));
+}
+
+TEST(testBlockSparsity, algebra) {
+  const ocs2::matrix_t A = getRandomSparseMatrix(12, 10, 0.2);
+  const ocs2::matrix_t B = getRandomSparseMatrix(10, 8, 0.2);
+  const ocs2::matrix_t C = getRandomSparseMatrix(12, 10, 0.2);
+  const auto sA = ocs2::BlockSparsity::fromMatrix(A);
+  const auto sB = ocs2::BlockSparsity::fromMatrix(B);
+  const auto sC = ocs2::BlockSparsity::fromMatrix(C);
+
+  EXPECT_TRUE(isCovered(sA.transpose(), A.transpose()));
+  EXPECT_TRUE(isCovered(sA + sC, A + C));
+  EXPECT_TRUE(isCovered(sA * sB, A * B));
+  EXPECT_TRUE(sA.transpose().transpose() == sA);
+}
+
+TEST(testBlockSparsity, products) {
+  const int n = 24;
+  const int m = 16;
+  const ocs2::matrix_t A = getRandomSparseMatrix(n, m, 0.15);
+  const auto sA = ocs2::BlockSparsity::fromMatrix(A);
+  const ocs2::matrix_t offset = ocs2::matrix_t::Random(n, n);
+
+  // out += A * B
+  const ocs2::matrix_t B = ocs2::matrix_t::Random(m, n);
+  ocs2::matrix_t out = offset;
+  ocs2::block_sparse::addProduct(sA, A, B, out);
+  EXPECT_TRUE(out.isApprox(offset + A * B));
+
+  // out += A' * B
+  const ocs2::matrix_t Bt = ocs2::matrix_t::Random(n, m);
+  out = offset.topLeftCorner(m, m);
+  ocs2::block_sparse::addTransposeProduct(sA, A, Bt, out);
+  EXPECT_TRUE(out.isApprox(offset.topLeftCorner(m, m) + A.transpose() * Bt));
+
+  // out += B * A
+  const ocs2::matrix_t P = ocs2::matrix_t::Random(n, n);
+  out = offset.leftCols(m);
+  ocs2::block_sparse::addRightProduct(P, sA, A, out);
+  EXPECT_TRUE(out.isApprox(offset.leftCols(m) + P * A));
+}
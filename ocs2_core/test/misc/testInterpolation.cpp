@@ -1,7 +1,9 @@
 #include <gtest/gtest.h>
 
+#include <cstdlib>
 #include <iostream>
 
+#include <ocs2_core/misc/Benchmark.h>
 #include <ocs2_core/misc/LinearInterpolation.h>
 #include <Eigen/Dense>
 
@@ -132,3 +134,74 @@ TEST(testLinearInterpolation, testDifferentEigenSizes) {
   result = ocs2::LinearInterpolation::interpolate(1.1, times, data);
   EXPECT_TRUE(result.isApprox(data[1]));
 }
+
+TEST(testLinearInterpolation, testTimeSegmentCursor) {
+  constexpr size_t numNodes = 100;
+  std::vector<double> times;
+  ocs2::vector_array_t states;
+  ocs2::matrix_array_t gains;
+  for (size_t i = 0; i < numNodes; i++) {
+    // Includes an event time (repeated time stamp)
+    times.push_back((i == 50) ? times.back() : 0.1 * i);
+    states.push_back(ocs2::vector_t::Random(3));
+    gains.push_back(ocs2::matrix_t::Random(2, 3));
+  }
+
+  std::vector<double> queryTimes;
+  for (double t = -1.0; t < 11.0; t += 0.0137) {
+    queryTimes.push_back(t);  // increasing
+  }
+  for (double t = 11.0; t > -1.0; t -= 0.0291) {
+    queryTimes.push_back(t);  // decreasing
+  }
+  for (size_t i = 0; i < 200; i++) {
+    queryTimes.push_back(12.0 * std::rand() / RAND_MAX - 1.0);  // random
+  }
+  queryTimes.push_back(times[50]);  // at the event time
+
+  ocs2::LinearInterpolation::TimeSegmentCursor cursor(times);
+  ocs2::vector_t state;
+  ocs2::matrix_t gain;
+  for (const auto t : queryTimes) {
+    const auto expectedIndexAlpha = ocs2::LinearInterpolation::timeSegment(t, times);
+    const auto& indexAlpha = cursor.seek(t);
+    ASSERT_EQ(indexAlpha.first, expectedIndexAlpha.first) << "time: " << t;
+    ASSERT_DOUBLE_EQ(indexAlpha.second, expectedIndexAlpha.second) << "time: " << t;
+
+    cursor.interpolateInto(states, state, gains, gain);
+    EXPECT_TRUE(state.isApprox(ocs2::LinearInterpolation::interpolate(t, times, states)));
+    EXPECT_TRUE(gain.isApprox(ocs2::LinearInterpolation::interpolate(t, times, gains)));
+    EXPECT_TRUE(state.isApprox(cursor.interpolate(states)));
+  }
+}
+
+TEST(testLinearInterpolation, benchmarkTimeSegmentCursor) {
+  constexpr size_t numNodes = 10000;
+  constexpr size_t numQueries = 100000;
+  std::vector<double> times(numNodes);
+  for (size_t i = 0; i < numNodes; i++) {
+    times[i] = 0.001 * i;
+  }
+  const double dt = times.back() / numQueries;
+
+  ocs2::benchmark::RepeatedTimer timeSegmentTimer;
+  double sum = 0.0;
+  timeSegmentTimer.startTimer();
+  for (size_t i = 0; i < numQueries; i++) {
+    sum += ocs2::LinearInterpolation::timeSegment(i * dt, times).second;
+  }
+  timeSegmentTimer.endTimer();
+
+  ocs2::benchmark::RepeatedTimer cursorTimer;
+  ocs2::LinearInterpolation::TimeSegmentCursor cursor(times);
+  double cursorSum = 0.0;
+  cursorTimer.startTimer();
+  for (size_t i = 0; i < numQueries; i++) {
+    cursorSum += cursor.seek(i * dt).second;
+  }
+  cursorTimer.endTimer();
+
+  EXPECT_DOUBLE_EQ(sum, cursorSum);
+  std::cerr << "[benchmarkTimeSegmentCursor] " << numQueries << " monotonic queries on " << numNodes << " nodes, timeSegment: "
+            << timeSegmentTimer.getTotalInMilliseconds() << " [ms], cursor: " << cursorTimer.getTotalInMilliseconds() << " [ms]\n";
+}
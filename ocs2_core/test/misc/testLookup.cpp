@@ -163,3 +163,18 @@ TEST(testLookup, findBoundedActiveIntervalInTimeArray) {
   ASSERT_ANY_THROW(findBoundedActiveIntervalInTimeArray(timeArrayEmpty, 0.0));
   ASSERT_ANY_THROW(findBoundedActiveIntervalInTimeArray(timeArrayEmpty, 1.0));
 }
+
+TEST(testLookup, findIndexInTimeArrayWithHint) {
+  const std::vector<std::vector<double>> timeArrays{
+      {-1.0, 2.0, 3.0}, {-1.0, 2.0, 2.0, 2.0, 3.0}, {0.0, 0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8, 0.9, 1.0}, {1.0}, {}};
+  const std::vector<double> queryTimes{-2.0, -1.0, 0.0, 0.05, 0.1, 0.15, 0.55, 0.9, 1.0, 1.9, 2.0, 2.1, 2.5, 3.0, 4.0};
+
+  // The result does not depend on the hint
+  for (const auto& timeArray : timeArrays) {
+    for (const auto time : queryTimes) {
+      for (int hint = -1; hint <= static_cast<int>(timeArray.size()) + 1; hint++) {
+        ASSERT_EQ(findIndexInTimeArray(timeArray, time, hint), findIndexInTimeArray(timeArray, time));
+      }
+    }
+  }
+}
@@ -0,0 +1,149 @@
+/******************************************************************************
+Copyright (c) 2020, Farbod Farshidian. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <sstream>
+#include <thread>
+
+#include <ocs2_core/misc/Tracing.h>
+
+using namespace ocs2;
+
+TEST(testTracing, recordAndExport) {
+  tracing::clear();
+  {
+    const tracing::ScopedEvent outer("test", "outer", 3);
+    const tracing::ScopedEvent inner("test", "inner");
+  }
+  std::thread worker([]() {
+    tracing::setThreadName("worker \"1\"");
+    const tracing::ScopedEvent event("test", "worker");
+  });
+  worker.join();
+
+  size_t numEvents = 0;
+  for (const auto& trace : tracing::collect()) {
+    numEvents += trace.events.size();
+    EXPECT_EQ(trace.numDroppedEvents, 0);
+    for (const auto& event : trace.events) {
+      EXPECT_GE(event.beginTime, 0);
+      EXPECT_GE(event.duration, 0);
+    }
+  }
+  EXPECT_EQ(numEvents, 3);
+
+  std::stringstream stream;
+  tracing::writeChromeTrace(stream);
+  const auto json = stream.str();
+  EXPECT_NE(json.find("\"traceEvents\""), std::string::npos);
+  EXPECT_NE(json.find("\"name\":\"outer\",\"cat\":\"test\",\"ph\":\"X\""), std::string::npos);
+  EXPECT_NE(json.find("\"args\":{\"index\":3}"), std::string::npos);
+  EXPECT_NE(json.find("\"args\":{\"name\":\"worker \\\"1\\\"\"}"), std::string::npos);
+
+  tracing::clear();
+  for (const auto& trace : tracing::collect()) {
+    EXPECT_TRUE(trace.events.empty());
+  }
+}
+
+TEST(testTracing, ringBufferOverflow) {
+  tracing::clear();
+  const size_t numRecorded = tracing::ringBufferCapacity + 100;
+  std::thread worker([&]() {
+    for (size_t i = 0; i < numRecorded; ++i) {
+      tracing::recordEvent("test", "overflow", 0, 1, i);
+    }
+  });
+  worker.join();
+
+  bool found = false;
+  for (const auto& trace : tracing::collect()) {
+    if (!trace.events.empty() && trace.events.front().name == std::string("overflow")) {
+      found = true;
+      EXPECT_EQ(trace.events.size(), tracing::ringBufferCapacity);
+      EXPECT_EQ(trace.numDroppedEvents, 100);
+      EXPECT_EQ(trace.events.front().index, 100);
+      EXPECT_EQ(trace.events.back().index, numRecorded - 1);
+    }
+  }
+  EXPECT_TRUE(found);
+}
+
+TEST(testTracing, disabled) {
+  tracing::clear();
+  tracing::setEnabled(false);
+  { const tracing::ScopedEvent event("test", "disabled"); }
+  tracing::setEnabled(true);
+  for (const auto& trace : tracing::collect()) {
+    EXPECT_TRUE(trace.events.empty());
+  }
+}
+
+TEST(testTracing, releaseExitedThreads) {
+  tracing::clear();
+  const auto numBuffers = tracing::collect().size();
+
+  // a thread without events releases its buffer on exit
+  std::thread idleWorker([]() { tracing::setThreadName("idle"); });
+  idleWorker.join();
+  EXPECT_EQ(tracing::collect().size(), numBuffers);
+
+  // a thread with events keeps its buffer for the export until the next clear
+  std::thread worker([]() { const tracing::ScopedEvent event("test", "exited"); });
+  worker.join();
+  EXPECT_EQ(tracing::collect().size(), numBuffers + 1);
+  tracing::clear();
+  EXPECT_EQ(tracing::collect().size(), numBuffers);
+}
+
+TEST(testTracing, concurrentExport) {
+  tracing::clear();
+  std::atomic_bool done{false};
+  std::thread worker([&]() {
+    for (int64_t i = 0; !done; ++i) {
+      tracing::recordEvent("test", "concurrent", i, 2 * i, i);
+    }
+  });
+
+  // every exported event has to be consistent, i.e. not mix the fields of an overwritten event
+  for (int k = 0; k < 20; ++k) {
+    for (const auto& trace : tracing::collect()) {
+      for (const auto& event : trace.events) {
+        if (event.name == std::string("concurrent")) {
+          ASSERT_EQ(event.beginTime, event.index);
+          ASSERT_EQ(event.duration, event.index);
+        }
+      }
+    }
+  }
+  done = true;
+  worker.join();
+}
@@ -0,0 +1,79 @@
+/******************************************************************************
+Copyright (c) 2020, Farbod Farshidian. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <ocs2_core/thread_support/SpinBarrier.h>
+
+using namespace ocs2;
+
+TEST(testSpinBarrier, synchronizesPhases) {
+  constexpr size_t numThreads = 4;
+  constexpr size_t numPhases = 1000;
+  SpinBarrier barrier(numThreads, 100);
+
+  std::atomic<size_t> numArrivals{0};
+  size_t numCompletions = 0;  // only modified in the completion function
+  std::atomic<bool> isConsistent{true};
+
+  auto worker = [&]() {
+    bool localSense = false;
+    for (size_t phase = 0; phase < numPhases; ++phase) {
+      ++numArrivals;
+      barrier.arriveAndWait(localSense, [&] {
+        // all threads of this phase have arrived, and none of the next phase
+        if (numArrivals != (phase + 1) * numThreads) {
+          isConsistent = false;
+        }
+        ++numCompletions;
+      });
+      // the completion of this phase is visible to every thread
+      if (numCompletions != phase + 1) {
+        isConsistent = false;
+      }
+      barrier.arriveAndWait(localSense);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < numThreads; ++i) {
+    threads.emplace_back(worker);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_TRUE(isConsistent);
+  EXPECT_EQ(numCompletions, numPhases);
+  EXPECT_EQ(numArrivals, numPhases * numThreads);
+}
@@ -1,4 +1,8 @@
 #include <gtest/gtest.h>
+
+#include <cmath>
+
+#include <ocs2_core/misc/Benchmark.h>
 #include <ocs2_core/thread_support/ThreadPool.h>
 
 using namespace ocs2;
@@ -121,3 +125,128 @@ TEST(testThreadPool, testMoveOnlyTask) {
 
   EXPECT_EQ(result.get(), 3.14);
 }
+
+TEST(testThreadPool, testParallelFor) {
+  ThreadPool pool(3);
+  for (int grainSize : {0, 1, 3, 1000}) {
+    std::vector<std::atomic_int> counts(1000);
+    for (auto& c : counts) {
+      c = 0;
+    }
+    std::vector<std::atomic_int> workerUsage(pool.numThreads() + 1);
+    for (auto& c : workerUsage) {
+      c = 0;
+    }
+
+    pool.parallelFor(0, counts.size(), grainSize, [&](int workerId, int i) {
+      ASSERT_LE(workerId, pool.numThreads());
+      // A worker ID is never used by two threads at the same time
+      EXPECT_EQ(workerUsage[workerId]++, 0);
+      counts[i]++;
+      workerUsage[workerId]--;
+    });
+
+    for (const auto& c : counts) {
+      EXPECT_EQ(c, 1);
+    }
+  }
+}
+
+TEST(testThreadPool, testParallelForOffsetRange) {
+  ThreadPool pool(2);
+  std::atomic_int sum;
+  sum = 0;
+
+  pool.parallelFor(10, 20, 1, [&](int, int i) { sum += i; });
+  EXPECT_EQ(sum, 145);
+
+  pool.parallelFor(5, 5, 1, [&](int, int i) { sum += i; });
+  EXPECT_EQ(sum, 145);
+}
+
+TEST(testThreadPool, testParallelForNoThreads) {
+  ThreadPool pool(0);
+  std::atomic_int counter;
+  counter = 0;
+
+  pool.parallelFor(0, 42, 0, [&](int workerId, int) {
+    EXPECT_EQ(workerId, 0);
+    counter++;
+  });
+
+  EXPECT_EQ(counter, 42);
+}
+
+TEST(testThreadPool, testParallelForPropagateException) {
+  ThreadPool pool(2);
+  std::atomic_int counter;
+  counter = 0;
+
+  auto task = [&](int, int i) {
+    if (i == 17) {
+      throw std::runtime_error("exception");
+    }
+    counter++;
+  };
+  EXPECT_THROW(pool.parallelFor(0, 100, 1, task), std::runtime_error);
+  EXPECT_LT(counter, 100);
+}
+
+TEST(testThreadPool, testParallelForSpinning) {
+  ThreadPool pool(2, 0, 10000);
+  std::atomic_int counter;
+  counter = 0;
+
+  for (int k = 0; k < 100; ++k) {
+    pool.parallelFor(0, 10, 1, [&](int, int) { counter++; });
+  }
+
+  EXPECT_EQ(counter, 1000);
+}
+
+TEST(testThreadPool, benchmarkParallelFor) {
+  constexpr int numThreads = 4;
+  constexpr int numIndices = 400;
+  constexpr int numRepeats = 200;
+  ThreadPool pool(numThreads - 1);
+  ThreadPool spinningPool(numThreads - 1, 0, 100000);
+
+  // Some unbalanced work per index
+  std::vector<double> result(numIndices);
+  auto work = [&](int i) {
+    double x = i;
+    for (int k = 0; k < 200 + 50 * (i % 7); ++k) {
+      x = std::sqrt(x + k);
+    }
+    result[i] = x;
+  };
+
+  benchmark::RepeatedTimer sharedCounterTimer;
+  benchmark::RepeatedTimer parallelForTimer;
+  benchmark::RepeatedTimer spinningParallelForTimer;
+  for (int r = 0; r < numRepeats; ++r) {
+    sharedCounterTimer.startTimer();
+    std::atomic_int timeIndex{0};
+    pool.runParallel(
+        [&](int) {
+          int i;
+          while ((i = timeIndex++) < numIndices) {
+            work(i);
+          }
+        },
+        numThreads);
+    sharedCounterTimer.endTimer();
+
+    parallelForTimer.startTimer();
+    pool.parallelFor(0, numIndices, 0, [&](int, int i) { work(i); });
+    parallelForTimer.endTimer();
+
+    spinningParallelForTimer.startTimer();
+    spinningPool.parallelFor(0, numIndices, 0, [&](int, int i) { work(i); });
+    spinningParallelForTimer.endTimer();
+  }
+
+  std::cout << "runParallel with shared counter : " << sharedCounterTimer.getAverageInMilliseconds() << " [ms]\n";
+  std::cout << "parallelFor                     : " << parallelForTimer.getAverageInMilliseconds() << " [ms]\n";
+  std::cout << "parallelFor with spinning       : " << spinningParallelForTimer.getAverageInMilliseconds() << " [ms]\n";
+}
@@ -68,6 +68,8 @@ struct Settings {
   size_t nThreads_ = 1;
   /** Priority of threads used in the multi-threading scheme. */
   int threadPriority_ = 99;
+  /** Number of busy-wait iterations of an idle worker thread before it goes to sleep. */
+  size_t threadSpinCount_ = 0;
 
   /** Maximum number of iterations of DDP. */
   size_t maxNumIterations_ = 15;
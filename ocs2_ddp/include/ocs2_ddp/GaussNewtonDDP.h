@@ -125,6 +125,17 @@ class GaussNewtonDDP : public SolverBase {
     threadPool_.runParallel([&](int) { taskFunction(); }, N);
   }
 
+  /**
+   * Helper to run a task for each index in [begin, end) in parallel over settings().nThreads_ threads (blocking)
+   *
+   * @param [in] begin: first index
+   * @param [in] end: one past the last index
+   * @param [in] taskFunction: task function with signature (workerId, index). The workerId is in [0, settings().nThreads_ - 1].
+   */
+  void parallelFor(int begin, int end, std::function<void(int, int)> taskFunction) {
+    threadPool_.parallelFor(begin, end, 0, std::move(taskFunction));
+  }
+
   /**
    * Takes the following steps: (1) Computes the Hessian of the Hamiltonian (i.e., Hm) (2) Based on Hm, it calculates
    * the range space and the null space projections of the input-state equality constraints. (3) Based on these two
@@ -351,7 +362,6 @@ class GaussNewtonDDP : public SolverBase {
 
   // multi-threading helper variables
   std::atomic_size_t nextTaskId_{0};
-  std::atomic_size_t nextTimeIndex_{0};
 
   scalar_t initTime_ = 0.0;
   scalar_t finalTime_ = 0.0;
@@ -99,6 +99,23 @@ class LineSearchStrategy final : public SearchStrategyBase {
   /** Computes the solution on a thread and a given stepLength  */
   void computeSolution(size_t taskId, scalar_t stepLength, search_strategy::Solution& solution);
 
+  /** Computes the dual solution, the metrics, and the performance index of a rolled out primal solution on a thread */
+  void evaluateSolution(size_t taskId, scalar_t stepLength, search_strategy::Solution& solution);
+
+  /**
+   * Line search with the horizon split into segments (see line_search::Settings::numRolloutSegments). The step lengths are processed
+   * in waves of numParticipants / numRolloutSegments candidates, such that all segments of a wave are rolled out in parallel.
+   */
+  void segmentedLineSearch();
+
+  /**
+   * Rolls out the controllers of the given step lengths in segments. The primal solution of the i-th step length is written to
+   * workersSolution_[i].
+   *
+   * @return whether the rollout of each step length is numerically stable.
+   */
+  std::vector<bool> rolloutSegments(const scalar_array_t& stepLengths);
+
   /**
    * Defines line search task on a thread with various learning rates and choose the largest acceptable step-size.
    * The class computes the nominal controller and the nominal trajectories as well the corresponding performance indices.
@@ -116,6 +133,23 @@ class LineSearchStrategy final : public SearchStrategyBase {
   std::vector<std::reference_wrapper<OptimalControlProblem>> optimalControlProblemRefStock_;
   std::function<scalar_t(PerformanceIndex)> meritFunc_;
 
+  // segmented rollout
+  struct RolloutSegment {
+    scalar_t initTime = 0.0;
+    scalar_t finalTime = 0.0;
+    vector_t initState;
+    vector_t finalState;
+    matrix_t sensitivity;  // derivative of finalState w.r.t. initState
+    bool isStable = false;
+    scalar_array_t timeTrajectory;
+    size_array_t postEventIndices;
+    vector_array_t stateTrajectory;
+    vector_array_t inputTrajectory;
+  };
+  std::vector<RolloutSegment> rolloutSegments_;  // segments of all step lengths in a wave, ordered by step length and time
+  scalar_array_t guessTimeTrajectory_;           // trajectory to start the segments from
+  vector_array_t guessStateTrajectory_;
+
   // input
   LineSearchInputRef lineSearchInputRef_;
   // output
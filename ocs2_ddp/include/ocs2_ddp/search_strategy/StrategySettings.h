@@ -97,6 +97,14 @@ struct Settings {
   hessian_correction::Strategy hessianCorrectionStrategy = hessian_correction::Strategy::DIAGONAL_SHIFT;
   /** The multiple used for correcting the Hessian for numerical stability of the Riccati backward pass.*/
   scalar_t hessianCorrectionMultiple = numeric_traits::limitEpsilon<scalar_t>();
+  /**
+   * Number of segments of the horizon which are rolled out in parallel for each step length. The segments start from the previous
+   * trajectory and are rolled out again from Newton-corrected start states until these match the end states of the preceding segments.
+   * Requires a rollout with a given mode schedule (i.e. not state-triggered). For 1, the horizon is rolled out serially.
+   */
+  size_t numRolloutSegments = 1;
+  /** The accepted mismatch between the start state of a segment and the end state of the preceding segment (infinity norm). */
+  scalar_t rolloutDefectTolerance = 1e-6;
 };  // end of Settings
 
 /**
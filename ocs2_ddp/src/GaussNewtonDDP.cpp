@@ -35,6 +35,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <ocs2_core/control/FeedforwardController.h>
 #include <ocs2_core/integration/TrapezoidalIntegration.h>
 #include <ocs2_core/misc/LinearAlgebra.h>
+#include <ocs2_core/misc/Tracing.h>
 
 #include <ocs2_oc/oc_problem/OptimalControlProblemHelperFunction.h>
 #include <ocs2_oc/rollout/InitializerRollout.h>
@@ -53,7 +54,8 @@ namespace ocs2 {
 /******************************************************************************************************/
 GaussNewtonDDP::GaussNewtonDDP(ddp::Settings ddpSettings, const RolloutBase& rollout, const OptimalControlProblem& optimalControlProblem,
                                const Initializer& initializer)
-    : ddpSettings_(std::move(ddpSettings)), threadPool_(std::max(ddpSettings_.nThreads_, size_t(1)) - 1, ddpSettings_.threadPriority_) {
+    : ddpSettings_(std::move(ddpSettings)),
+      threadPool_(std::max(ddpSettings_.nThreads_, size_t(1)) - 1, ddpSettings_.threadPriority_, ddpSettings_.threadSpinCount_) {
   Eigen::setNbThreads(1);  // no multithreading within Eigen.
   Eigen::initParallel();
 
@@ -162,6 +164,9 @@ std::string GaussNewtonDDP::getBenchmarkingInfo() const {
                << searchStrategyTotal / benchmarkTotal * 100 << "%)\n";
     infoStream << "\tDual Solution      :\t" << totalDualSolutionTimer_.getAverageInMilliseconds() << " [ms] \t\t("
                << dualSolutionTotal / benchmarkTotal * 100 << "%)\n\n";
+    if (optimalControlProblemStock_.front().termProfilerPtr != nullptr) {
+      infoStream << optimalControlProblemStock_.front().termProfilerPtr->getReport();
+    }
   }
   return infoStream.str();
 }
@@ -197,6 +202,9 @@ void GaussNewtonDDP::reset() {
   computeControllerTimer_.reset();
   searchStrategyTimer_.reset();
   totalDualSolutionTimer_.reset();
+  if (optimalControlProblemStock_.front().termProfilerPtr != nullptr) {
+    optimalControlProblemStock_.front().termProfilerPtr->reset();
+  }
 }
 
 /******************************************************************************************************/
@@ -514,6 +522,8 @@ scalar_t GaussNewtonDDP::calculateRolloutMerit(const PerformanceIndex& performan
 /******************************************************************************************************/
 /******************************************************************************************************/
 scalar_t GaussNewtonDDP::solveSequentialRiccatiEquationsImpl(const ScalarFunctionQuadraticApproximation& finalValueFunction) {
+  OCS2_TRACE_SCOPE("ddp", "backwardPass");
+
   // pre-allocate memory for dual solution
   const size_t outputN = nominalPrimalData_.primalSolution.timeTrajectory_.size();
   nominalDualData_.valueFunctionTrajectory.clear();
@@ -586,6 +596,8 @@ scalar_t GaussNewtonDDP::solveSequentialRiccatiEquationsImpl(const ScalarFunctio
 /******************************************************************************************************/
 /******************************************************************************************************/
 void GaussNewtonDDP::calculateController() {
+  OCS2_TRACE_SCOPE("ddp", "computeController");
+
   const size_t N = nominalPrimalData_.primalSolution.timeTrajectory_.size();
 
   unoptimizedController_.clear();
@@ -594,15 +606,10 @@ void GaussNewtonDDP::calculateController() {
   unoptimizedController_.biasArray_.resize(N);
   unoptimizedController_.deltaBiasArray_.resize(N);
 
-  nextTimeIndex_ = 0;
-  auto task = [this, N] {
-    int timeIndex;
-    // get next time index (atomic)
-    while ((timeIndex = nextTimeIndex_++) < N) {
-      calculateControllerWorker(timeIndex, nominalPrimalData_, nominalDualData_, unoptimizedController_);
-    }
+  auto task = [this](int, int timeIndex) {
+    calculateControllerWorker(timeIndex, nominalPrimalData_, nominalDualData_, unoptimizedController_);
   };
-  runParallel(task, ddpSettings_.nThreads_);
+  parallelFor(0, N, task);
 
   // Since the controller for the last timestamp is invalid, if the last time is not the event time, use the control policy of the second to
   // last time for the last time
@@ -645,6 +652,8 @@ void GaussNewtonDDP::calculateController() {
 /******************************************************************************************************/
 /******************************************************************************************************/
 void GaussNewtonDDP::approximateOptimalControlProblem() {
+  OCS2_TRACE_SCOPE("ddp", "lqApproximation");
+
   /*
    * compute and augment the LQ approximation of intermediate times
    */
@@ -659,46 +668,38 @@ void GaussNewtonDDP::approximateOptimalControlProblem() {
   nominalPrimalData_.modelDataEventTimes.clear();
   nominalPrimalData_.modelDataEventTimes.resize(NE);
   if (NE > 0) {
-    nextTimeIndex_ = 0;
-    nextTaskId_ = 0;
-    auto task = [this, NE]() {
-      const size_t taskId = nextTaskId_++;  // assign task ID (atomic)
-
-      // timeIndex is atomic
-      int timeIndex;
-      while ((timeIndex = nextTimeIndex_++) < NE) {
-        ModelData& modelData = nominalPrimalData_.modelDataEventTimes[timeIndex];
-        const size_t preEventIndex = nominalPrimalData_.primalSolution.postEventIndices_[timeIndex] - 1;
-        const auto& time = nominalPrimalData_.primalSolution.timeTrajectory_[preEventIndex];
-        const auto& state = nominalPrimalData_.primalSolution.stateTrajectory_[preEventIndex];
-        const auto& multiplier = nominalDualData_.dualSolution.preJumps[timeIndex];
-
-        // approximate LQ for the pre-event node
-        ocs2::approximatePreJumpLQ(optimalControlProblemStock_[taskId], time, state, multiplier, modelData);
-
-        // checking the numerical properties
-        if (ddpSettings_.checkNumericalStability_) {
-          const auto errSize = checkSize(modelData, state.rows(), 0);
-          if (!errSize.empty()) {
-            throw std::runtime_error("[GaussNewtonDDP::approximateOptimalControlProblem] Mismatch in dimensions at intermediate time: " +
-                                     std::to_string(time) + "\n" + errSize);
-          }
-          const std::string errProperties =
-              checkDynamicsProperties(modelData) + checkCostProperties(modelData) + checkConstraintProperties(modelData);
-          if (!errProperties.empty()) {
-            throw std::runtime_error("[GaussNewtonDDP::approximateOptimalControlProblem] Ill-posed problem at event time: " +
-                                     std::to_string(time) + "\n" + errProperties);
-          }
+    auto task = [this](int workerId, int timeIndex) {
+      ModelData& modelData = nominalPrimalData_.modelDataEventTimes[timeIndex];
+      const size_t preEventIndex = nominalPrimalData_.primalSolution.postEventIndices_[timeIndex] - 1;
+      const auto& time = nominalPrimalData_.primalSolution.timeTrajectory_[preEventIndex];
+      const auto& state = nominalPrimalData_.primalSolution.stateTrajectory_[preEventIndex];
+      const auto& multiplier = nominalDualData_.dualSolution.preJumps[timeIndex];
+
+      // approximate LQ for the pre-event node
+      ocs2::approximatePreJumpLQ(optimalControlProblemStock_[workerId], time, state, multiplier, modelData);
+
+      // checking the numerical properties
+      if (ddpSettings_.checkNumericalStability_) {
+        const auto errSize = checkSize(modelData, state.rows(), 0);
+        if (!errSize.empty()) {
+          throw std::runtime_error("[GaussNewtonDDP::approximateOptimalControlProblem] Mismatch in dimensions at intermediate time: " +
+                                   std::to_string(time) + "\n" + errSize);
         }
-
-        // shift Hessian
-        if (ddpSettings_.strategy_ == search_strategy::Type::LINE_SEARCH) {
-          hessian_correction::shiftHessian(ddpSettings_.lineSearch_.hessianCorrectionStrategy, modelData.cost.dfdxx,
-                                           ddpSettings_.lineSearch_.hessianCorrectionMultiple);
+        const std::string errProperties =
+            checkDynamicsProperties(modelData) + checkCostProperties(modelData) + checkConstraintProperties(modelData);
+        if (!errProperties.empty()) {
+          throw std::runtime_error("[GaussNewtonDDP::approximateOptimalControlProblem] Ill-posed problem at event time: " +
+                                   std::to_string(time) + "\n" + errProperties);
         }
       }
+
+      // shift Hessian
+      if (ddpSettings_.strategy_ == search_strategy::Type::LINE_SEARCH) {
+        hessian_correction::shiftHessian(ddpSettings_.lineSearch_.hessianCorrectionStrategy, modelData.cost.dfdxx,
+                                         ddpSettings_.lineSearch_.hessianCorrectionMultiple);
+      }
     };
-    runParallel(task, ddpSettings_.nThreads_);
+    parallelFor(0, NE, task);
   }
 
   /*
@@ -830,6 +831,8 @@ void GaussNewtonDDP::updateConstraintPenalties(scalar_t equalityConstraintsSSE)
 /******************************************************************************************************/
 /******************************************************************************************************/
 bool GaussNewtonDDP::initializePrimalSolution() {
+  OCS2_TRACE_SCOPE("ddp", "initialRollout");
+
   try {
     // clear before starting to fill
     nominalPrimalData_.clear();
@@ -901,6 +904,8 @@ void GaussNewtonDDP::initializeDualSolutionAndMetrics() {
 /******************************************************************************************************/
 /******************************************************************************************************/
 void GaussNewtonDDP::takePrimalDualStep(scalar_t lqModelExpectedCost) {
+  OCS2_TRACE_SCOPE("ddp", "searchStrategy");
+
   // update primal: run search strategy and find the optimal stepLength
   searchStrategyTimer_.startTimer();
   scalar_t avgTimeStep;
@@ -978,6 +983,8 @@ void GaussNewtonDDP::runImpl(scalar_t initTime, const vector_t& initState, scala
 /******************************************************************************************************/
 /******************************************************************************************************/
 void GaussNewtonDDP::runImpl(scalar_t initTime, const vector_t& initState, scalar_t finalTime) {
+  OCS2_TRACE_SCOPE("ddp", "run");
+
   if (ddpSettings_.displayInfo_) {
     std::cerr << "\n++++++++++++++++++++++++++++++++++++++++++++++++++++++";
     std::cerr << "\n+++++++++++++ " + ddp::toAlgorithmName(ddpSettings_.algorithm_) + " solver is initialized ++++++++++++++";
@@ -1028,6 +1035,7 @@ void GaussNewtonDDP::runImpl(scalar_t initTime, const vector_t& initState, scala
 
   // DDP main loop
   while (true) {
+    OCS2_TRACE_SCOPE_INDEX("ddp", "iteration", totalNumIterations_ - initIteration);
     if (ddpSettings_.displayInfo_) {
       std::cerr << "\n###################";
       std::cerr << "\n#### Iteration " << (totalNumIterations_ - initIteration);
@@ -29,6 +29,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "ocs2_ddp/SLQ.h"
 
+#include <ocs2_core/misc/Tracing.h>
+
 #include "ocs2_ddp/DDP_HelperFunctions.h"
 #include "ocs2_ddp/riccati_equations/RiccatiModificationInterpolation.h"
 
@@ -87,38 +89,32 @@ void SLQ::approximateIntermediateLQ(const DualSolution& dualSolution, PrimalData
   modelDataTrajectory.clear();
   modelDataTrajectory.resize(timeTrajectory.size());
 
-  nextTimeIndex_ = 0;
-  nextTaskId_ = 0;
-  auto task = [&]() {
-    const size_t taskId = nextTaskId_++;  // assign task ID (atomic)
-
-    // get next time index is atomic
-    size_t timeIndex;
-    while ((timeIndex = nextTimeIndex_++) < timeTrajectory.size()) {
-      // approximate LQ for the given time index
-      ocs2::approximateIntermediateLQ(optimalControlProblemStock_[taskId], timeTrajectory[timeIndex], stateTrajectory[timeIndex],
-                                      inputTrajectory[timeIndex], multiplierTrajectory[timeIndex], modelDataTrajectory[timeIndex]);
-
-      // checking the numerical properties
-      if (settings().checkNumericalStability_) {
-        const auto errSize =
-            checkSize(modelDataTrajectory[timeIndex], stateTrajectory[timeIndex].rows(), inputTrajectory[timeIndex].rows());
-        if (!errSize.empty()) {
-          throw std::runtime_error("[SLQ::approximateIntermediateLQ] Mismatch in dimensions at intermediate time: " +
-                                   std::to_string(timeTrajectory[timeIndex]) + "\n" + errSize);
-        }
-        const std::string errProperties = checkDynamicsProperties(modelDataTrajectory[timeIndex]) +
-                                          checkCostProperties(modelDataTrajectory[timeIndex]) +
-                                          checkConstraintProperties(modelDataTrajectory[timeIndex]);
-        if (!errProperties.empty()) {
-          throw std::runtime_error("[SLQ::approximateIntermediateLQ] Ill-posed problem at intermediate time: " +
-                                   std::to_string(timeTrajectory[timeIndex]) + "\n" + errProperties);
-        }
+  auto task = [&](int workerId, int timeIndex) {
+    OCS2_TRACE_SCOPE_INDEX("ddp", "node", timeIndex);
+
+    // approximate LQ for the given time index
+    ocs2::approximateIntermediateLQ(optimalControlProblemStock_[workerId], timeTrajectory[timeIndex], stateTrajectory[timeIndex],
+                                    inputTrajectory[timeIndex], multiplierTrajectory[timeIndex], modelDataTrajectory[timeIndex]);
+
+    // checking the numerical properties
+    if (settings().checkNumericalStability_) {
+      const auto errSize =
+          checkSize(modelDataTrajectory[timeIndex], stateTrajectory[timeIndex].rows(), inputTrajectory[timeIndex].rows());
+      if (!errSize.empty()) {
+        throw std::runtime_error("[SLQ::approximateIntermediateLQ] Mismatch in dimensions at intermediate time: " +
+                                 std::to_string(timeTrajectory[timeIndex]) + "\n" + errSize);
       }
-    }  // end of while loop
+      const std::string errProperties = checkDynamicsProperties(modelDataTrajectory[timeIndex]) +
+                                        checkCostProperties(modelDataTrajectory[timeIndex]) +
+                                        checkConstraintProperties(modelDataTrajectory[timeIndex]);
+      if (!errProperties.empty()) {
+        throw std::runtime_error("[SLQ::approximateIntermediateLQ] Ill-posed problem at intermediate time: " +
+                                 std::to_string(timeTrajectory[timeIndex]) + "\n" + errProperties);
+      }
+    }
   };
 
-  runParallel(task, settings().nThreads_);
+  parallelFor(0, timeTrajectory.size(), task);
 }
 
 /******************************************************************************************************/
@@ -181,20 +177,13 @@ scalar_t SLQ::solveSequentialRiccatiEquations(const ScalarFunctionQuadraticAppro
 
   if (N > 0) {
     // perform the computeRiccatiModificationTerms for partition i
-    nextTimeIndex_ = 0;
-    nextTaskId_ = 0;
-    auto task = [this, N]() {
-      int timeIndex;
-      const matrix_t SmDummy = matrix_t::Zero(0, 0);
-
-      // get next time index is atomic
-      while ((timeIndex = nextTimeIndex_++) < N) {
-        computeProjectionAndRiccatiModification(nominalPrimalData_.modelDataTrajectory[timeIndex], SmDummy,
-                                                nominalDualData_.projectedModelDataTrajectory[timeIndex],
-                                                nominalDualData_.riccatiModificationTrajectory[timeIndex]);
-      }
+    const matrix_t SmDummy = matrix_t::Zero(0, 0);
+    auto task = [&](int, int timeIndex) {
+      computeProjectionAndRiccatiModification(nominalPrimalData_.modelDataTrajectory[timeIndex], SmDummy,
+                                              nominalDualData_.projectedModelDataTrajectory[timeIndex],
+                                              nominalDualData_.riccatiModificationTrajectory[timeIndex]);
     };
-    runParallel(task, settings().nThreads_);
+    parallelFor(0, N, task);
   }
 
   return solveSequentialRiccatiEquationsImpl(finalValueFunction);
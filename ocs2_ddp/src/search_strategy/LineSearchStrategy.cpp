@@ -29,16 +29,88 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "ocs2_ddp/search_strategy/LineSearchStrategy.h"
 
+#include <algorithm>
 #include <iomanip>
+#include <numeric>
 
 #include "ocs2_ddp/DDP_HelperFunctions.h"
 #include "ocs2_ddp/HessianCorrection.h"
 
+#include <ocs2_core/misc/LinearInterpolation.h>
 #include <ocs2_oc/oc_problem/OptimalControlProblemHelperFunction.h>
 #include <ocs2_oc/trajectory_adjustment/TrajectorySpreadingHelperFunctions.h>
 
 namespace ocs2 {
 
+namespace {
+
+/**
+ * Splits [initTime, finalTime] into about numSegments rollout segments of equal duration. Each interior boundary is moved onto the
+ * time grid of the fixed-step rollout in its mode, i.e. a multiple of timeStep after the start of the mode as defined by
+ * RolloutBase::findActiveModesTimeInterval, strictly between two events. Boundaries without such a grid point are dropped.
+ *
+ * @return The boundaries of the segments, starting with initTime and ending with finalTime.
+ */
+scalar_array_t segmentBoundaries(scalar_t initTime, scalar_t finalTime, const scalar_array_t& eventTimes, size_t numSegments,
+                                 scalar_t timeStep) {
+  constexpr auto eps = numeric_traits::weakEpsilon<scalar_t>();
+  scalar_array_t boundaries{initTime};
+  for (size_t s = 1; s < numSegments; ++s) {
+    const scalar_t time = initTime + static_cast<scalar_t>(s) * (finalTime - initTime) / static_cast<scalar_t>(numSegments);
+    const auto nextEventItr = std::upper_bound(eventTimes.cbegin(), eventTimes.cend(), time);
+    const scalar_t modeBeginTime = (nextEventItr == eventTimes.cbegin()) ? initTime : std::max(initTime, *std::prev(nextEventItr));
+    const scalar_t modeEndTime = (nextEventItr == eventTimes.cend()) ? finalTime : std::min(finalTime, *nextEventItr);
+    const scalar_t modeStartTime = modeBeginTime + eps;
+    const scalar_t numSteps = std::max(std::round((time - modeStartTime) / timeStep), 1.0);
+    const scalar_t boundary = modeStartTime + numSteps * timeStep;
+    if (boundary < modeEndTime && boundary > boundaries.back()) {
+      boundaries.push_back(boundary);
+    }
+  }
+  boundaries.push_back(finalTime);
+  return boundaries;
+}
+
+/**
+ * Computes the sensitivity of the final state of a closed-loop rollout to its initial state. The variational equation of the closed
+ * loop is integrated along the rolled out trajectory with Heun's method and the state jumps are linearized with the jump map.
+ */
+matrix_t closedLoopSensitivity(OptimalControlProblem& problem, const LinearController& controller, const scalar_array_t& timeTrajectory,
+                               const size_array_t& postEventIndices, const vector_array_t& stateTrajectory,
+                               const vector_array_t& inputTrajectory) {
+  auto& preComputation = *problem.preComputationPtr;
+  auto closedLoopJacobian = [&](size_t k) -> matrix_t {
+    const auto& t = timeTrajectory[k];
+    preComputation.request(Request::Dynamics + Request::Approximation, t, stateTrajectory[k], inputTrajectory[k]);
+    const auto dynamics = problem.dynamicsPtr->linearApproximation(t, stateTrajectory[k], inputTrajectory[k], preComputation);
+    const matrix_t gain = LinearInterpolation::interpolate(t, controller.timeStamp_, controller.gainArray_);
+    return dynamics.dfdx + dynamics.dfdu * gain;
+  };
+
+  const auto stateDim = stateTrajectory.front().size();
+  matrix_t sensitivity = matrix_t::Identity(stateDim, stateDim);
+  matrix_t jacobian = closedLoopJacobian(0);
+  auto eventItr = postEventIndices.cbegin();
+  for (size_t k = 0; k + 1 < timeTrajectory.size(); ++k) {
+    const bool isEvent = eventItr != postEventIndices.cend() && *eventItr == k + 1;
+    const matrix_t nextJacobian = closedLoopJacobian(k + 1);
+    if (isEvent) {
+      preComputation.requestPreJump(Request::Dynamics + Request::Approximation, timeTrajectory[k], stateTrajectory[k]);
+      const auto jumpMap = problem.dynamicsPtr->jumpMapLinearApproximation(timeTrajectory[k], stateTrajectory[k], preComputation);
+      sensitivity = jumpMap.dfdx * sensitivity;
+      ++eventItr;
+    } else {
+      const scalar_t dt = timeTrajectory[k + 1] - timeTrajectory[k];
+      const matrix_t predictor = sensitivity + dt * jacobian * sensitivity;
+      sensitivity += 0.5 * dt * (jacobian * sensitivity + nextJacobian * predictor);
+    }
+    jacobian = nextJacobian;
+  }
+  return sensitivity;
+}
+
+}  // unnamed namespace
+
 /******************************************************************************************************/
 /******************************************************************************************************/
 /******************************************************************************************************/
@@ -86,7 +158,6 @@ size_t LineSearchStrategy::maxNumOfSearches() const {
 /******************************************************************************************************/
 /******************************************************************************************************/
 void LineSearchStrategy::computeSolution(size_t taskId, scalar_t stepLength, search_strategy::Solution& solution) {
-  auto& problem = optimalControlProblemRefStock_[taskId];
   auto& rollout = rolloutRefStock_[taskId];
 
   // compute primal solution
@@ -95,6 +166,15 @@ void LineSearchStrategy::computeSolution(size_t taskId, scalar_t stepLength, sea
   solution.avgTimeStep = rolloutTrajectory(rollout, lineSearchInputRef_.timePeriodPtr->first, *lineSearchInputRef_.initStatePtr,
                                            lineSearchInputRef_.timePeriodPtr->second, solution.primalSolution);
 
+  evaluateSolution(taskId, stepLength, solution);
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void LineSearchStrategy::evaluateSolution(size_t taskId, scalar_t stepLength, search_strategy::Solution& solution) {
+  auto& problem = optimalControlProblemRefStock_[taskId];
+
   // adjust dual solution only if it is required
   const DualSolution* adjustedDualSolutionPtr = lineSearchInputRef_.dualSolutionPtr;
   if (!lineSearchInputRef_.dualSolutionPtr->timeTrajectory.empty()) {
@@ -162,12 +242,20 @@ bool LineSearchStrategy::run(const std::pair<scalar_t, scalar_t>& timePeriod, co
     throw std::runtime_error("[SearchStrategy::run] DDP controller does not generate a stable rollout!");
   }
 
-  // run workers
-  nextTaskId_ = 0;
-  alphaExpNext_ = 0;
-  alphaProcessed_ = std::vector<bool>(maxNumOfSearches(), false);
-  auto task = [&](int) { lineSearchTask(nextTaskId_++); };
-  threadPoolRef_.runParallel(task, threadPoolRef_.numThreads());
+  if (settings_.numRolloutSegments > 1) {
+    // the segments of the first step lengths start from the nominal trajectory
+    guessTimeTrajectory_ = bestSolutionRef_->primalSolution.timeTrajectory_;
+    guessStateTrajectory_ = bestSolutionRef_->primalSolution.stateTrajectory_;
+    segmentedLineSearch();
+
+  } else {
+    // run workers
+    nextTaskId_ = 0;
+    alphaExpNext_ = 0;
+    alphaProcessed_ = std::vector<bool>(maxNumOfSearches(), false);
+    auto task = [&](int) { lineSearchTask(nextTaskId_++); };
+    threadPoolRef_.runParallel(task, threadPoolRef_.numThreads());
+  }
 
   // revitalize all integrators
   for (RolloutBase& rollout : rolloutRefStock_) {
@@ -257,6 +345,187 @@ void LineSearchStrategy::lineSearchTask(const size_t taskId) {
   }  // end of while loop
 }
 
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void LineSearchStrategy::segmentedLineSearch() {
+  const size_t numParticipants = threadPoolRef_.numThreads() + 1;
+  const size_t numStepLengthsPerWave = std::max(numParticipants / settings_.numRolloutSegments, size_t(1));
+
+  size_t alphaExp = 0;
+  scalar_array_t stepLengths;
+  stepLengths.reserve(numStepLengthsPerWave);
+  while (true) {
+    // the next wave of step lengths, from large to small
+    stepLengths.clear();
+    while (stepLengths.size() < numStepLengthsPerWave) {
+      const scalar_t stepLength = settings_.maxStepLength * std::pow(settings_.contractionRate, alphaExp);
+      if (!numerics::almost_ge(stepLength, settings_.minStepLength)) {
+        break;
+      }
+      stepLengths.push_back(stepLength);
+      ++alphaExp;
+    }
+    if (stepLengths.empty()) {
+      return;
+    }
+
+    const auto isStable = rolloutSegments(stepLengths);
+
+    auto evaluationTask = [&](int workerId, int i) {
+      auto& solution = workersSolution_[i];
+      try {
+        if (!isStable[i]) {
+          throw std::runtime_error("System became unstable during the rollout!");
+        }
+        evaluateSolution(workerId, stepLengths[i], solution);
+      } catch (const std::exception& error) {
+        if (baseSettings_.displayInfo) {
+          printString("    [Thread " + std::to_string(workerId) + "] rollout with step length " + std::to_string(stepLengths[i]) +
+                      " is terminated: " + error.what() + '\n');
+        }
+        solution.performanceIndex.merit = std::numeric_limits<scalar_t>::max();
+        solution.performanceIndex.cost = std::numeric_limits<scalar_t>::max();
+      }
+    };
+    threadPoolRef_.parallelFor(0, static_cast<int>(stepLengths.size()), 1, evaluationTask);
+
+    // the largest step length which satisfies the Armijo condition
+    for (size_t i = 0; i < stepLengths.size(); ++i) {
+      const bool armijoCondition = workersSolution_[i].performanceIndex.merit <
+                                   (baselineMerit_ - settings_.armijoCoefficient * stepLengths[i] * unoptimizedControllerUpdateIS_);
+      if (armijoCondition) {
+        bestStepSize_ = stepLengths[i];
+        swap(*bestSolutionRef_, workersSolution_[i]);
+        return;
+      }
+    }
+
+    // the segments of the next wave start from the trajectory of the smallest step length so far
+    if (isStable.back()) {
+      guessTimeTrajectory_ = workersSolution_[stepLengths.size() - 1].primalSolution.timeTrajectory_;
+      guessStateTrajectory_ = workersSolution_[stepLengths.size() - 1].primalSolution.stateTrajectory_;
+    }
+  }
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+std::vector<bool> LineSearchStrategy::rolloutSegments(const scalar_array_t& stepLengths) {
+  const scalar_t initTime = lineSearchInputRef_.timePeriodPtr->first;
+  const scalar_t finalTime = lineSearchInputRef_.timePeriodPtr->second;
+  const auto& modeSchedule = *lineSearchInputRef_.modeSchedulePtr;
+  const size_t numStepLengths = stepLengths.size();
+  const auto boundaries = segmentBoundaries(initTime, finalTime, modeSchedule.eventTimes, settings_.numRolloutSegments,
+                                            rolloutRefStock_.front().get().settings().timeStep);
+  const size_t numSegments = boundaries.size() - 1;
+
+  // controllers
+  for (size_t i = 0; i < numStepLengths; ++i) {
+    auto& primalSolution = workersSolution_[i].primalSolution;
+    primalSolution.modeSchedule_ = modeSchedule;
+    incrementController(stepLengths[i], *lineSearchInputRef_.unoptimizedControllerPtr, getLinearController(primalSolution));
+  }
+
+  // the first segment starts from the initial state, the others from the guess trajectory
+  rolloutSegments_.resize(numStepLengths * numSegments);
+  for (size_t i = 0; i < numStepLengths; ++i) {
+    for (size_t s = 0; s < numSegments; ++s) {
+      auto& segment = rolloutSegments_[i * numSegments + s];
+      // the rollout starts a mode weakEpsilon after the given initial time, such that the segment continues the grid of the previous one
+      segment.initTime = (s == 0) ? initTime : boundaries[s] - numeric_traits::weakEpsilon<scalar_t>();
+      segment.finalTime = boundaries[s + 1];
+      segment.initState = (s == 0) ? *lineSearchInputRef_.initStatePtr
+                                   : LinearInterpolation::interpolate(boundaries[s], guessTimeTrajectory_, guessStateTrajectory_);
+      segment.sensitivity.resize(0, 0);
+    }
+  }
+
+  // a copy of the mode schedule for each worker, since RolloutBase::run takes it by reference
+  std::vector<ModeSchedule> modeSchedules(threadPoolRef_.numThreads() + 1, modeSchedule);
+  auto rolloutTask = [&](int workerId, size_t segmentIndex) {
+    auto& segment = rolloutSegments_[segmentIndex];
+    auto& rollout = rolloutRefStock_[workerId].get();
+    auto& controller = getLinearController(workersSolution_[segmentIndex / numSegments].primalSolution);
+    const bool isLastSegment = (segmentIndex + 1) % numSegments == 0;
+    try {
+      segment.finalState = rollout.run(segment.initTime, segment.initState, segment.finalTime, &controller, modeSchedules[workerId],
+                                       segment.timeTrajectory, segment.postEventIndices, segment.stateTrajectory, segment.inputTrajectory);
+      segment.isStable = segment.finalState.allFinite();
+      if (segment.isStable && !isLastSegment && segment.sensitivity.size() == 0) {
+        segment.sensitivity = closedLoopSensitivity(optimalControlProblemRefStock_[workerId], controller, segment.timeTrajectory,
+                                                    segment.postEventIndices, segment.stateTrajectory, segment.inputTrajectory);
+      }
+    } catch (const std::exception&) {
+      segment.isStable = false;
+    }
+  };
+
+  // Roll out all segments in parallel, then correct the initial states of the segments by a Newton step on the defects (Parareal with
+  // the linearized closed loop as the coarse propagator): x_{s+1} = F_s(x_s) + Phi_s * (x_s^+ - x_s), where x_s^+ is the corrected
+  // initial state of segment s. After k sweeps the first k segments are exact, the sweeps stop when no correction exceeds the tolerance.
+  std::vector<size_t> pendingSegments(rolloutSegments_.size());
+  std::iota(pendingSegments.begin(), pendingSegments.end(), size_t(0));
+  vector_t initStateCorrection;
+  while (!pendingSegments.empty()) {
+    threadPoolRef_.parallelFor(0, static_cast<int>(pendingSegments.size()), 1,
+                               [&](int workerId, int k) { rolloutTask(workerId, pendingSegments[k]); });
+
+    pendingSegments.clear();
+    for (size_t i = 0; i < numStepLengths; ++i) {
+      initStateCorrection.setZero(lineSearchInputRef_.initStatePtr->size());
+      for (size_t s = 0; s + 1 < numSegments; ++s) {
+        const auto& segment = rolloutSegments_[i * numSegments + s];
+        if (!segment.isStable) {
+          break;
+        }
+        auto& nextSegment = rolloutSegments_[i * numSegments + s + 1];
+        const vector_t nextInitState = segment.finalState + segment.sensitivity * initStateCorrection;
+        initStateCorrection = nextInitState - nextSegment.initState;
+        if (initStateCorrection.lpNorm<Eigen::Infinity>() > settings_.rolloutDefectTolerance) {
+          nextSegment.initState = nextInitState;
+          pendingSegments.push_back(i * numSegments + s + 1);
+        } else {
+          initStateCorrection.setZero();
+        }
+      }
+    }
+  }
+
+  // concatenate the segments, the final node of a segment is replaced by the initial node of the next one
+  std::vector<bool> isStable(numStepLengths, true);
+  for (size_t i = 0; i < numStepLengths; ++i) {
+    auto& solution = workersSolution_[i];
+    auto& primalSolution = solution.primalSolution;
+    primalSolution.timeTrajectory_.clear();
+    primalSolution.postEventIndices_.clear();
+    primalSolution.stateTrajectory_.clear();
+    primalSolution.inputTrajectory_.clear();
+    for (size_t s = 0; s < numSegments; ++s) {
+      const auto& segment = rolloutSegments_[i * numSegments + s];
+      if (!segment.isStable) {
+        isStable[i] = false;
+        break;
+      }
+      const size_t offset = primalSolution.timeTrajectory_.size();
+      const size_t numNodes = (s + 1 < numSegments) ? segment.timeTrajectory.size() - 1 : segment.timeTrajectory.size();
+      for (const auto index : segment.postEventIndices) {
+        primalSolution.postEventIndices_.push_back(offset + index);
+      }
+      primalSolution.timeTrajectory_.insert(primalSolution.timeTrajectory_.end(), segment.timeTrajectory.begin(),
+                                            segment.timeTrajectory.begin() + numNodes);
+      primalSolution.stateTrajectory_.insert(primalSolution.stateTrajectory_.end(), segment.stateTrajectory.begin(),
+                                             segment.stateTrajectory.begin() + numNodes);
+      primalSolution.inputTrajectory_.insert(primalSolution.inputTrajectory_.end(), segment.inputTrajectory.begin(),
+                                             segment.inputTrajectory.begin() + numNodes);
+    }
+    solution.avgTimeStep = (finalTime - initTime) / static_cast<scalar_t>(primalSolution.timeTrajectory_.size());
+  }
+
+  return isStable;
+}
+
 /******************************************************************************************************/
 /******************************************************************************************************/
 /******************************************************************************************************/
@@ -83,6 +83,8 @@ Settings load(const std::string& filename, const std::string& fieldName, bool ve
   settings.hessianCorrectionStrategy = hessian_correction::fromString(hessianCorrectionStrategyName);
 
   loadData::loadPtreeValue(pt, settings.hessianCorrectionMultiple, fieldName + ".hessianCorrectionMultiple", verbose);
+  loadData::loadPtreeValue(pt, settings.numRolloutSegments, fieldName + ".numRolloutSegments", verbose);
+  loadData::loadPtreeValue(pt, settings.rolloutDefectTolerance, fieldName + ".rolloutDefectTolerance", verbose);
 
   if (verbose) {
     std::cerr << " #### }" << std::endl;
@@ -28,12 +28,14 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 ******************************************************************************/
 
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <cstdlib>
 #include <ctime>
 #include <iostream>
 
 #include <ocs2_core/control/FeedforwardController.h>
 #include <ocs2_core/initialization/DefaultInitializer.h>
+#include <ocs2_core/misc/LinearInterpolation.h>
 #include <ocs2_oc/rollout/TimeTriggeredRollout.h>
 #include <ocs2_oc/test/EXP0.h>
 
@@ -153,6 +155,53 @@ TEST_F(Exp0, ddp_feedback_policy) {
   EXPECT_DOUBLE_EQ(solution.timeTrajectory_.back(), finalTime) << "MESSAGE: SLQ failed in policy final time of trajectory!";
 }
 
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+TEST_F(Exp0, ddp_segmented_rollout) {
+  // dynamics and rollout, the segments continue the time grid of the fixed-step integrator
+  ocs2::EXP0_System systemDynamics(referenceManagerPtr);
+  auto fixedStepRolloutSettings = rolloutSettings();
+  fixedStepRolloutSettings.integratorType = ocs2::IntegratorType::RK4;
+  fixedStepRolloutSettings.useFixedStepIntegrator = true;
+  ocs2::TimeTriggeredRollout rollout(systemDynamics, fixedStepRolloutSettings);
+
+  auto solve = [&](size_t numRolloutSegments) {
+    auto ddpSettings = getSettings(ocs2::ddp::Algorithm::SLQ, 4, ocs2::search_strategy::Type::LINE_SEARCH);
+    ddpSettings.lineSearch_.numRolloutSegments = numRolloutSegments;
+    ddpSettings.lineSearch_.rolloutDefectTolerance = 1e-10;
+    ocs2::SLQ ddp(ddpSettings, rollout, problem, *initializerPtr);
+    ddp.setReferenceManager(referenceManagerPtr);
+    ddp.run(startTime, initState, finalTime);
+    return std::make_pair(ddp.primalSolution(finalTime), ddp.getIterationsLog());
+  };
+
+  const auto serial = solve(1);
+  const auto segmented = solve(4);
+
+  // the same iterations
+  ASSERT_EQ(segmented.second.size(), serial.second.size());
+  for (size_t i = 0; i < serial.second.size(); ++i) {
+    EXPECT_NEAR(segmented.second[i].cost, serial.second[i].cost, 1e-9 * serial.second[i].cost) << "iteration " << i;
+  }
+
+  // the same trajectory
+  const auto& serialSolution = serial.first;
+  const auto& segmentedSolution = segmented.first;
+  EXPECT_EQ(segmentedSolution.postEventIndices_.size(), serialSolution.postEventIndices_.size());
+  EXPECT_DOUBLE_EQ(segmentedSolution.timeTrajectory_.back(), serialSolution.timeTrajectory_.back());
+  for (size_t k = 0; k < serialSolution.timeTrajectory_.size(); ++k) {
+    const auto t = serialSolution.timeTrajectory_[k];
+    if (std::any_of(serialSolution.postEventIndices_.begin(), serialSolution.postEventIndices_.end(),
+                    [&](size_t index) { return index == k || index == k + 1; })) {
+      continue;  // the interpolation is ambiguous at the event time
+    }
+    const ocs2::vector_t state =
+        ocs2::LinearInterpolation::interpolate(t, segmentedSolution.timeTrajectory_, segmentedSolution.stateTrajectory_);
+    EXPECT_TRUE(state.isApprox(serialSolution.stateTrajectory_[k], 1e-9)) << "time " << t;
+  }
+}
+
 /******************************************************************************************************/
 /******************************************************************************************************/
 /******************************************************************************************************/
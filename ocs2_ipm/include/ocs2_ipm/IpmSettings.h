@@ -63,8 +63,19 @@ struct Settings {
   hpipm_interface::Settings hpipmSettings = hpipm_interface::Settings();
 
   // Discretization method
-  scalar_t dt = 0.01;  // user-defined time discretization
+  scalar_t dt = 0.01;                           // user-defined time discretization
+  scalar_array_t dtSwitchingTimes;              // multi-rate horizon: times since the initial time at which the next entry of dtSchedule
+                                                // is used as the time step, dt is used before the first one
+  scalar_array_t dtSchedule;                    // time steps after each of the dtSwitchingTimes
+  scalar_t dtGrowthFactor = 1.0;                // geometric growth of the time step per node after the last switching time
+  scalar_t dtGrowthMax = 0.1;                   // upper bound of the growing time step
+  bool useAdaptiveTimeDiscretization = false;   // Refine or coarsen the grid of the next problem based on the previous solution
+  scalar_t adaptiveDtMin = 0.0025;              // lower bound of the adapted time step
+  scalar_t adaptiveDtMax = 0.04;                // upper bound of the adapted time step
+  scalar_t adaptiveRefinementTolerance = 1e-3;  // intervals with a larger local integration error are refined
+  scalar_t adaptiveCoarseningTolerance = 1e-5;  // intervals with a smaller local integration error are coarsened
   SensitivityIntegratorType integratorType = SensitivityIntegratorType::RK2;
+  scalar_t integratorMaxStep = 0.0;  // intervals longer than this are integrated in sub-steps, e.g. for a coarse tail. 0 to disable.
 
   // Barrier strategy of the primal-dual interior point method. Conventions follows Ipopt.
   scalar_t initialBarrierParameter = 1.0e-02;  // Initial value of the barrier parameter
@@ -95,6 +106,8 @@ struct Settings {
   // Threading
   size_t nThreads = 4;
   int threadPriority = 50;
+  int parallelForGrainSize = 1;  // Number of consecutive nodes a worker takes at once. If <= 0, it is adapted to the horizon.
+  size_t threadSpinCount = 0;    // Number of busy-wait iterations of an idle worker before it sleeps.
 };
 
 /**
@@ -60,12 +60,22 @@ Settings loadSettings(const std::string& filename, const std::string& fieldName,
   loadData::loadPtreeValue(pt, settings.armijoFactor, fieldName + ".armijoFactor", verbose);
   loadData::loadPtreeValue(pt, settings.costTol, fieldName + ".costTol", verbose);
   loadData::loadPtreeValue(pt, settings.dt, fieldName + ".dt", verbose);
+  loadData::loadStdVector(filename, fieldName + ".dtSwitchingTimes", settings.dtSwitchingTimes, verbose);
+  loadData::loadStdVector(filename, fieldName + ".dtSchedule", settings.dtSchedule, verbose);
+  loadData::loadPtreeValue(pt, settings.dtGrowthFactor, fieldName + ".dtGrowthFactor", verbose);
+  loadData::loadPtreeValue(pt, settings.dtGrowthMax, fieldName + ".dtGrowthMax", verbose);
+  loadData::loadPtreeValue(pt, settings.useAdaptiveTimeDiscretization, fieldName + ".useAdaptiveTimeDiscretization", verbose);
+  loadData::loadPtreeValue(pt, settings.adaptiveDtMin, fieldName + ".adaptiveDtMin", verbose);
+  loadData::loadPtreeValue(pt, settings.adaptiveDtMax, fieldName + ".adaptiveDtMax", verbose);
+  loadData::loadPtreeValue(pt, settings.adaptiveRefinementTolerance, fieldName + ".adaptiveRefinementTolerance", verbose);
+  loadData::loadPtreeValue(pt, settings.adaptiveCoarseningTolerance, fieldName + ".adaptiveCoarseningTolerance", verbose);
   loadData::loadPtreeValue(pt, settings.useFeedbackPolicy, fieldName + ".useFeedbackPolicy", verbose);
   loadData::loadPtreeValue(pt, settings.createValueFunction, fieldName + ".createValueFunction", verbose);
   loadData::loadPtreeValue(pt, settings.computeLagrangeMultipliers, fieldName + ".computeLagrangeMultipliers", verbose);
   auto integratorName = sensitivity_integrator::toString(settings.integratorType);
   loadData::loadPtreeValue(pt, integratorName, fieldName + ".integratorType", verbose);
   settings.integratorType = sensitivity_integrator::fromString(integratorName);
+  loadData::loadPtreeValue(pt, settings.integratorMaxStep, fieldName + ".integratorMaxStep", verbose);
   loadData::loadPtreeValue(pt, settings.initialBarrierParameter, fieldName + ".initialBarrierParameter", verbose);
   loadData::loadPtreeValue(pt, settings.targetBarrierParameter, fieldName + ".targetBarrierParameter", verbose);
   loadData::loadPtreeValue(pt, settings.barrierReductionCostTol, fieldName + ".barrierReductionCostTol ", verbose);
@@ -83,6 +93,8 @@ Settings loadSettings(const std::string& filename, const std::string& fieldName,
   loadData::loadPtreeValue(pt, settings.printLinesearch, fieldName + ".printLinesearch", verbose);
   loadData::loadPtreeValue(pt, settings.nThreads, fieldName + ".nThreads", verbose);
   loadData::loadPtreeValue(pt, settings.threadPriority, fieldName + ".threadPriority", verbose);
+  loadData::loadPtreeValue(pt, settings.parallelForGrainSize, fieldName + ".parallelForGrainSize", verbose);
+  loadData::loadPtreeValue(pt, settings.threadSpinCount, fieldName + ".threadSpinCount", verbose);
 
   if (settings.initialSlackLowerBound <= 0.0) {
     throw std::runtime_error("[MultipleShootingIpmSettings] initialSlackLowerBound must be positive!");
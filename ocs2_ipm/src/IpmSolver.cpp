@@ -33,6 +33,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <iostream>
 #include <numeric>
 
+#include <ocs2_core/misc/Tracing.h>
 #include <ocs2_oc/approximate_model/LinearQuadraticApproximator.h>
 #include <ocs2_oc/multiple_shooting/Helpers.h>
 #include <ocs2_oc/multiple_shooting/Initialization.h>
@@ -61,18 +62,31 @@ ipm::Settings rectifySettings(const OptimalControlProblem& ocp, ipm::Settings&&
   }
   return settings;
 }
+
+AdaptiveTimeDiscretization::Settings adaptiveTimeDiscretizationSettings(const ipm::Settings& settings) {
+  AdaptiveTimeDiscretization::Settings adaptiveSettings;
+  adaptiveSettings.dt = settings.dt;
+  adaptiveSettings.dtMin = settings.adaptiveDtMin;
+  adaptiveSettings.dtMax = settings.adaptiveDtMax;
+  adaptiveSettings.refinementTolerance = settings.adaptiveRefinementTolerance;
+  adaptiveSettings.coarseningTolerance = settings.adaptiveCoarseningTolerance;
+  return adaptiveSettings;
+}
 }  // anonymous namespace
 
 IpmSolver::IpmSolver(ipm::Settings settings, const OptimalControlProblem& optimalControlProblem, const Initializer& initializer)
     : settings_(rectifySettings(optimalControlProblem, std::move(settings))),
+      horizonStepSchedule_(createHorizonStepSchedule(settings_.dt, settings_.dtSwitchingTimes, settings_.dtSchedule,
+                                                     settings_.dtGrowthFactor, settings_.dtGrowthMax)),
+      adaptiveTimeDiscretization_(adaptiveTimeDiscretizationSettings(settings_)),
       hpipmInterface_(OcpSize(), settings_.hpipmSettings),
-      threadPool_(std::max(settings_.nThreads, size_t(1)) - 1, settings_.threadPriority) {
+      threadPool_(std::max(settings_.nThreads, size_t(1)) - 1, settings_.threadPriority, settings_.threadSpinCount) {
   Eigen::setNbThreads(1);  // No multithreading within Eigen.
   Eigen::initParallel();
 
   // Dynamics discretization
-  discretizer_ = selectDynamicsDiscretization(settings_.integratorType);
-  sensitivityDiscretizer_ = selectDynamicsSensitivityDiscretization(settings_.integratorType);
+  discretizer_ = selectDynamicsDiscretization(settings_.integratorType, settings_.integratorMaxStep);
+  sensitivityDiscretizer_ = selectDynamicsSensitivityDiscretization(settings_.integratorType, settings_.integratorMaxStep);
 
   // Clone objects to have one for each worker
   for (int w = 0; w < settings_.nThreads; w++) {
@@ -104,6 +118,7 @@ void IpmSolver::reset() {
   dualIneqTrajectory_.clear();
   valueFunction_.clear();
   performanceIndeces_.clear();
+  adaptiveTimeDiscretization_.reset();
 
   // reset timers
   totalNumIterations_ = 0;
@@ -112,6 +127,9 @@ void IpmSolver::reset() {
   solveQpTimer_.reset();
   linesearchTimer_.reset();
   computeControllerTimer_.reset();
+  if (ocpDefinitions_.front().termProfilerPtr != nullptr) {
+    ocpDefinitions_.front().termProfilerPtr->reset();
+  }
 }
 
 std::string IpmSolver::getBenchmarkingInformation() const {
@@ -140,6 +158,9 @@ std::string IpmSolver::getBenchmarkingInformation() const {
                << linesearchTotal / benchmarkTotal * inPercent << "%)\n";
     infoStream << "\tCompute Controller :\t" << computeControllerTimer_.getAverageInMilliseconds() << " [ms] \t\t("
                << computeControllerTotal / benchmarkTotal * inPercent << "%)\n";
+    if (ocpDefinitions_.front().termProfilerPtr != nullptr) {
+      infoStream << ocpDefinitions_.front().termProfilerPtr->getReport();
+    }
   }
   return infoStream.str();
 }
@@ -201,6 +222,8 @@ MultiplierCollection IpmSolver::getIntermediateDualSolution(scalar_t time) const
 }
 
 void IpmSolver::runImpl(scalar_t initTime, const vector_t& initState, scalar_t finalTime) {
+  OCS2_TRACE_SCOPE("ipm", "run");
+
   if (settings_.printSolverStatus || settings_.printLinesearch) {
     std::cerr << "\n++++++++++++++++++++++++++++++++++++++++++++++++++++++";
     std::cerr << "\n+++++++++++++ IPM solver is initialized ++++++++++++++";
@@ -209,7 +232,9 @@ void IpmSolver::runImpl(scalar_t initTime, const vector_t& initState, scalar_t f
 
   // Determine time discretization, taking into account event times.
   const auto& eventTimes = this->getReferenceManager().getModeSchedule().eventTimes;
-  const auto timeDiscretization = timeDiscretizationWithEvents(initTime, finalTime, settings_.dt, eventTimes);
+  const auto timeDiscretization = settings_.useAdaptiveTimeDiscretization
+                                      ? adaptiveTimeDiscretization_.getTimeDiscretization(initTime, finalTime, eventTimes)
+                                      : timeDiscretizationWithEvents(initTime, finalTime, horizonStepSchedule_, eventTimes);
 
   // Initialize references
   for (auto& ocpDefinition : ocpDefinitions_) {
@@ -254,6 +279,7 @@ void IpmSolver::runImpl(scalar_t initTime, const vector_t& initState, scalar_t f
   int iter = 0;
   ipm::Convergence convergence = ipm::Convergence::FALSE;
   while (convergence == ipm::Convergence::FALSE) {
+    OCS2_TRACE_SCOPE_INDEX("ipm", "iteration", iter);
     if (settings_.printSolverStatus || settings_.printLinesearch) {
       std::cerr << "\nIPM iteration: " << iter << " (barrier parameter: " << barrierParam << ")\n";
     }
@@ -295,6 +321,9 @@ void IpmSolver::runImpl(scalar_t initTime, const vector_t& initState, scalar_t f
   }
 
   computeControllerTimer_.startTimer();
+  if (settings_.useAdaptiveTimeDiscretization) {
+    adaptiveTimeDiscretization_.update(timeDiscretization, x, u, *ocpDefinitions_.front().dynamicsPtr, discretizer_);
+  }
   primalSolution_ = toPrimalSolution(timeDiscretization, std::move(x), std::move(u));
   costateTrajectory_ = std::move(lmd);
   projectionMultiplierTrajectory_ = std::move(nu);
@@ -311,8 +340,8 @@ void IpmSolver::runImpl(scalar_t initTime, const vector_t& initState, scalar_t f
   }
 }
 
-void IpmSolver::runParallel(std::function<void(int)> taskFunction) {
-  threadPool_.runParallel(std::move(taskFunction), settings_.nThreads);
+void IpmSolver::parallelFor(int begin, int end, std::function<void(int, int)> taskFunction) {
+  threadPool_.parallelFor(begin, end, settings_.parallelForGrainSize, std::move(taskFunction));
 }
 
 void IpmSolver::initializeCostateTrajectory(const std::vector<AnnotatedTime>& timeDiscretization, const vector_array_t& stateTrajectory,
@@ -324,9 +353,11 @@ void IpmSolver::initializeCostateTrajectory(const std::vector<AnnotatedTime>& ti
   const auto interpolateTill =
       primalSolution_.timeTrajectory_.size() < 2 ? timeDiscretization.front().time : primalSolution_.timeTrajectory_.back();
 
+  LinearInterpolation::TimeSegmentCursor cursor(primalSolution_.timeTrajectory_);
   const scalar_t initTime = getIntervalStart(timeDiscretization[0]);
   if (initTime < interpolateTill) {
-    costateTrajectory.push_back(LinearInterpolation::interpolate(initTime, primalSolution_.timeTrajectory_, costateTrajectory_));
+    cursor.seek(initTime);
+    costateTrajectory.push_back(cursor.interpolate(costateTrajectory_));
   } else {
     costateTrajectory.push_back(vector_t::Zero(stateTrajectory[0].size()));
   }
@@ -334,7 +365,8 @@ void IpmSolver::initializeCostateTrajectory(const std::vector<AnnotatedTime>& ti
   for (int i = 1; i < stateTrajectory.size(); i++) {
     const auto time = getIntervalEnd(timeDiscretization[i]);
     if (time < interpolateTill) {  // interpolate previous solution
-      costateTrajectory.push_back(LinearInterpolation::interpolate(time, primalSolution_.timeTrajectory_, costateTrajectory_));
+      cursor.seek(time);
+      costateTrajectory.push_back(cursor.interpolate(costateTrajectory_));
     } else {  // Initialize with zero
       costateTrajectory.push_back(vector_t::Zero(stateTrajectory[i].size()));
     }
@@ -353,13 +385,14 @@ void IpmSolver::initializeProjectionMultiplierTrajectory(const std::vector<Annot
       primalSolution_.timeTrajectory_.size() < 2 ? timeDiscretization.front().time : *std::prev(primalSolution_.timeTrajectory_.end(), 2);
 
   // @todo Fix this using trajectory spreading
+  LinearInterpolation::TimeSegmentCursor cursor(primalSolution_.timeTrajectory_);
   auto interpolateProjectionMultiplierTrajectory = [&](scalar_t time) -> vector_t {
     const size_t numConstraints = ocpDefinition.equalityConstraintPtr->getNumConstraints(time);
-    const size_t index = LinearInterpolation::timeSegment(time, primalSolution_.timeTrajectory_).first;
+    const size_t index = cursor.seek(time).first;
     if (projectionMultiplierTrajectory_.size() > index + 1) {
       if (projectionMultiplierTrajectory_[index].size() == numConstraints &&
           projectionMultiplierTrajectory_[index].size() == projectionMultiplierTrajectory_[index + 1].size()) {
-        return LinearInterpolation::interpolate(time, primalSolution_.timeTrajectory_, projectionMultiplierTrajectory_);
+        return cursor.interpolate(projectionMultiplierTrajectory_);
       }
     }
     if (projectionMultiplierTrajectory_.size() > index) {
@@ -471,6 +504,8 @@ IpmSolver::OcpSubproblemSolution IpmSolver::getOCPSolution(const vector_t& delta
                                                            const vector_array_t& slackStateIneq, const vector_array_t& dualStateIneq,
                                                            const vector_array_t& slackStateInputIneq,
                                                            const vector_array_t& dualStateInputIneq) {
+  OCS2_TRACE_SCOPE("ipm", "solveQp");
+
   // Solve the QP
   OcpSubproblemSolution solution;
   auto& deltaXSol = solution.deltaXSol;
@@ -510,13 +545,11 @@ IpmSolver::OcpSubproblemSolution IpmSolver::getOCPSolution(const vector_t& delta
   scalar_array_t primalStepSizes(settings_.nThreads, 1.0);
   scalar_array_t dualStepSizes(settings_.nThreads, 1.0);
 
-  std::atomic_int timeIndex{0};
-  auto parallelTask = [&](int workerId) {
+  auto parallelTask = [&](int workerId, int i) {
     // Get worker specific resources
     vector_t tmp;  // 1 temporary for re-use for projection.
 
-    int i = timeIndex++;
-    while (i < N) {
+    if (i < N) {
       deltaSlackStateIneq[i] = ipm::retrieveSlackDirection(stateIneqConstraints_[i], deltaXSol[i], barrierParam, slackStateIneq[i]);
       deltaDualStateIneq[i] = ipm::retrieveDualDirection(barrierParam, slackStateIneq[i], dualStateIneq[i], deltaSlackStateIneq[i]);
       deltaSlackStateInputIneq[i] =
@@ -550,11 +583,7 @@ IpmSolver::OcpSubproblemSolution IpmSolver::getOCPSolution(const vector_t& delta
         deltaUSol[i] = tmp + constraintsProjection_[i].f;
         deltaUSol[i].noalias() += constraintsProjection_[i].dfdx * deltaXSol[i];
       }
-
-      i = timeIndex++;
-    }
-
-    if (i == N) {  // Only one worker will execute this
+    } else {  // Terminal node
       deltaSlackStateIneq[i] = ipm::retrieveSlackDirection(stateIneqConstraints_[i], deltaXSol[i], barrierParam, slackStateIneq[i]);
       deltaDualStateIneq[i] = ipm::retrieveDualDirection(barrierParam, slackStateIneq[i], dualStateIneq[i], deltaSlackStateIneq[i]);
       primalStepSizes[workerId] =
@@ -569,7 +598,7 @@ IpmSolver::OcpSubproblemSolution IpmSolver::getOCPSolution(const vector_t& delta
       }
     }
   };
-  runParallel(std::move(parallelTask));
+  parallelFor(0, N + 1, std::move(parallelTask));
 
   solution.maxPrimalStepSize = *std::min_element(primalStepSizes.begin(), primalStepSizes.end());
   solution.maxDualStepSize = *std::min_element(dualStepSizes.begin(), dualStepSizes.end());
@@ -591,6 +620,8 @@ void IpmSolver::extractValueFunction(const std::vector<AnnotatedTime>& time, con
 }
 
 PrimalSolution IpmSolver::toPrimalSolution(const std::vector<AnnotatedTime>& time, vector_array_t&& x, vector_array_t&& u) {
+  OCS2_TRACE_SCOPE("ipm", "computeController");
+
   if (settings_.useFeedbackPolicy) {
     ModeSchedule modeSchedule = this->getReferenceManager().getModeSchedule();
     matrix_array_t KMatrices = hpipmInterface_.getRiccatiFeedback(dynamics_[0], lagrangian_[0]);
@@ -608,6 +639,8 @@ PerformanceIndex IpmSolver::setupQuadraticSubproblem(const std::vector<Annotated
                                                      const vector_array_t& nu, scalar_t barrierParam, const vector_array_t& slackStateIneq,
                                                      const vector_array_t& slackStateInputIneq, const vector_array_t& dualStateIneq,
                                                      const vector_array_t& dualStateInputIneq, std::vector<Metrics>& metrics) {
+  OCS2_TRACE_SCOPE("ipm", "lqApproximation");
+
   // Problem horizon
   const int N = static_cast<int>(time.size()) - 1;
 
@@ -622,13 +655,13 @@ PerformanceIndex IpmSolver::setupQuadraticSubproblem(const std::vector<Annotated
   constraintsSize_.resize(N + 1);
   metrics.resize(N + 1);
 
-  std::atomic_int timeIndex{0};
-  auto parallelTask = [&](int workerId) {
+  auto parallelTask = [&](int workerId, int i) {
+    OCS2_TRACE_SCOPE_INDEX("ipm", "node", i);
+
     // Get worker specific resources
     OptimalControlProblem& ocpDefinition = ocpDefinitions_[workerId];
 
-    int i = timeIndex++;
-    while (i < N) {
+    if (i < N) {
       if (time[i].event == AnnotatedTime::Event::PreEvent) {
         // Event node
         auto result = multiple_shooting::setupEventNode(ocpDefinition, time[i].time, x[i], x[i + 1]);
@@ -687,11 +720,7 @@ PerformanceIndex IpmSolver::setupQuadraticSubproblem(const std::vector<Annotated
         performance[workerId].dualFeasibilitiesSSE +=
             ipm::evaluateComplementarySlackness(barrierParam, slackStateInputIneq[i], dualStateInputIneq[i]);
       }
-
-      i = timeIndex++;
-    }
-
-    if (i == N) {  // Only one worker will execute this
+    } else {  // Terminal node
       const scalar_t tN = getIntervalStart(time[N]);
       auto result = multiple_shooting::setupTerminalNode(ocpDefinition, tN, x[N]);
       metrics[i] = multiple_shooting::computeMetrics(result);
@@ -709,7 +738,7 @@ PerformanceIndex IpmSolver::setupQuadraticSubproblem(const std::vector<Annotated
       performance[workerId].dualFeasibilitiesSSE += ipm::evaluateComplementarySlackness(barrierParam, slackStateIneq[N], dualStateIneq[N]);
     }
   };
-  runParallel(std::move(parallelTask));
+  parallelFor(0, N + 1, std::move(parallelTask));
 
   // Account for initial state in performance
   const vector_t initDynamicsViolation = initState - x.front();
@@ -731,13 +760,11 @@ PerformanceIndex IpmSolver::computePerformance(const std::vector<AnnotatedTime>&
   metrics.resize(N + 1);
 
   std::vector<PerformanceIndex> performance(settings_.nThreads, PerformanceIndex());
-  std::atomic_int timeIndex{0};
-  auto parallelTask = [&](int workerId) {
+  auto parallelTask = [&](int workerId, int i) {
     // Get worker specific resources
     OptimalControlProblem& ocpDefinition = ocpDefinitions_[workerId];
 
-    int i = timeIndex++;
-    while (i < N) {
+    if (i < N) {
       if (time[i].event == AnnotatedTime::Event::PreEvent) {
         // Event node
         metrics[i] = multiple_shooting::computeEventMetrics(ocpDefinition, time[i].time, x[i], x[i + 1]);
@@ -754,17 +781,13 @@ PerformanceIndex IpmSolver::computePerformance(const std::vector<AnnotatedTime>&
         }
         performance[workerId] += ipm::toPerformanceIndex(metrics[i], dt, barrierParam, slackStateIneq[i], slackStateInputIneq[i]);
       }
-
-      i = timeIndex++;
-    }
-
-    if (i == N) {  // Only one worker will execute this
+    } else {  // Terminal node
       const scalar_t tN = getIntervalStart(time[N]);
       metrics[N] = multiple_shooting::computeTerminalMetrics(ocpDefinition, tN, x[N]);
       performance[workerId] += ipm::toPerformanceIndex(metrics[N], barrierParam, slackStateIneq[N]);
     }
   };
-  runParallel(std::move(parallelTask));
+  parallelFor(0, N + 1, std::move(parallelTask));
 
   // Account for initial state in performance
   const vector_t initDynamicsViolation = initState - x.front();
@@ -781,6 +804,7 @@ ipm::StepInfo IpmSolver::takePrimalStep(const PerformanceIndex& baseline, const
                                         const vector_t& initState, const OcpSubproblemSolution& subproblemSolution, vector_array_t& x,
                                         vector_array_t& u, scalar_t barrierParam, vector_array_t& slackStateIneq,
                                         vector_array_t& slackStateInputIneq, std::vector<Metrics>& metrics) {
+  OCS2_TRACE_SCOPE("ipm", "linesearch");
   using StepType = FilterLinesearch::StepType;
 
   /*
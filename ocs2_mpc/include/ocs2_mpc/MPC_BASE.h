@@ -67,6 +67,21 @@ class MPC_BASE {
    */
   virtual bool run(scalar_t currentTime, const vector_t& currentState);
 
+  /**
+   * Prepares the next call to run(), e.g. the preparation phase of a real-time iteration scheme. The MPC interfaces call this once the
+   * policy of the last run() is published, such that the preparation does not add to the feedback latency of the next run().
+   *
+   * @param [in] lastRunTime: The time of the last call to run(). The next call is expected one MPC period later, or one run duration
+   * later if the MPC frequency is not limited.
+   */
+  void prepareNextRun(scalar_t lastRunTime);
+
+  /** Benchmark of run(), i.e. the feedback latency from the measured state to the updated policy. */
+  const benchmark::RepeatedTimer& getRunTimer() const { return mpcTimer_; }
+
+  /** Benchmark of prepareNextRun(). */
+  const benchmark::RepeatedTimer& getPreparationTimer() const { return preparationTimer_; }
+
   /** Gets a pointer to the underlying solver used in the MPC. */
   virtual SolverBase* getSolverPtr() = 0;
 
@@ -89,6 +104,14 @@ class MPC_BASE {
    */
   virtual void calculateController(scalar_t initTime, const vector_t& initState, scalar_t finalTime) = 0;
 
+  /**
+   * Prepares the solver for the next problem before its initial state is known. The default implementation does nothing.
+   *
+   * @param [in] initTime: The expected initial time of the next problem.
+   * @param [in] finalTime: The expected final time of the next problem.
+   */
+  virtual void prepareController(scalar_t initTime, scalar_t finalTime) {}
+
   /** Whether this is the first iteration of MPC or not. */
   bool isFirstMpcRun() const { return initRun_; }
 
@@ -97,6 +120,7 @@ class MPC_BASE {
   const mpc::Settings mpcSettings_;
 
   benchmark::RepeatedTimer mpcTimer_;
+  benchmark::RepeatedTimer preparationTimer_;
 };
 
 }  // namespace ocs2
@@ -31,8 +31,11 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <Eigen/Dense>
 
+#include <array>
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <mutex>
 
@@ -54,6 +57,10 @@ namespace ocs2 {
 /**
  * This class implements core MRT (Model Reference Tracking) functionality.
  * The responsibility of filling the buffer variables is left to the deriving classes.
+ *
+ * The policies are exchanged through a triple buffer: the MRT thread owns the active policy, the MPC thread owns the policy being
+ * filled, and the latest published policy waits in between. The buffers are swapped by an atomic exchange of their indices, such that
+ * updatePolicy() never blocks on the MPC thread and the buffers are reused without reallocation.
  */
 class MRT_BASE {
  public:
@@ -63,6 +70,7 @@ class MRT_BASE {
 
   /**
    * Resets the class to its instantiated state.
+   * @note This method should not be called concurrently with updatePolicy().
    */
   void reset();
 
@@ -116,6 +124,9 @@ class MRT_BASE {
 
   /**
    * @brief Evaluates the controller
+   * This method is real-time safe: it does not allocate memory once the outputs have the correct size, e.g. after the first call with
+   * the same output vectors. The lookups in the policy start at the result of the previous query, such that consecutive calls with
+   * increasing time take constant time.
    *
    * @param [in] currentTime: the query time.
    * @param [in] currentState: the query state.
@@ -127,6 +138,7 @@ class MRT_BASE {
 
   /**
    * @brief Rolls out the control policy from the current time and state to get the next state and input using the MPC policy.
+   * @note This method allocates memory for the rollout trajectories.
    *
    * @param [in] currentTime: start time of the rollout.
    * @param [in] currentState: state to start rollout from.
@@ -141,7 +153,7 @@ class MRT_BASE {
   /**
    * Checks the data buffer for an update of the MPC policy. If a new policy
    * is available on the buffer this method will load it to the in-use policy.
-   * This method also calls the modifyActiveSolution() method.
+   * This method also calls the modifyActiveSolution() method. It is wait-free.
    *
    * @return True if the policy is updated.
    */
@@ -159,32 +171,50 @@ class MRT_BASE {
   void addMrtObserver(std::shared_ptr<MrtObserver> mrtObserver) { observerPtrArray_.push_back(std::move(mrtObserver)); };
 
  protected:
+  /**
+   * Moves the given policy into the buffer. The previous content of the buffer is destroyed in the calling thread.
+   */
   void moveToBuffer(std::unique_ptr<CommandData> commandDataPtr, std::unique_ptr<PrimalSolution> primalSolutionPtr,
                     std::unique_ptr<PerformanceIndex> performanceIndicesPtr);
 
+  /**
+   * Fills the buffer in place and publishes it. The buffer holds an outdated policy whose memory can be reused.
+   *
+   * @param [in] fillFunction: Callback which fills the command, the policy, and the performance indices of the buffer.
+   */
+  void fillBuffer(const std::function<void(CommandData&, PrimalSolution&, PerformanceIndex&)>& fillFunction);
+
  private:
-  /** Calls modifyActiveSolution on all mrt observers. This function is called while holding a policyBufferMutex lock */
+  struct PolicyBuffer {
+    CommandData command;
+    PrimalSolution primalSolution;
+    PerformanceIndex performanceIndices;
+  };
+
+  /** Calls modifyActiveSolution on all mrt observers. This function is called from updatePolicy() */
   void modifyActiveSolution(const CommandData& command, PrimalSolution& primalSolution);
 
-  /** Calls modifyBufferedSolution on all mrt observers. This function is called while holding a policyBufferMutex lock */
+  /** Calls modifyBufferedSolution on all mrt observers. This function is called before publishing a buffer while holding bufferMutex_ */
   void modifyBufferedSolution(const CommandData& commandBuffer, PrimalSolution& primalSolutionBuffer);
 
   // flags on state of the class
   std::atomic_bool policyReceivedEver_;
-  bool newPolicyInBuffer_;  // whether a new policy is waiting to be swapped in
+  bool activePolicyValid_;  // whether the active buffer contains a policy
+
+  // triple buffer of the MPC output
+  static constexpr uint8_t bufferIndexMask_ = 0x3;
+  static constexpr uint8_t newPolicyFlag_ = 0x4;  // whether the published buffer has not been swapped in yet
+  std::array<PolicyBuffer, 3> policyBuffers_;
+  uint8_t activeIndex_;                  // owned by updatePolicy()
+  uint8_t backIndex_;                    // owned by the thread filling the buffer
+  std::atomic<uint8_t> publishedIndex_;  // index of the latest published buffer and newPolicyFlag_
 
-  // variables related to the MPC output
-  std::unique_ptr<CommandData> activeCommandPtr_;
-  std::unique_ptr<CommandData> bufferCommandPtr_;
-  std::unique_ptr<PrimalSolution> activePrimalSolutionPtr_;
-  std::unique_ptr<PrimalSolution> bufferPrimalSolutionPtr_;
-  std::unique_ptr<PerformanceIndex> activePerformanceIndicesPtr_;
-  std::unique_ptr<PerformanceIndex> bufferPerformanceIndicesPtr_;
+  // lookup hints of evaluatePolicy() in the active policy
+  int stateTimeIndexHint_;
+  int controllerTimeIndexHint_;
 
   // thread safety
-  mutable std::mutex bufferMutex_;  // for policy variables with the prefix (buffer*)
-  const size_t mrtTrylockWarningThreshold_ = 5;
-  size_t mrtTrylockWarningCount_;
+  std::mutex bufferMutex_;  // serializes the threads filling the buffer, updatePolicy() never takes it
 
   // variables needed for policy evaluation
   std::unique_ptr<RolloutBase> rolloutPtr_;
@@ -44,6 +44,7 @@ MPC_BASE::MPC_BASE(mpc::Settings mpcSettings) : mpcSettings_(std::move(mpcSettin
 void MPC_BASE::reset() {
   initRun_ = true;
   mpcTimer_.reset();
+  preparationTimer_.reset();
   getSolverPtr()->reset();
 }
 
@@ -68,18 +69,18 @@ bool MPC_BASE::run(scalar_t currentTime, const vector_t& currentState) {
     std::cerr << "\n### MPC is called at time:  " << currentTime << " [s].";
     std::cerr << "\n### MPC final Time:         " << finalTime << " [s].";
     std::cerr << "\n### MPC time horizon:       " << mpcSettings_.timeHorizon_ << " [s].\n";
-    mpcTimer_.startTimer();
   }
+  mpcTimer_.startTimer();
 
   // calculate the MPC policy
   calculateController(currentTime, currentState, finalTime);
 
   // set initRun flag to false
   initRun_ = false;
+  mpcTimer_.endTimer();
 
   // display
   if (mpcSettings_.debugPrint_) {
-    mpcTimer_.endTimer();
     std::cerr << "\n### MPC Benchmarking";
     std::cerr << "\n###   Maximum : " << mpcTimer_.getMaxIntervalInMilliseconds() << "[ms].";
     std::cerr << "\n###   Average : " << mpcTimer_.getAverageInMilliseconds() << "[ms].";
@@ -89,4 +90,26 @@ bool MPC_BASE::run(scalar_t currentTime, const vector_t& currentState) {
   return true;
 }
 
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void MPC_BASE::prepareNextRun(scalar_t lastRunTime) {
+  if (initRun_) {
+    return;
+  }
+
+  const scalar_t nextTime = (mpcSettings_.mpcDesiredFrequency_ > 0.0) ? lastRunTime + 1.0 / mpcSettings_.mpcDesiredFrequency_
+                                                                      : lastRunTime + 1e-3 * mpcTimer_.getLastIntervalInMilliseconds();
+  preparationTimer_.startTimer();
+  prepareController(nextTime, nextTime + mpcSettings_.timeHorizon_);
+  preparationTimer_.endTimer();
+
+  if (mpcSettings_.debugPrint_) {
+    std::cerr << "\n### MPC Preparation";
+    std::cerr << "\n###   Maximum : " << preparationTimer_.getMaxIntervalInMilliseconds() << "[ms].";
+    std::cerr << "\n###   Average : " << preparationTimer_.getAverageInMilliseconds() << "[ms].";
+    std::cerr << "\n###   Latest  : " << preparationTimer_.getLastIntervalInMilliseconds() << "[ms]." << std::endl;
+  }
+}
+
 }  // namespace ocs2
@@ -110,29 +110,31 @@ void MPC_MRT_Interface::advanceMpc() {
     std::cerr << "\n###   Average : " << mpcTimer_.getAverageInMilliseconds() << "[ms].";
     std::cerr << "\n###   Latest  : " << mpcTimer_.getLastIntervalInMilliseconds() << "[ms]." << std::endl;
   }
+
+  // prepare the next run once the policy is available to the MRT
+  mpc_.prepareNextRun(currentObservation.time);
 }
 
 /******************************************************************************************************/
 /******************************************************************************************************/
 /******************************************************************************************************/
 void MPC_MRT_Interface::copyToBuffer(const SystemObservation& mpcInitObservation) {
-  // policy
-  auto primalSolutionPtr = std::make_unique<PrimalSolution>();
   const scalar_t startTime = mpcInitObservation.time;
   const scalar_t finalTime =
       (mpc_.settings().solutionTimeWindow_ < 0) ? mpc_.getSolverPtr()->getFinalTime() : startTime + mpc_.settings().solutionTimeWindow_;
-  mpc_.getSolverPtr()->getPrimalSolution(finalTime, primalSolutionPtr.get());
 
-  // command
-  auto commandPtr = std::make_unique<CommandData>();
-  commandPtr->mpcInitObservation_ = mpcInitObservation;
-  commandPtr->mpcTargetTrajectories_ = mpc_.getSolverPtr()->getReferenceManager().getTargetTrajectories();
+  // fill the buffer in place to reuse the memory of an outdated policy
+  this->fillBuffer([&](CommandData& command, PrimalSolution& primalSolution, PerformanceIndex& performanceIndices) {
+    // policy
+    mpc_.getSolverPtr()->getPrimalSolution(finalTime, &primalSolution);
 
-  // performance indices
-  auto performanceIndicesPtr = std::make_unique<PerformanceIndex>();
-  *performanceIndicesPtr = mpc_.getSolverPtr()->getPerformanceIndeces();
+    // command
+    command.mpcInitObservation_ = mpcInitObservation;
+    command.mpcTargetTrajectories_ = mpc_.getSolverPtr()->getReferenceManager().getTargetTrajectories();
 
-  this->moveToBuffer(std::move(commandPtr), std::move(primalSolutionPtr), std::move(performanceIndicesPtr));
+    // performance indices
+    performanceIndices = mpc_.getSolverPtr()->getPerformanceIndeces();
+  });
 }
 
 /******************************************************************************************************/
@@ -47,23 +47,26 @@ void MRT_BASE::reset() {
   std::lock_guard<std::mutex> lock(bufferMutex_);
 
   policyReceivedEver_ = false;
-  newPolicyInBuffer_ = false;
-  mrtTrylockWarningCount_ = 0;
-
-  activeCommandPtr_.reset();
-  bufferCommandPtr_.reset();
-  activePrimalSolutionPtr_.reset();
-  bufferPrimalSolutionPtr_.reset();
-  activePerformanceIndicesPtr_.reset();
-  bufferPerformanceIndicesPtr_.reset();
+  activePolicyValid_ = false;
+  stateTimeIndexHint_ = 0;
+  controllerTimeIndexHint_ = 0;
+
+  for (auto& buffer : policyBuffers_) {
+    buffer.command = CommandData();
+    buffer.primalSolution = PrimalSolution();
+    buffer.performanceIndices = PerformanceIndex();
+  }
+  activeIndex_ = 0;
+  publishedIndex_.store(1, std::memory_order_release);
+  backIndex_ = 2;
 }
 
 /******************************************************************************************************/
 /******************************************************************************************************/
 /******************************************************************************************************/
 const CommandData& MRT_BASE::getCommand() const {
-  if (activeCommandPtr_ != nullptr) {
-    return *activeCommandPtr_;
+  if (activePolicyValid_) {
+    return policyBuffers_[activeIndex_].command;
   } else {
     throw std::runtime_error("[MRT_BASE::getCommand] updatePolicy() should be called first!");
   }
@@ -73,8 +76,8 @@ const CommandData& MRT_BASE::getCommand() const {
 /******************************************************************************************************/
 /******************************************************************************************************/
 const PrimalSolution& MRT_BASE::getPolicy() const {
-  if (activePrimalSolutionPtr_ != nullptr) {
-    return *activePrimalSolutionPtr_;
+  if (activePolicyValid_) {
+    return policyBuffers_[activeIndex_].primalSolution;
   } else {
     throw std::runtime_error("[MRT_BASE::getPolicy] updatePolicy() should be called first!");
   }
@@ -84,8 +87,8 @@ const PrimalSolution& MRT_BASE::getPolicy() const {
 /******************************************************************************************************/
 /******************************************************************************************************/
 const PerformanceIndex& MRT_BASE::getPerformanceIndices() const {
-  if (activePerformanceIndicesPtr_ != nullptr) {
-    return *activePerformanceIndicesPtr_;
+  if (activePolicyValid_) {
+    return policyBuffers_[activeIndex_].performanceIndices;
   } else {
     throw std::runtime_error("[MRT_BASE::getPerformanceIndices] updatePolicy() should be called first!");
   }
@@ -102,20 +105,21 @@ void MRT_BASE::initRollout(const RolloutBase* rolloutPtr) {
 /******************************************************************************************************/
 /******************************************************************************************************/
 void MRT_BASE::evaluatePolicy(scalar_t currentTime, const vector_t& currentState, vector_t& mpcState, vector_t& mpcInput, size_t& mode) {
-  if (activePrimalSolutionPtr_ == nullptr) {
+  if (!activePolicyValid_) {
     throw std::runtime_error("[MRT_BASE::evaluatePolicy] updatePolicy() should be called first!");
   }
+  const auto& activePrimalSolution = policyBuffers_[activeIndex_].primalSolution;
 
-  if (currentTime > activePrimalSolutionPtr_->timeTrajectory_.back()) {
+  if (currentTime > activePrimalSolution.timeTrajectory_.back()) {
     std::cerr << "The requested currentTime is greater than the received plan: " << std::to_string(currentTime) << ">"
-              << std::to_string(activePrimalSolutionPtr_->timeTrajectory_.back()) << "\n";
+              << std::to_string(activePrimalSolution.timeTrajectory_.back()) << "\n";
   }
 
-  mpcInput = activePrimalSolutionPtr_->controllerPtr_->computeInput(currentTime, currentState);
-  mpcState =
-      LinearInterpolation::interpolate(currentTime, activePrimalSolutionPtr_->timeTrajectory_, activePrimalSolutionPtr_->stateTrajectory_);
+  activePrimalSolution.controllerPtr_->computeInputRealTime(currentTime, currentState, mpcInput, controllerTimeIndexHint_);
+  const auto indexAlpha = LinearInterpolation::timeSegment(currentTime, activePrimalSolution.timeTrajectory_, stateTimeIndexHint_);
+  LinearInterpolation::interpolateInto(indexAlpha, activePrimalSolution.stateTrajectory_, mpcState);
 
-  mode = activePrimalSolutionPtr_->modeSchedule_.modeAtTime(currentTime);
+  mode = activePrimalSolution.modeSchedule_.modeAtTime(currentTime);
 }
 
 /******************************************************************************************************/
@@ -127,13 +131,14 @@ void MRT_BASE::rolloutPolicy(scalar_t currentTime, const vector_t& currentState,
     throw std::runtime_error("[MRT_BASE::rolloutPolicy] rollout class is not set! Use initRollout() to initialize it!");
   }
 
-  if (activePrimalSolutionPtr_ == nullptr) {
+  if (!activePolicyValid_) {
     throw std::runtime_error("[MRT_BASE::rolloutPolicy] updatePolicy() should be called first!");
   }
+  auto& activePrimalSolution = policyBuffers_[activeIndex_].primalSolution;
 
-  if (currentTime > activePrimalSolutionPtr_->timeTrajectory_.back()) {
+  if (currentTime > activePrimalSolution.timeTrajectory_.back()) {
     std::cerr << "The requested currentTime is greater than the received plan: " << std::to_string(currentTime) << ">"
-              << std::to_string(activePrimalSolutionPtr_->timeTrajectory_.back()) << "\n";
+              << std::to_string(activePrimalSolution.timeTrajectory_.back()) << "\n";
   }
 
   // perform a rollout
@@ -141,42 +146,32 @@ void MRT_BASE::rolloutPolicy(scalar_t currentTime, const vector_t& currentState,
   size_array_t postEventIndicesStock;
   vector_array_t stateTrajectory, inputTrajectory;
   const scalar_t finalTime = currentTime + timeStep;
-  rolloutPtr_->run(currentTime, currentState, finalTime, activePrimalSolutionPtr_->controllerPtr_.get(),
-                   activePrimalSolutionPtr_->modeSchedule_, timeTrajectory, postEventIndicesStock, stateTrajectory, inputTrajectory);
+  rolloutPtr_->run(currentTime, currentState, finalTime, activePrimalSolution.controllerPtr_.get(),
+                   activePrimalSolution.modeSchedule_, timeTrajectory, postEventIndicesStock, stateTrajectory, inputTrajectory);
 
   mpcState = stateTrajectory.back();
   mpcInput = inputTrajectory.back();
 
-  mode = activePrimalSolutionPtr_->modeSchedule_.modeAtTime(finalTime);
+  mode = activePrimalSolution.modeSchedule_.modeAtTime(finalTime);
 }
 
 /******************************************************************************************************/
 /******************************************************************************************************/
 /******************************************************************************************************/
 bool MRT_BASE::updatePolicy() {
-  std::unique_lock<std::mutex> lock(bufferMutex_, std::try_to_lock);
-  if (lock.owns_lock()) {
-    mrtTrylockWarningCount_ = 0;
-    if (newPolicyInBuffer_) {
-      // update the active solution from buffer
-      activeCommandPtr_.swap(bufferCommandPtr_);
-      activePrimalSolutionPtr_.swap(bufferPrimalSolutionPtr_);
-      activePerformanceIndicesPtr_.swap(bufferPerformanceIndicesPtr_);
-      newPolicyInBuffer_ = false;  // make sure we don't swap in the old policy again
-
-      modifyActiveSolution(*activeCommandPtr_, *activePrimalSolutionPtr_);
-      return true;
-    } else {
-      return false;  // No policy update: the buffer contains nothing new.
-    }
-  } else {
-    ++mrtTrylockWarningCount_;
-    if (mrtTrylockWarningCount_ > mrtTrylockWarningThreshold_) {
-      std::cerr << "[MRT_BASE::updatePolicy] failed to lock the policyBufferMutex for " << mrtTrylockWarningCount_
-                << " consecutive times.\n";
-    }
-    return false;  // No policy update: the lock could not be acquired.
+  if ((publishedIndex_.load(std::memory_order_relaxed) & newPolicyFlag_) == 0) {
+    return false;  // No policy update: the buffer contains nothing new.
   }
+
+  // swap the active buffer with the latest published one, which clears the newPolicyFlag_
+  activeIndex_ = publishedIndex_.exchange(activeIndex_, std::memory_order_acq_rel) & bufferIndexMask_;
+  activePolicyValid_ = true;
+  stateTimeIndexHint_ = 0;
+  controllerTimeIndexHint_ = 0;
+
+  auto& activeBuffer = policyBuffers_[activeIndex_];
+  modifyActiveSolution(activeBuffer.command, activeBuffer.primalSolution);
+  return true;
 }
 
 /******************************************************************************************************/
@@ -196,16 +191,28 @@ void MRT_BASE::moveToBuffer(std::unique_ptr<CommandData> commandDataPtr, std::un
     throw std::runtime_error("[MRT_BASE::moveToBuffer] performanceIndicesPtr cannot be a null pointer!");
   }
 
-  std::lock_guard<std::mutex> lk(bufferMutex_);
   // use swap such that the old objects are destroyed after releasing the lock.
-  bufferCommandPtr_.swap(commandDataPtr);
-  bufferPrimalSolutionPtr_.swap(primalSolutionPtr);
-  bufferPerformanceIndicesPtr_.swap(performanceIndicesPtr);
+  fillBuffer([&](CommandData& command, PrimalSolution& primalSolution, PerformanceIndex& performanceIndices) {
+    std::swap(command, *commandDataPtr);
+    primalSolution.swap(*primalSolutionPtr);
+    std::swap(performanceIndices, *performanceIndicesPtr);
+  });
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void MRT_BASE::fillBuffer(const std::function<void(CommandData&, PrimalSolution&, PerformanceIndex&)>& fillFunction) {
+  std::lock_guard<std::mutex> lock(bufferMutex_);
+  auto& backBuffer = policyBuffers_[backIndex_];
+  fillFunction(backBuffer.command, backBuffer.primalSolution, backBuffer.performanceIndices);
 
   // allow user to modify the buffer
-  modifyBufferedSolution(*bufferCommandPtr_, *bufferPrimalSolutionPtr_);
+  modifyBufferedSolution(backBuffer.command, backBuffer.primalSolution);
 
-  newPolicyInBuffer_ = true;
+  // publish the buffer and take over the previously published one, which is either outdated or has been released by updatePolicy()
+  const uint8_t publishedIndex = publishedIndex_.exchange(backIndex_ | newPolicyFlag_, std::memory_order_acq_rel);
+  backIndex_ = publishedIndex & bufferIndexMask_;
   policyReceivedEver_ = true;
 }
 
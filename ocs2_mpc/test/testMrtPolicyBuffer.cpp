@@ -0,0 +1,173 @@
+/******************************************************************************
+Copyright (c) 2020, Farbod Farshidian. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include <ocs2_core/control/LinearController.h>
+#include <ocs2_core/test/MallocHook.h>
+
+#include "ocs2_mpc/MRT_BASE.h"
+
+using namespace ocs2;
+
+namespace {
+
+constexpr size_t stateDim = 12;
+constexpr size_t inputDim = 12;
+constexpr size_t numNodes = 200;
+
+/** MRT which receives the policies through moveToBuffer */
+class TestMrt final : public MRT_BASE {
+ public:
+  void resetMpcNode(const TargetTrajectories& initTargetTrajectories) override {}
+  void setCurrentObservation(const SystemObservation& observation) override {}
+
+  /** Publishes a policy in which all fields are tagged with the given id */
+  void publishPolicy(size_t id) {
+    const auto value = static_cast<scalar_t>(id);
+    const scalar_t dt = 0.01;
+
+    auto primalSolutionPtr = std::make_unique<PrimalSolution>();
+    for (size_t k = 0; k < numNodes; k++) {
+      primalSolutionPtr->timeTrajectory_.push_back(value + k * dt);
+      primalSolutionPtr->stateTrajectory_.push_back(vector_t::Constant(stateDim, value));
+      primalSolutionPtr->inputTrajectory_.push_back(vector_t::Constant(inputDim, value));
+    }
+    primalSolutionPtr->controllerPtr_.reset(new LinearController(primalSolutionPtr->timeTrajectory_, primalSolutionPtr->inputTrajectory_,
+                                                                 matrix_array_t(numNodes, matrix_t::Zero(inputDim, stateDim))));
+
+    auto commandPtr = std::make_unique<CommandData>();
+    commandPtr->mpcInitObservation_.time = value;
+
+    auto performanceIndicesPtr = std::make_unique<PerformanceIndex>();
+    performanceIndicesPtr->cost = value;
+
+    this->moveToBuffer(std::move(commandPtr), std::move(primalSolutionPtr), std::move(performanceIndicesPtr));
+  }
+};
+
+}  // unnamed namespace
+
+TEST(testMrtPolicyBuffer, updatePolicy) {
+  TestMrt mrt;
+  ASSERT_FALSE(mrt.initialPolicyReceived());
+  ASSERT_FALSE(mrt.updatePolicy());
+  ASSERT_ANY_THROW(mrt.getPolicy());
+
+  mrt.publishPolicy(1);
+  mrt.publishPolicy(2);
+  ASSERT_TRUE(mrt.initialPolicyReceived());
+  ASSERT_TRUE(mrt.updatePolicy());
+  ASSERT_FALSE(mrt.updatePolicy());
+  EXPECT_DOUBLE_EQ(mrt.getCommand().mpcInitObservation_.time, 2.0);
+  EXPECT_DOUBLE_EQ(mrt.getPolicy().timeTrajectory_.front(), 2.0);
+  EXPECT_DOUBLE_EQ(mrt.getPerformanceIndices().cost, 2.0);
+
+  mrt.publishPolicy(3);
+  ASSERT_TRUE(mrt.updatePolicy());
+  EXPECT_DOUBLE_EQ(mrt.getPolicy().timeTrajectory_.front(), 3.0);
+
+  mrt.reset();
+  ASSERT_FALSE(mrt.initialPolicyReceived());
+  ASSERT_FALSE(mrt.updatePolicy());
+  ASSERT_ANY_THROW(mrt.getCommand());
+}
+
+TEST(testMrtPolicyBuffer, evaluatePolicyAllocationFree) {
+  TestMrt mrt;
+  mrt.publishPolicy(1);
+  ASSERT_TRUE(mrt.updatePolicy());
+
+  const vector_t x = vector_t::Random(stateDim);
+  vector_t mpcState, mpcInput;
+  size_t mode;
+  mrt.evaluatePolicy(1.0, x, mpcState, mpcInput, mode);  // sizes the outputs
+
+  const size_t numAllocations = malloc_hook::countAllocations([&]() {
+    for (scalar_t t = 1.0; t < 2.9; t += 0.0025) {
+      mrt.evaluatePolicy(t, x, mpcState, mpcInput, mode);
+    }
+    mrt.evaluatePolicy(1.5, x, mpcState, mpcInput, mode);
+  });
+  EXPECT_EQ(numAllocations, 0);
+  EXPECT_TRUE(mpcState.isApproxToConstant(1.0));
+  EXPECT_TRUE(mpcInput.isApproxToConstant(1.0));
+}
+
+TEST(testMrtPolicyBuffer, stressTest) {
+  TestMrt mrt;
+  mrt.publishPolicy(0);
+
+  // MPC thread: publishes policies as fast as possible
+  std::atomic_bool stop{false};
+  std::atomic<size_t> numPublished{1};
+  std::thread mpcThread([&]() {
+    while (!stop) {
+      mrt.publishPolicy(numPublished);
+      ++numPublished;
+    }
+  });
+
+  // MRT thread: updates and evaluates the policy in a loop
+  size_t numUpdates = 0;
+  size_t numEvaluations = 0;
+  scalar_t lastId = -1.0;
+  vector_t mpcState, mpcInput;
+  size_t mode;
+  const auto endTime = std::chrono::steady_clock::now() + std::chrono::milliseconds(500);
+  while (std::chrono::steady_clock::now() < endTime) {
+    const size_t numPublishedBeforeUpdate = numPublished;
+    numUpdates += mrt.updatePolicy() ? 1 : 0;
+    const scalar_t id = mrt.getCommand().mpcInitObservation_.time;
+    mrt.evaluatePolicy(id, vector_t::Zero(stateDim), mpcState, mpcInput, mode);
+    ++numEvaluations;
+
+    // The update is never skipped: at least the last policy that was published before the update is active
+    ASSERT_GE(id, static_cast<scalar_t>(numPublishedBeforeUpdate - 1));
+
+    // The policy is consistent and never moves backwards
+    ASSERT_GE(id, lastId);
+    ASSERT_DOUBLE_EQ(mrt.getPolicy().timeTrajectory_.front(), id);
+    ASSERT_DOUBLE_EQ(mrt.getPerformanceIndices().cost, id);
+    ASSERT_TRUE(mpcState.isApproxToConstant(id));
+    ASSERT_TRUE(mpcInput.isApproxToConstant(id));
+    lastId = id;
+  }
+  stop = true;
+  mpcThread.join();
+
+  EXPECT_GT(numUpdates, 0);
+  std::cerr << "[testMrtPolicyBuffer] policies published: " << numPublished << ", policy updates: " << numUpdates
+            << ", evaluations: " << numEvaluations << "\n";
+}
@@ -31,6 +31,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <ocs2_ballbot/BallbotInterface.h>
 #include <ocs2_mpcnet_core/MpcnetInterfaceBase.h>
+#include <ocs2_mpcnet_core/control/MpcnetOnnxController.h>
 
 namespace ocs2 {
 namespace ballbot {
@@ -45,8 +46,10 @@ class BallbotMpcnetInterface final : public ocs2::mpcnet::MpcnetInterfaceBase {
    * @param [in] nDataGenerationThreads : Number of data generation threads.
    * @param [in] nPolicyEvaluationThreads : Number of policy evaluation threads.
    * @param [in] raisim : Whether to use RaiSim for the rollouts.
+   * @param [in] batchDataGeneration : Whether to solve the MPC problems of all data generation tasks with one SQP batch solver, which
+   *                                   uses nDataGenerationThreads threads.
    */
-  BallbotMpcnetInterface(size_t nDataGenerationThreads, size_t nPolicyEvaluationThreads, bool raisim);
+  BallbotMpcnetInterface(size_t nDataGenerationThreads, size_t nPolicyEvaluationThreads, bool raisim, bool batchDataGeneration);
 
   /**
    * Default destructor.
@@ -60,6 +63,18 @@ class BallbotMpcnetInterface final : public ocs2::mpcnet::MpcnetInterfaceBase {
    * @return Pointer to the MPC.
    */
   std::unique_ptr<MPC_BASE> getMpc(BallbotInterface& ballbotInterface);
+
+  /**
+   * Helper to get the batch data generation.
+   * @param [in] ballbotInterface : The ballbot interface, its reference manager is used by the batch data generation.
+   * @param [in] nThreads : Number of threads of the batch solver.
+   * @param [in] rolloutPtr : Pointer to the rollout to be used.
+   * @param [in] onnxEnvironmentPtr : Pointer to the ONNX environment.
+   * @return Pointer to the batch data generation.
+   */
+  std::unique_ptr<ocs2::mpcnet::MpcnetBatchDataGeneration> getBatchDataGeneration(BallbotInterface& ballbotInterface, size_t nThreads,
+                                                                                  std::unique_ptr<RolloutBase> rolloutPtr,
+                                                                                  std::shared_ptr<Ort::Env> onnxEnvironmentPtr);
 };
 
 }  // namespace ballbot
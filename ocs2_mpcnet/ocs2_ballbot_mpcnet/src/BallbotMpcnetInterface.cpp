@@ -41,7 +41,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 namespace ocs2 {
 namespace ballbot {
 
-BallbotMpcnetInterface::BallbotMpcnetInterface(size_t nDataGenerationThreads, size_t nPolicyEvaluationThreads, bool raisim) {
+BallbotMpcnetInterface::BallbotMpcnetInterface(size_t nDataGenerationThreads, size_t nPolicyEvaluationThreads, bool raisim,
+                                               bool batchDataGeneration) {
   // create ONNX environment
   auto onnxEnvironmentPtr = ocs2::mpcnet::createOnnxEnvironment();
   // path to config file
@@ -76,6 +77,13 @@ BallbotMpcnetInterface::BallbotMpcnetInterface(size_t nDataGenerationThreads, si
   mpcnetRolloutManagerPtr_.reset(new ocs2::mpcnet::MpcnetRolloutManager(nDataGenerationThreads, nPolicyEvaluationThreads,
                                                                         std::move(mpcPtrs), std::move(mpcnetPtrs), std::move(rolloutPtrs),
                                                                         mpcnetDefinitionPtrs, referenceManagerPtrs));
+  // set up MPC-Net batch data generation, which replaces the data generation threads
+  if (batchDataGeneration) {
+    BallbotInterface ballbotInterface(taskFile, libraryFolder);
+    std::unique_ptr<RolloutBase> rolloutPtr(ballbotInterface.getRollout().clone());
+    mpcnetRolloutManagerPtr_->setBatchDataGeneration(
+        getBatchDataGeneration(ballbotInterface, nDataGenerationThreads, std::move(rolloutPtr), onnxEnvironmentPtr));
+  }
 }
 
 /******************************************************************************************************/
@@ -107,5 +115,33 @@ std::unique_ptr<MPC_BASE> BallbotMpcnetInterface::getMpc(BallbotInterface& ballb
   return mpcPtr;
 }
 
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+std::unique_ptr<ocs2::mpcnet::MpcnetBatchDataGeneration> BallbotMpcnetInterface::getBatchDataGeneration(
+    BallbotInterface& ballbotInterface, size_t nThreads, std::unique_ptr<RolloutBase> rolloutPtr,
+    std::shared_ptr<Ort::Env> onnxEnvironmentPtr) {
+  // ensure SQP settings are as needed for MPC-Net
+  const auto sqpSettings = [&]() {
+    auto settings = ballbotInterface.sqpSettings();
+    settings.nThreads = nThreads;
+    settings.useFeedbackPolicy = true;
+    settings.createValueFunction = true;
+    settings.printSolverStatus = false;
+    settings.printSolverStatistics = false;
+    settings.printLinesearch = false;
+    return settings;
+  }();
+  // create one batch solver for all data generation tasks
+  auto solverPtr =
+      std::make_unique<SqpBatchSolver>(sqpSettings, ballbotInterface.getOptimalControlProblem(), ballbotInterface.getInitializer());
+  auto mpcnetDefinitionPtr = std::make_shared<BallbotMpcnetDefinition>();
+  auto mpcnetPtr = std::make_unique<ocs2::mpcnet::MpcnetOnnxController>(mpcnetDefinitionPtr, ballbotInterface.getReferenceManagerPtr(),
+                                                                         std::move(onnxEnvironmentPtr));
+  return std::make_unique<ocs2::mpcnet::MpcnetBatchDataGeneration>(std::move(solverPtr), ballbotInterface.mpcSettings().timeHorizon_,
+                                                                   std::move(mpcnetPtr), std::move(rolloutPtr), mpcnetDefinitionPtr,
+                                                                   ballbotInterface.getReferenceManagerPtr());
+}
+
 }  // namespace ballbot
 }  // namespace ocs2
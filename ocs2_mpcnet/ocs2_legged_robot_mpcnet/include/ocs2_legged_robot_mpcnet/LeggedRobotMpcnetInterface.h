@@ -32,6 +32,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <ocs2_legged_robot/LeggedRobotInterface.h>
 #include <ocs2_legged_robot_raisim/LeggedRobotRaisimConversions.h>
 #include <ocs2_mpcnet_core/MpcnetInterfaceBase.h>
+#include <ocs2_mpcnet_core/control/MpcnetOnnxController.h>
 
 namespace ocs2 {
 namespace legged_robot {
@@ -46,8 +47,10 @@ class LeggedRobotMpcnetInterface final : public ocs2::mpcnet::MpcnetInterfaceBas
    * @param [in] nDataGenerationThreads : Number of data generation threads.
    * @param [in] nPolicyEvaluationThreads : Number of policy evaluation threads.
    * @param [in] raisim : Whether to use RaiSim for the rollouts.
+   * @param [in] batchDataGeneration : Whether to solve the MPC problems of all data generation tasks with one SQP batch solver, which
+   *                                   uses nDataGenerationThreads threads.
    */
-  LeggedRobotMpcnetInterface(size_t nDataGenerationThreads, size_t nPolicyEvaluationThreads, bool raisim);
+  LeggedRobotMpcnetInterface(size_t nDataGenerationThreads, size_t nPolicyEvaluationThreads, bool raisim, bool batchDataGeneration);
 
   /**
    * Default destructor.
@@ -62,6 +65,18 @@ class LeggedRobotMpcnetInterface final : public ocs2::mpcnet::MpcnetInterfaceBas
    */
   std::unique_ptr<MPC_BASE> getMpc(LeggedRobotInterface& leggedRobotInterface);
 
+  /**
+   * Helper to get the batch data generation.
+   * @param [in] leggedRobotInterface : The legged robot interface, its reference manager is used by the batch data generation.
+   * @param [in] nThreads : Number of threads of the batch solver.
+   * @param [in] rolloutPtr : Pointer to the rollout to be used.
+   * @param [in] onnxEnvironmentPtr : Pointer to the ONNX environment.
+   * @return Pointer to the batch data generation.
+   */
+  std::unique_ptr<ocs2::mpcnet::MpcnetBatchDataGeneration> getBatchDataGeneration(LeggedRobotInterface& leggedRobotInterface,
+                                                                                  size_t nThreads, std::unique_ptr<RolloutBase> rolloutPtr,
+                                                                                  std::shared_ptr<Ort::Env> onnxEnvironmentPtr);
+
   // Legged robot interface pointers (keep alive for Pinocchio interface)
   std::vector<std::unique_ptr<LeggedRobotInterface>> leggedRobotInterfacePtrs_;
   // Legged robot RaiSim conversions pointers (keep alive for RaiSim rollout)
@@ -51,7 +51,9 @@ def main(root_dir: str, config_file_name: str) -> None:
     # config
     config = Config(os.path.join(root_dir, "config", config_file_name))
     # interface
-    interface = MpcnetInterface(config.DATA_GENERATION_THREADS, config.POLICY_EVALUATION_THREADS, config.RAISIM)
+    interface = MpcnetInterface(
+        config.DATA_GENERATION_THREADS, config.POLICY_EVALUATION_THREADS, config.RAISIM, config.DATA_GENERATION_BATCH
+    )
     # loss
     experts_loss = HamiltonianLoss(config)
     gating_loss = CrossEntropyLoss(config)
@@ -43,7 +43,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 namespace ocs2 {
 namespace legged_robot {
 
-LeggedRobotMpcnetInterface::LeggedRobotMpcnetInterface(size_t nDataGenerationThreads, size_t nPolicyEvaluationThreads, bool raisim) {
+LeggedRobotMpcnetInterface::LeggedRobotMpcnetInterface(size_t nDataGenerationThreads, size_t nPolicyEvaluationThreads, bool raisim,
+                                                       bool batchDataGeneration) {
   // create ONNX environment
   auto onnxEnvironmentPtr = ocs2::mpcnet::createOnnxEnvironment();
   // paths to files
@@ -104,9 +105,20 @@ LeggedRobotMpcnetInterface::LeggedRobotMpcnetInterface(size_t nDataGenerationThr
     mpcnetDefinitionPtrs.push_back(mpcnetDefinitionPtr);
     referenceManagerPtrs.push_back(leggedRobotInterfacePtrs_[i]->getReferenceManagerPtr());
   }
+  // the batch data generation clones the rollout of the first data generation thread for each of its systems
+  std::unique_ptr<RolloutBase> batchRolloutPtr;
+  if (batchDataGeneration && nDataGenerationThreads > 0) {
+    batchRolloutPtr.reset(rolloutPtrs.front()->clone());
+  }
   mpcnetRolloutManagerPtr_.reset(new ocs2::mpcnet::MpcnetRolloutManager(nDataGenerationThreads, nPolicyEvaluationThreads,
                                                                         std::move(mpcPtrs), std::move(mpcnetPtrs), std::move(rolloutPtrs),
                                                                         mpcnetDefinitionPtrs, referenceManagerPtrs));
+  // set up MPC-Net batch data generation, which replaces the data generation threads
+  if (batchRolloutPtr != nullptr) {
+    leggedRobotInterfacePtrs_.push_back(std::make_unique<LeggedRobotInterface>(taskFile, urdfFile, referenceFile));
+    mpcnetRolloutManagerPtr_->setBatchDataGeneration(
+        getBatchDataGeneration(*leggedRobotInterfacePtrs_.back(), nDataGenerationThreads, std::move(batchRolloutPtr), onnxEnvironmentPtr));
+  }
 }
 
 /******************************************************************************************************/
@@ -139,5 +151,33 @@ std::unique_ptr<MPC_BASE> LeggedRobotMpcnetInterface::getMpc(LeggedRobotInterfac
   return mpcPtr;
 }
 
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+std::unique_ptr<ocs2::mpcnet::MpcnetBatchDataGeneration> LeggedRobotMpcnetInterface::getBatchDataGeneration(
+    LeggedRobotInterface& leggedRobotInterface, size_t nThreads, std::unique_ptr<RolloutBase> rolloutPtr,
+    std::shared_ptr<Ort::Env> onnxEnvironmentPtr) {
+  // ensure SQP settings are as needed for MPC-Net
+  const auto sqpSettings = [&]() {
+    auto settings = leggedRobotInterface.sqpSettings();
+    settings.nThreads = nThreads;
+    settings.useFeedbackPolicy = true;
+    settings.createValueFunction = true;
+    settings.printSolverStatus = false;
+    settings.printSolverStatistics = false;
+    settings.printLinesearch = false;
+    return settings;
+  }();
+  // create one batch solver for all data generation tasks
+  auto solverPtr = std::make_unique<SqpBatchSolver>(sqpSettings, leggedRobotInterface.getOptimalControlProblem(),
+                                                    leggedRobotInterface.getInitializer());
+  auto mpcnetDefinitionPtr = std::make_shared<LeggedRobotMpcnetDefinition>(leggedRobotInterface);
+  auto mpcnetPtr = std::make_unique<ocs2::mpcnet::MpcnetOnnxController>(
+      mpcnetDefinitionPtr, leggedRobotInterface.getReferenceManagerPtr(), std::move(onnxEnvironmentPtr));
+  return std::make_unique<ocs2::mpcnet::MpcnetBatchDataGeneration>(std::move(solverPtr), leggedRobotInterface.mpcSettings().timeHorizon_,
+                                                                   std::move(mpcnetPtr), std::move(rolloutPtr), mpcnetDefinitionPtr,
+                                                                   leggedRobotInterface.getReferenceManagerPtr());
+}
+
 }  // namespace legged_robot
 }  // namespace ocs2
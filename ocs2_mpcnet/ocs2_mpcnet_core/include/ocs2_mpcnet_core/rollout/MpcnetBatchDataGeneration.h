@@ -0,0 +1,139 @@
+/******************************************************************************
+Copyright (c) 2022, Farbod Farshidian. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#pragma once
+
+#include <ocs2_mpc/SystemObservation.h>
+#include <ocs2_oc/rollout/RolloutBase.h>
+#include <ocs2_oc/synchronized_module/ReferenceManagerInterface.h>
+#include <ocs2_sqp/SqpBatchSolver.h>
+
+#include "ocs2_mpcnet_core/MpcnetDefinitionBase.h"
+#include "ocs2_mpcnet_core/control/MpcnetBehavioralController.h"
+#include "ocs2_mpcnet_core/control/MpcnetControllerBase.h"
+#include "ocs2_mpcnet_core/rollout/MpcnetData.h"
+
+namespace ocs2 {
+namespace mpcnet {
+
+/**
+ *  A class for generating data from several systems that are forward simulated in lockstep with behavioral controllers.
+ *  Contrary to MpcnetDataGeneration, which runs one MPC per system, the MPC problems of all systems are solved together by a single
+ *  SqpBatchSolver, which shares one thread pool and one copy of the optimal control problem per worker.
+ *  The terms of the optimal control problem and the learned policy read the mode schedule from the reference manager, which is shared by
+ *  all systems. The systems are therefore grouped by their mode schedule and time, and the batch solver runs once per group with the mode
+ *  schedule of the group applied to the reference manager. Before a system is forward simulated, its references are applied.
+ */
+class MpcnetBatchDataGeneration final {
+ public:
+  /**
+   * Constructor.
+   * @param [in] solverPtr : Pointer to the batch solver to be used (this class takes ownership). It needs the createValueFunction setting.
+   * @param [in] timeHorizon : The MPC time horizon.
+   * @param [in] mpcnetPtr : Pointer to the MPC-Net policy to be used (this class takes ownership).
+   * @param [in] rolloutPtr : Pointer to the rollout to be used, it is cloned for each system (this class takes ownership).
+   * @param [in] mpcnetDefinitionPtr : Pointer to the MPC-Net definitions to be used (shared ownership).
+   * @param [in] referenceManagerPtr : Pointer to the reference manager read by the optimal control problem of the batch solver and by the
+   *                                   MPC-Net policy (shared ownership).
+   */
+  MpcnetBatchDataGeneration(std::unique_ptr<SqpBatchSolver> solverPtr, scalar_t timeHorizon,
+                            std::unique_ptr<MpcnetControllerBase> mpcnetPtr, std::unique_ptr<RolloutBase> rolloutPtr,
+                            std::shared_ptr<MpcnetDefinitionBase> mpcnetDefinitionPtr,
+                            std::shared_ptr<ReferenceManagerInterface> referenceManagerPtr);
+
+  /**
+   * Default destructor.
+   */
+  ~MpcnetBatchDataGeneration() = default;
+
+  /**
+   * Deleted copy constructor.
+   */
+  MpcnetBatchDataGeneration(const MpcnetBatchDataGeneration&) = delete;
+
+  /**
+   * Deleted copy assignment.
+   */
+  MpcnetBatchDataGeneration& operator=(const MpcnetBatchDataGeneration&) = delete;
+
+  /**
+   * Run the data generation for a batch of systems, see MpcnetDataGeneration::run.
+   * @param [in] alpha : The mixture parameter for the behavioral controller.
+   * @param [in] policyFilePath : The path to the file with the learned policy for the behavioral controller.
+   * @param [in] timeStep : The time step for the forward simulation of the system with the behavioral controller.
+   * @param [in] dataDecimation : The integer factor used for downsampling the data signal.
+   * @param [in] nSamples : The number of samples drawn from a multivariate normal distribution around the nominal states.
+   * @param [in] samplingCovariance : The covariance matrix used for sampling from a multivariate normal distribution.
+   * @param [in] initialObservations : The initial system observations to start from (time and state required).
+   * @param [in] modeSchedules : The mode schedules providing the event times and mode sequence.
+   * @param [in] targetTrajectories : The target trajectories to be tracked.
+   * @return Pointer to the data array with the generated data of all systems.
+   */
+  const data_array_t* run(scalar_t alpha, const std::string& policyFilePath, scalar_t timeStep, size_t dataDecimation, size_t nSamples,
+                          const matrix_t& samplingCovariance, const std::vector<SystemObservation>& initialObservations,
+                          const std::vector<ModeSchedule>& modeSchedules, const std::vector<TargetTrajectories>& targetTrajectories);
+
+ private:
+  /** The state of a single forward simulated system. */
+  struct System {
+    SystemObservation systemObservation;
+    ModeSchedule modeSchedule;
+    TargetTrajectories targetTrajectories;
+    std::unique_ptr<MpcnetBehavioralController> behavioralControllerPtr;
+    std::unique_ptr<RolloutBase> rolloutPtr;
+    PrimalSolution primalSolution;
+    data_array_t dataArray;
+    int iteration = 0;
+    bool isActive = true;
+  };
+
+  /** Applies the mode schedule and target trajectories of a system to the reference manager at the current time of the system. */
+  void updateReferences(const System& system);
+
+  /** Solves the MPC problems of a group of systems with the same mode schedule and time, the solutions are copied to the systems. */
+  void solve(const std::vector<size_t>& systemIndices);
+
+  /** Gets a data point of a system from the solution of its MPC problem, which is problem problemIndex of the last batch. */
+  data_point_t getDataPoint(size_t problemIndex, const System& system, const vector_t& deviation);
+
+  /** Forward simulates a system with its behavioral controller, see MpcnetRolloutBase::step(). */
+  void step(System& system, scalar_t timeStep);
+
+  std::unique_ptr<SqpBatchSolver> solverPtr_;
+  scalar_t timeHorizon_;
+  std::unique_ptr<MpcnetControllerBase> mpcnetPtr_;
+  std::unique_ptr<RolloutBase> rolloutPtr_;
+  std::shared_ptr<MpcnetDefinitionBase> mpcnetDefinitionPtr_;
+  std::shared_ptr<ReferenceManagerInterface> referenceManagerPtr_;
+  std::vector<System> systems_;
+  data_array_t dataArray_;
+};
+
+}  // namespace mpcnet
+}  // namespace ocs2
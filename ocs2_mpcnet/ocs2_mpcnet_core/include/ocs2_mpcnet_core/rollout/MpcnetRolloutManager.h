@@ -31,6 +31,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <ocs2_core/thread_support/ThreadPool.h>
 
+#include "ocs2_mpcnet_core/rollout/MpcnetBatchDataGeneration.h"
 #include "ocs2_mpcnet_core/rollout/MpcnetDataGeneration.h"
 #include "ocs2_mpcnet_core/rollout/MpcnetPolicyEvaluation.h"
 
@@ -64,6 +65,13 @@ class MpcnetRolloutManager {
    */
   virtual ~MpcnetRolloutManager() = default;
 
+  /**
+   * Sets a batch data generation, which then replaces the per-thread data generations in startDataGeneration.
+   * @note The systems of a data generation are then solved by one batch solver, one batch per distinct mode schedule.
+   * @param [in] batchDataGenerationPtr : Pointer to the batch data generation to be used (this class takes ownership).
+   */
+  void setBatchDataGeneration(std::unique_ptr<MpcnetBatchDataGeneration> batchDataGenerationPtr);
+
   /**
    * Starts the data genration forward simulated by a behavioral controller.
    * @param [in] alpha : The mixture parameter for the behavioral controller.
@@ -123,6 +131,7 @@ class MpcnetRolloutManager {
   std::atomic_int nDataGenerationTasksDone_;
   std::unique_ptr<ThreadPool> dataGenerationThreadPoolPtr_;
   std::vector<std::unique_ptr<MpcnetDataGeneration>> dataGenerationPtrs_;
+  std::unique_ptr<MpcnetBatchDataGeneration> batchDataGenerationPtr_;
   std::vector<std::future<const data_array_t*>> dataGenerationFtrs_;
   data_array_t dataArray_;
   // policy evaluation variables
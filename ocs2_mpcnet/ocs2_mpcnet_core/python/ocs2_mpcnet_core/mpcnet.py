@@ -148,6 +148,7 @@ class Mpcnet(metaclass=ABCMeta):
             mode_schedules,
             target_trajectories,
         )
+        self.data_generation_start_time = time.time()
 
     def start_policy_evaluation(self, policy: BasePolicy, alpha: float = 0.0):
         """Start policy evaluation.
@@ -211,6 +212,8 @@ class Mpcnet(metaclass=ABCMeta):
                     # logging
                     self.writer.add_scalar("data/new_data_points", len(data), iteration)
                     self.writer.add_scalar("data/total_data_points", len(self.memory), iteration)
+                    data_generation_time = time.time() - self.data_generation_start_time
+                    self.writer.add_scalar("data/samples_per_second", len(data) / data_generation_time, iteration)
                     print("iteration", iteration, "received data points", len(data), "requesting with alpha", alpha)
                     # start new data generation
                     self.start_data_generation(self.policy, alpha)
@@ -0,0 +1,267 @@
+/******************************************************************************
+Copyright (c) 2022, Farbod Farshidian. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+ * Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+ * Neither the name of the copyright holder nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#include "ocs2_mpcnet_core/rollout/MpcnetBatchDataGeneration.h"
+
+#include <algorithm>
+#include <random>
+
+namespace ocs2 {
+namespace mpcnet {
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+MpcnetBatchDataGeneration::MpcnetBatchDataGeneration(std::unique_ptr<SqpBatchSolver> solverPtr, scalar_t timeHorizon,
+                                                     std::unique_ptr<MpcnetControllerBase> mpcnetPtr,
+                                                     std::unique_ptr<RolloutBase> rolloutPtr,
+                                                     std::shared_ptr<MpcnetDefinitionBase> mpcnetDefinitionPtr,
+                                                     std::shared_ptr<ReferenceManagerInterface> referenceManagerPtr)
+    : solverPtr_(std::move(solverPtr)),
+      timeHorizon_(timeHorizon),
+      mpcnetPtr_(std::move(mpcnetPtr)),
+      rolloutPtr_(std::move(rolloutPtr)),
+      mpcnetDefinitionPtr_(std::move(mpcnetDefinitionPtr)),
+      referenceManagerPtr_(std::move(referenceManagerPtr)) {
+  if (timeHorizon_ <= 0.0) {
+    throw std::runtime_error("[MpcnetBatchDataGeneration] The time horizon has to be positive.");
+  }
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+const data_array_t* MpcnetBatchDataGeneration::run(scalar_t alpha, const std::string& policyFilePath, scalar_t timeStep,
+                                                   size_t dataDecimation, size_t nSamples, const matrix_t& samplingCovariance,
+                                                   const std::vector<SystemObservation>& initialObservations,
+                                                   const std::vector<ModeSchedule>& modeSchedules,
+                                                   const std::vector<TargetTrajectories>& targetTrajectories) {
+  if (initialObservations.size() != modeSchedules.size() || initialObservations.size() != targetTrajectories.size()) {
+    throw std::runtime_error("[MpcnetBatchDataGeneration::run] The number of observations, mode schedules and targets has to be equal.");
+  }
+
+  // clear data array
+  dataArray_.clear();
+
+  // reset solver and prepare learned controller
+  solverPtr_->reset();
+  mpcnetPtr_->loadPolicyModel(policyFilePath);
+
+  // set systems
+  systems_.clear();
+  systems_.resize(initialObservations.size());
+  for (size_t i = 0; i < systems_.size(); i++) {
+    auto& system = systems_[i];
+    system.systemObservation = initialObservations[i];
+    system.modeSchedule = modeSchedules[i];
+    system.targetTrajectories = targetTrajectories[i];
+    system.behavioralControllerPtr.reset(new MpcnetBehavioralController());
+    system.behavioralControllerPtr->setAlpha(alpha);
+    system.behavioralControllerPtr->setLearnedController(*mpcnetPtr_);
+    system.rolloutPtr.reset(rolloutPtr_->clone());
+    system.rolloutPtr->resetRollout();
+  }
+
+  // set up scalar standard normal generator and compute Cholesky decomposition of covariance matrix
+  std::random_device randomDevice;
+  std::default_random_engine pseudoRandomNumberGenerator(randomDevice());
+  std::normal_distribution<scalar_t> standardNormalDistribution(scalar_t(0.0), scalar_t(1.0));
+  auto standardNormalNullaryOp = [&](scalar_t) -> scalar_t { return standardNormalDistribution(pseudoRandomNumberGenerator); };
+  const matrix_t L = samplingCovariance.llt().matrixL();
+
+  // run data generation
+  std::vector<std::vector<size_t>> groups;
+  while (true) {
+    // group the systems that are still running by their mode schedule and time, the systems of a group are solved as one batch
+    groups.clear();
+    for (size_t i = 0; i < systems_.size(); i++) {
+      const auto& system = systems_[i];
+      if (!system.isActive || system.systemObservation.time > system.targetTrajectories.timeTrajectory.back()) {
+        continue;
+      }
+      auto groupItr = std::find_if(groups.begin(), groups.end(), [&](const std::vector<size_t>& group) {
+        const auto& other = systems_[group.front()];
+        return other.systemObservation.time == system.systemObservation.time &&
+               other.modeSchedule.eventTimes == system.modeSchedule.eventTimes &&
+               other.modeSchedule.modeSequence == system.modeSchedule.modeSequence;
+      });
+      if (groupItr == groups.end()) {
+        groups.push_back({i});
+      } else {
+        groupItr->push_back(i);
+      }
+    }
+    if (groups.empty()) {
+      break;
+    }
+
+    for (const auto& group : groups) {
+      try {
+        // solve the MPC problems of the group together
+        solve(group);
+      } catch (const std::exception& e) {
+        // print error for exceptions
+        std::cerr << "[MpcnetBatchDataGeneration::run] a standard exception was caught, with message: " << e.what() << "\n";
+        // the data generation run of the systems in this group failed, clear their data
+        for (const auto i : group) {
+          systems_[i].dataArray.clear();
+          systems_[i].isActive = false;
+        }
+        continue;
+      }
+
+      for (size_t j = 0; j < group.size(); j++) {
+        auto& system = systems_[group[j]];
+        try {
+          // step system
+          updateReferences(system);
+          step(system, timeStep);
+
+          // downsample the data signal by an integer factor
+          if (system.iteration % dataDecimation == 0) {
+            // get nominal data point
+            const auto stateDim = system.systemObservation.state.size();
+            system.dataArray.push_back(getDataPoint(j, system, vector_t::Zero(stateDim)));
+
+            // get samples around nominal data point
+            for (int i = 0; i < nSamples; i++) {
+              const vector_t deviation = L * vector_t::NullaryExpr(stateDim, standardNormalNullaryOp);
+              system.dataArray.push_back(getDataPoint(j, system, deviation));
+            }
+          }
+
+          // update iteration
+          ++system.iteration;
+        } catch (const std::exception& e) {
+          // print error for exceptions
+          std::cerr << "[MpcnetBatchDataGeneration::run] a standard exception was caught, with message: " << e.what() << "\n";
+          // the data generation run of this system failed, clear its data
+          system.dataArray.clear();
+          system.isActive = false;
+        }
+      }
+    }
+  }
+
+  // gather data of all systems
+  for (auto& system : systems_) {
+    dataArray_.insert(dataArray_.end(), std::make_move_iterator(system.dataArray.begin()), std::make_move_iterator(system.dataArray.end()));
+    system.dataArray.clear();
+  }
+
+  // return pointer to the data array
+  return &dataArray_;
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void MpcnetBatchDataGeneration::updateReferences(const System& system) {
+  const auto& observation = system.systemObservation;
+  referenceManagerPtr_->setModeSchedule(system.modeSchedule);
+  referenceManagerPtr_->setTargetTrajectories(system.targetTrajectories);
+  referenceManagerPtr_->preSolverRun(observation.time, observation.time + timeHorizon_, observation.state);
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void MpcnetBatchDataGeneration::solve(const std::vector<size_t>& systemIndices) {
+  // the systems of the group share the mode schedule, which the reference manager may modify in preSolverRun
+  updateReferences(systems_[systemIndices.front()]);
+  const auto& modeSchedule = referenceManagerPtr_->getModeSchedule();
+
+  std::vector<SqpBatchSolver::Problem> problems(systemIndices.size());
+  for (size_t j = 0; j < systemIndices.size(); j++) {
+    auto& system = systems_[systemIndices[j]];
+    auto& problem = problems[j];
+    problem.initTime = system.systemObservation.time;
+    problem.initState = system.systemObservation.state;
+    problem.finalTime = problem.initTime + timeHorizon_;
+    problem.modeSchedule = modeSchedule;
+    problem.targetTrajectories = system.targetTrajectories;
+    problem.initialGuess = std::move(system.primalSolution);
+  }
+  solverPtr_->run(std::move(problems));
+
+  for (size_t j = 0; j < systemIndices.size(); j++) {
+    systems_[systemIndices[j]].primalSolution = solverPtr_->primalSolution(j);
+  }
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+data_point_t MpcnetBatchDataGeneration::getDataPoint(size_t problemIndex, const System& system, const vector_t& deviation) {
+  data_point_t dataPoint;
+  const auto& primalSolution = system.primalSolution;
+  dataPoint.t = primalSolution.timeTrajectory_.front();
+  dataPoint.x = primalSolution.stateTrajectory_.front() + deviation;
+  dataPoint.u = primalSolution.controllerPtr_->computeInput(dataPoint.t, dataPoint.x);
+  dataPoint.mode = primalSolution.modeSchedule_.modeAtTime(dataPoint.t);
+  dataPoint.observation = mpcnetDefinitionPtr_->getObservation(dataPoint.t, dataPoint.x, system.modeSchedule, system.targetTrajectories);
+  dataPoint.actionTransformation =
+      mpcnetDefinitionPtr_->getActionTransformation(dataPoint.t, dataPoint.x, system.modeSchedule, system.targetTrajectories);
+  dataPoint.hamiltonian = solverPtr_->getHamiltonian(problemIndex, dataPoint.t, dataPoint.x, dataPoint.u);
+  return dataPoint;
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void MpcnetBatchDataGeneration::step(System& system, scalar_t timeStep) {
+  const auto& primalSolution = system.primalSolution;
+
+  // update behavioral controller with MPC controller
+  system.behavioralControllerPtr->setOptimalController(*primalSolution.controllerPtr_);
+
+  // forward simulate system with behavioral controller
+  scalar_array_t timeTrajectory;
+  size_array_t postEventIndicesStock;
+  vector_array_t stateTrajectory;
+  vector_array_t inputTrajectory;
+  system.rolloutPtr->run(primalSolution.timeTrajectory_.front(), primalSolution.stateTrajectory_.front(),
+                         primalSolution.timeTrajectory_.front() + timeStep, system.behavioralControllerPtr.get(),
+                         system.modeSchedule, timeTrajectory, postEventIndicesStock, stateTrajectory, inputTrajectory);
+
+  // update system observation
+  system.systemObservation.time = timeTrajectory.back();
+  system.systemObservation.state = stateTrajectory.back();
+  system.systemObservation.input = inputTrajectory.back();
+  system.systemObservation.mode = primalSolution.modeSchedule_.modeAtTime(system.systemObservation.time);
+
+  // check forward simulated system
+  if (!mpcnetDefinitionPtr_->isValid(system.systemObservation.time, system.systemObservation.state, system.modeSchedule,
+                                     system.targetTrajectories)) {
+    throw std::runtime_error("[MpcnetBatchDataGeneration::step] Tuple (time, state, modeSchedule, targetTrajectories) is not valid.");
+  }
+}
+
+}  // namespace mpcnet
+}  // namespace ocs2
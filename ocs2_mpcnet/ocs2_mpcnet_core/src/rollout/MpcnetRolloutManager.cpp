@@ -66,6 +66,13 @@ MpcnetRolloutManager::MpcnetRolloutManager(size_t nDataGenerationThreads, size_t
   }
 }
 
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void MpcnetRolloutManager::setBatchDataGeneration(std::unique_ptr<MpcnetBatchDataGeneration> batchDataGenerationPtr) {
+  batchDataGenerationPtr_ = std::move(batchDataGenerationPtr);
+}
+
 /******************************************************************************************************/
 /******************************************************************************************************/
 /******************************************************************************************************/
@@ -82,6 +89,19 @@ void MpcnetRolloutManager::startDataGeneration(scalar_t alpha, const std::string
   dataGenerationFtrs_.clear();
   nDataGenerationTasksDone_ = 0;
 
+  // push a single task solving all systems together into pool
+  if (batchDataGenerationPtr_ != nullptr) {
+    dataGenerationFtrs_.push_back(dataGenerationThreadPoolPtr_->run([=](int threadNumber) {
+      const auto* result = batchDataGenerationPtr_->run(alpha, policyFilePath, timeStep, dataDecimation, nSamples, samplingCovariance,
+                                                        initialObservations, modeSchedules, targetTrajectories);
+      nDataGenerationTasksDone_++;
+      // print thread and task number
+      std::cerr << "Data generation thread " << threadNumber << " finished batch task " << nDataGenerationTasksDone_ << "\n";
+      return result;
+    }));
+    return;
+  }
+
   // push tasks into pool
   for (int i = 0; i < initialObservations.size(); i++) {
     dataGenerationFtrs_.push_back(dataGenerationThreadPoolPtr_->run([=](int threadNumber) {
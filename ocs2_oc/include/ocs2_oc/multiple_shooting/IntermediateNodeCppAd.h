@@ -0,0 +1,186 @@
+/******************************************************************************
+Copyright (c) 2020, Farbod Farshidian. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#pragma once
+
+#include <memory>
+
+#include <ocs2_core/Types.h>
+#include <ocs2_core/automatic_differentiation/CppAdInterface.h>
+#include <ocs2_core/automatic_differentiation/Types.h>
+#include <ocs2_core/integration/SensitivityIntegrator.h>
+#include <ocs2_core/penalties/MultidimensionalPenalty.h>
+#include <ocs2_core/penalties/penalties/PenaltyBase.h>
+#include <ocs2_core/reference/TargetTrajectories.h>
+
+#include "ocs2_oc/multiple_shooting/Transcription.h"
+
+namespace ocs2 {
+namespace multiple_shooting {
+
+/**
+ * Fused transcription of an intermediate node. The discretized dynamics, the intermediate cost, and the state-input constraints of a
+ * node are taped into a single CppAD model such that the quantities shared between them (e.g. the kinematics of a robot, see
+ * nodeFunction()) are only evaluated once and the whole node is approximated by a single compiled library.
+ *
+ * The taped model has the variables [x, u] and the parameters [t, dt, p], with p given by getParameters(). Its output is stacked as
+ * [x_{k+1}; r; s; g; h] with x_{k+1} the discretized flow map, r the residual of the intermediate cost, s the soft constraints, g the
+ * state-input equality constraints and h the state-input inequality constraints.
+ *
+ * The cost is approximated with Gauss-Newton, as in StateInputCostGaussNewtonAd, and the soft constraints are penalized with the penalty
+ * set by setSoftConstraintPenalty() based on their linear approximation, as in StateInputSoftConstraint of ConstraintOrder::Linear:
+ *  L = 0.5 ||r||^2 + sum_i p(s_i)
+ *  d2L = dr' * dr + ds' * diag(p''(s)) * ds
+ * Only the first order model is therefore compiled.
+ *
+ * The derived class has to describe all intermediate terms of the optimal control problem, as the node replaces the evaluation of the
+ * dynamics, costs, soft constraints and constraints of the optimal control problem in setupIntermediateNode().
+ */
+class IntermediateNodeCppAd {
+ public:
+  IntermediateNodeCppAd() = default;
+  virtual ~IntermediateNodeCppAd() = default;
+  virtual IntermediateNodeCppAd* clone() const = 0;
+
+  /** Initialize the CppAd interface
+   * @param stateDim : state vector dimension.
+   * @param inputDim : input vector dimension.
+   * @param parameterDim : parameter vector dimension, set to 0 if getParameters() is not used.
+   * @param integratorType : Integrator used for the discretization of the flow map.
+   * @param modelName : Name of the generate model library.
+   * @param modelFolder : Folder where the model library files are saved.
+   * @param recompileLibraries : If true, always compile the model library, else try to load existing library if available.
+   * @param verbose : Print information.
+   */
+  void initialize(size_t stateDim, size_t inputDim, size_t parameterDim, SensitivityIntegratorType integratorType,
+                  const std::string& modelName, const std::string& modelFolder = "/tmp/ocs2", bool recompileLibraries = true,
+                  bool verbose = true);
+
+  /** Integrator used for the discretization of the flow map */
+  SensitivityIntegratorType getIntegratorType() const { return integratorType_; }
+
+  /** Get the parameter vector */
+  virtual vector_t getParameters(scalar_t time, const TargetTrajectories& targetTrajectories) const { return vector_t(0); }
+
+  /** Sizes of the taped soft constraint terms, in the order they are stacked. Defaults to a single term. */
+  virtual size_array_t getSoftConstraintTermsSize() const { return {numSoftConstraints_}; }
+
+  /** Whether the taped soft constraint term with the given index is active at the given time. */
+  virtual bool isSoftConstraintTermActive(size_t termIndex, scalar_t time) const { return true; }
+
+  /** Sizes of the taped state-input equality constraint terms, in the order they are stacked. Defaults to a single term. */
+  virtual size_array_t getEqualityConstraintTermsSize() const { return {numEqualityConstraints_}; }
+
+  /** Whether the taped state-input equality constraint term with the given index is active at the given time. */
+  virtual bool isEqualityConstraintTermActive(size_t termIndex, scalar_t time) const { return true; }
+
+  /** Sizes of the taped state-input inequality constraint terms, in the order they are stacked. Defaults to a single term. */
+  virtual size_array_t getInequalityConstraintTermsSize() const { return {numInequalityConstraints_}; }
+
+  /** Whether the taped state-input inequality constraint term with the given index is active at the given time. */
+  virtual bool isInequalityConstraintTermActive(size_t termIndex, scalar_t time) const { return true; }
+
+  /**
+   * Compute the multiple shooting transcription of an intermediate node with a single evaluation of the fused model.
+   *
+   * @param t : Start of the discrete interval
+   * @param dt : Duration of the interval
+   * @param x : State at start of the interval
+   * @param x_next : State at the end of the interval
+   * @param u : Input, taken to be constant across the interval.
+   * @param targetTrajectories : The target trajectories used to compute the parameters.
+   * @return multiple shooting transcription for this node.
+   */
+  Transcription setupIntermediateNode(scalar_t t, scalar_t dt, const vector_t& x, const vector_t& x_next, const vector_t& u,
+                                      const TargetTrajectories& targetTrajectories) const;
+
+ protected:
+  IntermediateNodeCppAd(const IntermediateNodeCppAd& rhs);
+
+  /** Sets the penalty applied to each soft constraint. Required if softConstraint() is not empty. */
+  void setSoftConstraintPenalty(std::unique_ptr<PenaltyBase> penaltyPtr);
+
+  /**
+   * Evaluates all terms at the start of the interval, where the flow map is the first stage of the integrator. The derived class can
+   * override this to share computations between the terms, e.g. the kinematics of a robot. By default, the terms are evaluated
+   * separately.
+   */
+  virtual void nodeFunction(const ad_scalar_t& time, const ad_vector_t& state, const ad_vector_t& input, const ad_vector_t& parameters,
+                            ad_vector_t& stateDerivative, ad_vector_t& costResidual, ad_vector_t& softConstraintValue,
+                            ad_vector_t& equalityConstraintValue, ad_vector_t& inequalityConstraintValue) const;
+
+  /** The CppAD continuous time flow map */
+  virtual ad_vector_t flowMap(const ad_scalar_t& time, const ad_vector_t& state, const ad_vector_t& input,
+                              const ad_vector_t& parameters) const = 0;
+
+  /** The CppAD residual r of the intermediate cost L = 0.5 ||r||^2 */
+  virtual ad_vector_t costVectorFunction(const ad_scalar_t& time, const ad_vector_t& state, const ad_vector_t& input,
+                                         const ad_vector_t& parameters) const = 0;
+
+  /** The CppAD soft constraints. All terms are taped, the inactive ones are removed after evaluation. */
+  virtual ad_vector_t softConstraint(const ad_scalar_t& time, const ad_vector_t& state, const ad_vector_t& input,
+                                     const ad_vector_t& parameters) const {
+    return ad_vector_t(0);
+  }
+
+  /** The CppAD state-input equality constraints. All terms are taped, the inactive ones are removed after evaluation. */
+  virtual ad_vector_t equalityConstraint(const ad_scalar_t& time, const ad_vector_t& state, const ad_vector_t& input,
+                                         const ad_vector_t& parameters) const {
+    return ad_vector_t(0);
+  }
+
+  /** The CppAD state-input inequality constraints. All terms are taped, the inactive ones are removed after evaluation. */
+  virtual ad_vector_t inequalityConstraint(const ad_scalar_t& time, const ad_vector_t& state, const ad_vector_t& input,
+                                           const ad_vector_t& parameters) const {
+    return ad_vector_t(0);
+  }
+
+ private:
+  /** Discretizes the flow map over [t, t + dt] with the selected integrator, given the flow map k1 at the start of the interval. */
+  ad_vector_t discretizeFlowMap(const ad_scalar_t& time, const ad_scalar_t& dt, const ad_vector_t& state, const ad_vector_t& input,
+                                const ad_vector_t& parameters, const ad_vector_t& k1) const;
+
+  /** Copies the rows of the active terms into the transcription. */
+  VectorFunctionLinearApproximation selectActiveRows(const matrix_t& jacobian, const vector_t& values, size_t offset,
+                                                     const size_array_t& termsSize, const std::vector<bool>& isTermActive,
+                                                     size_array_t& activeTermsSize) const;
+
+  std::unique_ptr<CppAdInterface> adInterfacePtr_;
+  std::unique_ptr<MultidimensionalPenalty> softConstraintPenaltyPtr_;
+  SensitivityIntegratorType integratorType_ = SensitivityIntegratorType::RK4;
+  size_t stateDim_ = 0;
+  size_t inputDim_ = 0;
+  size_t numCostResiduals_ = 0;
+  size_t numSoftConstraints_ = 0;
+  size_t numEqualityConstraints_ = 0;
+  size_t numInequalityConstraints_ = 0;
+};
+
+}  // namespace multiple_shooting
+}  // namespace ocs2
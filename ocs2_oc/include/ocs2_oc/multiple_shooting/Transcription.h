@@ -31,6 +31,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <ocs2_core/Types.h>
 #include <ocs2_core/integration/SensitivityIntegrator.h>
+#include <ocs2_core/model_data/Metrics.h>
 
 #include "ocs2_oc/multiple_shooting/ProjectionMultiplierCoefficients.h"
 #include "ocs2_oc/oc_problem/OptimalControlProblem.h"
@@ -78,6 +79,18 @@ struct Transcription {
 Transcription setupIntermediateNode(OptimalControlProblem& optimalControlProblem, DynamicsSensitivityDiscretizer& sensitivityDiscretizer,
                                     scalar_t t, scalar_t dt, const vector_t& x, const vector_t& x_next, const vector_t& u);
 
+/**
+ * Moves an intermediate node transcription to a nearby point without evaluating derivatives. The values of the cost, dynamics, and
+ * constraints are taken from the metrics at the new point, the cost gradient is updated with the cost Hessian, and all other derivatives
+ * are kept. This is exact for linear dynamics and constraints, and quadratic costs.
+ *
+ * @param transcription : Unprojected transcription at {x, u}, updated in place to {x + dx, u + du}.
+ * @param dx : Change of the state at the start of the interval.
+ * @param du : Change of the input.
+ * @param metrics : Metrics at the new point, see computeIntermediateMetrics.
+ */
+void updateIntermediateNode(Transcription& transcription, const vector_t& dx, const vector_t& du, const Metrics& metrics);
+
 /**
  * Apply the state-input equality constraint projection for a single intermediate node transcription.
  *
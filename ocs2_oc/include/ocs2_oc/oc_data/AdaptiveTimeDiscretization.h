@@ -0,0 +1,96 @@
+/******************************************************************************
+Copyright (c) 2020, Farbod Farshidian. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#pragma once
+
+#include <ocs2_core/Types.h>
+#include <ocs2_core/dynamics/SystemDynamicsBase.h>
+#include <ocs2_core/integration/SensitivityIntegrator.h>
+
+#include "ocs2_oc/oc_data/TimeDiscretization.h"
+
+namespace ocs2 {
+
+/**
+ * Adapts the time discretization of a multiple shooting solver between consecutive problems (e.g. MPC iterations). It keeps a
+ * piecewise constant profile of the desired step size over time. After each solve, the step of every interval whose local error
+ * exceeds the refinement tolerance is halved, and the step of every interval whose error is below the coarsening tolerance is doubled,
+ * within [dtMin, dtMax]. The local error of an interval is estimated by step doubling: the max-norm of the difference between one
+ * step and two half steps of the discretized dynamics, starting from the solution at the interval's start node.
+ *
+ * Beyond the profile, i.e. before the first solve or past the previous final time, the nominal step is used. The solver initializes
+ * the new grid by interpolating the previous solution.
+ */
+class AdaptiveTimeDiscretization {
+ public:
+  struct Settings {
+    scalar_t dt = 0.01;                    // nominal step, used where no profile is available
+    scalar_t dtMin = 0.0025;               // lower bound of the refined step
+    scalar_t dtMax = 0.04;                 // upper bound of the coarsened step
+    scalar_t refinementTolerance = 1e-3;   // intervals with a larger local error are refined
+    scalar_t coarseningTolerance = 1e-5;   // intervals with a smaller local error are coarsened
+  };
+
+  explicit AdaptiveTimeDiscretization(Settings settings);
+
+  /** Clears the step size profile, the next discretization is uniform at the nominal step. */
+  void reset();
+
+  /**
+   * Decides on the time discretization of the next problem based on the current step size profile.
+   *
+   * @param initTime : start time.
+   * @param finalTime : final time.
+   * @param eventTimes : Event times where a time discretization must be made.
+   * @return vector of discrete time points
+   */
+  std::vector<AnnotatedTime> getTimeDiscretization(scalar_t initTime, scalar_t finalTime, const scalar_array_t& eventTimes) const;
+
+  /**
+   * Refines and coarsens the step size profile based on the local error of a solution.
+   *
+   * @param timeDiscretization : The time discretization of the solution.
+   * @param stateTrajectory : The state of each node of the solution.
+   * @param inputTrajectory : The input of each interval of the solution.
+   * @param dynamics : The system dynamics.
+   * @param discretizer : The discretization of the dynamics used by the solver.
+   */
+  void update(const std::vector<AnnotatedTime>& timeDiscretization, const vector_array_t& stateTrajectory,
+              const vector_array_t& inputTrajectory, SystemDynamicsBase& dynamics, const DynamicsDiscretizer& discretizer);
+
+  /** The desired step at the given time. */
+  scalar_t getStepSize(scalar_t time) const;
+
+ private:
+  Settings settings_;
+  scalar_array_t profileTimes_;  // start times of the profile segments, the last entry is the end of the profile
+  scalar_array_t profileStepSizes_;
+};
+
+}  // namespace ocs2
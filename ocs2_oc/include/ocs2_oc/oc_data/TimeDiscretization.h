@@ -29,6 +29,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #pragma once
 
+#include <functional>
+#include <limits>
+
 #include <ocs2_core/NumericTraits.h>
 #include <ocs2_core/Types.h>
 
@@ -48,6 +51,35 @@ struct AnnotatedTime {
   explicit AnnotatedTime(scalar_t t, Event e = Event::None) : time(t), event(e){};
 };
 
+/**
+ * Step size schedule of a non-uniform (multi-rate) horizon, as a function of the time since the start of the horizon. The step is
+ * piecewise constant, dt[k] is used between switchingTimes[k - 1] and switchingTimes[k]. After the last switching time, the step grows
+ * geometrically by growthFactor per step, up to dtMax. This allows a fine discretization near the initial time and a coarse tail.
+ */
+struct HorizonStepSchedule {
+  scalar_array_t switchingTimes;                          // times since the start of the horizon at which the next step size is used
+  scalar_array_t dt;                                      // piecewise constant step sizes, one more than the switching times
+  scalar_t growthFactor = 1.0;                            // ratio of two consecutive steps after the last switching time
+  scalar_t dtMax = std::numeric_limits<scalar_t>::max();  // upper bound of the growing step
+
+  /** Returns the step size from a node at the given time since the start of the horizon */
+  scalar_t getStepSize(scalar_t timeSinceStart) const;
+};
+
+/**
+ * Creates the step size schedule of a horizon from the time step settings of the multiple shooting solvers.
+ * Throws if the step sizes are not positive, the switching times are not increasing, or the growth factor is smaller than one.
+ *
+ * @param [in] dt : The step size from the start of the horizon.
+ * @param [in] dtSwitchingTimes : Increasing times since the start of the horizon at which the next entry of dtSchedule is used.
+ * @param [in] dtSchedule : The step sizes after each of the dtSwitchingTimes.
+ * @param [in] growthFactor : Ratio of two consecutive steps after the last switching time.
+ * @param [in] dtMax : Upper bound of the growing step.
+ * @return The step size schedule.
+ */
+HorizonStepSchedule createHorizonStepSchedule(scalar_t dt, const scalar_array_t& dtSwitchingTimes, const scalar_array_t& dtSchedule,
+                                              scalar_t growthFactor, scalar_t dtMax);
+
 /** Computes the time at which to interpolate, respecting interpolation rules around event times */
 scalar_t getInterpolationTime(const AnnotatedTime& annotatedTime);
 
@@ -76,6 +108,38 @@ std::vector<AnnotatedTime> timeDiscretizationWithEvents(scalar_t initTime, scala
                                                         const scalar_array_t& eventTimes,
                                                         scalar_t dt_min = 10.0 * numeric_traits::limitEpsilon<scalar_t>());
 
+/**
+ * Decides on time discretization along the horizon with a time-varying step. Tries to make a step of dt(t) from each node at time t,
+ * but will also ensure that event times are part of the discretization.
+ *
+ * @param initTime : start time.
+ * @param finalTime : final time.
+ * @param dt : desired discretization step as a function of the time of the node the step starts from. Must be positive.
+ * @param eventTimes : Event times where a time discretization must be made.
+ * @param dt_min : minimum discretization step. Smaller intervals will be merged. Needs to be bigger than limitEpsilon to avoid
+ * interpolation problems
+ * @return vector of discrete time points
+ */
+std::vector<AnnotatedTime> timeDiscretizationWithEvents(scalar_t initTime, scalar_t finalTime, const std::function<scalar_t(scalar_t)>& dt,
+                                                        const scalar_array_t& eventTimes,
+                                                        scalar_t dt_min = 10.0 * numeric_traits::limitEpsilon<scalar_t>());
+
+/**
+ * Decides on time discretization along the horizon with a non-uniform step schedule. Tries to make the step of the schedule from each
+ * node, but will also ensure that event times are part of the discretization.
+ *
+ * @param initTime : start time.
+ * @param finalTime : final time.
+ * @param stepSchedule : desired discretization step, relative to the start time.
+ * @param eventTimes : Event times where a time discretization must be made.
+ * @param dt_min : minimum discretization step. Smaller intervals will be merged. Needs to be bigger than limitEpsilon to avoid
+ * interpolation problems
+ * @return vector of discrete time points
+ */
+std::vector<AnnotatedTime> timeDiscretizationWithEvents(scalar_t initTime, scalar_t finalTime, const HorizonStepSchedule& stepSchedule,
+                                                        const scalar_array_t& eventTimes,
+                                                        scalar_t dt_min = 10.0 * numeric_traits::limitEpsilon<scalar_t>());
+
 /**
  * Extracts the time trajectory from the annotated time trajectory.
  *
@@ -40,6 +40,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <ocs2_core/cost/StateCostCollection.h>
 #include <ocs2_core/cost/StateInputCostCollection.h>
 #include <ocs2_core/dynamics/SystemDynamicsBase.h>
+#include <ocs2_core/misc/TermProfiler.h>
 #include <ocs2_core/reference/TargetTrajectories.h>
 
 namespace ocs2 {
@@ -115,6 +116,9 @@ struct OptimalControlProblem {
   /** The cost desired trajectories (will be substitute by ReferenceManager) */
   const TargetTrajectories* targetTrajectoriesPtr;
 
+  /** The profiler of the cost and constraint terms, nullptr if profiling is disabled (see enableTermProfiling()) */
+  std::shared_ptr<TermProfiler> termProfilerPtr;
+
   /** Default constructor */
   OptimalControlProblem();
 
@@ -135,6 +139,15 @@ struct OptimalControlProblem {
 
   /** Swap */
   void swap(OptimalControlProblem& other) noexcept;
+
+  /**
+   * Enables the profiling of the cost, soft constraint, constraint, and Lagrangian terms. The terms are registered by the name of
+   * their collection and their own name, e.g. "softConstraint/frictionCone". The copies of the problem share the profiler, such that
+   * the statistics of all worker threads of a solver are aggregated. It should be called before the problem is passed to the solver.
+   *
+   * @return The profiler of the terms.
+   */
+  std::shared_ptr<TermProfiler> enableTermProfiling();
 };
 
 }  // namespace ocs2
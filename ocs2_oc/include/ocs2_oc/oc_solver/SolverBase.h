@@ -133,6 +133,23 @@ class SolverBase {
     synchronizedModules_.push_back(std::move(synchronizedModule));
   }
 
+  /**
+   * Returns true if modules are synchronized with the solver, i.e. the problem may change right before it is solved.
+   */
+  bool hasSynchronizedModules() const { return !synchronizedModules_.empty(); }
+
+  /**
+   * Returns a counter that increases whenever the optimal control problem may have changed outside of the ReferenceManager, i.e. a
+   * synchronized module that modifies the problem was updated or markProblemModified() was called.
+   */
+  size_t getProblemEpoch() const { return problemEpoch_; }
+
+  /**
+   * Notifies the solver that the optimal control problem was changed outside of the ReferenceManager and the synchronized modules, e.g.
+   * the parameters of a cost were set directly. Increases the problem epoch.
+   */
+  void markProblemModified() { ++problemEpoch_; }
+
   /**
    * Adds an observer to probe the dual solution or optimized metrics.
    * @note: Observers will slow down the MPC. Only employ them during debugging and remove them for deployment.
@@ -270,6 +287,7 @@ class SolverBase {
   std::shared_ptr<ReferenceManagerInterface> referenceManagerPtr_;  // this pointer cannot be nullptr
   std::vector<std::shared_ptr<SolverSynchronizedModule>> synchronizedModules_;
   std::vector<std::unique_ptr<SolverObserver>> solverObservers_;
+  size_t problemEpoch_ = 0;
 };
 
 }  // namespace ocs2
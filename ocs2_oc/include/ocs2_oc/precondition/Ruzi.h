@@ -94,6 +94,31 @@ void ocpDataInPlaceInParallel(ThreadPool& threadPool, const vector_t& x0, const
                               std::vector<ScalarFunctionQuadraticApproximation>& cost, vector_array_t& DOut, vector_array_t& EOut,
                               vector_array_t& scalingVectors, scalar_t& cOut);
 
+/**
+ * Incremental variant of the above for a sequence of similar problems, e.g. the subproblems of one MPC run. If warmStart is set and the
+ * given scaling {DOut, EOut, cOut} matches the size of the problem, the data is first scaled by it. The iterations then only correct for
+ * the change of the data since the previous problem. The iterations stop once all row and column scaling factors of an iteration deviate
+ * less than the tolerance from 1, or after maxIteration.
+ *
+ * @param [in] threadPool : The external thread pool.
+ * @param [in] x0 : The initial state.
+ * @param [in] ocpSize : The size of the oc problem.
+ * @param [in] maxIteration : Maximum number of iterations.
+ * @param [in] tolerance : Convergence tolerance on the deviation of the scaling factors from 1. A zero tolerance runs all iterations.
+ * @param [in] warmStart : Whether to start from the given scaling {DOut, EOut, cOut}.
+ * @param [in, out] dynamics : The dynamics array of all time points.
+ * @param [in, out] cost : The cost array of all time points.
+ * @param [in, out] DOut : The matrix D decomposed for each time step.
+ * @param [in, out] EOut : The matrix E decomposed for each time step.
+ * @param [out] scalingVectors : Vector representation for the identity parts of the dynamics constraints inside the constraint matrix.
+ * @param [in, out] cOut : Scaling factor c.
+ * @return The number of iterations.
+ */
+int ocpDataInPlaceInParallel(ThreadPool& threadPool, const vector_t& x0, const OcpSize& ocpSize, int maxIteration, scalar_t tolerance,
+                             bool warmStart, std::vector<VectorFunctionLinearApproximation>& dynamics,
+                             std::vector<ScalarFunctionQuadraticApproximation>& cost, vector_array_t& DOut, vector_array_t& EOut,
+                             vector_array_t& scalingVectors, scalar_t& cOut);
+
 /**
  * Calculates the pre-conditioning factors D, E, and c, and scale the input dynamics, and cost data in place in place.
  *
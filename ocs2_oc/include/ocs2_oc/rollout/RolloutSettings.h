@@ -53,6 +53,9 @@ struct Settings {
   scalar_t timeStep = 1e-2;
   /** Rollout integration scheme type */
   IntegratorType integratorType = IntegratorType::ODE45;
+  /** Whether TimeTriggeredRollout integrates EULER and RK4 in place into preallocated trajectories instead of going through odeint.
+   *  The results are bit-identical to the odeint path. */
+  bool useFixedStepIntegrator = false;
 
   /** Whether to check that the rollout is numerically stable */
   bool checkNumericalStability = false;
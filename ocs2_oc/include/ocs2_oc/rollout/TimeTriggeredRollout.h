@@ -30,6 +30,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include <ocs2_core/dynamics/ControlledSystemBase.h>
 #include <ocs2_core/integration/Integrator.h>
@@ -49,7 +51,7 @@ class TimeTriggeredRollout : public RolloutBase {
    * Constructor.
    *
    * @param [in] systemDynamics: The system dynamics for forward rollout.
-   * @param [in] rolloutSettings: The rollout settings.
+   * @param [in] rolloutSettings: The rollout settings. If useFixedStepIntegrator is set, integratorType should be EULER or RK4.
    */
   explicit TimeTriggeredRollout(const ControlledSystemBase& systemDynamics, rollout::Settings rolloutSettings = rollout::Settings());
 
@@ -69,12 +71,31 @@ class TimeTriggeredRollout : public RolloutBase {
                vector_array_t& inputTrajectory) override;
 
  private:
+  /**
+   * Fixed-step counterpart of the odeint-based integration in run(). It reserves the exact trajectory size from the time step
+   * and the mode schedule and integrates in place into the output trajectories. It replicates the time grid of odeint's
+   * integrate_adaptive for basic steppers as well as the arithmetic of its EULER and RK4 steppers, therefore its result is
+   * bit-identical to the odeint path.
+   */
+  void runFixedStep(const std::vector<std::pair<scalar_t, scalar_t>>& timeIntervalArray, const vector_t& initState, int maxNumSteps,
+                    scalar_array_t& timeTrajectory, size_array_t& postEventIndices, vector_array_t& stateTrajectory,
+                    vector_array_t& inputTrajectory);
+
+  /** Performs one EULER or RK4 step from (t, x) with step size dt and writes the result to xNext. */
+  void fixedStep(scalar_t t, scalar_t dt, const vector_t& x, vector_t& xNext, int maxNumSteps);
+
+  /** Evaluates the closed-loop flow map and checks the number of function calls in the same way as IntegratorBase. */
+  void computeFlowMap(scalar_t t, const vector_t& x, vector_t& dxdt, int maxNumSteps);
+
   std::unique_ptr<PreComputation> preCompPtr_;
   std::unique_ptr<ControlledSystemBase> systemDynamicsPtr_;
 
   std::shared_ptr<SystemEventHandler> systemEventHandlersPtr_;
 
   std::unique_ptr<IntegratorBase> dynamicsIntegratorPtr_;
+
+  // fixed-step integrator workspace
+  vector_t k1_, k2_, k3_, k4_, xTmp_;
 };
 
 }  // namespace ocs2
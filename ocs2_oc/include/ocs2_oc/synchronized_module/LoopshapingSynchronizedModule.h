@@ -49,6 +49,8 @@ class LoopshapingSynchronizedModule : public SolverSynchronizedModule {
 
   void postSolverRun(const PrimalSolution& primalSolution) override;
 
+  bool modifiesProblem() const override;
+
   void add(std::shared_ptr<ocs2::SolverSynchronizedModule> module) { synchronizedModulesPtrArray_.push_back(std::move(module)); }
 
  private:
@@ -63,6 +63,13 @@ class SolverSynchronizedModule {
    * @param primalSolution : primalSolution
    */
   virtual void postSolverRun(const PrimalSolution& primalSolution) = 0;
+
+  /**
+   * Returns true if preSolverRun may change the optimal control problem outside of the ReferenceManager, e.g. parameters of its dynamics,
+   * costs or constraints. Solvers that reuse linearizations across runs discard them after such an update. Modules that only read the
+   * solution or only update the ReferenceManager can return false.
+   */
+  virtual bool modifiesProblem() const { return true; }
 };
 
 }  // namespace ocs2
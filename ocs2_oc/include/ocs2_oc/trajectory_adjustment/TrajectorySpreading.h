@@ -29,7 +29,11 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #pragma once
 
+#include <cmath>
+#include <limits>
+
 #include <ocs2_core/Types.h>
+#include <ocs2_core/misc/Lookup.h>
 #include <ocs2_core/reference/ModeSchedule.h>
 
 namespace ocs2 {
@@ -123,11 +127,15 @@ class TrajectorySpreading final {
    */
   size_array_t findPostEventIndices(const scalar_array_t& eventTimes, const scalar_array_t& timeTrajectory) const {
     size_array_t postEventIndices(eventTimes.size());
+    int indexHint = 0;  // the event times are sorted, so each search starts at the previous result
     for (std::size_t i = 0; i < eventTimes.size(); i++) {
       if (i == eventTimes.size() - 1 && eventTimes[i] == timeTrajectory.back()) {
         postEventIndices[i] = timeTrajectory.size() - 1;
       } else {
-        postEventIndices[i] = upperBoundIndex(timeTrajectory, eventTimes[i]);
+        // the first time larger than the event time is the first time not smaller than its successor (upper bound)
+        const auto eventTimeSuccessor = std::nextafter(eventTimes[i], std::numeric_limits<scalar_t>::infinity());
+        indexHint = lookup::findIndexInTimeArray(timeTrajectory, eventTimeSuccessor, indexHint);
+        postEventIndices[i] = indexHint;
       }
     }
     return postEventIndices;
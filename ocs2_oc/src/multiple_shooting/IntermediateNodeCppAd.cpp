@@ -0,0 +1,264 @@
+/******************************************************************************
+Copyright (c) 2020, Farbod Farshidian. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#include "ocs2_oc/multiple_shooting/IntermediateNodeCppAd.h"
+
+namespace ocs2 {
+namespace multiple_shooting {
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void IntermediateNodeCppAd::initialize(size_t stateDim, size_t inputDim, size_t parameterDim, SensitivityIntegratorType integratorType,
+                                       const std::string& modelName, const std::string& modelFolder, bool recompileLibraries,
+                                       bool verbose) {
+  stateDim_ = stateDim;
+  inputDim_ = inputDim;
+  integratorType_ = integratorType;
+
+  // The output dimensions are not stored in the library. Evaluate the node once, without recording, to obtain them.
+  {
+    ad_vector_t stateDerivative, costResidual, softConstraintValue, equalityConstraintValue, inequalityConstraintValue;
+    nodeFunction(ad_scalar_t(0.0), ad_vector_t::Zero(stateDim), ad_vector_t::Zero(inputDim), ad_vector_t::Zero(parameterDim),
+                 stateDerivative, costResidual, softConstraintValue, equalityConstraintValue, inequalityConstraintValue);
+    numCostResiduals_ = costResidual.size();
+    numSoftConstraints_ = softConstraintValue.size();
+    numEqualityConstraints_ = equalityConstraintValue.size();
+    numInequalityConstraints_ = inequalityConstraintValue.size();
+  }
+
+  auto nodeAd = [=](const ad_vector_t& x, const ad_vector_t& p, ad_vector_t& y) {
+    assert(x.rows() == stateDim + inputDim);
+    assert(p.rows() == 2 + parameterDim);
+    const ad_vector_t state = x.head(stateDim);
+    const ad_vector_t input = x.tail(inputDim);
+    const ad_scalar_t time = p(0);
+    const ad_scalar_t dt = p(1);
+    const ad_vector_t parameters = p.tail(parameterDim);
+
+    ad_vector_t stateDerivative, costResidual, softConstraintValue, equalityConstraintValue, inequalityConstraintValue;
+    this->nodeFunction(time, state, input, parameters, stateDerivative, costResidual, softConstraintValue, equalityConstraintValue,
+                       inequalityConstraintValue);
+
+    y.resize(stateDim + numCostResiduals_ + numSoftConstraints_ + numEqualityConstraints_ + numInequalityConstraints_);
+    y.head(stateDim) = this->discretizeFlowMap(time, dt, state, input, parameters, stateDerivative);
+    y.segment(stateDim, numCostResiduals_) = costResidual;
+    y.segment(stateDim + numCostResiduals_, numSoftConstraints_) = softConstraintValue;
+    y.segment(stateDim + numCostResiduals_ + numSoftConstraints_, numEqualityConstraints_) = equalityConstraintValue;
+    y.tail(numInequalityConstraints_) = inequalityConstraintValue;
+  };
+  adInterfacePtr_.reset(new CppAdInterface(nodeAd, stateDim + inputDim, 2 + parameterDim, modelName, modelFolder));
+
+  if (recompileLibraries) {
+    adInterfacePtr_->createModels(CppAdInterface::ApproximationOrder::First, verbose);
+  } else {
+    adInterfacePtr_->loadModelsIfAvailable(CppAdInterface::ApproximationOrder::First, verbose);
+  }
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+IntermediateNodeCppAd::IntermediateNodeCppAd(const IntermediateNodeCppAd& rhs)
+    : adInterfacePtr_(rhs.adInterfacePtr_ != nullptr ? new CppAdInterface(*rhs.adInterfacePtr_) : nullptr),
+      softConstraintPenaltyPtr_(rhs.softConstraintPenaltyPtr_ != nullptr ? new MultidimensionalPenalty(*rhs.softConstraintPenaltyPtr_)
+                                                                          : nullptr),
+      integratorType_(rhs.integratorType_),
+      stateDim_(rhs.stateDim_),
+      inputDim_(rhs.inputDim_),
+      numCostResiduals_(rhs.numCostResiduals_),
+      numSoftConstraints_(rhs.numSoftConstraints_),
+      numEqualityConstraints_(rhs.numEqualityConstraints_),
+      numInequalityConstraints_(rhs.numInequalityConstraints_) {}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void IntermediateNodeCppAd::setSoftConstraintPenalty(std::unique_ptr<PenaltyBase> penaltyPtr) {
+  softConstraintPenaltyPtr_.reset(new MultidimensionalPenalty(std::move(penaltyPtr)));
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+Transcription IntermediateNodeCppAd::setupIntermediateNode(scalar_t t, scalar_t dt, const vector_t& x, const vector_t& x_next,
+                                                           const vector_t& u, const TargetTrajectories& targetTrajectories) const {
+  if (adInterfacePtr_ == nullptr) {
+    throw std::runtime_error("[IntermediateNodeCppAd] The model is not initialized!");
+  }
+  if (numSoftConstraints_ > 0 && softConstraintPenaltyPtr_ == nullptr) {
+    throw std::runtime_error("[IntermediateNodeCppAd] The penalty of the soft constraints is not set!");
+  }
+
+  const vector_t parameters = getParameters(t, targetTrajectories);
+  vector_t tapedParameters(2 + parameters.size());
+  tapedParameters << t, dt, parameters;
+  vector_t tapedStateInput(stateDim_ + inputDim_);
+  tapedStateInput << x, u;
+
+  const vector_t values = adInterfacePtr_->getFunctionValue(tapedStateInput, tapedParameters);
+  const matrix_t jacobian = adInterfacePtr_->getJacobian(tapedStateInput, tapedParameters);
+
+  Transcription transcription;
+
+  // Dynamics: dx_{k+1} = A_{k} * dx_{k} + B_{k} * du_{k} + b_{k}
+  auto& dynamics = transcription.dynamics;
+  dynamics.f = values.head(stateDim_) - x_next;
+  dynamics.dfdx = jacobian.topLeftCorner(stateDim_, stateDim_);
+  dynamics.dfdu = jacobian.topRightCorner(stateDim_, inputDim_);
+
+  // Costs: Gauss-Newton approximation of 0.5 ||r||^2, the integral is approximated with forward euler
+  auto& cost = transcription.cost;
+  const auto costResidual = values.segment(stateDim_, numCostResiduals_);
+  const auto drdx = jacobian.block(stateDim_, 0, numCostResiduals_, stateDim_);
+  const auto drdu = jacobian.block(stateDim_, stateDim_, numCostResiduals_, inputDim_);
+  cost.f = 0.5 * costResidual.squaredNorm();
+  cost.dfdx.noalias() = drdx.transpose() * costResidual;
+  cost.dfdu.noalias() = drdu.transpose() * costResidual;
+  cost.dfdxx.noalias() = drdx.transpose() * drdx;
+  cost.dfdux.noalias() = drdu.transpose() * drdx;
+  cost.dfduu.noalias() = drdu.transpose() * drdu;
+
+  // Soft constraints: penalty of the linearized constraints
+  if (numSoftConstraints_ > 0) {
+    const auto termsSize = getSoftConstraintTermsSize();
+    std::vector<bool> isTermActive(termsSize.size());
+    for (size_t i = 0; i < termsSize.size(); ++i) {
+      isTermActive[i] = isSoftConstraintTermActive(i, t);
+    }
+    size_array_t activeTermsSize;
+    const auto softConstraints =
+        selectActiveRows(jacobian, values, stateDim_ + numCostResiduals_, termsSize, isTermActive, activeTermsSize);
+    if (softConstraints.f.size() > 0) {
+      cost += softConstraintPenaltyPtr_->getQuadraticApproximation(t, softConstraints);
+    }
+  }
+  cost *= dt;
+
+  // State-input equality constraints
+  if (numEqualityConstraints_ > 0) {
+    const auto termsSize = getEqualityConstraintTermsSize();
+    std::vector<bool> isTermActive(termsSize.size());
+    for (size_t i = 0; i < termsSize.size(); ++i) {
+      isTermActive[i] = isEqualityConstraintTermActive(i, t);
+    }
+    transcription.stateInputEqConstraints = selectActiveRows(jacobian, values, stateDim_ + numCostResiduals_ + numSoftConstraints_,
+                                                             termsSize, isTermActive, transcription.constraintsSize.stateInputEq);
+  }
+
+  // State-input inequality constraints
+  if (numInequalityConstraints_ > 0) {
+    const auto termsSize = getInequalityConstraintTermsSize();
+    std::vector<bool> isTermActive(termsSize.size());
+    for (size_t i = 0; i < termsSize.size(); ++i) {
+      isTermActive[i] = isInequalityConstraintTermActive(i, t);
+    }
+    const size_t offset = stateDim_ + numCostResiduals_ + numSoftConstraints_ + numEqualityConstraints_;
+    transcription.stateInputIneqConstraints =
+        selectActiveRows(jacobian, values, offset, termsSize, isTermActive, transcription.constraintsSize.stateInputIneq);
+  }
+
+  return transcription;
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void IntermediateNodeCppAd::nodeFunction(const ad_scalar_t& time, const ad_vector_t& state, const ad_vector_t& input,
+                                         const ad_vector_t& parameters, ad_vector_t& stateDerivative, ad_vector_t& costResidual,
+                                         ad_vector_t& softConstraintValue, ad_vector_t& equalityConstraintValue,
+                                         ad_vector_t& inequalityConstraintValue) const {
+  stateDerivative = flowMap(time, state, input, parameters);
+  costResidual = costVectorFunction(time, state, input, parameters);
+  softConstraintValue = softConstraint(time, state, input, parameters);
+  equalityConstraintValue = equalityConstraint(time, state, input, parameters);
+  inequalityConstraintValue = inequalityConstraint(time, state, input, parameters);
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+ad_vector_t IntermediateNodeCppAd::discretizeFlowMap(const ad_scalar_t& time, const ad_scalar_t& dt, const ad_vector_t& state,
+                                                     const ad_vector_t& input, const ad_vector_t& parameters, const ad_vector_t& k1) const {
+  switch (integratorType_) {
+    case SensitivityIntegratorType::EULER: {
+      return state + dt * k1;
+    }
+    case SensitivityIntegratorType::RK2: {
+      const ad_scalar_t dt_halve = dt / 2.0;
+      const ad_vector_t k2 = flowMap(time + dt, state + dt * k1, input, parameters);
+      return state + dt_halve * (k1 + k2);
+    }
+    case SensitivityIntegratorType::RK4: {
+      const ad_scalar_t dt_halve = dt / 2.0;
+      const ad_scalar_t dt_sixth = dt / 6.0;
+      const ad_vector_t k2 = flowMap(time + dt_halve, state + dt_halve * k1, input, parameters);
+      const ad_vector_t k3 = flowMap(time + dt_halve, state + dt_halve * k2, input, parameters);
+      const ad_vector_t k4 = flowMap(time + dt, state + dt * k3, input, parameters);
+      return state + dt_sixth * (k1 + k4) + (2.0 * dt_sixth) * (k2 + k3);
+    }
+    default:
+      throw std::runtime_error("[IntermediateNodeCppAd] Integrator of type " + sensitivity_integrator::toString(integratorType_) +
+                               " not supported.");
+  }
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+VectorFunctionLinearApproximation IntermediateNodeCppAd::selectActiveRows(const matrix_t& jacobian, const vector_t& values, size_t offset,
+                                                                          const size_array_t& termsSize,
+                                                                          const std::vector<bool>& isTermActive,
+                                                                          size_array_t& activeTermsSize) const {
+  activeTermsSize.assign(termsSize.size(), 0);
+  size_t numActive = 0;
+  for (size_t i = 0; i < termsSize.size(); ++i) {
+    if (isTermActive[i]) {
+      activeTermsSize[i] = termsSize[i];
+      numActive += termsSize[i];
+    }
+  }
+
+  auto approximation = VectorFunctionLinearApproximation::Zero(numActive, stateDim_, inputDim_);
+  size_t tapedRow = offset;
+  size_t activeRow = 0;
+  for (size_t i = 0; i < termsSize.size(); ++i) {
+    if (isTermActive[i]) {
+      approximation.f.segment(activeRow, termsSize[i]) = values.segment(tapedRow, termsSize[i]);
+      approximation.dfdx.middleRows(activeRow, termsSize[i]) = jacobian.block(tapedRow, 0, termsSize[i], stateDim_);
+      approximation.dfdu.middleRows(activeRow, termsSize[i]) = jacobian.block(tapedRow, stateDim_, termsSize[i], inputDim_);
+      activeRow += termsSize[i];
+    }
+    tapedRow += termsSize[i];
+  }
+  return approximation;
+}
+
+}  // namespace multiple_shooting
+}  // namespace ocs2
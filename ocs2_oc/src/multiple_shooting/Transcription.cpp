@@ -37,6 +37,18 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 namespace ocs2 {
 namespace multiple_shooting {
 
+namespace {
+/** Concatenates the values of the constraint terms into the value of the constraint collection */
+void setConstraintValue(const vector_array_t& termValues, VectorFunctionLinearApproximation& constraint) {
+  Eigen::Index offset = 0;
+  for (const auto& value : termValues) {
+    constraint.f.segment(offset, value.size()) = value;
+    offset += value.size();
+  }
+  assert(offset == constraint.f.size());
+}
+}  // anonymous namespace
+
 Transcription setupIntermediateNode(OptimalControlProblem& optimalControlProblem, DynamicsSensitivityDiscretizer& sensitivityDiscretizer,
                                     scalar_t t, scalar_t dt, const vector_t& x, const vector_t& x_next, const vector_t& u) {
   // Results and short-hand notation
@@ -93,6 +105,26 @@ Transcription setupIntermediateNode(OptimalControlProblem& optimalControlProblem
   return transcription;
 }
 
+void updateIntermediateNode(Transcription& transcription, const vector_t& dx, const vector_t& du, const Metrics& metrics) {
+  auto& cost = transcription.cost;
+
+  // Cost: exact value, first-order update of the gradient
+  cost.f = metrics.cost;
+  cost.dfdx.noalias() += cost.dfdxx * dx;
+  if (du.size() > 0) {
+    cost.dfdx.noalias() += cost.dfdux.transpose() * du;
+    cost.dfdu.noalias() += cost.dfdux * dx;
+    cost.dfdu.noalias() += cost.dfduu * du;
+  }
+
+  // Dynamics and constraints: exact values
+  transcription.dynamics.f = metrics.dynamicsViolation;
+  setConstraintValue(metrics.stateEqConstraint, transcription.stateEqConstraints);
+  setConstraintValue(metrics.stateInputEqConstraint, transcription.stateInputEqConstraints);
+  setConstraintValue(metrics.stateIneqConstraint, transcription.stateIneqConstraints);
+  setConstraintValue(metrics.stateInputIneqConstraint, transcription.stateInputIneqConstraints);
+}
+
 void projectTranscription(Transcription& transcription, bool extractProjectionMultiplier) {
   auto& cost = transcription.cost;
   auto& dynamics = transcription.dynamics;
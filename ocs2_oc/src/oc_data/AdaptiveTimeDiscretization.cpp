@@ -0,0 +1,131 @@
+/******************************************************************************
+Copyright (c) 2020, Farbod Farshidian. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#include "ocs2_oc/oc_data/AdaptiveTimeDiscretization.h"
+
+#include <algorithm>
+
+namespace ocs2 {
+
+namespace {
+/** Step doubling estimate of the local error of one discretization step: compares one step of size dt with two steps of size dt/2. */
+scalar_t estimateLocalError(SystemDynamicsBase& dynamics, const DynamicsDiscretizer& discretizer, scalar_t t, scalar_t dt,
+                            const vector_t& x, const vector_t& u) {
+  const vector_t fullStep = discretizer(dynamics, t, x, u, dt);
+  const vector_t halfStep = discretizer(dynamics, t, x, u, 0.5 * dt);
+  const vector_t twoHalfSteps = discretizer(dynamics, t + 0.5 * dt, halfStep, u, 0.5 * dt);
+  return (fullStep - twoHalfSteps).lpNorm<Eigen::Infinity>();
+}
+}  // unnamed namespace
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+AdaptiveTimeDiscretization::AdaptiveTimeDiscretization(Settings settings) : settings_(std::move(settings)) {
+  if (settings_.dtMin <= 0.0 || settings_.dtMin > settings_.dtMax) {
+    throw std::runtime_error("[AdaptiveTimeDiscretization] The step bounds should satisfy 0 < dtMin <= dtMax.");
+  }
+  if (settings_.coarseningTolerance > settings_.refinementTolerance) {
+    throw std::runtime_error("[AdaptiveTimeDiscretization] The coarsening tolerance should not exceed the refinement tolerance.");
+  }
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void AdaptiveTimeDiscretization::reset() {
+  profileTimes_.clear();
+  profileStepSizes_.clear();
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+scalar_t AdaptiveTimeDiscretization::getStepSize(scalar_t time) const {
+  if (profileStepSizes_.empty() || time < profileTimes_.front() || time >= profileTimes_.back()) {
+    return settings_.dt;
+  }
+  const auto upperIt = std::upper_bound(profileTimes_.cbegin(), profileTimes_.cend(), time);
+  return profileStepSizes_[std::distance(profileTimes_.cbegin(), upperIt) - 1];
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+std::vector<AnnotatedTime> AdaptiveTimeDiscretization::getTimeDiscretization(scalar_t initTime, scalar_t finalTime,
+                                                                             const scalar_array_t& eventTimes) const {
+  return timeDiscretizationWithEvents(
+      initTime, finalTime, [this](scalar_t t) { return getStepSize(t); }, eventTimes);
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void AdaptiveTimeDiscretization::update(const std::vector<AnnotatedTime>& timeDiscretization, const vector_array_t& stateTrajectory,
+                                        const vector_array_t& inputTrajectory, SystemDynamicsBase& dynamics,
+                                        const DynamicsDiscretizer& discretizer) {
+  const auto numNodes = timeDiscretization.size();
+  if (numNodes < 2 || stateTrajectory.size() + 1 < numNodes || inputTrajectory.size() + 1 < numNodes) {
+    throw std::runtime_error("[AdaptiveTimeDiscretization] The solution should have a state and an input per interval.");
+  }
+
+  const int N = static_cast<int>(numNodes) - 1;
+  scalar_array_t newProfileTimes;
+  scalar_array_t newProfileStepSizes;
+  newProfileTimes.reserve(N + 1);
+  newProfileStepSizes.reserve(N);
+  for (int i = 0; i < N; ++i) {
+    if (timeDiscretization[i].event == AnnotatedTime::Event::PreEvent) {
+      continue;  // the event node does not span an interval
+    }
+
+    // The desired rather than the actual interval length is adapted, since intervals are truncated at events and the final time.
+    const scalar_t t = timeDiscretization[i].time;
+    const scalar_t dt = timeDiscretization[i + 1].time - t;
+    const scalar_t error = estimateLocalError(dynamics, discretizer, t, dt, stateTrajectory[i], inputTrajectory[i]);
+    scalar_t stepSize = getStepSize(t);
+    if (error > settings_.refinementTolerance) {
+      stepSize = std::max(0.5 * stepSize, settings_.dtMin);
+    } else if (error < settings_.coarseningTolerance) {
+      stepSize = std::min(2.0 * stepSize, settings_.dtMax);
+    }
+
+    if (!newProfileStepSizes.empty() && newProfileStepSizes.back() == stepSize) {
+      continue;  // extend the current segment
+    }
+    newProfileTimes.push_back(t);
+    newProfileStepSizes.push_back(stepSize);
+  }
+  newProfileTimes.push_back(timeDiscretization.back().time);
+
+  profileTimes_.swap(newProfileTimes);
+  profileStepSizes_.swap(newProfileStepSizes);
+}
+
+}  // namespace ocs2
@@ -29,10 +29,53 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "ocs2_oc/oc_data/TimeDiscretization.h"
 
+#include <algorithm>
+
 #include <ocs2_core/misc/Lookup.h>
 
 namespace ocs2 {
 
+scalar_t HorizonStepSchedule::getStepSize(scalar_t timeSinceStart) const {
+  assert(dt.size() == switchingTimes.size() + 1);
+  const size_t index = std::upper_bound(switchingTimes.begin(), switchingTimes.end(), timeSinceStart) - switchingTimes.begin();
+  if (index < switchingTimes.size() || growthFactor == 1.0) {
+    return dt[index];
+  }
+
+  // Geometric growth: a step of dt + (growthFactor - 1) * tau grows by growthFactor from one node to the next
+  const scalar_t lastSwitchingTime = switchingTimes.empty() ? 0.0 : switchingTimes.back();
+  const scalar_t step = dt.back() + (growthFactor - 1.0) * (timeSinceStart - lastSwitchingTime);
+  return std::min(step, dtMax);
+}
+
+HorizonStepSchedule createHorizonStepSchedule(scalar_t dt, const scalar_array_t& dtSwitchingTimes, const scalar_array_t& dtSchedule,
+                                              scalar_t growthFactor, scalar_t dtMax) {
+  if (dtSchedule.size() != dtSwitchingTimes.size()) {
+    throw std::runtime_error("[createHorizonStepSchedule] dtSchedule needs one time step for each of the dtSwitchingTimes.");
+  }
+  if (!(dt > 0.0) || !std::all_of(dtSchedule.begin(), dtSchedule.end(), [](scalar_t step) { return step > 0.0; })) {
+    throw std::runtime_error("[createHorizonStepSchedule] The time steps dt and dtSchedule have to be positive.");
+  }
+  if (!std::is_sorted(dtSwitchingTimes.begin(), dtSwitchingTimes.end())) {
+    throw std::runtime_error("[createHorizonStepSchedule] dtSwitchingTimes have to be sorted in increasing order.");
+  }
+  if (!(growthFactor >= 1.0)) {
+    throw std::runtime_error("[createHorizonStepSchedule] The time step growth factor has to be at least one.");
+  }
+  if (growthFactor > 1.0 && !(dtMax > 0.0)) {
+    throw std::runtime_error("[createHorizonStepSchedule] The upper bound of the growing time step has to be positive.");
+  }
+
+  HorizonStepSchedule stepSchedule;
+  stepSchedule.switchingTimes = dtSwitchingTimes;
+  stepSchedule.dt.reserve(dtSchedule.size() + 1);
+  stepSchedule.dt.push_back(dt);
+  stepSchedule.dt.insert(stepSchedule.dt.end(), dtSchedule.begin(), dtSchedule.end());
+  stepSchedule.growthFactor = growthFactor;
+  stepSchedule.dtMax = dtMax;
+  return stepSchedule;
+}
+
 scalar_t getInterpolationTime(const AnnotatedTime& annotatedTime) {
   return annotatedTime.time + numeric_traits::limitEpsilon<scalar_t>();
 }
@@ -60,6 +103,18 @@ scalar_t getIntervalDuration(const AnnotatedTime& start, const AnnotatedTime& en
 std::vector<AnnotatedTime> timeDiscretizationWithEvents(scalar_t initTime, scalar_t finalTime, scalar_t dt,
                                                         const scalar_array_t& eventTimes, scalar_t dt_min) {
   assert(dt > 0);
+  return timeDiscretizationWithEvents(
+      initTime, finalTime, [dt](scalar_t) { return dt; }, eventTimes, dt_min);
+}
+
+std::vector<AnnotatedTime> timeDiscretizationWithEvents(scalar_t initTime, scalar_t finalTime, const HorizonStepSchedule& stepSchedule,
+                                                        const scalar_array_t& eventTimes, scalar_t dt_min) {
+  return timeDiscretizationWithEvents(
+      initTime, finalTime, [&](scalar_t t) { return stepSchedule.getStepSize(t - initTime); }, eventTimes, dt_min);
+}
+
+std::vector<AnnotatedTime> timeDiscretizationWithEvents(scalar_t initTime, scalar_t finalTime, const std::function<scalar_t(scalar_t)>& dt,
+                                                        const scalar_array_t& eventTimes, scalar_t dt_min) {
   assert(finalTime > initTime);
   std::vector<AnnotatedTime> timeDiscretization;
 
@@ -70,7 +125,9 @@ std::vector<AnnotatedTime> timeDiscretizationWithEvents(scalar_t initTime, scala
   // Fill iteratively with pre event, post events are added later
   AnnotatedTime nextNode = timeDiscretization.back();
   while (timeDiscretization.back().time < finalTime) {
-    nextNode.time = nextNode.time + dt;
+    const scalar_t step = dt(nextNode.time);
+    assert(step > 0);
+    nextNode.time = nextNode.time + step;
     nextNode.event = AnnotatedTime::Event::None;
 
     // Check if an event has passed
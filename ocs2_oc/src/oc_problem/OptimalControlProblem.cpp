@@ -103,7 +103,8 @@ OptimalControlProblem::OptimalControlProblem(const OptimalControlProblem& other)
       finalInequalityLagrangianPtr(other.finalInequalityLagrangianPtr->clone()),
       /* Misc. */
       preComputationPtr(other.preComputationPtr->clone()),
-      targetTrajectoriesPtr(other.targetTrajectoriesPtr) {
+      targetTrajectoriesPtr(other.targetTrajectoriesPtr),
+      termProfilerPtr(other.termProfilerPtr) {
   if (other.dynamicsPtr != nullptr) {
     dynamicsPtr.reset(other.dynamicsPtr->clone());
   }
@@ -162,6 +163,52 @@ void OptimalControlProblem::swap(OptimalControlProblem& other) noexcept {
   /* Misc. */
   preComputationPtr.swap(other.preComputationPtr);
   std::swap(targetTrajectoriesPtr, other.targetTrajectoriesPtr);
+  termProfilerPtr.swap(other.termProfilerPtr);
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+std::shared_ptr<TermProfiler> OptimalControlProblem::enableTermProfiling() {
+  if (termProfilerPtr == nullptr) {
+    termProfilerPtr = std::make_shared<TermProfiler>();
+  }
+
+  /* Cost */
+  costPtr->setTermProfiler(termProfilerPtr, "cost");
+  stateCostPtr->setTermProfiler(termProfilerPtr, "stateCost");
+  preJumpCostPtr->setTermProfiler(termProfilerPtr, "preJumpCost");
+  finalCostPtr->setTermProfiler(termProfilerPtr, "finalCost");
+
+  /* Soft constraints */
+  softConstraintPtr->setTermProfiler(termProfilerPtr, "softConstraint");
+  stateSoftConstraintPtr->setTermProfiler(termProfilerPtr, "stateSoftConstraint");
+  preJumpSoftConstraintPtr->setTermProfiler(termProfilerPtr, "preJumpSoftConstraint");
+  finalSoftConstraintPtr->setTermProfiler(termProfilerPtr, "finalSoftConstraint");
+
+  /* Equality constraints */
+  equalityConstraintPtr->setTermProfiler(termProfilerPtr, "equalityConstraint");
+  stateEqualityConstraintPtr->setTermProfiler(termProfilerPtr, "stateEqualityConstraint");
+  preJumpEqualityConstraintPtr->setTermProfiler(termProfilerPtr, "preJumpEqualityConstraint");
+  finalEqualityConstraintPtr->setTermProfiler(termProfilerPtr, "finalEqualityConstraint");
+
+  /* Inequality constraints */
+  inequalityConstraintPtr->setTermProfiler(termProfilerPtr, "inequalityConstraint");
+  stateInequalityConstraintPtr->setTermProfiler(termProfilerPtr, "stateInequalityConstraint");
+  preJumpInequalityConstraintPtr->setTermProfiler(termProfilerPtr, "preJumpInequalityConstraint");
+  finalInequalityConstraintPtr->setTermProfiler(termProfilerPtr, "finalInequalityConstraint");
+
+  /* Lagrangians */
+  equalityLagrangianPtr->setTermProfiler(termProfilerPtr, "equalityLagrangian");
+  stateEqualityLagrangianPtr->setTermProfiler(termProfilerPtr, "stateEqualityLagrangian");
+  inequalityLagrangianPtr->setTermProfiler(termProfilerPtr, "inequalityLagrangian");
+  stateInequalityLagrangianPtr->setTermProfiler(termProfilerPtr, "stateInequalityLagrangian");
+  preJumpEqualityLagrangianPtr->setTermProfiler(termProfilerPtr, "preJumpEqualityLagrangian");
+  preJumpInequalityLagrangianPtr->setTermProfiler(termProfilerPtr, "preJumpInequalityLagrangian");
+  finalEqualityLagrangianPtr->setTermProfiler(termProfilerPtr, "finalEqualityLagrangian");
+  finalInequalityLagrangianPtr->setTermProfiler(termProfilerPtr, "finalInequalityLagrangian");
+
+  return termProfilerPtr;
 }
 
 }  // namespace ocs2
@@ -27,6 +27,7 @@ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 ******************************************************************************/
 
+#include <algorithm>
 #include <iostream>
 #include <mutex>
 
@@ -96,6 +97,11 @@ void SolverBase::preRun(scalar_t initTime, const vector_t& initState, scalar_t f
   for (auto& module : synchronizedModules_) {
     module->preSolverRun(initTime, finalTime, initState, *referenceManagerPtr_);
   }
+
+  const auto modifiesProblem = [](const std::shared_ptr<SolverSynchronizedModule>& module) { return module->modifiesProblem(); };
+  if (std::any_of(synchronizedModules_.begin(), synchronizedModules_.end(), modifiesProblem)) {
+    ++problemEpoch_;
+  }
 }
 
 /******************************************************************************************************/
@@ -29,9 +29,11 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "ocs2_oc/precondition/Ruzi.h"
 
+#include <algorithm>
 #include <atomic>
 #include <functional>
 #include <numeric>
+#include <tuple>
 
 namespace ocs2 {
 namespace precondition {
@@ -49,45 +51,19 @@ scalar_t limitScaling(const scalar_t& v) {
   }
 }
 
+/** Raises infNorm to the infinity norm of the rows of mat where the latter is larger. */
 template <typename T>
-vector_t matrixInfNormRows(const Eigen::MatrixBase<T>& mat) {
-  if (mat.rows() == 0 || mat.cols() == 0) {
-    return vector_t(0);
-  } else {
-    return mat.rowwise().template lpNorm<Eigen::Infinity>();
-  }
-}
-
-template <typename T, typename... Rest>
-vector_t matrixInfNormRows(const Eigen::MatrixBase<T>& mat, const Eigen::MatrixBase<Rest>&... rest) {
-  vector_t temp = matrixInfNormRows(rest...);
-  if (mat.rows() == 0 || mat.cols() == 0) {
-    return temp;
-  } else if (temp.rows() != 0) {
-    return mat.rowwise().template lpNorm<Eigen::Infinity>().cwiseMax(temp);
-  } else {
-    return mat.rowwise().template lpNorm<Eigen::Infinity>();
+void maxInfNormRowsInPlace(const Eigen::MatrixBase<T>& mat, vector_t& infNorm) {
+  if (mat.size() > 0) {
+    infNorm = infNorm.cwiseMax(mat.rowwise().template lpNorm<Eigen::Infinity>());
   }
 }
 
+/** Raises infNorm to the infinity norm of the columns of mat where the latter is larger. */
 template <typename T>
-vector_t matrixInfNormCols(const Eigen::MatrixBase<T>& mat) {
-  if (mat.rows() == 0 || mat.cols() == 0) {
-    return vector_t(0);
-  } else {
-    return mat.colwise().template lpNorm<Eigen::Infinity>().transpose();
-  }
-}
-
-template <typename T, typename... Rest>
-vector_t matrixInfNormCols(const Eigen::MatrixBase<T>& mat, const Eigen::MatrixBase<Rest>&... rest) {
-  vector_t temp = matrixInfNormCols(rest...);
-  if (mat.rows() == 0 || mat.cols() == 0) {
-    return temp;
-  } else if (temp.rows() != 0) {
-    return mat.colwise().template lpNorm<Eigen::Infinity>().transpose().cwiseMax(temp);
-  } else {
-    return mat.colwise().template lpNorm<Eigen::Infinity>().transpose();
+void maxInfNormColsInPlace(const Eigen::MatrixBase<T>& mat, vector_t& infNorm) {
+  if (mat.size() > 0) {
+    infNorm = infNorm.cwiseMax(mat.colwise().template lpNorm<Eigen::Infinity>().transpose());
   }
 }
 
@@ -101,32 +77,74 @@ void scaleMatrixInPlace(const vector_t* rowScale, const vector_t* colScale, Eige
   }
 }
 
-void invSqrtInfNormInParallel(ThreadPool& threadPool, const std::vector<VectorFunctionLinearApproximation>& dynamics,
-                              const std::vector<ScalarFunctionQuadraticApproximation>& cost, const vector_array_t& scalingVectors,
-                              vector_array_t& D, vector_array_t& E) {
-  // Helper function
-  auto invSqrt = [](const vector_t& v) -> vector_t { return v.unaryExpr(std::ref(limitScaling)).array().sqrt().inverse(); };
+/**
+ * Computes the Ruiz scaling factors D and E, i.e. the inverse square root of the infinity norms of the columns and rows of the KKT matrix.
+ * The norms are accumulated stage-wise into the preallocated D and E without forming transposed copies of the data.
+ *
+ * @return The largest deviation of the factors from 1.
+ */
+scalar_t invSqrtInfNormInParallel(ThreadPool& threadPool, const OcpSize& ocpSize,
+                                  const std::vector<VectorFunctionLinearApproximation>& dynamics,
+                                  const std::vector<ScalarFunctionQuadraticApproximation>& cost, const vector_array_t& scalingVectors,
+                                  vector_array_t& D, vector_array_t& E) {
+  // Helper function, turns the infinity norms in v into scaling factors and returns their largest deviation from 1
+  auto invSqrtInPlace = [](vector_t& v) -> scalar_t {
+    v = v.unaryExpr(std::ref(limitScaling)).array().sqrt().inverse();
+    return v.size() > 0 ? (v.array() - 1.0).abs().maxCoeff() : 0.0;
+  };
 
   // resize
-  const int N = static_cast<int>(cost.size()) - 1;
+  const int N = ocpSize.numStages;
   E.resize(N);
   D.resize(2 * N);
 
-  D[0] = invSqrt(matrixInfNormCols(cost[0].dfduu, dynamics[0].dfdu));
-  E[0] = invSqrt(matrixInfNormRows(dynamics[0].dfdu, scalingVectors[0]));
+  D[0].setZero(ocpSize.numInputs[0]);
+  maxInfNormColsInPlace(cost[0].dfduu, D[0]);
+  maxInfNormColsInPlace(dynamics[0].dfdu, D[0]);
+  E[0].setZero(ocpSize.numStates[1]);
+  maxInfNormRowsInPlace(dynamics[0].dfdu, E[0]);
+  E[0] = E[0].cwiseMax(scalingVectors[0].cwiseAbs());
+  scalar_t maxDeviation = std::max(invSqrtInPlace(D[0]), invSqrtInPlace(E[0]));
 
+  const size_t numWorkers = threadPool.numThreads() + 1U;
+  scalar_array_t maxDeviationArray(numWorkers, 0.0);
   std::atomic_int timeStamp{1};
   auto task = [&](int workerId) {
     int k;
     while ((k = timeStamp++) < N) {
-      D[2 * k - 1] = invSqrt(matrixInfNormCols(cost[k].dfdxx, cost[k].dfdux, scalingVectors[k - 1].transpose().eval(), dynamics[k].dfdx));
-      D[2 * k] = invSqrt(matrixInfNormCols(cost[k].dfdux.transpose().eval(), cost[k].dfduu, dynamics[k].dfdu));
-      E[k] = invSqrt(matrixInfNormRows(dynamics[k].dfdx, dynamics[k].dfdu, scalingVectors[k]));
+      // columns of [Q; P; C'; A] of the state x_k
+      auto& Dx = D[2 * k - 1];
+      Dx.setZero(ocpSize.numStates[k]);
+      maxInfNormColsInPlace(cost[k].dfdxx, Dx);
+      maxInfNormColsInPlace(cost[k].dfdux, Dx);
+      Dx = Dx.cwiseMax(scalingVectors[k - 1].cwiseAbs());
+      maxInfNormColsInPlace(dynamics[k].dfdx, Dx);
+
+      // columns of [P'; R; B] of the input u_k
+      auto& Du = D[2 * k];
+      Du.setZero(ocpSize.numInputs[k]);
+      maxInfNormRowsInPlace(cost[k].dfdux, Du);
+      maxInfNormColsInPlace(cost[k].dfduu, Du);
+      maxInfNormColsInPlace(dynamics[k].dfdu, Du);
+
+      // rows of [A, B, C] of the dynamics of x_{k+1}
+      E[k].setZero(ocpSize.numStates[k + 1]);
+      maxInfNormRowsInPlace(dynamics[k].dfdx, E[k]);
+      maxInfNormRowsInPlace(dynamics[k].dfdu, E[k]);
+      E[k] = E[k].cwiseMax(scalingVectors[k].cwiseAbs());
+
+      const scalar_t deviation = std::max({invSqrtInPlace(Dx), invSqrtInPlace(Du), invSqrtInPlace(E[k])});
+      maxDeviationArray[workerId] = std::max(maxDeviationArray[workerId], deviation);
     }
   };
-  threadPool.runParallel(std::move(task), threadPool.numThreads() + 1U);
+  threadPool.runParallel(std::move(task), numWorkers);
+
+  D[2 * N - 1].setZero(ocpSize.numStates[N]);
+  maxInfNormColsInPlace(cost[N].dfdxx, D[2 * N - 1]);
+  D[2 * N - 1] = D[2 * N - 1].cwiseMax(scalingVectors[N - 1].cwiseAbs());
+  maxDeviation = std::max(maxDeviation, invSqrtInPlace(D[2 * N - 1]));
 
-  D[2 * N - 1] = invSqrt(matrixInfNormCols(cost[N].dfdxx, scalingVectors[N - 1].transpose().eval()));
+  return std::max(maxDeviation, *std::max_element(maxDeviationArray.cbegin(), maxDeviationArray.cend()));
 }
 
 void scaleDataOneStepInPlaceInParallel(ThreadPool& threadPool, const vector_array_t& D, const vector_array_t& E,
@@ -211,32 +229,81 @@ void ocpDataInPlaceInParallel(ThreadPool& threadPool, const vector_t& x0, const
                               std::vector<VectorFunctionLinearApproximation>& dynamics,
                               std::vector<ScalarFunctionQuadraticApproximation>& cost, vector_array_t& DOut, vector_array_t& EOut,
                               vector_array_t& scalingVectors, scalar_t& cOut) {
+  std::ignore = ocpDataInPlaceInParallel(threadPool, x0, ocpSize, iteration, 0.0, false, dynamics, cost, DOut, EOut, scalingVectors, cOut);
+}
+
+int ocpDataInPlaceInParallel(ThreadPool& threadPool, const vector_t& x0, const OcpSize& ocpSize, const int maxIteration,
+                             const scalar_t tolerance, const bool warmStart, std::vector<VectorFunctionLinearApproximation>& dynamics,
+                             std::vector<ScalarFunctionQuadraticApproximation>& cost, vector_array_t& DOut, vector_array_t& EOut,
+                             vector_array_t& scalingVectors, scalar_t& cOut) {
   const int N = ocpSize.numStages;
   if (N < 1) {
     throw std::runtime_error("[precondition::ocpDataInPlaceInParallel] The number of stages cannot be less than 1.");
   }
 
+  const auto numDecisionVariables = std::accumulate(ocpSize.numInputs.begin(), ocpSize.numInputs.end(), 0) +
+                                    std::accumulate(std::next(ocpSize.numStates.begin()), ocpSize.numStates.end(), 0);
+
+  std::atomic_int timeIndex{0};
+  const size_t numWorkers = threadPool.numThreads() + 1U;
+
+  auto scaleCostInParallel = [&](scalar_t gamma) {
+    timeIndex = 0;
+    auto scaleCost = [&](int workerId) {
+      int k;
+      while ((k = timeIndex++) <= N) {
+        cost[k].dfdxx *= gamma;
+        cost[k].dfduu *= gamma;
+        cost[k].dfdux *= gamma;
+        cost[k].dfdx *= gamma;
+        cost[k].dfdu *= gamma;
+      }
+    };
+    threadPool.runParallel(std::move(scaleCost), numWorkers);
+  };
+
+  const bool isScalingConsistent = [&]() {
+    if (DOut.size() != 2 * N || EOut.size() != N) {
+      return false;
+    }
+    for (int i = 0; i < N; i++) {
+      if (DOut[2 * i].size() != ocpSize.numInputs[i] || DOut[2 * i + 1].size() != ocpSize.numStates[i + 1] ||
+          EOut[i].size() != ocpSize.numStates[i + 1]) {
+        return false;
+      }
+    }
+    return true;
+  }();
+
   // Init output
-  cOut = 1.0;
-  DOut.resize(2 * N);
-  EOut.resize(N);
   scalingVectors.resize(N);
   for (int i = 0; i < N; i++) {
-    DOut[2 * i].setOnes(ocpSize.numInputs[i]);
-    DOut[2 * i + 1].setOnes(ocpSize.numStates[i + 1]);
-    EOut[i].setOnes(ocpSize.numStates[i + 1]);
     scalingVectors[i].setOnes(ocpSize.numStates[i + 1]);
   }
-
-  const auto numDecisionVariables = std::accumulate(ocpSize.numInputs.begin(), ocpSize.numInputs.end(), 0) +
-                                    std::accumulate(std::next(ocpSize.numStates.begin()), ocpSize.numStates.end(), 0);
+  if (warmStart && isScalingConsistent) {
+    // Start from the scaling of the previous problem, the iterations below only correct for the change of the data
+    scaleDataOneStepInPlaceInParallel(threadPool, DOut, EOut, dynamics, cost, scalingVectors);
+    scaleCostInParallel(cOut);
+  } else {
+    cOut = 1.0;
+    DOut.resize(2 * N);
+    EOut.resize(N);
+    for (int i = 0; i < N; i++) {
+      DOut[2 * i].setOnes(ocpSize.numInputs[i]);
+      DOut[2 * i + 1].setOnes(ocpSize.numStates[i + 1]);
+      EOut[i].setOnes(ocpSize.numStates[i + 1]);
+    }
+  }
 
   vector_array_t D(2 * N), E(N);
-  std::atomic_int timeIndex{0};
-  const size_t numWorkers = threadPool.numThreads() + 1U;
-  for (int i = 0; i < iteration; i++) {
-    invSqrtInfNormInParallel(threadPool, dynamics, cost, scalingVectors, D, E);
-    scaleDataOneStepInPlaceInParallel(threadPool, D, E, dynamics, cost, scalingVectors);
+  int numIterations = 0;
+  bool isConverged = false;
+  while (!isConverged && numIterations < maxIteration) {
+    // The data is equilibrated once no row and column needs to be scaled by more than the tolerance
+    isConverged = invSqrtInfNormInParallel(threadPool, ocpSize, dynamics, cost, scalingVectors, D, E) < tolerance;
+    if (!isConverged) {
+      scaleDataOneStepInPlaceInParallel(threadPool, D, E, dynamics, cost, scalingVectors);
+    }
 
     timeIndex = 0;
     scalar_array_t infNormOfhArray(numWorkers, 0.0);
@@ -244,19 +311,30 @@ void ocpDataInPlaceInParallel(ThreadPool& threadPool, const vector_t& x0, const
     auto infNormOfh_sumOfInfNormOfH = [&](int workerId) {
       scalar_t workerInfNormOfh = 0.0;
       scalar_t workerSumOfInfNormOfH = 0.0;
+      vector_t infNormOfHCols;
 
       int k = timeIndex++;
       if (k == 0) {  // Only one worker will execute this
         workerInfNormOfh = (cost[0].dfdu + cost[0].dfdux * x0).lpNorm<Eigen::Infinity>();
-        workerSumOfInfNormOfH = matrixInfNormCols(cost[0].dfduu).derived().sum();
+        infNormOfHCols.setZero(ocpSize.numInputs[0]);
+        maxInfNormColsInPlace(cost[0].dfduu, infNormOfHCols);
+        workerSumOfInfNormOfH = infNormOfHCols.sum();
         k = timeIndex++;
       }
 
       while (k <= N) {
         workerInfNormOfh = std::max(workerInfNormOfh, cost[k].dfdx.lpNorm<Eigen::Infinity>());
         workerInfNormOfh = std::max(workerInfNormOfh, cost[k].dfdu.lpNorm<Eigen::Infinity>());
-        workerSumOfInfNormOfH += matrixInfNormCols(cost[k].dfdxx, cost[k].dfdux).derived().sum();
-        workerSumOfInfNormOfH += matrixInfNormCols(cost[k].dfdux.transpose().eval(), cost[k].dfduu).derived().sum();
+        // columns of [Q; P] of the state x_k
+        infNormOfHCols.setZero(ocpSize.numStates[k]);
+        maxInfNormColsInPlace(cost[k].dfdxx, infNormOfHCols);
+        maxInfNormColsInPlace(cost[k].dfdux, infNormOfHCols);
+        workerSumOfInfNormOfH += infNormOfHCols.sum();
+        // columns of [P'; R] of the input u_k
+        infNormOfHCols.setZero(ocpSize.numInputs[k]);
+        maxInfNormRowsInPlace(cost[k].dfdux, infNormOfHCols);
+        maxInfNormColsInPlace(cost[k].dfduu, infNormOfHCols);
+        workerSumOfInfNormOfH += infNormOfHCols.sum();
         k = timeIndex++;
       }
 
@@ -270,36 +348,23 @@ void ocpDataInPlaceInParallel(ThreadPool& threadPool, const vector_t& x0, const
     const auto averageOfInfNormOfH = sumOfInfNormOfH / static_cast<scalar_t>(numDecisionVariables);
     const auto gamma = 1.0 / limitScaling(std::max(averageOfInfNormOfH, infNormOfh));
 
-    // compute EOut, DOut, and scale cost
-    timeIndex = 0;
-    auto computeDOutEOutScaleCost = [&](int workerId) {
-      int k = timeIndex++;
-      while (k < N) {
+    // compute EOut and DOut
+    if (!isConverged) {
+      for (int k = 0; k < N; k++) {
         EOut[k].array() *= E[k].array();
         DOut[2 * k].array() *= D[2 * k].array();
         DOut[2 * k + 1].array() *= D[2 * k + 1].array();
-        // cost
-        cost[k].dfdxx *= gamma;
-        cost[k].dfduu *= gamma;
-        cost[k].dfdux *= gamma;
-        cost[k].dfdx *= gamma;
-        cost[k].dfdu *= gamma;
-
-        k = timeIndex++;
       }
-      if (k == N) {  // Only one worker will execute this
-        cost[N].dfdxx *= gamma;
-        cost[N].dfduu *= gamma;
-        cost[N].dfdux *= gamma;
-        cost[N].dfdx *= gamma;
-        cost[N].dfdu *= gamma;
-      }
-    };
-    threadPool.runParallel(std::move(computeDOutEOutScaleCost), numWorkers);
+    }
 
-    // compute cOut
+    // scale cost and compute cOut
+    scaleCostInParallel(gamma);
     cOut *= gamma;
+
+    ++numIterations;
   }
+
+  return numIterations;
 }
 
 void kktMatrixInPlace(int iteration, Eigen::SparseMatrix<scalar_t>& H, vector_t& h, Eigen::SparseMatrix<scalar_t>& G, vector_t& g,
@@ -56,6 +56,7 @@ Settings loadSettings(const std::string& filename, const std::string& fieldName,
   auto integratorName = integrator_type::toString(settings.integratorType);  // keep default
   loadData::loadPtreeValue(pt, integratorName, fieldName + ".integratorType", verbose);
   settings.integratorType = integrator_type::fromString(integratorName);
+  loadData::loadPtreeValue(pt, settings.useFixedStepIntegrator, fieldName + ".useFixedStepIntegrator", verbose);
 
   loadData::loadPtreeValue(pt, settings.checkNumericalStability, fieldName + ".checkNumericalStability", verbose);
   loadData::loadPtreeValue(pt, settings.reconstructInputTrajectory, fieldName + ".reconstructInputTrajectory", verbose);
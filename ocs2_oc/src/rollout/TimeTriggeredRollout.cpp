@@ -29,8 +29,39 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "ocs2_oc/rollout/TimeTriggeredRollout.h"
 
+#include <cmath>
+#include <limits>
+#include <sstream>
+
 namespace ocs2 {
 
+namespace {
+
+/**
+ * Number of full steps which odeint's integrate_const takes on [startTime, finalTime], i.e. the number of steps for which
+ * startTime + (step + 1) * dt does not exceed finalTime by more than the machine epsilon.
+ */
+size_t numFullSteps(scalar_t startTime, scalar_t finalTime, scalar_t dt) {
+  constexpr scalar_t eps = std::numeric_limits<scalar_t>::epsilon();
+  const auto isFullStep = [&](size_t step) { return (startTime + static_cast<scalar_t>(step) * dt) + dt - finalTime <= eps; };
+
+  auto numSteps = static_cast<size_t>(std::max(0.0, std::floor((finalTime - startTime) / dt)));
+  while (numSteps > 0 && !isFullStep(numSteps - 1)) {
+    numSteps--;
+  }
+  while (isFullStep(numSteps)) {
+    numSteps++;
+  }
+  return numSteps;
+}
+
+/** Whether odeint's integrate_adaptive adds a truncated step after the full steps to end exactly at finalTime. */
+bool hasTruncatedStep(scalar_t lastFullStepTime, scalar_t finalTime) {
+  return finalTime - lastFullStepTime > std::numeric_limits<scalar_t>::epsilon();
+}
+
+}  // unnamed namespace
+
 /******************************************************************************************************/
 /******************************************************************************************************/
 /******************************************************************************************************/
@@ -38,6 +69,12 @@ TimeTriggeredRollout::TimeTriggeredRollout(const ControlledSystemBase& systemDyn
     : RolloutBase(std::move(rolloutSettings)), systemDynamicsPtr_(systemDynamics.clone()), systemEventHandlersPtr_(new SystemEventHandler) {
   // construct dynamicsIntegratorsPtr
   dynamicsIntegratorPtr_ = std::move(newIntegrator(this->settings().integratorType, systemEventHandlersPtr_));
+
+  if (this->settings().useFixedStepIntegrator && this->settings().integratorType != IntegratorType::EULER &&
+      this->settings().integratorType != IntegratorType::RK4) {
+    throw std::runtime_error("[TimeTriggeredRollout] The fixed-step integrator only supports EULER and RK4, but " +
+                             integrator_type::toString(this->settings().integratorType) + " is requested!");
+  }
 }
 
 /******************************************************************************************************/
@@ -61,6 +98,17 @@ vector_t TimeTriggeredRollout::run(scalar_t initTime, const vector_t& initState,
   // max number of steps for integration
   const auto maxNumSteps = static_cast<size_t>(this->settings().maxNumStepsPerSecond * std::max(1.0, finalTime - initTime));
 
+  if (this->settings().useFixedStepIntegrator) {
+    systemDynamicsPtr_->setController(controller);
+    systemDynamicsPtr_->resetNumFunctionCalls();
+    systemEventHandlersPtr_->reset();
+
+    runFixedStep(timeIntervalArray, initState, maxNumSteps, timeTrajectory, postEventIndices, stateTrajectory, inputTrajectory);
+
+    this->checkNumericalStability(*controller, timeTrajectory, postEventIndices, stateTrajectory, inputTrajectory);
+    return stateTrajectory.back();
+  }
+
   // clearing the output trajectories
   timeTrajectory.clear();
   timeTrajectory.reserve(maxNumSteps + 1);
@@ -81,7 +129,8 @@ vector_t TimeTriggeredRollout::run(scalar_t initTime, const vector_t& initState,
   systemEventHandlersPtr_->reset();
 
   vector_t beginState = initState;
-  int k_u = 0;  // control input iterator
+  int k_u = 0;                      // control input iterator
+  int controllerTimeIndexHint = 0;  // lookup hint of the controller
   for (int i = 0; i < numSubsystems; i++) {
     if (timeIntervalArray[i].first < timeIntervalArray[i].second) {
       Observer observer(&stateTrajectory, &timeTrajectory);  // concatenate trajectory
@@ -97,7 +146,9 @@ vector_t TimeTriggeredRollout::run(scalar_t initTime, const vector_t& initState,
     // compute control input trajectory and concatenate to inputTrajectory
     if (this->settings().reconstructInputTrajectory) {
       for (; k_u < timeTrajectory.size(); k_u++) {
-        inputTrajectory.emplace_back(systemDynamicsPtr_->controllerPtr()->computeInput(timeTrajectory[k_u], stateTrajectory[k_u]));
+        inputTrajectory.emplace_back();
+        systemDynamicsPtr_->controllerPtr()->computeInputRealTime(timeTrajectory[k_u], stateTrajectory[k_u], inputTrajectory.back(),
+                                                                  controllerTimeIndexHint);
       }  // end of k_u loop
     }
 
@@ -115,4 +166,124 @@ vector_t TimeTriggeredRollout::run(scalar_t initTime, const vector_t& initState,
   return stateTrajectory.back();
 }
 
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void TimeTriggeredRollout::runFixedStep(const std::vector<std::pair<scalar_t, scalar_t>>& timeIntervalArray, const vector_t& initState,
+                                        int maxNumSteps, scalar_array_t& timeTrajectory, size_array_t& postEventIndices,
+                                        vector_array_t& stateTrajectory, vector_array_t& inputTrajectory) {
+  const scalar_t dt = this->settings().timeStep;
+  const int numSubsystems = timeIntervalArray.size();
+  const int numEvents = numSubsystems - 1;
+
+  // exact size of the trajectories
+  size_t trajectorySize = 0;
+  for (const auto& interval : timeIntervalArray) {
+    trajectorySize++;
+    if (interval.first < interval.second) {
+      const auto numSteps = numFullSteps(interval.first, interval.second, dt);
+      trajectorySize += numSteps;
+      if (hasTruncatedStep(interval.first + dt * static_cast<scalar_t>(numSteps), interval.second)) {
+        trajectorySize++;
+      }
+    }
+  }
+
+  // resizing keeps the already allocated states of a previous rollout
+  timeTrajectory.resize(trajectorySize);
+  stateTrajectory.resize(trajectorySize);
+  inputTrajectory.resize(this->settings().reconstructInputTrajectory ? trajectorySize : 0);
+  postEventIndices.clear();
+  postEventIndices.reserve(numEvents);
+
+  // observes the point k the same way the odeint observer does
+  auto observe = [&](size_t k, scalar_t t) {
+    timeTrajectory[k] = t;
+    systemEventHandlersPtr_->handleEvent(*systemDynamicsPtr_, t, stateTrajectory[k]);
+  };
+
+  stateTrajectory.front() = initState;
+  size_t k = 0;  // trajectory iterator
+  for (int i = 0; i < numSubsystems; i++) {
+    const scalar_t startTime = timeIntervalArray[i].first;
+    const scalar_t finalTime = timeIntervalArray[i].second;
+
+    if (startTime < finalTime) {
+      const auto numSteps = numFullSteps(startTime, finalTime, dt);
+      for (size_t step = 0; step < numSteps; step++, k++) {
+        observe(k, startTime + static_cast<scalar_t>(step) * dt);
+        fixedStep(timeTrajectory[k], dt, stateTrajectory[k], stateTrajectory[k + 1], maxNumSteps);
+      }
+      observe(k, startTime + static_cast<scalar_t>(numSteps) * dt);
+
+      if (hasTruncatedStep(timeTrajectory[k], finalTime)) {
+        fixedStep(timeTrajectory[k], finalTime - timeTrajectory[k], stateTrajectory[k], stateTrajectory[k + 1], maxNumSteps);
+        k++;
+        observe(k, finalTime);
+      }
+    } else {
+      timeTrajectory[k] = finalTime;
+    }
+    k++;
+
+    // a jump has taken place
+    if (i < numEvents) {
+      postEventIndices.push_back(k);
+      stateTrajectory[k] = systemDynamicsPtr_->computeJumpMap(timeTrajectory[k - 1], stateTrajectory[k - 1]);
+    }
+  }  // end of i loop
+
+  // compute control input trajectory
+  if (this->settings().reconstructInputTrajectory) {
+    int controllerTimeIndexHint = 0;
+    for (size_t j = 0; j < trajectorySize; j++) {
+      systemDynamicsPtr_->controllerPtr()->computeInputRealTime(timeTrajectory[j], stateTrajectory[j], inputTrajectory[j],
+                                                                controllerTimeIndexHint);
+    }
+  }
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void TimeTriggeredRollout::fixedStep(scalar_t t, scalar_t dt, const vector_t& x, vector_t& xNext, int maxNumSteps) {
+  // the expressions follow odeint's euler and generic runge_kutta4 operation by operation, including the zero
+  // Butcher tableau entries, such that the rounding is identical.
+  computeFlowMap(t, x, k1_, maxNumSteps);
+
+  if (this->settings().integratorType == IntegratorType::EULER) {
+    xNext = 1.0 * x + dt * k1_;
+    return;
+  }
+
+  constexpr scalar_t oneHalf = 1.0 / 2.0;
+  constexpr scalar_t oneThird = 1.0 / 3.0;
+  constexpr scalar_t oneSixth = 1.0 / 6.0;
+
+  xTmp_ = 1.0 * x + (oneHalf * dt) * k1_;
+  computeFlowMap(t + oneHalf * dt, xTmp_, k2_, maxNumSteps);
+
+  xTmp_ = 1.0 * x + (0.0 * dt) * k1_ + (oneHalf * dt) * k2_;
+  computeFlowMap(t + oneHalf * dt, xTmp_, k3_, maxNumSteps);
+
+  xTmp_ = 1.0 * x + (0.0 * dt) * k1_ + (0.0 * dt) * k2_ + (1.0 * dt) * k3_;
+  computeFlowMap(t + 1.0 * dt, xTmp_, k4_, maxNumSteps);
+
+  xNext = 1.0 * x + (oneSixth * dt) * k1_ + (oneThird * dt) * k2_ + (oneThird * dt) * k3_ + (oneSixth * dt) * k4_;
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void TimeTriggeredRollout::computeFlowMap(scalar_t t, const vector_t& x, vector_t& dxdt, int maxNumSteps) {
+  dxdt = systemDynamicsPtr_->computeFlowMap(t, x);
+  // max number of function calls
+  if (systemDynamicsPtr_->incrementNumFunctionCalls() > maxNumSteps) {
+    std::stringstream msg;
+    msg << "Integration terminated since the maximum number of function calls is reached. State at termination time " << t << ":\n["
+        << x.transpose() << "]\n";
+    throw std::runtime_error(msg.str());
+  }
+}
+
 }  // namespace ocs2
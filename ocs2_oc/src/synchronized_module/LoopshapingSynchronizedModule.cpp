@@ -29,6 +29,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "ocs2_oc/synchronized_module/LoopshapingSynchronizedModule.h"
 
+#include <algorithm>
+
 #include "ocs2_oc/oc_data/LoopshapingPrimalSolution.h"
 
 namespace ocs2 {
@@ -59,4 +61,9 @@ void LoopshapingSynchronizedModule::postSolverRun(const PrimalSolution& primalSo
   }
 }
 
+bool LoopshapingSynchronizedModule::modifiesProblem() const {
+  return std::any_of(synchronizedModulesPtrArray_.begin(), synchronizedModulesPtrArray_.end(),
+                     [](const std::shared_ptr<SolverSynchronizedModule>& module) { return module->modifiesProblem(); });
+}
+
 }  // namespace ocs2
@@ -0,0 +1,254 @@
+/******************************************************************************
+Copyright (c) 2020, Farbod Farshidian. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <ocs2_core/constraint/StateInputConstraintCppAd.h>
+#include <ocs2_core/cost/StateInputGaussNewtonCostAd.h>
+#include <ocs2_core/dynamics/SystemDynamicsBaseAD.h>
+#include <ocs2_core/misc/Benchmark.h>
+#include <ocs2_core/penalties/penalties/RelaxedBarrierPenalty.h>
+#include <ocs2_core/soft_constraint/StateInputSoftConstraint.h>
+#include <ocs2_core/test/testTools.h>
+
+#include "ocs2_oc/multiple_shooting/IntermediateNodeCppAd.h"
+#include "ocs2_oc/multiple_shooting/Transcription.h"
+
+using namespace ocs2;
+
+namespace {
+
+constexpr size_t STATE_DIM = 4;
+constexpr size_t INPUT_DIM = 2;
+constexpr scalar_t SWITCH_TIME = 0.5;
+
+template <typename SCALAR_T>
+Eigen::Matrix<SCALAR_T, -1, 1> testFlowMap(const Eigen::Matrix<SCALAR_T, -1, 1>& x, const Eigen::Matrix<SCALAR_T, -1, 1>& u) {
+  Eigen::Matrix<SCALAR_T, -1, 1> dxdt(STATE_DIM);
+  dxdt << x(1), sin(x(0)) * u(0), x(3), cos(x(2)) + x(0) * u(1);
+  return dxdt;
+}
+
+template <typename SCALAR_T>
+Eigen::Matrix<SCALAR_T, -1, 1> testCostResidual(const Eigen::Matrix<SCALAR_T, -1, 1>& x, const Eigen::Matrix<SCALAR_T, -1, 1>& u) {
+  Eigen::Matrix<SCALAR_T, -1, 1> r(STATE_DIM + INPUT_DIM + 1);
+  r << x, u, sqrt(2.0) * x(0) * u(0);
+  return r;
+}
+
+template <typename SCALAR_T>
+Eigen::Matrix<SCALAR_T, -1, 1> testSoftConstraint(const Eigen::Matrix<SCALAR_T, -1, 1>& x, const Eigen::Matrix<SCALAR_T, -1, 1>& u) {
+  Eigen::Matrix<SCALAR_T, -1, 1> h(1);
+  h << 2.0 - x(0) * x(0) - u(1) * u(1);
+  return h;
+}
+
+RelaxedBarrierPenalty::Config testPenaltyConfig() {
+  return RelaxedBarrierPenalty::Config(0.1, 1.5);
+}
+
+template <typename SCALAR_T>
+Eigen::Matrix<SCALAR_T, -1, 1> testConstraint(const Eigen::Matrix<SCALAR_T, -1, 1>& x, const Eigen::Matrix<SCALAR_T, -1, 1>& u) {
+  Eigen::Matrix<SCALAR_T, -1, 1> g(2);
+  g << u(0) + x(1) * u(1) - sin(x(0)), u(1) - x(2);
+  return g;
+}
+
+class TestDynamics final : public SystemDynamicsBaseAD {
+ public:
+  TestDynamics() { initialize(STATE_DIM, INPUT_DIM, "testIntermediateNode_dynamics", "/tmp/ocs2", true, false); }
+  TestDynamics* clone() const override { return new TestDynamics(*this); }
+
+ protected:
+  ad_vector_t systemFlowMap(ad_scalar_t time, const ad_vector_t& state, const ad_vector_t& input,
+                            const ad_vector_t& parameters) const override {
+    return testFlowMap(state, input);
+  }
+};
+
+class TestCost final : public StateInputCostGaussNewtonAd {
+ public:
+  TestCost() { initialize(STATE_DIM, INPUT_DIM, 0, "testIntermediateNode_cost", "/tmp/ocs2", true, false); }
+  TestCost* clone() const override { return new TestCost(*this); }
+
+ protected:
+  TestCost(const TestCost& rhs) = default;
+  ad_vector_t costVectorFunction(ad_scalar_t time, const ad_vector_t& state, const ad_vector_t& input,
+                                 const ad_vector_t& parameters) const override {
+    return testCostResidual(state, input);
+  }
+};
+
+/** The soft constraint is only active after SWITCH_TIME. */
+class TestSoftConstraint final : public StateInputConstraintCppAd {
+ public:
+  TestSoftConstraint() : StateInputConstraintCppAd(ConstraintOrder::Linear) {
+    initialize(STATE_DIM, INPUT_DIM, 0, "testIntermediateNode_softConstraint", "/tmp/ocs2", true, false);
+  }
+  TestSoftConstraint* clone() const override { return new TestSoftConstraint(*this); }
+  bool isActive(scalar_t time) const override { return time > SWITCH_TIME; }
+  size_t getNumConstraints(scalar_t time) const override { return 1; }
+
+ protected:
+  TestSoftConstraint(const TestSoftConstraint& rhs) = default;
+  ad_vector_t constraintFunction(ad_scalar_t time, const ad_vector_t& state, const ad_vector_t& input,
+                                 const ad_vector_t& parameters) const override {
+    return testSoftConstraint(state, input);
+  }
+};
+
+/** The second row of the test constraint is only active before SWITCH_TIME. */
+class TestConstraint final : public StateInputConstraintCppAd {
+ public:
+  explicit TestConstraint(size_t row) : StateInputConstraintCppAd(ConstraintOrder::Linear), row_(row) {
+    initialize(STATE_DIM, INPUT_DIM, 0, "testIntermediateNode_constraint" + std::to_string(row), "/tmp/ocs2", true, false);
+  }
+  TestConstraint* clone() const override { return new TestConstraint(*this); }
+  bool isActive(scalar_t time) const override { return row_ == 0 || time < SWITCH_TIME; }
+  size_t getNumConstraints(scalar_t time) const override { return 1; }
+
+ protected:
+  TestConstraint(const TestConstraint& rhs) = default;
+  ad_vector_t constraintFunction(ad_scalar_t time, const ad_vector_t& state, const ad_vector_t& input,
+                                 const ad_vector_t& parameters) const override {
+    return testConstraint(state, input).segment(row_, 1);
+  }
+
+ private:
+  size_t row_;
+};
+
+class TestIntermediateNode final : public multiple_shooting::IntermediateNodeCppAd {
+ public:
+  TestIntermediateNode() {
+    setSoftConstraintPenalty(std::make_unique<RelaxedBarrierPenalty>(testPenaltyConfig()));
+    initialize(STATE_DIM, INPUT_DIM, 0, SensitivityIntegratorType::RK4, "testIntermediateNode_fused", "/tmp/ocs2", true, false);
+  }
+  TestIntermediateNode* clone() const override { return new TestIntermediateNode(*this); }
+  size_array_t getEqualityConstraintTermsSize() const override { return {1, 1}; }
+  bool isEqualityConstraintTermActive(size_t termIndex, scalar_t time) const override { return termIndex == 0 || time < SWITCH_TIME; }
+  bool isSoftConstraintTermActive(size_t termIndex, scalar_t time) const override { return time > SWITCH_TIME; }
+
+ protected:
+  TestIntermediateNode(const TestIntermediateNode& rhs) = default;
+  ad_vector_t flowMap(const ad_scalar_t& time, const ad_vector_t& state, const ad_vector_t& input,
+                      const ad_vector_t& parameters) const override {
+    return testFlowMap(state, input);
+  }
+  ad_vector_t costVectorFunction(const ad_scalar_t& time, const ad_vector_t& state, const ad_vector_t& input,
+                                 const ad_vector_t& parameters) const override {
+    return testCostResidual(state, input);
+  }
+  ad_vector_t softConstraint(const ad_scalar_t& time, const ad_vector_t& state, const ad_vector_t& input,
+                             const ad_vector_t& parameters) const override {
+    return testSoftConstraint(state, input);
+  }
+  ad_vector_t equalityConstraint(const ad_scalar_t& time, const ad_vector_t& state, const ad_vector_t& input,
+                                 const ad_vector_t& parameters) const override {
+    return testConstraint(state, input);
+  }
+};
+
+}  // namespace
+
+class IntermediateNodeCppAdTest : public ::testing::Test {
+ protected:
+  IntermediateNodeCppAdTest() {
+    problem.dynamicsPtr.reset(new TestDynamics());
+    problem.costPtr->add("cost", std::make_unique<TestCost>());
+    problem.softConstraintPtr->add("softConstraint", std::make_unique<StateInputSoftConstraint>(
+                                                         std::make_unique<TestSoftConstraint>(),
+                                                         std::make_unique<RelaxedBarrierPenalty>(testPenaltyConfig())));
+    problem.equalityConstraintPtr->add("constraint0", std::make_unique<TestConstraint>(0));
+    problem.equalityConstraintPtr->add("constraint1", std::make_unique<TestConstraint>(1));
+    problem.targetTrajectoriesPtr = &targetTrajectories;
+  }
+
+  void compare(scalar_t t) {
+    const scalar_t dt = 0.01;
+    const vector_t x = vector_t::Random(STATE_DIM);
+    const vector_t xNext = vector_t::Random(STATE_DIM);
+    const vector_t u = vector_t::Random(INPUT_DIM);
+
+    const auto expected = multiple_shooting::setupIntermediateNode(problem, sensitivityDiscretizer, t, dt, x, xNext, u);
+    const auto fused = fusedNode.setupIntermediateNode(t, dt, x, xNext, u, targetTrajectories);
+
+    EXPECT_TRUE(isApprox(fused.dynamics, expected.dynamics));
+    EXPECT_TRUE(isApprox(fused.cost, expected.cost));
+    EXPECT_TRUE(isApprox(fused.stateInputEqConstraints, expected.stateInputEqConstraints));
+    EXPECT_EQ(fused.constraintsSize.stateInputEq, expected.constraintsSize.stateInputEq);
+  }
+
+  TargetTrajectories targetTrajectories{{0.0}, {vector_t::Zero(STATE_DIM)}, {vector_t::Zero(INPUT_DIM)}};
+  OptimalControlProblem problem;
+  DynamicsSensitivityDiscretizer sensitivityDiscretizer = selectDynamicsSensitivityDiscretization(SensitivityIntegratorType::RK4);
+  TestIntermediateNode fusedNode;
+};
+
+TEST_F(IntermediateNodeCppAdTest, matchesTranscription) {
+  compare(0.0);
+  compare(2.0 * SWITCH_TIME);
+}
+
+TEST_F(IntermediateNodeCppAdTest, clone) {
+  std::unique_ptr<multiple_shooting::IntermediateNodeCppAd> clonePtr(fusedNode.clone());
+  const vector_t x = vector_t::Random(STATE_DIM);
+  const vector_t u = vector_t::Random(INPUT_DIM);
+  const auto original = fusedNode.setupIntermediateNode(0.0, 0.01, x, x, u, targetTrajectories);
+  const auto cloned = clonePtr->setupIntermediateNode(0.0, 0.01, x, x, u, targetTrajectories);
+  EXPECT_TRUE(isApprox(cloned.dynamics, original.dynamics));
+  EXPECT_TRUE(isApprox(cloned.cost, original.cost));
+  EXPECT_TRUE(isApprox(cloned.stateInputEqConstraints, original.stateInputEqConstraints));
+}
+
+TEST_F(IntermediateNodeCppAdTest, benchmark) {
+  constexpr int numRepeats = 1000;
+  const scalar_t dt = 0.01;
+  const vector_t x = vector_t::Random(STATE_DIM);
+  const vector_t u = vector_t::Random(INPUT_DIM);
+
+  // Warm up, such that the timing does not include loading the model libraries
+  multiple_shooting::setupIntermediateNode(problem, sensitivityDiscretizer, 0.0, dt, x, x, u);
+  fusedNode.setupIntermediateNode(0.0, dt, x, x, u, targetTrajectories);
+
+  benchmark::RepeatedTimer separateTimer;
+  benchmark::RepeatedTimer fusedTimer;
+  for (int i = 0; i < numRepeats; ++i) {
+    separateTimer.startTimer();
+    const auto separate = multiple_shooting::setupIntermediateNode(problem, sensitivityDiscretizer, 0.0, dt, x, x, u);
+    separateTimer.endTimer();
+
+    fusedTimer.startTimer();
+    const auto fused = fusedNode.setupIntermediateNode(0.0, dt, x, x, u, targetTrajectories);
+    fusedTimer.endTimer();
+  }
+
+  std::cerr << "[IntermediateNodeCppAd] per node, separate: " << separateTimer.getAverageInMilliseconds() * 1e3
+            << " [us], fused: " << fusedTimer.getAverageInMilliseconds() * 1e3 << " [us]\n";
+}
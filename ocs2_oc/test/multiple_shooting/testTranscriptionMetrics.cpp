@@ -37,6 +37,17 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 using namespace ocs2;
 
+namespace {
+bool isApprox(const VectorFunctionLinearApproximation& lhs, const VectorFunctionLinearApproximation& rhs, scalar_t tol) {
+  return lhs.f.isApprox(rhs.f, tol) && lhs.dfdx.isApprox(rhs.dfdx, tol) && lhs.dfdu.isApprox(rhs.dfdu, tol);
+}
+
+bool isApprox(const ScalarFunctionQuadraticApproximation& lhs, const ScalarFunctionQuadraticApproximation& rhs, scalar_t tol) {
+  return std::abs(lhs.f - rhs.f) < tol && lhs.dfdx.isApprox(rhs.dfdx, tol) && lhs.dfdu.isApprox(rhs.dfdu, tol) &&
+         lhs.dfdxx.isApprox(rhs.dfdxx, tol) && lhs.dfdux.isApprox(rhs.dfdux, tol) && lhs.dfduu.isApprox(rhs.dfduu, tol);
+}
+}  // namespace
+
 TEST(test_transcription_metrics, intermediate) {
   constexpr int nx = 2;
   constexpr int nu = 2;
@@ -119,3 +130,44 @@ TEST(test_transcription_metrics, terminal) {
 
   ASSERT_TRUE(metrics.isApprox(multiple_shooting::computeMetrics(transcription), 1e-12));
 }
+
+TEST(test_transcription_metrics, updateIntermediate) {
+  constexpr int nx = 3;
+  constexpr int nu = 2;
+
+  // linear-quadratic problem, for which the update is exact
+  OptimalControlProblem problem;
+  problem.dynamicsPtr = getOcs2Dynamics(getRandomDynamics(nx, nu));
+  problem.costPtr->add("intermediateCost", getOcs2Cost(getRandomCost(nx, nu)));
+  problem.equalityConstraintPtr->add("equalityConstraint", getOcs2Constraints(getRandomConstraints(nx, nu, 2)));
+  problem.stateEqualityConstraintPtr->add("stateEqualityConstraint", getOcs2StateOnlyConstraints(getRandomConstraints(nx, 0, 1)));
+  problem.inequalityConstraintPtr->add("inequalityConstraint", getOcs2Constraints(getRandomConstraints(nx, nu, 3)));
+  problem.inequalityConstraintPtr->add("inequalityConstraint2", getOcs2Constraints(getRandomConstraints(nx, nu, 1)));
+  problem.stateInequalityConstraintPtr->add("stateInequalityConstraint", getOcs2StateOnlyConstraints(getRandomConstraints(nx, 0, 4)));
+  const TargetTrajectories targetTrajectories({0.0}, {vector_t::Random(nx)}, {vector_t::Random(nu)});
+  problem.targetTrajectoriesPtr = &targetTrajectories;
+
+  auto discretizer = selectDynamicsDiscretization(SensitivityIntegratorType::RK4);
+  auto sensitivityDiscretizer = selectDynamicsSensitivityDiscretization(SensitivityIntegratorType::RK4);
+
+  const scalar_t t = 0.5;
+  const scalar_t dt = 0.1;
+  const vector_t x = vector_t::Random(nx);
+  const vector_t u = vector_t::Random(nu);
+  const vector_t dx = 0.1 * vector_t::Random(nx);
+  const vector_t du = 0.1 * vector_t::Random(nu);
+  const vector_t x_next = vector_t::Random(nx);
+
+  auto transcription = multiple_shooting::setupIntermediateNode(problem, sensitivityDiscretizer, t, dt, x, x_next, u);
+  const auto metrics = multiple_shooting::computeIntermediateMetrics(problem, discretizer, t, dt, x + dx, x_next, u + du);
+  multiple_shooting::updateIntermediateNode(transcription, dx, du, metrics);
+  const auto expected = multiple_shooting::setupIntermediateNode(problem, sensitivityDiscretizer, t, dt, x + dx, x_next, u + du);
+
+  constexpr scalar_t tol = 1e-9;
+  ASSERT_TRUE(isApprox(transcription.cost, expected.cost, tol));
+  ASSERT_TRUE(isApprox(transcription.dynamics, expected.dynamics, tol));
+  ASSERT_TRUE(isApprox(transcription.stateEqConstraints, expected.stateEqConstraints, tol));
+  ASSERT_TRUE(isApprox(transcription.stateInputEqConstraints, expected.stateInputEqConstraints, tol));
+  ASSERT_TRUE(isApprox(transcription.stateIneqConstraints, expected.stateIneqConstraints, tol));
+  ASSERT_TRUE(isApprox(transcription.stateInputIneqConstraints, expected.stateInputIneqConstraints, tol));
+}
@@ -0,0 +1,156 @@
+/******************************************************************************
+Copyright (c) 2020, Farbod Farshidian. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <iostream>
+
+#include <ocs2_core/integration/SensitivityIntegrator.h>
+
+#include "ocs2_oc/oc_data/AdaptiveTimeDiscretization.h"
+
+using namespace ocs2;
+
+namespace {
+/** Harmonic oscillator whose frequency rises smoothly from 1 to 10 rad/s around t = 0.5 */
+class SwitchedFrequencyOscillator final : public SystemDynamicsBase {
+ public:
+  SwitchedFrequencyOscillator* clone() const override { return new SwitchedFrequencyOscillator(*this); }
+
+  vector_t computeFlowMap(scalar_t t, const vector_t& x, const vector_t& u, const PreComputation&) override {
+    return (vector_t(2) << x(1), -omegaSquared(t) * x(0) + u(0)).finished();
+  }
+
+  VectorFunctionLinearApproximation linearApproximation(scalar_t t, const vector_t& x, const vector_t& u,
+                                                        const PreComputation& preComp) override {
+    VectorFunctionLinearApproximation approximation;
+    approximation.f = computeFlowMap(t, x, u, preComp);
+    approximation.dfdx = (matrix_t(2, 2) << 0.0, 1.0, -omegaSquared(t), 0.0).finished();
+    approximation.dfdu = (matrix_t(2, 1) << 0.0, 1.0).finished();
+    return approximation;
+  }
+
+ private:
+  static scalar_t omegaSquared(scalar_t t) { return 1.0 + 99.0 * std::exp(-std::pow((t - 0.5) / 0.05, 2)); }
+};
+
+/** Simulates the oscillator with a multiple shooting grid, returns the state at each node */
+vector_array_t simulate(SystemDynamicsBase& dynamics, const DynamicsDiscretizer& discretizer, const std::vector<AnnotatedTime>& time) {
+  const vector_t u = vector_t::Zero(1);
+  vector_array_t x{(vector_t(2) << 1.0, 0.0).finished()};
+  for (size_t i = 0; i + 1 < time.size(); ++i) {
+    x.push_back(discretizer(dynamics, time[i].time, x.back(), u, time[i + 1].time - time[i].time));
+  }
+  return x;
+}
+
+AdaptiveTimeDiscretization::Settings getSettings() {
+  AdaptiveTimeDiscretization::Settings settings;
+  settings.dt = 0.1;
+  settings.dtMin = 0.0125;
+  settings.dtMax = 0.2;
+  settings.refinementTolerance = 1e-4;
+  settings.coarseningTolerance = 1e-6;
+  return settings;
+}
+
+/** Refines and coarsens the grid of [0, 2] on the given number of consecutive solutions */
+std::vector<AnnotatedTime> adaptGrid(AdaptiveTimeDiscretization& adaptiveTimeDiscretization, int numUpdates) {
+  SwitchedFrequencyOscillator dynamics;
+  const auto discretizer = selectDynamicsDiscretization(SensitivityIntegratorType::RK4);
+  auto time = adaptiveTimeDiscretization.getTimeDiscretization(0.0, 2.0, {});
+  for (int k = 0; k < numUpdates; ++k) {
+    const auto x = simulate(dynamics, discretizer, time);
+    const vector_array_t u(x.size(), vector_t::Zero(1));
+    adaptiveTimeDiscretization.update(time, x, u, dynamics, discretizer);
+    time = adaptiveTimeDiscretization.getTimeDiscretization(0.0, 2.0, {});
+  }
+  return time;
+}
+}  // unnamed namespace
+
+TEST(test_adaptive_time_discretization, uniformWithoutProfile) {
+  AdaptiveTimeDiscretization adaptiveTimeDiscretization(getSettings());
+  const scalar_array_t eventTimes{0.45};
+  const auto adaptive = adaptiveTimeDiscretization.getTimeDiscretization(0.0, 1.0, eventTimes);
+  const auto uniform = timeDiscretizationWithEvents(0.0, 1.0, 0.1, eventTimes);
+  ASSERT_EQ(adaptive.size(), uniform.size());
+  for (size_t i = 0; i < uniform.size(); ++i) {
+    ASSERT_EQ(adaptive[i].time, uniform[i].time);
+    ASSERT_EQ(adaptive[i].event, uniform[i].event);
+  }
+}
+
+TEST(test_adaptive_time_discretization, refineAndCoarsen) {
+  const auto settings = getSettings();
+  AdaptiveTimeDiscretization adaptiveTimeDiscretization(settings);
+  const auto time = adaptGrid(adaptiveTimeDiscretization, 4);
+
+  ASSERT_EQ(time.front().time, 0.0);
+  ASSERT_EQ(time.back().time, 2.0);
+  ASSERT_DOUBLE_EQ(adaptiveTimeDiscretization.getStepSize(0.5), settings.dtMin);
+  ASSERT_DOUBLE_EQ(adaptiveTimeDiscretization.getStepSize(1.5), settings.dtMax);
+  ASSERT_DOUBLE_EQ(adaptiveTimeDiscretization.getStepSize(2.5), settings.dt);  // beyond the profile
+  for (size_t i = 0; i + 1 < time.size(); ++i) {
+    const scalar_t step = time[i + 1].time - time[i].time;
+    ASSERT_GT(step, 0.0);
+    ASSERT_LE(step, settings.dtMax + 1e-12);
+  }
+  ASSERT_LT(time.size(), timeDiscretizationWithEvents(0.0, 2.0, settings.dtMin, {}).size());
+
+  adaptiveTimeDiscretization.reset();
+  ASSERT_DOUBLE_EQ(adaptiveTimeDiscretization.getStepSize(0.5), settings.dt);
+}
+
+TEST(test_adaptive_time_discretization, trackingAccuracy) {
+  SwitchedFrequencyOscillator dynamics;
+  const auto discretizer = selectDynamicsDiscretization(SensitivityIntegratorType::RK4);
+  const auto reference = simulate(dynamics, discretizer, timeDiscretizationWithEvents(0.0, 2.0, 1e-4, {})).back();
+  auto finalError = [&](const std::vector<AnnotatedTime>& time) {
+    return (simulate(dynamics, discretizer, time).back() - reference).lpNorm<Eigen::Infinity>();
+  };
+
+  AdaptiveTimeDiscretization adaptiveTimeDiscretization(getSettings());
+  const auto adaptive = adaptGrid(adaptiveTimeDiscretization, 4);
+  const auto nominal = timeDiscretizationWithEvents(0.0, 2.0, getSettings().dt, {});
+  const auto sameSize = timeDiscretizationWithEvents(0.0, 2.0, 2.0 / (adaptive.size() - 1), {});
+  const auto fine = timeDiscretizationWithEvents(0.0, 2.0, getSettings().dtMin, {});
+
+  std::cerr << "[trackingAccuracy] nodes / final state error\n";
+  std::cerr << "  uniform dt     : " << nominal.size() << " / " << finalError(nominal) << "\n";
+  std::cerr << "  uniform same N : " << sameSize.size() << " / " << finalError(sameSize) << "\n";
+  std::cerr << "  uniform dtMin  : " << fine.size() << " / " << finalError(fine) << "\n";
+  std::cerr << "  adaptive       : " << adaptive.size() << " / " << finalError(adaptive) << "\n";
+
+  // Far fewer nodes than the finest uniform grid, yet much more accurate than a uniform grid with the same number of nodes
+  ASSERT_LT(adaptive.size(), fine.size() / 4);
+  ASSERT_LT(finalError(adaptive), finalError(nominal));
+  ASSERT_LT(10.0 * finalError(adaptive), finalError(sameSize));
+}
@@ -127,4 +127,80 @@ TEST(test_time_discretization, withEvents) {
   ASSERT_EQ(time[12].event, AnnotatedTime::Event::PreEvent);
   ASSERT_EQ(time[13].event, AnnotatedTime::Event::PostEvent);
   ASSERT_EQ(time[14].event, AnnotatedTime::Event::None);
-}
\ No newline at end of file
+}
+TEST(test_time_discretization, timeVaryingStep) {
+  scalar_t initTime = 0.0;
+  scalar_t finalTime = 1.0;
+  scalar_array_t eventTimes{0.55};
+  auto dt = [](scalar_t t) { return t < 0.5 ? 0.25 : 0.1; };
+
+  auto time = timeDiscretizationWithEvents(initTime, finalTime, dt, eventTimes);
+  ASSERT_EQ(time.size(), 10);
+  ASSERT_DOUBLE_EQ(time[1].time, 0.25);
+  ASSERT_DOUBLE_EQ(time[2].time, 0.5);
+  ASSERT_EQ(time[3].time, eventTimes[0]);
+  ASSERT_EQ(time[3].event, AnnotatedTime::Event::PreEvent);
+  ASSERT_EQ(time[4].event, AnnotatedTime::Event::PostEvent);
+  ASSERT_DOUBLE_EQ(time[5].time, 0.65);
+  ASSERT_DOUBLE_EQ(time[6].time, 0.75);
+  ASSERT_DOUBLE_EQ(time[8].time, 0.95);
+  ASSERT_EQ(time[9].time, finalTime);
+}
+
+TEST(test_time_discretization, constantStepMatchesUniform) {
+  scalar_t initTime = 0.1;
+  scalar_t finalTime = 3.9;
+  scalar_t dt = 0.1;
+  scalar_array_t eventTimes{1.1, 1.3, 1.4, 2.05};
+
+  const auto uniform = timeDiscretizationWithEvents(initTime, finalTime, dt, eventTimes);
+  const auto varying = timeDiscretizationWithEvents(
+      initTime, finalTime, [dt](scalar_t) { return dt; }, eventTimes);
+  ASSERT_EQ(uniform.size(), varying.size());
+  for (size_t i = 0; i < uniform.size(); ++i) {
+    ASSERT_EQ(uniform[i].time, varying[i].time);
+    ASSERT_EQ(uniform[i].event, varying[i].event);
+  }
+}
+
+TEST(test_time_discretization, piecewiseStepSchedule) {
+  scalar_t initTime = 1.0;
+  scalar_t finalTime = 2.0;
+  HorizonStepSchedule stepSchedule;
+  stepSchedule.switchingTimes = {0.5};
+  stepSchedule.dt = {0.125, 0.25};
+
+  auto time = timeDiscretizationWithEvents(initTime, finalTime, stepSchedule, {});
+  const scalar_array_t expected{1.0, 1.125, 1.25, 1.375, 1.5, 1.75, 2.0};
+  ASSERT_EQ(toTime(time), expected);
+}
+
+TEST(test_time_discretization, geometricStepSchedule) {
+  scalar_t initTime = 0.0;
+  scalar_t finalTime = 2.0;
+  HorizonStepSchedule stepSchedule;
+  stepSchedule.dt = {0.125};
+  stepSchedule.growthFactor = 2.0;
+  stepSchedule.dtMax = 0.5;
+
+  auto time = timeDiscretizationWithEvents(initTime, finalTime, stepSchedule, {});
+  const scalar_array_t expected{0.0, 0.125, 0.375, 0.875, 1.375, 1.875, 2.0};
+  ASSERT_EQ(toTime(time), expected);
+}
+
+TEST(test_time_discretization, createHorizonStepSchedule) {
+  const auto stepSchedule = createHorizonStepSchedule(0.125, {0.5}, {0.25}, 1.0, 0.5);
+  ASSERT_EQ(stepSchedule.switchingTimes, scalar_array_t{0.5});
+  ASSERT_EQ(stepSchedule.dt, (scalar_array_t{0.125, 0.25}));
+
+  auto time = timeDiscretizationWithEvents(1.0, 2.0, stepSchedule, {});
+  const scalar_array_t expected{1.0, 1.125, 1.25, 1.375, 1.5, 1.75, 2.0};
+  ASSERT_EQ(toTime(time), expected);
+
+  EXPECT_ANY_THROW(createHorizonStepSchedule(0.125, {0.5}, {}, 1.0, 0.5));              // missing step
+  EXPECT_ANY_THROW(createHorizonStepSchedule(0.0, {}, {}, 1.0, 0.5));                   // zero step
+  EXPECT_ANY_THROW(createHorizonStepSchedule(0.125, {0.5}, {-0.25}, 1.0, 0.5));         // negative step
+  EXPECT_ANY_THROW(createHorizonStepSchedule(0.125, {0.5, 0.25}, {0.25, 0.5}, 1.0, 0.5));  // unsorted switching times
+  EXPECT_ANY_THROW(createHorizonStepSchedule(0.125, {}, {}, 0.5, 0.5));                 // shrinking steps
+  EXPECT_ANY_THROW(createHorizonStepSchedule(0.125, {}, {}, 2.0, 0.0));                 // no upper bound
+}
@@ -187,6 +187,69 @@ TEST_F(PreconditionTest, ocpDataInPlaceInParallel) {
   EXPECT_TRUE(g_ref.isApprox(g_scaledData));  // g
 }
 
+TEST_F(PreconditionTest, ocpDataInPlaceInParallelWarmStart) {
+  ocs2::ThreadPool threadPool(5, 99);
+  constexpr int maxIteration = 20;
+  constexpr ocs2::scalar_t tolerance = 1e-2;
+
+  // Scaling of the first problem
+  ocs2::vector_array_t D_array, E_array, scalingVectors;
+  ocs2::scalar_t c;
+  auto dynamicsFirst = dynamicsArray;
+  auto costFirst = costArray;
+  const int numIterationsFirst = ocs2::precondition::ocpDataInPlaceInParallel(
+      threadPool, x0, ocpSize_, maxIteration, tolerance, false, dynamicsFirst, costFirst, D_array, E_array, scalingVectors, c);
+  EXPECT_LT(numIterationsFirst, maxIteration);
+
+  // A slightly different second problem
+  for (auto& dynamics : dynamicsArray) {
+    dynamics.dfdx *= 1.01;
+  }
+  for (auto& cost : costArray) {
+    cost.dfdx *= 0.99;
+  }
+  Eigen::SparseMatrix<ocs2::scalar_t> H_src, G_src;
+  ocs2::vector_t h_src, g_src;
+  ocs2::getCostMatrixSparse(ocpSize_, x0, costArray, H_src, h_src);
+  ocs2::getConstraintMatrixSparse(ocpSize_, x0, dynamicsArray, nullptr, nullptr, G_src, g_src);
+
+  auto dynamicsCold = dynamicsArray;
+  auto costCold = costArray;
+  ocs2::vector_array_t D_cold, E_cold, scalingVectorsCold;
+  ocs2::scalar_t c_cold;
+  const int numIterationsCold = ocs2::precondition::ocpDataInPlaceInParallel(
+      threadPool, x0, ocpSize_, maxIteration, tolerance, false, dynamicsCold, costCold, D_cold, E_cold, scalingVectorsCold, c_cold);
+
+  const int numIterationsWarm = ocs2::precondition::ocpDataInPlaceInParallel(
+      threadPool, x0, ocpSize_, maxIteration, tolerance, true, dynamicsArray, costArray, D_array, E_array, scalingVectors, c);
+  EXPECT_LT(numIterationsWarm, numIterationsCold);
+
+  // The scaled data must be the data scaled by the accumulated {D, E, c} of the warm start
+  ocs2::vector_t D_stacked(numDecisionVariables_), E_stacked(numConstraints_);
+  int curRow = 0;
+  for (auto& v : D_array) {
+    D_stacked.segment(curRow, v.size()) = v;
+    curRow += v.size();
+  }
+  curRow = 0;
+  for (auto& v : E_array) {
+    E_stacked.segment(curRow, v.size()) = v;
+    curRow += v.size();
+  }
+
+  Eigen::SparseMatrix<ocs2::scalar_t> H_scaledData, G_scaledData;
+  ocs2::vector_t h_scaledData, g_scaledData;
+  ocs2::getCostMatrixSparse(ocpSize_, x0, costArray, H_scaledData, h_scaledData);
+  ocs2::getConstraintMatrixSparse(ocpSize_, x0, dynamicsArray, nullptr, &scalingVectors, G_scaledData, g_scaledData);
+
+  const Eigen::SparseMatrix<ocs2::scalar_t> H_ref = c * D_stacked.asDiagonal() * H_src * D_stacked.asDiagonal();
+  const Eigen::SparseMatrix<ocs2::scalar_t> G_ref = E_stacked.asDiagonal() * G_src * D_stacked.asDiagonal();
+  EXPECT_TRUE(H_ref.isApprox(H_scaledData));                                // H
+  EXPECT_TRUE((c * D_stacked.cwiseProduct(h_src)).isApprox(h_scaledData));  // h
+  EXPECT_TRUE(G_ref.isApprox(G_scaledData));                                // G
+  EXPECT_TRUE(E_stacked.cwiseProduct(g_src).isApprox(g_scaledData));        // g
+}
+
 TEST_F(PreconditionTest, descaleSolution) {
   ocs2::vector_array_t D(2 * N_);
   ocs2::vector_t DStacked(numDecisionVariables_);
@@ -37,6 +37,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <ocs2_core/Types.h>
 #include <ocs2_core/control/LinearController.h>
 #include <ocs2_core/dynamics/LinearSystemDynamics.h>
+#include <ocs2_core/misc/Benchmark.h>
 #include <ocs2_oc/rollout/TimeTriggeredRollout.h>
 
 using namespace ocs2;
@@ -85,3 +86,104 @@ TEST(time_rollout_test, time_rollout_test) {
   ASSERT_EQ(totalSize, stateTrajectory.size());
   ASSERT_EQ(totalSize, inputTrajectory.size());
 }
+
+class FixedStepRolloutTest : public testing::TestWithParam<IntegratorType> {
+ protected:
+  static constexpr size_t nx = 2;
+  static constexpr size_t nu = 1;
+
+  FixedStepRolloutTest()
+      : systemDynamics((matrix_t(nx, nx) << -2.0, -1.0, 1.0, 0.0).finished(), (matrix_t(nx, nu) << 1.0, 0.0).finished()),
+        controller({initTime, finalTime}, vector_array_t(2, vector_t::Ones(nu)),
+                   matrix_array_t(2, (matrix_t(nu, nx) << -0.3, 0.1).finished())) {}
+
+  rollout::Settings getSettings(bool useFixedStepIntegrator) const {
+    rollout::Settings settings;
+    settings.timeStep = 1e-3;
+    settings.integratorType = GetParam();
+    settings.useFixedStepIntegrator = useFixedStepIntegrator;
+    return settings;
+  }
+
+  // the final time and the event times are not on the time grid so that the truncated steps are tested too
+  const scalar_t initTime = 0.0;
+  const scalar_t finalTime = 5.00037;
+  const vector_t initState = (vector_t(nx) << 1.0, -0.5).finished();
+  const ModeSchedule modeSchedule{{1.00013, 2.5, 2.5, 3.7}, {0, 1, 2, 3, 4}};
+
+  LinearSystemDynamics systemDynamics;
+  LinearController controller;
+};
+
+TEST_P(FixedStepRolloutTest, bitIdenticalToOdeint) {
+  TimeTriggeredRollout odeintRollout(systemDynamics, getSettings(false));
+  TimeTriggeredRollout fixedStepRollout(systemDynamics, getSettings(true));
+
+  scalar_array_t timeTrajectory, fixedStepTimeTrajectory;
+  size_array_t postEventIndices, fixedStepPostEventIndices;
+  vector_array_t stateTrajectory, fixedStepStateTrajectory;
+  vector_array_t inputTrajectory, fixedStepInputTrajectory;
+
+  auto modeScheduleCopy = modeSchedule;
+  odeintRollout.run(initTime, initState, finalTime, &controller, modeScheduleCopy, timeTrajectory, postEventIndices, stateTrajectory,
+                    inputTrajectory);
+  // run twice to check the reuse of the trajectories
+  for (int i = 0; i < 2; i++) {
+    fixedStepRollout.run(initTime, initState, finalTime, &controller, modeScheduleCopy, fixedStepTimeTrajectory,
+                         fixedStepPostEventIndices, fixedStepStateTrajectory, fixedStepInputTrajectory);
+  }
+
+  EXPECT_EQ(postEventIndices, fixedStepPostEventIndices);
+  EXPECT_EQ(timeTrajectory, fixedStepTimeTrajectory);
+  ASSERT_EQ(stateTrajectory.size(), fixedStepStateTrajectory.size());
+  ASSERT_EQ(inputTrajectory.size(), fixedStepInputTrajectory.size());
+  for (size_t k = 0; k < stateTrajectory.size(); k++) {
+    EXPECT_TRUE(stateTrajectory[k] == fixedStepStateTrajectory[k]) << "at index " << k;
+    EXPECT_TRUE(inputTrajectory[k] == fixedStepInputTrajectory[k]) << "at index " << k;
+  }
+}
+
+TEST_P(FixedStepRolloutTest, benchmark) {
+  constexpr size_t numRuns = 20;
+  TimeTriggeredRollout odeintRollout(systemDynamics, getSettings(false));
+  TimeTriggeredRollout fixedStepRollout(systemDynamics, getSettings(true));
+
+  scalar_array_t timeTrajectory;
+  size_array_t postEventIndices;
+  vector_array_t stateTrajectory;
+  vector_array_t inputTrajectory;
+  auto modeScheduleCopy = modeSchedule;
+
+  benchmark::RepeatedTimer odeintTimer;
+  for (size_t i = 0; i < numRuns; i++) {
+    odeintTimer.startTimer();
+    odeintRollout.run(initTime, initState, finalTime, &controller, modeScheduleCopy, timeTrajectory, postEventIndices, stateTrajectory,
+                      inputTrajectory);
+    odeintTimer.endTimer();
+  }
+
+  benchmark::RepeatedTimer fixedStepTimer;
+  for (size_t i = 0; i < numRuns; i++) {
+    fixedStepTimer.startTimer();
+    fixedStepRollout.run(initTime, initState, finalTime, &controller, modeScheduleCopy, timeTrajectory, postEventIndices, stateTrajectory,
+                         inputTrajectory);
+    fixedStepTimer.endTimer();
+  }
+
+  std::cerr << "[FixedStepRolloutTest] " << integrator_type::toString(GetParam()) << " rollout of " << timeTrajectory.size()
+            << " points, odeint: " << odeintTimer.getAverageInMilliseconds()
+            << " [ms], fixed-step: " << fixedStepTimer.getAverageInMilliseconds() << " [ms]\n";
+}
+
+INSTANTIATE_TEST_CASE_P(FixedStepRolloutTestCase, FixedStepRolloutTest, testing::Values(IntegratorType::EULER, IntegratorType::RK4),
+                        [](const testing::TestParamInfo<FixedStepRolloutTest::ParamType>& info) {
+                          return integrator_type::toString(info.param);
+                        });
+
+TEST(time_rollout_test, fixedStepRequiresFixedStepIntegrator) {
+  LinearSystemDynamics systemDynamics(matrix_t::Zero(1, 1), matrix_t::Zero(1, 1));
+  rollout::Settings settings;
+  settings.integratorType = IntegratorType::ODE45;
+  settings.useFixedStepIntegrator = true;
+  EXPECT_THROW(TimeTriggeredRollout(systemDynamics, settings), std::runtime_error);
+}
@@ -0,0 +1,120 @@
+/******************************************************************************
+Copyright (c) 2017, Farbod Farshidian. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include <ocs2_core/Types.h>
+
+#include "ocs2_perceptive/distance_transform/DistanceTransformInterface.h"
+
+namespace ocs2 {
+
+/**
+ * Signed distance field of the terrain described by an elevation map, stored as a stack of horizontal layers.
+ *
+ * Each layer holds the planar signed distance to the terrain at its height: positive where the cell is above the elevation and negative
+ * where it is below, truncated to [-maxDistance, maxDistance]. A sample combines this planar distance with the vertical distance to the
+ * elevation of its own cell, which keeps the samples within [-maxDistance, maxDistance]. Queries interpolate the samples tri-linearly. The
+ * planar distances are computed per layer with the separable distance transform of computeDistanceTransform().
+ *
+ * Because of the truncation, a sample only depends on the elevation within maxDistance of it. The field can therefore be computed from a
+ * previous field of a shifted and partially changed map: it copies the previous layers and only recomputes the tiles near cells whose
+ * occupancy changed, in the layers where it changed. The result is identical to computing the field from scratch.
+ *
+ * The elevation map follows the grid_map convention: the x-coordinate decreases with the row index and the y-coordinate with the column
+ * index. Cells with a NaN elevation are free space. The layers are at multiples of the resolution, such that maps at different heights
+ * share their layers.
+ */
+class IncrementalSignedDistanceField : public DistanceTransformInterface {
+ public:
+  /**
+   * Computes the field from scratch.
+   *
+   * @param [in] elevation: The elevation map.
+   * @param [in] resolution: The size of the cells, also used as the distance between layers.
+   * @param [in] firstCellPosition: The XY-position of the center of cell (0, 0).
+   * @param [in] minHeight: The field covers at least heights down to minHeight.
+   * @param [in] maxHeight: The field covers at least heights up to maxHeight.
+   * @param [in] maxDistance: The planar distances are truncated to this value.
+   */
+  IncrementalSignedDistanceField(const Eigen::MatrixXf& elevation, scalar_t resolution, const Eigen::Vector2d& firstCellPosition,
+                                 scalar_t minHeight, scalar_t maxHeight, scalar_t maxDistance);
+
+  /**
+   * Computes the field for a new elevation map, reusing the part of a previous field that the new map does not change. Falls back to
+   * computing the field from scratch if the maps do not share their resolution, grid alignment, or maxDistance.
+   *
+   * @param [in] previous: The field of the previous elevation map.
+   * For the other parameters see the constructor above.
+   */
+  IncrementalSignedDistanceField(const Eigen::MatrixXf& elevation, scalar_t resolution, const Eigen::Vector2d& firstCellPosition,
+                                 scalar_t minHeight, scalar_t maxHeight, scalar_t maxDistance,
+                                 const IncrementalSignedDistanceField& previous);
+
+  ~IncrementalSignedDistanceField() override = default;
+
+  scalar_t getValue(const vector3_t& p) const override;
+
+  /** Projects the point along the gradient, exact only where the field is an exact distance. */
+  vector3_t getProjectedPoint(const vector3_t& p) const override;
+
+  std::pair<scalar_t, vector3_t> getLinearApproximation(const vector3_t& p) const override;
+
+  /** Number of samples along x, y and z. */
+  size_t getNumRows() const { return elevation_.rows(); }
+  size_t getNumCols() const { return elevation_.cols(); }
+  size_t getNumLayers() const { return layers_.size(); }
+
+  /** Position and value of the sample (row, col, layer). */
+  vector3_t getSamplePosition(size_t row, size_t col, size_t layer) const;
+  scalar_t getSampleValue(size_t row, size_t col, size_t layer) const;
+
+  /** Fraction of the samples for which the planar distance was computed, 1.0 when the field was computed from scratch. */
+  scalar_t getRecomputedFraction() const { return recomputedFraction_; }
+
+ private:
+  /** Computes the layers, reusing the previous field when it is not nullptr. */
+  void computeLayers(const IncrementalSignedDistanceField* previousPtr);
+
+  float getLayerHeight(size_t layer) const { return static_cast<float>((firstLayer_ + static_cast<int>(layer)) * resolution_); }
+
+  Eigen::MatrixXf elevation_;
+  scalar_t resolution_;
+  Eigen::Vector2d firstCellPosition_;
+  scalar_t maxDistance_;
+  int firstLayer_;  // Layer l is at height (firstLayer_ + l) * resolution_
+
+  std::vector<Eigen::MatrixXf> layers_;  // Truncated planar signed distance of each layer
+  scalar_t recomputedFraction_ = 1.0;
+};
+
+}  // namespace ocs2
@@ -0,0 +1,418 @@
+/******************************************************************************
+Copyright (c) 2017, Farbod Farshidian. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#include "ocs2_perceptive/distance_transform/IncrementalSignedDistanceField.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+
+#include "ocs2_perceptive/distance_transform/ComputeDistanceTransform.h"
+#include "ocs2_perceptive/interpolation/TrilinearInterpolation.h"
+
+namespace ocs2 {
+
+namespace {
+
+/** Side length of the tiles in which changes are tracked, in cells */
+constexpr int tileSize = 8;
+
+/** Block of cells [row, row + rows) x [col, col + cols) */
+struct Block {
+  int row;
+  int col;
+  int rows;
+  int cols;
+};
+
+/** Memory reused over the computation of all layers */
+struct Workspace {
+  Eigen::Array<bool, Eigen::Dynamic, Eigen::Dynamic> occupancy;
+  Eigen::MatrixXf obstacleColumnDistance;  // squared distance to the nearest obstacle in the same column
+  Eigen::MatrixXf freeColumnDistance;      // squared distance to the nearest free cell in the same column
+  std::vector<float> obstacleRowDistance;
+  std::vector<float> freeRowDistance;
+  std::vector<size_t> vBuffer;
+  std::vector<float> zBuffer;
+};
+
+inline bool isOccupied(float elevation, float height) {
+  return elevation >= height;  // false for NaN
+}
+
+/**
+ * Computes the planar signed distance of the cells in target, using the occupancy in window only. The distances are exact as long as window
+ * contains all cells within the truncation radius of target.
+ *
+ * @param [in] infinity: Squared distance in cells for samples without a site, larger than any squared distance that is not truncated.
+ */
+void computePlanarDistance(const Eigen::MatrixXf& elevation, float height, float resolution, float maxDistance, float infinity,
+                           const Block& window, const Block& target, Eigen::MatrixXf& layer, Workspace& workspace) {
+  auto& occupancy = workspace.occupancy;
+  occupancy = elevation.block(window.row, window.col, window.rows, window.cols).array() >= height;
+  const auto numOccupied = occupancy.count();
+
+  // Layers without obstacles or without free cells are truncated everywhere.
+  if (numOccupied == 0 || numOccupied == window.rows * window.cols) {
+    const float value = (numOccupied == 0) ? maxDistance : -maxDistance;
+    layer.block(target.row, target.col, target.rows, target.cols).setConstant(value);
+    return;
+  }
+
+  // Transform along the columns of the window
+  workspace.obstacleColumnDistance.resize(window.rows, window.cols);
+  workspace.freeColumnDistance.resize(window.rows, window.cols);
+  for (int j = 0; j < window.cols; ++j) {
+    const auto occupancyColumn = occupancy.col(j);
+    auto obstacleColumn = workspace.obstacleColumnDistance.col(j);
+    auto freeColumn = workspace.freeColumnDistance.col(j);
+    computeDistanceTransform(
+        window.rows, [&](size_t i) { return occupancyColumn(i) ? 0.0F : infinity; }, [&](size_t i, float d) { obstacleColumn(i) = d; }, 0,
+        window.rows, workspace.vBuffer, workspace.zBuffer);
+    computeDistanceTransform(
+        window.rows, [&](size_t i) { return occupancyColumn(i) ? infinity : 0.0F; }, [&](size_t i, float d) { freeColumn(i) = d; }, 0,
+        window.rows, workspace.vBuffer, workspace.zBuffer);
+  }
+
+  // Transform along the rows, only for the rows of the target
+  workspace.obstacleRowDistance.resize(window.cols);
+  workspace.freeRowDistance.resize(window.cols);
+  const int rowOffset = target.row - window.row;
+  const int colOffset = target.col - window.col;
+  for (int i = rowOffset; i < rowOffset + target.rows; ++i) {
+    computeDistanceTransform(
+        window.cols, [&](size_t j) { return workspace.obstacleColumnDistance(i, j); },
+        [&](size_t j, float d) { workspace.obstacleRowDistance[j] = d; }, 0, window.cols, workspace.vBuffer, workspace.zBuffer);
+    computeDistanceTransform(
+        window.cols, [&](size_t j) { return workspace.freeColumnDistance(i, j); },
+        [&](size_t j, float d) { workspace.freeRowDistance[j] = d; }, 0, window.cols, workspace.vBuffer, workspace.zBuffer);
+
+    // The border between obstacle and free space lies half a cell from the centers.
+    for (int j = colOffset; j < colOffset + target.cols; ++j) {
+      auto& value = layer(window.row + i, window.col + j);
+      if (occupancy(i, j)) {
+        value = -std::min(resolution * std::sqrt(workspace.freeRowDistance[j]) - 0.5F * resolution, maxDistance);
+      } else {
+        value = std::min(resolution * std::sqrt(workspace.obstacleRowDistance[j]) - 0.5F * resolution, maxDistance);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+IncrementalSignedDistanceField::IncrementalSignedDistanceField(const Eigen::MatrixXf& elevation, scalar_t resolution,
+                                                               const Eigen::Vector2d& firstCellPosition, scalar_t minHeight,
+                                                               scalar_t maxHeight, scalar_t maxDistance)
+    : elevation_(elevation),
+      resolution_(resolution),
+      firstCellPosition_(firstCellPosition),
+      maxDistance_(maxDistance),
+      firstLayer_(static_cast<int>(std::floor(minHeight / resolution))) {
+  if (elevation_.size() == 0 || resolution_ <= 0.0 || maxDistance_ <= 0.0 || maxHeight < minHeight) {
+    throw std::runtime_error("[IncrementalSignedDistanceField] Invalid elevation map, resolution, height range, or maxDistance.");
+  }
+  const int lastLayer = static_cast<int>(std::ceil(maxHeight / resolution));
+  layers_.resize(lastLayer - firstLayer_ + 1);
+  computeLayers(nullptr);
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+IncrementalSignedDistanceField::IncrementalSignedDistanceField(const Eigen::MatrixXf& elevation, scalar_t resolution,
+                                                               const Eigen::Vector2d& firstCellPosition, scalar_t minHeight,
+                                                               scalar_t maxHeight, scalar_t maxDistance,
+                                                               const IncrementalSignedDistanceField& previous)
+    : elevation_(elevation),
+      resolution_(resolution),
+      firstCellPosition_(firstCellPosition),
+      maxDistance_(maxDistance),
+      firstLayer_(static_cast<int>(std::floor(minHeight / resolution))) {
+  if (elevation_.size() == 0 || resolution_ <= 0.0 || maxDistance_ <= 0.0 || maxHeight < minHeight) {
+    throw std::runtime_error("[IncrementalSignedDistanceField] Invalid elevation map, resolution, height range, or maxDistance.");
+  }
+  const int lastLayer = static_cast<int>(std::ceil(maxHeight / resolution));
+  layers_.resize(lastLayer - firstLayer_ + 1);
+
+  // The previous layers can only be reused on the same grid.
+  const Eigen::Vector2d shift = (previous.firstCellPosition_ - firstCellPosition_) / resolution_;
+  const bool isSameGrid = std::abs(previous.resolution_ - resolution_) <= 1e-9 * resolution_ && previous.maxDistance_ == maxDistance_ &&
+                          (shift - shift.array().round().matrix()).cwiseAbs().maxCoeff() < 1e-3;
+  computeLayers(isSameGrid ? &previous : nullptr);
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void IncrementalSignedDistanceField::computeLayers(const IncrementalSignedDistanceField* previousPtr) {
+  const int numRows = elevation_.rows();
+  const int numCols = elevation_.cols();
+  const int numLayers = layers_.size();
+  const auto resolution = static_cast<float>(resolution_);
+  const auto maxDistance = static_cast<float>(maxDistance_);
+
+  // Samples further than this number of cells from a change keep their truncated distance.
+  const int radius = static_cast<int>(std::ceil(maxDistance_ / resolution_ + 0.5));
+  const auto infinity = static_cast<float>((radius + 1) * (radius + 1));
+
+  const Block map{0, 0, numRows, numCols};
+  Workspace workspace;
+
+  if (previousPtr == nullptr) {
+    for (int l = 0; l < numLayers; ++l) {
+      layers_[l].resize(numRows, numCols);
+      computePlanarDistance(elevation_, getLayerHeight(l), resolution, maxDistance, infinity, map, map, layers_[l], workspace);
+    }
+    recomputedFraction_ = 1.0;
+    return;
+  }
+
+  const auto& previous = *previousPtr;
+  const int previousRows = previous.elevation_.rows();
+  const int previousCols = previous.elevation_.cols();
+  const Eigen::Vector2d shift = ((previous.firstCellPosition_ - firstCellPosition_) / resolution_).array().round();
+  const int rowShift = static_cast<int>(shift.x());  // cell (i, j) was cell (i + rowShift, j + colShift) in the previous map
+  const int colShift = static_cast<int>(shift.y());
+  const int layerShift = firstLayer_ - previous.firstLayer_;  // layer l was layer l + layerShift in the previous field
+
+  // Mark the tiles that contain a cell whose occupancy changed, per layer.
+  const int numTileRows = (numRows + tileSize - 1) / tileSize;
+  const int numTileCols = (numCols + tileSize - 1) / tileSize;
+  std::vector<std::vector<char>> isTileChanged(numLayers, std::vector<char>(numTileRows * numTileCols, 0));
+  const auto markAllLayers = [&](int i, int j) {
+    for (auto& tiles : isTileChanged) {
+      tiles[(i / tileSize) * numTileCols + j / tileSize] = 1;
+    }
+  };
+  for (int j = 0; j < numCols; ++j) {
+    for (int i = 0; i < numRows; ++i) {
+      const int previousRow = i + rowShift;
+      const int previousCol = j + colShift;
+      if (previousRow < 0 || previousRow >= previousRows || previousCol < 0 || previousCol >= previousCols) {
+        markAllLayers(i, j);
+        continue;
+      }
+
+      const float newElevation = elevation_(i, j);
+      const float oldElevation = previous.elevation_(previousRow, previousCol);
+      if (newElevation == oldElevation || (std::isnan(newElevation) && std::isnan(oldElevation))) {
+        continue;
+      }
+
+      // Only the layers between the old and new elevation can change occupancy, NaN counts as below all layers.
+      const bool isEitherNan = std::isnan(newElevation) || std::isnan(oldElevation);
+      const float lower = std::min(newElevation, oldElevation);
+      const float upper = std::fmax(newElevation, oldElevation);  // ignores NaN
+      const int firstChangedLayer = isEitherNan ? 0 : std::max(static_cast<int>(std::floor(lower / resolution_)) - firstLayer_, 0);
+      const int lastChangedLayer = std::min(static_cast<int>(std::ceil(upper / resolution_)) - firstLayer_, numLayers - 1);
+      for (int l = firstChangedLayer; l <= lastChangedLayer; ++l) {
+        const float height = getLayerHeight(l);
+        if (isOccupied(newElevation, height) != isOccupied(oldElevation, height)) {
+          isTileChanged[l][(i / tileSize) * numTileCols + j / tileSize] = 1;
+        }
+      }
+    }
+  }
+
+  // Cells near a side where the previous map extended further were computed with cells that are now outside the map.
+  for (int i = 0; i < numRows; ++i) {
+    if (colShift > 0) {
+      markAllLayers(i, 0);
+    }
+    if (previousCols - colShift > numCols) {
+      markAllLayers(i, numCols - 1);
+    }
+  }
+  for (int j = 0; j < numCols; ++j) {
+    if (rowShift > 0) {
+      markAllLayers(0, j);
+    }
+    if (previousRows - rowShift > numRows) {
+      markAllLayers(numRows - 1, j);
+    }
+  }
+
+  // Block of the map that is inside the previous map
+  const int overlapRow = std::max(-rowShift, 0);
+  const int overlapCol = std::max(-colShift, 0);
+  const int overlapRows = std::min(numRows, previousRows - rowShift) - overlapRow;
+  const int overlapCols = std::min(numCols, previousCols - colShift) - overlapCol;
+
+  const int tileRadius = (radius + tileSize - 1) / tileSize;
+  std::vector<char> isTileDirty(numTileRows * numTileCols);
+  size_t numRecomputed = 0;
+  for (int l = 0; l < numLayers; ++l) {
+    auto& layer = layers_[l];
+    layer.resize(numRows, numCols);
+
+    const int previousLayer = l + layerShift;
+    if (previousLayer < 0 || previousLayer >= static_cast<int>(previous.layers_.size())) {
+      computePlanarDistance(elevation_, getLayerHeight(l), resolution, maxDistance, infinity, map, map, layer, workspace);
+      numRecomputed += numRows * numCols;
+      continue;
+    }
+
+    if (overlapRows > 0 && overlapCols > 0) {
+      layer.block(overlapRow, overlapCol, overlapRows, overlapCols) =
+          previous.layers_[previousLayer].block(overlapRow + rowShift, overlapCol + colShift, overlapRows, overlapCols);
+    }
+
+    // A tile is dirty if it lies within the truncation radius of a changed tile.
+    std::fill(isTileDirty.begin(), isTileDirty.end(), 0);
+    for (int ti = 0; ti < numTileRows; ++ti) {
+      for (int tj = 0; tj < numTileCols; ++tj) {
+        if (isTileChanged[l][ti * numTileCols + tj]) {
+          for (int di = std::max(ti - tileRadius, 0); di <= std::min(ti + tileRadius, numTileRows - 1); ++di) {
+            std::fill_n(isTileDirty.begin() + di * numTileCols + std::max(tj - tileRadius, 0),
+                        std::min(tj + tileRadius, numTileCols - 1) - std::max(tj - tileRadius, 0) + 1, 1);
+          }
+        }
+      }
+    }
+
+    // Recompute runs of dirty tiles in a tile row at once, within a window extended by the truncation radius.
+    for (int ti = 0; ti < numTileRows; ++ti) {
+      int tj = 0;
+      while (tj < numTileCols) {
+        if (!isTileDirty[ti * numTileCols + tj]) {
+          ++tj;
+          continue;
+        }
+        const int firstTile = tj;
+        while (tj < numTileCols && isTileDirty[ti * numTileCols + tj]) {
+          ++tj;
+        }
+
+        Block target;
+        target.row = ti * tileSize;
+        target.col = firstTile * tileSize;
+        target.rows = std::min(target.row + tileSize, numRows) - target.row;
+        target.cols = std::min(tj * tileSize, numCols) - target.col;
+
+        Block window;
+        window.row = std::max(target.row - radius, 0);
+        window.col = std::max(target.col - radius, 0);
+        window.rows = std::min(target.row + target.rows + radius, numRows) - window.row;
+        window.cols = std::min(target.col + target.cols + radius, numCols) - window.col;
+
+        computePlanarDistance(elevation_, getLayerHeight(l), resolution, maxDistance, infinity, window, target, layer, workspace);
+        numRecomputed += target.rows * target.cols;
+      }
+    }
+  }
+  recomputedFraction_ = static_cast<scalar_t>(numRecomputed) / static_cast<scalar_t>(numRows * numCols * numLayers);
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+auto IncrementalSignedDistanceField::getSamplePosition(size_t row, size_t col, size_t layer) const -> vector3_t {
+  return {firstCellPosition_.x() - row * resolution_, firstCellPosition_.y() - col * resolution_,
+          (firstLayer_ + static_cast<int>(layer)) * resolution_};
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+scalar_t IncrementalSignedDistanceField::getSampleValue(size_t row, size_t col, size_t layer) const {
+  const float planarDistance = layers_[layer](row, col);
+  const float elevation = elevation_(row, col);
+  if (std::isnan(elevation)) {
+    return planarDistance;
+  }
+
+  // The vertical distance to the elevation of the cell bounds the distance to the terrain.
+  const float verticalDistance = getLayerHeight(layer) - elevation;
+  return (planarDistance > 0.0F) ? std::min(planarDistance, verticalDistance) : std::max(planarDistance, verticalDistance);
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+scalar_t IncrementalSignedDistanceField::getValue(const vector3_t& p) const {
+  return getLinearApproximation(p).first;
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+auto IncrementalSignedDistanceField::getProjectedPoint(const vector3_t& p) const -> vector3_t {
+  const auto valueAndGradient = getLinearApproximation(p);
+  const scalar_t gradientNorm = valueAndGradient.second.norm();
+  if (gradientNorm > 0.0) {
+    return p - valueAndGradient.first / gradientNorm * valueAndGradient.second;
+  } else {
+    return p;
+  }
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+auto IncrementalSignedDistanceField::getLinearApproximation(const vector3_t& p) const -> std::pair<scalar_t, vector3_t> {
+  // Position in a local frame where the indices increase along the axes, clamped to the samples.
+  const vector3_t localPosition(firstCellPosition_.x() - p.x(), firstCellPosition_.y() - p.y(), p.z() - firstLayer_ * resolution_);
+  const vector3_t upperBound = resolution_ * vector3_t(getNumRows() - 1, getNumCols() - 1, getNumLayers() - 1);
+  const vector3_t clampedPosition = localPosition.cwiseMax(0.0).cwiseMin(upperBound);
+
+  // Reference corner of the interpolation cell
+  std::array<size_t, 3> lower;
+  std::array<size_t, 3> upper;
+  for (size_t d = 0; d < 3; ++d) {
+    const auto maxIndex = static_cast<size_t>(std::round(upperBound(d) / resolution_));
+    lower[d] = std::min(static_cast<size_t>(clampedPosition(d) / resolution_), maxIndex);
+    upper[d] = std::min(lower[d] + 1, maxIndex);
+  }
+  const vector3_t referenceCorner = resolution_ * vector3_t(lower[0], lower[1], lower[2]);
+  const std::array<scalar_t, 8> cornerValues = {
+      getSampleValue(lower[0], lower[1], lower[2]), getSampleValue(upper[0], lower[1], lower[2]),
+      getSampleValue(lower[0], upper[1], lower[2]), getSampleValue(upper[0], upper[1], lower[2]),
+      getSampleValue(lower[0], lower[1], upper[2]), getSampleValue(upper[0], lower[1], upper[2]),
+      getSampleValue(lower[0], upper[1], upper[2]), getSampleValue(upper[0], upper[1], upper[2])};
+  auto valueAndGradient = trilinear_interpolation::getLinearApproximation(resolution_, referenceCorner, cornerValues, clampedPosition);
+
+  // Outside the samples, add the distance to the sampled box.
+  const vector3_t outsideOffset = localPosition - clampedPosition;
+  const scalar_t outsideDistance = outsideOffset.norm();
+  if (outsideDistance > 0.0) {
+    valueAndGradient.first += outsideDistance;
+    valueAndGradient.second += outsideOffset / outsideDistance;
+  }
+
+  // Back to world coordinates
+  valueAndGradient.second.head<2>() *= -1.0;
+  return valueAndGradient;
+}
+
+}  // namespace ocs2
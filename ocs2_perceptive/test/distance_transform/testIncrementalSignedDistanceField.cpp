@@ -0,0 +1,218 @@
+/******************************************************************************
+Copyright (c) 2020, Farbod Farshidian. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#include <cmath>
+#include <iostream>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include <ocs2_core/misc/Benchmark.h>
+
+#include "ocs2_perceptive/distance_transform/IncrementalSignedDistanceField.h"
+
+namespace ocs2 {
+
+class TestIncrementalSignedDistanceField : public ::testing::Test {
+ protected:
+  using vector3_t = IncrementalSignedDistanceField::vector3_t;
+
+  static constexpr scalar_t resolution = 0.04;
+  static constexpr scalar_t maxDistance = 0.3;
+
+  /** Stairs with a box on top, sampled on a grid_map style grid around firstCellPosition. */
+  static Eigen::MatrixXf getElevation(int numRows, int numCols, const Eigen::Vector2d& firstCellPosition) {
+    Eigen::MatrixXf elevation(numRows, numCols);
+    for (int j = 0; j < numCols; ++j) {
+      for (int i = 0; i < numRows; ++i) {
+        const scalar_t x = firstCellPosition.x() - i * resolution;
+        const scalar_t y = firstCellPosition.y() - j * resolution;
+        const bool isOnBox = std::abs(x - 0.5) < 0.2 && std::abs(y + 0.3) < 0.15;
+        elevation(i, j) = 0.15 * std::floor(std::max(x, 0.0) / 0.3) + (isOnBox ? 0.25 : 0.0) + 0.01 * std::sin(7.0 * y);
+      }
+    }
+    return elevation;
+  }
+
+  /** Changes the elevation of a few random cells and removes some. */
+  static void perturb(Eigen::MatrixXf& elevation, std::mt19937& generator) {
+    std::uniform_int_distribution<int> rowDistribution(0, elevation.rows() - 1);
+    std::uniform_int_distribution<int> colDistribution(0, elevation.cols() - 1);
+    std::uniform_real_distribution<float> heightDistribution(-0.1, 0.1);
+    for (int n = 0; n < 5; ++n) {
+      elevation(rowDistribution(generator), colDistribution(generator)) += heightDistribution(generator);
+    }
+    elevation(rowDistribution(generator), colDistribution(generator)) = std::numeric_limits<float>::quiet_NaN();
+  }
+
+  static void expectEqualSamples(const IncrementalSignedDistanceField& field, const IncrementalSignedDistanceField& expected) {
+    ASSERT_EQ(field.getNumRows(), expected.getNumRows());
+    ASSERT_EQ(field.getNumCols(), expected.getNumCols());
+    ASSERT_EQ(field.getNumLayers(), expected.getNumLayers());
+    for (size_t l = 0; l < expected.getNumLayers(); ++l) {
+      for (size_t j = 0; j < expected.getNumCols(); ++j) {
+        for (size_t i = 0; i < expected.getNumRows(); ++i) {
+          ASSERT_EQ(field.getSampleValue(i, j, l), expected.getSampleValue(i, j, l)) << "sample (" << i << ", " << j << ", " << l << ")";
+        }
+      }
+    }
+  }
+};
+
+constexpr scalar_t TestIncrementalSignedDistanceField::resolution;
+constexpr scalar_t TestIncrementalSignedDistanceField::maxDistance;
+
+TEST_F(TestIncrementalSignedDistanceField, flatGround) {
+  const Eigen::MatrixXf elevation = Eigen::MatrixXf::Zero(30, 40);
+  const IncrementalSignedDistanceField field(elevation, resolution, Eigen::Vector2d(0.5, 0.6), -0.5, 0.5, maxDistance);
+
+  for (const scalar_t height : {-0.25, -0.1, 0.05, 0.2}) {
+    const auto valueAndGradient = field.getLinearApproximation(vector3_t(0.1, 0.1, height));
+    EXPECT_NEAR(valueAndGradient.first, height, 1e-6);
+    EXPECT_TRUE(valueAndGradient.second.isApprox(vector3_t::UnitZ(), 1e-6)) << valueAndGradient.second.transpose();
+    EXPECT_TRUE(field.getProjectedPoint(vector3_t(0.1, 0.1, height)).isApprox(vector3_t(0.1, 0.1, 0.0), 1e-6));
+  }
+
+  // Truncated further from the terrain
+  EXPECT_NEAR(field.getValue(vector3_t(0.1, 0.1, 0.45)), maxDistance, 1e-6);
+  EXPECT_NEAR(field.getValue(vector3_t(0.1, 0.1, -0.45)), -maxDistance, 1e-6);
+
+  // Outside the sampled box, the distance to the box is added.
+  EXPECT_NEAR(field.getValue(vector3_t(1.5, 0.1, 0.1)), 0.1 + 1.0, 1e-6);
+}
+
+TEST_F(TestIncrementalSignedDistanceField, bruteForce) {
+  const int numRows = 25;
+  const int numCols = 20;
+  const Eigen::Vector2d firstCellPosition(0.8, 0.1);
+  const Eigen::MatrixXf elevation = getElevation(numRows, numCols, firstCellPosition);
+  const IncrementalSignedDistanceField field(elevation, resolution, firstCellPosition, -0.1, 0.5, maxDistance);
+
+  for (size_t l = 0; l < field.getNumLayers(); ++l) {
+    const auto height = static_cast<float>(field.getSamplePosition(0, 0, l).z());
+    for (int j = 0; j < numCols; ++j) {
+      for (int i = 0; i < numRows; ++i) {
+        // Distance to the nearest cell with the opposite occupancy
+        const bool isOccupied = elevation(i, j) >= height;
+        scalar_t minDistance = std::numeric_limits<scalar_t>::max();
+        for (int jj = 0; jj < numCols; ++jj) {
+          for (int ii = 0; ii < numRows; ++ii) {
+            if ((elevation(ii, jj) >= height) != isOccupied) {
+              minDistance = std::min(minDistance, resolution * std::sqrt((ii - i) * (ii - i) + (jj - j) * (jj - j)));
+            }
+          }
+        }
+        const scalar_t planarDistance = std::min(minDistance - 0.5 * resolution, maxDistance);
+        const scalar_t verticalDistance = height - elevation(i, j);
+        const scalar_t expected = isOccupied ? std::max(-planarDistance, verticalDistance) : std::min(planarDistance, verticalDistance);
+        ASSERT_NEAR(field.getSampleValue(i, j, l), expected, 1e-5) << "sample (" << i << ", " << j << ", " << l << ")";
+      }
+    }
+  }
+}
+
+TEST_F(TestIncrementalSignedDistanceField, incrementalMatchesFullRebuild) {
+  std::mt19937 generator(0);
+  const int numRows = 60;
+  const int numCols = 50;
+  Eigen::Vector2d firstCellPosition(1.2, 0.5);
+  scalar_t minHeight = -0.2;
+  scalar_t maxHeight = 0.6;
+
+  std::unique_ptr<IncrementalSignedDistanceField> fieldPtr(new IncrementalSignedDistanceField(
+      getElevation(numRows, numCols, firstCellPosition), resolution, firstCellPosition, minHeight, maxHeight, maxDistance));
+
+  // Shift the map, change its size and height range, and perturb the elevation.
+  const std::vector<std::pair<int, int>> shifts = {{0, 0}, {1, 0}, {0, -1}, {2, 3}, {-3, 1}, {-1, -2}, {40, 0}};
+  for (size_t n = 0; n < shifts.size(); ++n) {
+    firstCellPosition += resolution * Eigen::Vector2d(shifts[n].first, shifts[n].second);
+    minHeight += 0.03;
+    maxHeight -= 0.01;
+    const int newRows = numRows + static_cast<int>(n % 3) - 1;
+    Eigen::MatrixXf elevation = getElevation(newRows, numCols, firstCellPosition);
+    perturb(elevation, generator);
+
+    std::unique_ptr<IncrementalSignedDistanceField> newFieldPtr(
+        new IncrementalSignedDistanceField(elevation, resolution, firstCellPosition, minHeight, maxHeight, maxDistance, *fieldPtr));
+    const IncrementalSignedDistanceField expected(elevation, resolution, firstCellPosition, minHeight, maxHeight, maxDistance);
+    expectEqualSamples(*newFieldPtr, expected);
+    if (std::abs(shifts[n].first) < 5) {
+      EXPECT_LT(newFieldPtr->getRecomputedFraction(), 1.0);
+    }
+    fieldPtr.swap(newFieldPtr);
+  }
+
+  // A different grid alignment is computed from scratch.
+  const Eigen::Vector2d misalignedPosition = firstCellPosition + Eigen::Vector2d(0.5 * resolution, 0.0);
+  const Eigen::MatrixXf elevation = getElevation(numRows, numCols, misalignedPosition);
+  const IncrementalSignedDistanceField field(elevation, resolution, misalignedPosition, minHeight, maxHeight, maxDistance, *fieldPtr);
+  EXPECT_DOUBLE_EQ(field.getRecomputedFraction(), 1.0);
+  expectEqualSamples(field, IncrementalSignedDistanceField(elevation, resolution, misalignedPosition, minHeight, maxHeight, maxDistance));
+}
+
+TEST_F(TestIncrementalSignedDistanceField, benchmark) {
+  std::mt19937 generator(0);
+  const int numRows = 200;
+  const int numCols = 200;
+  const int numUpdates = 20;
+  Eigen::Vector2d firstCellPosition(4.0, 4.0);
+
+  std::unique_ptr<IncrementalSignedDistanceField> fieldPtr(new IncrementalSignedDistanceField(
+      getElevation(numRows, numCols, firstCellPosition), resolution, firstCellPosition, -0.2, 1.0, maxDistance));
+
+  // The map moves with one cell per update, as for a robot walking at 0.8 m/s with a map at 20 Hz.
+  benchmark::RepeatedTimer fullTimer;
+  benchmark::RepeatedTimer incrementalTimer;
+  scalar_t recomputedFraction = 0.0;
+  for (int n = 0; n < numUpdates; ++n) {
+    firstCellPosition.x() += resolution;
+    Eigen::MatrixXf elevation = getElevation(numRows, numCols, firstCellPosition);
+    perturb(elevation, generator);
+
+    fullTimer.startTimer();
+    const IncrementalSignedDistanceField expected(elevation, resolution, firstCellPosition, -0.2, 1.0, maxDistance);
+    fullTimer.endTimer();
+
+    incrementalTimer.startTimer();
+    std::unique_ptr<IncrementalSignedDistanceField> newFieldPtr(
+        new IncrementalSignedDistanceField(elevation, resolution, firstCellPosition, -0.2, 1.0, maxDistance, *fieldPtr));
+    incrementalTimer.endTimer();
+
+    recomputedFraction += newFieldPtr->getRecomputedFraction() / numUpdates;
+    ASSERT_EQ(newFieldPtr->getValue(vector3_t(3.0, 3.0, 0.5)), expected.getValue(vector3_t(3.0, 3.0, 0.5)));
+    fieldPtr.swap(newFieldPtr);
+  }
+
+  std::cerr << "[TestIncrementalSignedDistanceField] " << numRows << " x " << numCols << " x " << fieldPtr->getNumLayers() << " samples"
+            << ", full rebuild: " << fullTimer.getAverageInMilliseconds() << " [ms]"
+            << ", incremental: " << incrementalTimer.getAverageInMilliseconds() << " [ms]"
+            << ", recomputed: " << 100.0 * recomputedFraction << " [%]\n";
+}
+
+}  // namespace ocs2
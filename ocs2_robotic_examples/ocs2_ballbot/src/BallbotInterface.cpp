@@ -32,8 +32,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "ocs2_ballbot/BallbotInterface.h"
 
-#include <ocs2_core/cost/QuadraticStateCost.h>
-#include <ocs2_core/cost/QuadraticStateInputCost.h>
+#include <ocs2_core/cost/FixedSizeQuadraticCost.h>
 #include <ocs2_core/initialization/DefaultInitializer.h>
 #include <ocs2_core/misc/LoadData.h>
 
@@ -89,8 +88,8 @@ BallbotInterface::BallbotInterface(const std::string& taskFile, const std::strin
   std::cerr << "R:  \n" << R << "\n";
   std::cerr << "Q_final:\n" << Qf << "\n";
 
-  problem_.costPtr->add("cost", std::make_unique<QuadraticStateInputCost>(Q, R));
-  problem_.finalCostPtr->add("finalCost", std::make_unique<QuadraticStateCost>(Qf));
+  problem_.costPtr->add("cost", std::make_unique<FixedSizeQuadraticStateInputCost<STATE_DIM, INPUT_DIM>>(Q, R));
+  problem_.finalCostPtr->add("finalCost", std::make_unique<FixedSizeQuadraticStateCost<STATE_DIM>>(Qf));
 
   // Dynamics
   bool recompileLibraries;  // load the flag to generate library files from taskFile
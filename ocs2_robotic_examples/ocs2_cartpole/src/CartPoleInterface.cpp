@@ -35,8 +35,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <ocs2_core/augmented_lagrangian/AugmentedLagrangian.h>
 #include <ocs2_core/constraint/LinearStateInputConstraint.h>
-#include <ocs2_core/cost/QuadraticStateCost.h>
-#include <ocs2_core/cost/QuadraticStateInputCost.h>
+#include <ocs2_core/cost/FixedSizeQuadraticCost.h>
 #include <ocs2_core/initialization/DefaultInitializer.h>
 #include <ocs2_core/misc/LoadData.h>
 #include <ocs2_core/penalties/Penalties.h>
@@ -92,8 +91,8 @@ CartPoleInterface::CartPoleInterface(const std::string& taskFile, const std::str
     std::cerr << "Q_final:\n" << Qf << "\n";
   }
 
-  problem_.costPtr->add("cost", std::make_unique<QuadraticStateInputCost>(Q, R));
-  problem_.finalCostPtr->add("finalCost", std::make_unique<QuadraticStateCost>(Qf));
+  problem_.costPtr->add("cost", std::make_unique<FixedSizeQuadraticStateInputCost<STATE_DIM, INPUT_DIM>>(Q, R));
+  problem_.finalCostPtr->add("finalCost", std::make_unique<FixedSizeQuadraticStateCost<STATE_DIM>>(Qf));
 
   // Dynamics
   CartPoleParameters cartPoleParameters;
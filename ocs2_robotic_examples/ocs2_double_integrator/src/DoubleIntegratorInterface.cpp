@@ -32,9 +32,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "ocs2_double_integrator/DoubleIntegratorInterface.h"
 
-#include <ocs2_core/cost/QuadraticStateCost.h>
-#include <ocs2_core/cost/QuadraticStateInputCost.h>
-#include <ocs2_core/dynamics/LinearSystemDynamics.h>
+#include <ocs2_core/cost/FixedSizeQuadraticCost.h>
+#include <ocs2_core/dynamics/FixedSizeSystemDynamics.h>
 #include <ocs2_core/initialization/DefaultInitializer.h>
 #include <ocs2_core/misc/LoadData.h>
 
@@ -88,13 +87,14 @@ DoubleIntegratorInterface::DoubleIntegratorInterface(const std::string& taskFile
   std::cerr << "R:  \n" << R << "\n";
   std::cerr << "Q_final:\n" << Qf << "\n";
 
-  problem_.costPtr->add("cost", std::make_unique<QuadraticStateInputCost>(Q, R));
-  problem_.finalCostPtr->add("finalCost", std::make_unique<QuadraticStateCost>(Qf));
+  problem_.costPtr->add("cost", std::make_unique<FixedSizeQuadraticStateInputCost<STATE_DIM, INPUT_DIM>>(Q, R));
+  problem_.finalCostPtr->add("finalCost", std::make_unique<FixedSizeQuadraticStateCost<STATE_DIM>>(Qf));
 
   // Dynamics
-  const matrix_t A = (matrix_t(STATE_DIM, STATE_DIM) << 0.0, 1.0, 0.0, 0.0).finished();
-  const matrix_t B = (matrix_t(STATE_DIM, INPUT_DIM) << 0.0, 1.0).finished();
-  problem_.dynamicsPtr.reset(new LinearSystemDynamics(A, B));
+  using dynamics_t = FixedSizeLinearSystemDynamics<STATE_DIM, INPUT_DIM>;
+  const dynamics_t::state_matrix_t A = (dynamics_t::state_matrix_t() << 0.0, 1.0, 0.0, 0.0).finished();
+  const dynamics_t::state_input_matrix_t B = (dynamics_t::state_input_matrix_t() << 0.0, 1.0).finished();
+  problem_.dynamicsPtr.reset(new dynamics_t(A, B));
 
   // Rollout
   auto rolloutSettings = rollout::loadSettings(taskFile, "rollout", verbose);
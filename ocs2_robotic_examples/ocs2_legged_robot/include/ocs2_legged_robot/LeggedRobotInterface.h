@@ -36,6 +36,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <ocs2_ddp/DDP_Settings.h>
 #include <ocs2_ipm/IpmSettings.h>
 #include <ocs2_mpc/MPC_Settings.h>
+#include <ocs2_oc/multiple_shooting/IntermediateNodeCppAd.h>
 #include <ocs2_oc/rollout/TimeTriggeredRollout.h>
 #include <ocs2_pinocchio_interface/PinocchioInterface.h>
 #include <ocs2_robotic_tools/common/RobotInterface.h>
@@ -85,6 +86,9 @@ class LeggedRobotInterface final : public RobotInterface {
   const CentroidalModelInfo& getCentroidalModelInfo() const { return centroidalModelInfo_; }
   std::shared_ptr<SwitchedModelReferenceManager> getSwitchedModelReferenceManagerPtr() const { return referenceManagerPtr_; }
 
+  /** The fused intermediate node for the SQP solver, nullptr if ModelSettings::useIntermediateNodeCppAd is false. */
+  const multiple_shooting::IntermediateNodeCppAd* getIntermediateNodeCppAdPtr() const { return intermediateNodeCppAdPtr_.get(); }
+
   const LeggedRobotInitializer& getInitializer() const override { return *initializerPtr_; }
   std::shared_ptr<ReferenceManagerInterface> getReferenceManagerPtr() const override { return referenceManagerPtr_; }
 
@@ -122,6 +126,7 @@ class LeggedRobotInterface final : public RobotInterface {
   rollout::Settings rolloutSettings_;
   std::unique_ptr<RolloutBase> rolloutPtr_;
   std::unique_ptr<LeggedRobotInitializer> initializerPtr_;
+  std::unique_ptr<multiple_shooting::IntermediateNodeCppAd> intermediateNodeCppAdPtr_;
 
   vector_t initialState_;
 };
@@ -0,0 +1,135 @@
+/******************************************************************************
+Copyright (c) 2020, Farbod Farshidian. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#pragma once
+
+#include <memory>
+
+#include <ocs2_core/penalties/penalties/RelaxedBarrierPenalty.h>
+#include <ocs2_oc/multiple_shooting/IntermediateNodeCppAd.h>
+
+#include <ocs2_centroidal_model/CentroidalModelPinocchioMapping.h>
+#include <ocs2_pinocchio_interface/PinocchioInterface.h>
+
+#include "ocs2_legged_robot/common/ModelSettings.h"
+#include "ocs2_legged_robot/constraint/FrictionConeConstraint.h"
+#include "ocs2_legged_robot/reference_manager/SwitchedModelReferenceManager.h"
+
+namespace ocs2 {
+namespace legged_robot {
+
+/**
+ * Fused intermediate node of the legged robot. It tapes the centroidal dynamics, the tracking cost, the friction cone, and the foot
+ * constraints of LeggedRobotInterface into a single model, where the centroidal map and the forward kinematics are shared between the
+ * dynamics and the foot constraints.
+ *
+ * The equality constraints are taped as [zeroForce (3), zeroVelocity (3), normalVelocity (1)] for each foot, which matches the order of
+ * the terms in the optimal control problem. The terms are activated based on the contact flags of the reference manager.
+ *
+ * The tracking cost is taped as the residual of its Gauss-Newton approximation, which is exact for the quadratic cost. The soft friction
+ * cone is penalized based on its linear approximation, i.e. without the curvature of the cone that the quadratic approximation of
+ * FrictionConeConstraint adds to the penalty in the optimal control problem.
+ */
+class LeggedRobotIntermediateNodeCppAd final : public multiple_shooting::IntermediateNodeCppAd {
+ public:
+  /**
+   * Constructor
+   *
+   * @param [in] pinocchioInterface : The pinocchio interface.
+   * @param [in] info : The centroidal model information.
+   * @param [in] referenceManager : The reference manager providing the contact flags.
+   * @param [in] swingTrajectoryPlanner : The swing trajectory planner providing the references of the normal velocity constraints.
+   * @param [in] Q : The state weight of the tracking cost.
+   * @param [in] R : The input weight of the tracking cost.
+   * @param [in] frictionConeConfig : The friction cone settings.
+   * @param [in] barrierPenaltyConfig : The penalty of the friction cone, used if it is not a hard constraint.
+   * @param [in] useHardFrictionConeConstraint : Whether the friction cone is a hard inequality constraint or a soft constraint.
+   * @param [in] integratorType : Integrator used for the discretization of the dynamics.
+   * @param [in] modelName : Name of the generate model library.
+   * @param [in] modelSettings : The model settings.
+   */
+  LeggedRobotIntermediateNodeCppAd(const PinocchioInterface& pinocchioInterface, CentroidalModelInfo info,
+                                   const SwitchedModelReferenceManager& referenceManager,
+                                   const SwingTrajectoryPlanner& swingTrajectoryPlanner, matrix_t Q, matrix_t R,
+                                   FrictionConeConstraint::Config frictionConeConfig, RelaxedBarrierPenalty::Config barrierPenaltyConfig,
+                                   bool useHardFrictionConeConstraint, SensitivityIntegratorType integratorType,
+                                   const std::string& modelName, ModelSettings modelSettings);
+
+  ~LeggedRobotIntermediateNodeCppAd() override = default;
+  LeggedRobotIntermediateNodeCppAd* clone() const override { return new LeggedRobotIntermediateNodeCppAd(*this); }
+
+  vector_t getParameters(scalar_t time, const TargetTrajectories& targetTrajectories) const override;
+
+  size_array_t getSoftConstraintTermsSize() const override;
+  bool isSoftConstraintTermActive(size_t termIndex, scalar_t time) const override;
+
+  size_array_t getEqualityConstraintTermsSize() const override;
+  bool isEqualityConstraintTermActive(size_t termIndex, scalar_t time) const override;
+
+  size_array_t getInequalityConstraintTermsSize() const override;
+  bool isInequalityConstraintTermActive(size_t termIndex, scalar_t time) const override;
+
+ private:
+  LeggedRobotIntermediateNodeCppAd(const LeggedRobotIntermediateNodeCppAd& rhs);
+
+  void nodeFunction(const ad_scalar_t& time, const ad_vector_t& state, const ad_vector_t& input, const ad_vector_t& parameters,
+                    ad_vector_t& stateDerivative, ad_vector_t& costResidual, ad_vector_t& softConstraintValue,
+                    ad_vector_t& equalityConstraintValue, ad_vector_t& inequalityConstraintValue) const override;
+
+  ad_vector_t flowMap(const ad_scalar_t& time, const ad_vector_t& state, const ad_vector_t& input,
+                      const ad_vector_t& parameters) const override;
+
+  ad_vector_t costVectorFunction(const ad_scalar_t& time, const ad_vector_t& state, const ad_vector_t& input,
+                                 const ad_vector_t& parameters) const override;
+
+  ad_vector_t softConstraint(const ad_scalar_t& time, const ad_vector_t& state, const ad_vector_t& input,
+                             const ad_vector_t& parameters) const override;
+
+  /** Centroidal dynamics given the generalized velocities v, assumes that the centroidal map has been updated for the state. */
+  ad_vector_t centroidalDynamics(const ad_vector_t& input, const ad_vector_t& v) const;
+
+  /** Friction cone h(u) >= 0 of each foot */
+  ad_vector_t frictionCone(const ad_vector_t& input) const;
+
+  CentroidalModelInfo info_;
+  const SwitchedModelReferenceManager* referenceManagerPtr_;
+  const SwingTrajectoryPlanner* swingTrajectoryPlannerPtr_;
+  matrix_t stateWeightFactor_;  // S' with S * S' = Q
+  matrix_t inputWeightFactor_;  // S' with S * S' = R
+  FrictionConeConstraint::Config frictionConeConfig_;
+  bool useHardFrictionConeConstraint_;
+  ModelSettings modelSettings_;
+
+  // Only used to record the model, not copied.
+  std::unique_ptr<PinocchioInterfaceCppAd> pinocchioInterfaceCppAdPtr_;
+  std::unique_ptr<CentroidalModelPinocchioMappingCppAd> mappingCppAdPtr_;
+};
+
+}  // namespace legged_robot
+}  // namespace ocs2
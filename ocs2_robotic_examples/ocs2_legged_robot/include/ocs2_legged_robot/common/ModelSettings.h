@@ -47,6 +47,9 @@ struct ModelSettings {
   bool recompileLibrariesCppAd = true;
   std::string modelFolderCppAd = "/tmp/ocs2";
 
+  // Transcribes the intermediate nodes of the SQP solver with a single fused CppAD model
+  bool useIntermediateNodeCppAd = false;
+
   // This is only used to get names for the knees and to check urdf for extra joints that need to be fixed.
   std::vector<std::string> jointNames{"LF_HAA", "LF_HFE", "LF_KFE", "RF_HAA", "RF_HFE", "RF_KFE", 
                                       "LM_HAA", "LM_HFE", "LM_KFE", "RM_HAA", "RM_HFE", "RM_KFE", 
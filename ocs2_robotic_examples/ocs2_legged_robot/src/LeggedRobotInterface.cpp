@@ -46,6 +46,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <ocs2_oc/synchronized_module/SolverSynchronizedModule.h>
 #include <ocs2_pinocchio_interface/PinocchioEndEffectorKinematicsCppAd.h>
 
+#include "ocs2_legged_robot/LeggedRobotIntermediateNodeCppAd.h"
 #include "ocs2_legged_robot/LeggedRobotPreComputation.h"
 #include "ocs2_legged_robot/constraint/FrictionConeConstraint.h"
 #include "ocs2_legged_robot/constraint/NormalVelocityConstraintCppAd.h"
@@ -194,6 +195,16 @@ void LeggedRobotInterface::setupOptimalConrolProblem(const std::string& taskFile
   problemPtr_->preComputationPtr.reset(new LeggedRobotPreComputation(*pinocchioInterfacePtr_, centroidalModelInfo_,
                                                                      *referenceManagerPtr_->getSwingTrajectoryPlanner(), modelSettings_));
 
+  // Fused intermediate node, describes the same terms as the optimal control problem
+  if (modelSettings_.useIntermediateNodeCppAd) {
+    matrix_t Q(centroidalModelInfo_.stateDim, centroidalModelInfo_.stateDim);
+    loadData::loadEigenMatrix(taskFile, "Q", Q);
+    intermediateNodeCppAdPtr_.reset(new LeggedRobotIntermediateNodeCppAd(
+        *pinocchioInterfacePtr_, centroidalModelInfo_, *referenceManagerPtr_, *referenceManagerPtr_->getSwingTrajectoryPlanner(),
+        std::move(Q), initializeInputCostWeight(taskFile, centroidalModelInfo_), FrictionConeConstraint::Config(frictionCoefficient),
+        barrierPenaltyConfig, useHardFrictionConeConstraint_, sqpSettings_.integratorType, "intermediateNode", modelSettings_));
+  }
+
   // Rollout
   rolloutPtr_.reset(new TimeTriggeredRollout(*problemPtr_->dynamicsPtr, rolloutSettings_));
 
@@ -0,0 +1,272 @@
+/******************************************************************************
+Copyright (c) 2020, Farbod Farshidian. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#include <pinocchio/fwd.hpp>  // forward declarations must be included first.
+
+#include <pinocchio/algorithm/frames.hpp>
+#include <pinocchio/algorithm/kinematics.hpp>
+
+#include <ocs2_centroidal_model/AccessHelperFunctions.h>
+#include <ocs2_centroidal_model/ModelHelperFunctions.h>
+
+#include "ocs2_legged_robot/LeggedRobotIntermediateNodeCppAd.h"
+#include "ocs2_legged_robot/common/utils.h"
+
+namespace ocs2 {
+namespace legged_robot {
+
+namespace {
+// Taped equality constraint terms of each foot: zero force, zero velocity, and normal velocity
+constexpr size_t kNumEqualityTermsPerFoot = 3;
+
+/** Returns S' such that S * S' = W for a symmetric positive semi-definite weight W, i.e. 0.5 * e' * W * e = 0.5 * ||S' * e||^2. */
+matrix_t weightFactor(const matrix_t& W) {
+  const Eigen::SelfAdjointEigenSolver<matrix_t> eigenSolver(W);
+  const vector_t sqrtEigenvalues = eigenSolver.eigenvalues().cwiseMax(0.0).cwiseSqrt();
+  return sqrtEigenvalues.asDiagonal() * eigenSolver.eigenvectors().transpose();
+}
+}  // unnamed namespace
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+LeggedRobotIntermediateNodeCppAd::LeggedRobotIntermediateNodeCppAd(
+    const PinocchioInterface& pinocchioInterface, CentroidalModelInfo info, const SwitchedModelReferenceManager& referenceManager,
+    const SwingTrajectoryPlanner& swingTrajectoryPlanner, matrix_t Q, matrix_t R, FrictionConeConstraint::Config frictionConeConfig,
+    RelaxedBarrierPenalty::Config barrierPenaltyConfig, bool useHardFrictionConeConstraint, SensitivityIntegratorType integratorType,
+    const std::string& modelName, ModelSettings modelSettings)
+    : info_(std::move(info)),
+      referenceManagerPtr_(&referenceManager),
+      swingTrajectoryPlannerPtr_(&swingTrajectoryPlanner),
+      stateWeightFactor_(weightFactor(Q)),
+      inputWeightFactor_(weightFactor(R)),
+      frictionConeConfig_(std::move(frictionConeConfig)),
+      useHardFrictionConeConstraint_(useHardFrictionConeConstraint),
+      modelSettings_(std::move(modelSettings)),
+      pinocchioInterfaceCppAdPtr_(new PinocchioInterfaceCppAd(pinocchioInterface.toCppAd())),
+      mappingCppAdPtr_(new CentroidalModelPinocchioMappingCppAd(info_.toCppAd())) {
+  mappingCppAdPtr_->setPinocchioInterface(*pinocchioInterfaceCppAdPtr_);
+  setSoftConstraintPenalty(std::make_unique<RelaxedBarrierPenalty>(barrierPenaltyConfig));
+
+  // parameters: [nominal state, nominal input, swing z-velocity references, swing z-position references]
+  const size_t parameterDim = info_.stateDim + info_.inputDim + 2 * info_.numThreeDofContacts;
+  initialize(info_.stateDim, info_.inputDim, parameterDim, integratorType, modelName, modelSettings_.modelFolderCppAd,
+             modelSettings_.recompileLibrariesCppAd, modelSettings_.verboseCppAd);
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+LeggedRobotIntermediateNodeCppAd::LeggedRobotIntermediateNodeCppAd(const LeggedRobotIntermediateNodeCppAd& rhs)
+    : multiple_shooting::IntermediateNodeCppAd(rhs),
+      info_(rhs.info_),
+      referenceManagerPtr_(rhs.referenceManagerPtr_),
+      swingTrajectoryPlannerPtr_(rhs.swingTrajectoryPlannerPtr_),
+      stateWeightFactor_(rhs.stateWeightFactor_),
+      inputWeightFactor_(rhs.inputWeightFactor_),
+      frictionConeConfig_(rhs.frictionConeConfig_),
+      useHardFrictionConeConstraint_(rhs.useHardFrictionConeConstraint_),
+      modelSettings_(rhs.modelSettings_) {}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+vector_t LeggedRobotIntermediateNodeCppAd::getParameters(scalar_t time, const TargetTrajectories& targetTrajectories) const {
+  const size_t numFeet = info_.numThreeDofContacts;
+  const auto contactFlags = referenceManagerPtr_->getContactFlags(time);
+
+  vector_t parameters(info_.stateDim + info_.inputDim + 2 * numFeet);
+  parameters.head(info_.stateDim) = targetTrajectories.getDesiredState(time);
+  parameters.segment(info_.stateDim, info_.inputDim) = weightCompensatingInput(info_, contactFlags);
+  auto footParameters = parameters.tail(2 * numFeet);
+  for (size_t i = 0; i < numFeet; i++) {
+    footParameters(i) = swingTrajectoryPlannerPtr_->getZvelocityConstraint(i, time);
+    footParameters(numFeet + i) = swingTrajectoryPlannerPtr_->getZpositionConstraint(i, time);
+  }
+  return parameters;
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+size_array_t LeggedRobotIntermediateNodeCppAd::getSoftConstraintTermsSize() const {
+  return useHardFrictionConeConstraint_ ? size_array_t() : size_array_t(info_.numThreeDofContacts, 1);
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+bool LeggedRobotIntermediateNodeCppAd::isSoftConstraintTermActive(size_t termIndex, scalar_t time) const {
+  return referenceManagerPtr_->getContactFlags(time)[termIndex];
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+size_array_t LeggedRobotIntermediateNodeCppAd::getEqualityConstraintTermsSize() const {
+  size_array_t termsSize;
+  termsSize.reserve(kNumEqualityTermsPerFoot * info_.numThreeDofContacts);
+  for (size_t i = 0; i < info_.numThreeDofContacts; i++) {
+    termsSize.insert(termsSize.end(), {3, 3, 1});
+  }
+  return termsSize;
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+bool LeggedRobotIntermediateNodeCppAd::isEqualityConstraintTermActive(size_t termIndex, scalar_t time) const {
+  const bool inContact = referenceManagerPtr_->getContactFlags(time)[termIndex / kNumEqualityTermsPerFoot];
+  // The zero velocity constraint is active in stance, the zero force and normal velocity constraints in swing.
+  const bool isZeroVelocityTerm = (termIndex % kNumEqualityTermsPerFoot) == 1;
+  return isZeroVelocityTerm == inContact;
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+size_array_t LeggedRobotIntermediateNodeCppAd::getInequalityConstraintTermsSize() const {
+  return useHardFrictionConeConstraint_ ? size_array_t(info_.numThreeDofContacts, 1) : size_array_t();
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+bool LeggedRobotIntermediateNodeCppAd::isInequalityConstraintTermActive(size_t termIndex, scalar_t time) const {
+  return referenceManagerPtr_->getContactFlags(time)[termIndex];
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void LeggedRobotIntermediateNodeCppAd::nodeFunction(const ad_scalar_t& time, const ad_vector_t& state, const ad_vector_t& input,
+                                                    const ad_vector_t& parameters, ad_vector_t& stateDerivative, ad_vector_t& costResidual,
+                                                    ad_vector_t& softConstraintValue, ad_vector_t& equalityConstraintValue,
+                                                    ad_vector_t& inequalityConstraintValue) const {
+  const auto& infoCppAd = mappingCppAdPtr_->getCentroidalModelInfo();
+  const auto& model = pinocchioInterfaceCppAdPtr_->getModel();
+  auto& data = pinocchioInterfaceCppAdPtr_->getData();
+  const size_t numFeet = info_.numThreeDofContacts;
+  const auto footParameters = parameters.tail(2 * numFeet);
+  const ad_scalar_t positionErrorGain(modelSettings_.positionErrorGain);
+
+  // Dynamics
+  const ad_vector_t q = mappingCppAdPtr_->getPinocchioJointPosition(state);
+  updateCentroidalDynamics(*pinocchioInterfaceCppAdPtr_, infoCppAd, q);
+  const ad_vector_t v = mappingCppAdPtr_->getPinocchioJointVelocity(state, input);
+  stateDerivative = centroidalDynamics(input, v);
+
+  // Cost
+  costResidual = costVectorFunction(time, state, input, parameters);
+
+  // Foot constraints, the frame placements are already updated together with the centroidal map
+  pinocchio::forwardKinematics(model, data, q, v);
+  equalityConstraintValue.resize(7 * numFeet);
+  for (size_t i = 0; i < numFeet; i++) {
+    const size_t frameId = info_.endEffectorFrameIndices[i];
+    const ad_scalar_t footHeight = data.oMf[frameId].translation().z();
+    const Eigen::Matrix<ad_scalar_t, 3, 1> footVelocity =
+        pinocchio::getFrameVelocity(model, data, frameId, pinocchio::ReferenceFrame::LOCAL_WORLD_ALIGNED).linear();
+
+    auto footConstraints = equalityConstraintValue.segment<7>(7 * i);
+    footConstraints.head<3>() = centroidal_model::getContactForces(input, i, infoCppAd);
+    footConstraints.segment<3>(3) = footVelocity;
+    footConstraints(5) += positionErrorGain * footHeight;
+    const ad_scalar_t footHeightError = footHeight - footParameters(numFeet + i);
+    footConstraints(6) = footVelocity.z() - footParameters(i) + positionErrorGain * footHeightError;
+  }
+
+  // Friction cone
+  softConstraintValue = softConstraint(time, state, input, parameters);
+  inequalityConstraintValue = useHardFrictionConeConstraint_ ? frictionCone(input) : ad_vector_t(0);
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+ad_vector_t LeggedRobotIntermediateNodeCppAd::flowMap(const ad_scalar_t& time, const ad_vector_t& state, const ad_vector_t& input,
+                                                      const ad_vector_t& parameters) const {
+  const ad_vector_t q = mappingCppAdPtr_->getPinocchioJointPosition(state);
+  updateCentroidalDynamics(*pinocchioInterfaceCppAdPtr_, mappingCppAdPtr_->getCentroidalModelInfo(), q);
+  return centroidalDynamics(input, mappingCppAdPtr_->getPinocchioJointVelocity(state, input));
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+ad_vector_t LeggedRobotIntermediateNodeCppAd::costVectorFunction(const ad_scalar_t& time, const ad_vector_t& state,
+                                                                 const ad_vector_t& input, const ad_vector_t& parameters) const {
+  // Tracking cost
+  const ad_vector_t stateDeviation = state - parameters.head(info_.stateDim);
+  const ad_vector_t inputDeviation = input - parameters.segment(info_.stateDim, info_.inputDim);
+  ad_vector_t costResidual(stateWeightFactor_.rows() + inputWeightFactor_.rows());
+  costResidual << stateWeightFactor_.cast<ad_scalar_t>() * stateDeviation, inputWeightFactor_.cast<ad_scalar_t>() * inputDeviation;
+  return costResidual;
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+ad_vector_t LeggedRobotIntermediateNodeCppAd::softConstraint(const ad_scalar_t& time, const ad_vector_t& state, const ad_vector_t& input,
+                                                             const ad_vector_t& parameters) const {
+  return useHardFrictionConeConstraint_ ? ad_vector_t(0) : frictionCone(input);
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+ad_vector_t LeggedRobotIntermediateNodeCppAd::centroidalDynamics(const ad_vector_t& input, const ad_vector_t& v) const {
+  const auto& infoCppAd = mappingCppAdPtr_->getCentroidalModelInfo();
+  ad_vector_t stateDerivative(info_.stateDim);
+  centroidal_model::getNormalizedMomentum(stateDerivative, infoCppAd) =
+      getNormalizedCentroidalMomentumRate(*pinocchioInterfaceCppAdPtr_, infoCppAd, input);
+  centroidal_model::getGeneralizedCoordinates(stateDerivative, infoCppAd) = v;
+  return stateDerivative;
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+ad_vector_t LeggedRobotIntermediateNodeCppAd::frictionCone(const ad_vector_t& input) const {
+  const auto& infoCppAd = mappingCppAdPtr_->getCentroidalModelInfo();
+  const ad_scalar_t frictionCoefficient(frictionConeConfig_.frictionCoefficient);
+  const ad_scalar_t regularization(frictionConeConfig_.regularization);
+  const ad_scalar_t gripperForce(frictionConeConfig_.gripperForce);
+
+  ad_vector_t h(info_.numThreeDofContacts);
+  for (size_t i = 0; i < info_.numThreeDofContacts; i++) {
+    const Eigen::Matrix<ad_scalar_t, 3, 1> force = centroidal_model::getContactForces(input, i, infoCppAd);
+    const ad_scalar_t tangentialForceNorm = sqrt(force.x() * force.x() + force.y() * force.y() + regularization);
+    h(i) = frictionCoefficient * (force.z() + gripperForce) - tangentialForceNorm;
+  }
+  return h;
+}
+
+}  // namespace legged_robot
+}  // namespace ocs2
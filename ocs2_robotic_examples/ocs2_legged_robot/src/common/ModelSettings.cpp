@@ -54,6 +54,7 @@ ModelSettings loadModelSettings(const std::string& filename, const std::string&
   loadData::loadPtreeValue(pt, modelSettings.verboseCppAd, fieldName + ".verboseCppAd", verbose);
   loadData::loadPtreeValue(pt, modelSettings.recompileLibrariesCppAd, fieldName + ".recompileLibrariesCppAd", verbose);
   loadData::loadPtreeValue(pt, modelSettings.modelFolderCppAd, fieldName + ".modelFolderCppAd", verbose);
+  loadData::loadPtreeValue(pt, modelSettings.useIntermediateNodeCppAd, fieldName + ".useIntermediateNodeCppAd", verbose);
 
   if (verbose) {
     std::cerr << " #### =============================================================================" << std::endl;
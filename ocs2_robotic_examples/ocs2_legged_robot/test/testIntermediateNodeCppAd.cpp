@@ -0,0 +1,167 @@
+/******************************************************************************
+Copyright (c) 2021, Farbod Farshidian. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <ocs2_centroidal_model/CentroidalModelPinocchioMapping.h>
+#include <ocs2_centroidal_model/ModelHelperFunctions.h>
+#include <ocs2_core/misc/Benchmark.h>
+#include <ocs2_core/test/testTools.h>
+#include <ocs2_oc/multiple_shooting/Transcription.h>
+#include <ocs2_pinocchio_interface/PinocchioEndEffectorKinematicsCppAd.h>
+
+#include "ocs2_legged_robot/LeggedRobotIntermediateNodeCppAd.h"
+#include "ocs2_legged_robot/LeggedRobotPreComputation.h"
+#include "ocs2_legged_robot/constraint/NormalVelocityConstraintCppAd.h"
+#include "ocs2_legged_robot/constraint/ZeroForceConstraint.h"
+#include "ocs2_legged_robot/constraint/ZeroVelocityConstraintCppAd.h"
+#include "ocs2_legged_robot/cost/LeggedRobotQuadraticTrackingCost.h"
+#include "ocs2_legged_robot/dynamics/LeggedRobotDynamicsAD.h"
+#include "ocs2_legged_robot/test/AnymalFactoryFunctions.h"
+
+using namespace ocs2;
+using namespace legged_robot;
+
+/** Compares the fused node against the optimal control problem of LeggedRobotInterface with the hard friction cone constraint. */
+class TestLeggedRobotIntermediateNodeCppAd : public testing::Test {
+ public:
+  TestLeggedRobotIntermediateNodeCppAd() {
+    modelSettings.positionErrorGain = 20.0;
+    modelSettings.verboseCppAd = false;
+    referenceManagerPtr->preSolverRun(0.0, 1.0, vector_t::Zero(info.stateDim));
+    const auto& swingTrajectoryPlanner = *referenceManagerPtr->getSwingTrajectoryPlanner();
+
+    const matrix_t Q = matrix_t::Identity(info.stateDim, info.stateDim);
+    const matrix_t R = 1e-3 * matrix_t::Identity(info.inputDim, info.inputDim);
+    const FrictionConeConstraint::Config frictionConeConfig;
+
+    problem.dynamicsPtr.reset(new LeggedRobotDynamicsAD(*pinocchioInterfacePtr, info, "testIntermediateNode_dynamics", modelSettings));
+    problem.costPtr->add("baseTrackingCost", std::make_unique<LeggedRobotStateInputQuadraticCost>(Q, R, info, *referenceManagerPtr));
+
+    const auto infoCppAd = info.toCppAd();
+    const CentroidalModelPinocchioMappingCppAd pinocchioMappingCppAd(infoCppAd);
+    auto velocityUpdateCallback = [&infoCppAd](const ad_vector_t& state, PinocchioInterfaceCppAd& pinocchioInterfaceAd) {
+      const ad_vector_t q = centroidal_model::getGeneralizedCoordinates(state, infoCppAd);
+      updateCentroidalDynamics(pinocchioInterfaceAd, infoCppAd, q);
+    };
+    for (size_t i = 0; i < info.numThreeDofContacts; i++) {
+      const std::string& footName = modelSettings.contactNames3DoF[i];
+      PinocchioEndEffectorKinematicsCppAd eeKinematics(*pinocchioInterfacePtr, pinocchioMappingCppAd, {footName}, info.stateDim,
+                                                       info.inputDim, velocityUpdateCallback, "testIntermediateNode_" + footName,
+                                                       modelSettings.modelFolderCppAd, true, false);
+
+      EndEffectorLinearConstraint::Config zeroVelocityConfig;
+      zeroVelocityConfig.b.setZero(3);
+      zeroVelocityConfig.Av.setIdentity(3, 3);
+      zeroVelocityConfig.Ax.setZero(3, 3);
+      zeroVelocityConfig.Ax(2, 2) = modelSettings.positionErrorGain;
+
+      problem.inequalityConstraintPtr->add(footName + "_frictionCone", std::make_unique<FrictionConeConstraint>(
+                                                                             *referenceManagerPtr, frictionConeConfig, i, info));
+      problem.equalityConstraintPtr->add(footName + "_zeroForce", std::make_unique<ZeroForceConstraint>(*referenceManagerPtr, i, info));
+      problem.equalityConstraintPtr->add(footName + "_zeroVelocity", std::make_unique<ZeroVelocityConstraintCppAd>(
+                                                                          *referenceManagerPtr, eeKinematics, i, zeroVelocityConfig));
+      problem.equalityConstraintPtr->add(footName + "_normalVelocity",
+                                         std::make_unique<NormalVelocityConstraintCppAd>(*referenceManagerPtr, eeKinematics, i));
+    }
+    problem.preComputationPtr.reset(new LeggedRobotPreComputation(*pinocchioInterfacePtr, info, swingTrajectoryPlanner, modelSettings));
+    problem.targetTrajectoriesPtr = &targetTrajectories;
+
+    fusedNodePtr.reset(new LeggedRobotIntermediateNodeCppAd(*pinocchioInterfacePtr, info, *referenceManagerPtr, swingTrajectoryPlanner, Q,
+                                                            R, frictionConeConfig, RelaxedBarrierPenalty::Config(), true,
+                                                            SensitivityIntegratorType::RK2, "testIntermediateNode_fused", modelSettings));
+  }
+
+  vector_t randomState() const {
+    vector_t x = 0.1 * vector_t::Random(info.stateDim);
+    x(8) += 0.5;  // base height
+    return x;
+  }
+
+  vector_t randomInput() const {
+    vector_t u = 0.1 * vector_t::Random(info.inputDim);
+    for (size_t i = 0; i < info.numThreeDofContacts; i++) {
+      u(3 * i + 2) += 100.0;  // normal force
+    }
+    return u;
+  }
+
+  const CentroidalModelType centroidalModelType = CentroidalModelType::SingleRigidBodyDynamics;
+  std::unique_ptr<PinocchioInterface> pinocchioInterfacePtr = createAnymalPinocchioInterface();
+  const CentroidalModelInfo info = createAnymalCentroidalModelInfo(*pinocchioInterfacePtr, centroidalModelType);
+  const std::shared_ptr<SwitchedModelReferenceManager> referenceManagerPtr = createReferenceManager(info.numThreeDofContacts);
+  ModelSettings modelSettings;
+
+  TargetTrajectories targetTrajectories{{0.0}, {vector_t::Zero(info.stateDim)}, {vector_t::Zero(info.inputDim)}};
+  OptimalControlProblem problem;
+  DynamicsSensitivityDiscretizer sensitivityDiscretizer = selectDynamicsSensitivityDiscretization(SensitivityIntegratorType::RK2);
+  std::unique_ptr<LeggedRobotIntermediateNodeCppAd> fusedNodePtr;
+};
+
+TEST_F(TestLeggedRobotIntermediateNodeCppAd, matchesTranscription) {
+  const scalar_t dt = 0.015;
+  const scalar_t tol = 1e-6;
+  for (const scalar_t t : {0.1, 0.4, 0.7}) {
+    const vector_t x = randomState();
+    const vector_t xNext = randomState();
+    const vector_t u = randomInput();
+
+    const auto expected = multiple_shooting::setupIntermediateNode(problem, sensitivityDiscretizer, t, dt, x, xNext, u);
+    const auto fused = fusedNodePtr->setupIntermediateNode(t, dt, x, xNext, u, targetTrajectories);
+
+    EXPECT_TRUE(isApprox(fused.dynamics, expected.dynamics, tol));
+    EXPECT_TRUE(isApprox(fused.cost, expected.cost, tol));
+    EXPECT_TRUE(isApprox(fused.stateInputEqConstraints, expected.stateInputEqConstraints, tol));
+    EXPECT_TRUE(isApprox(fused.stateInputIneqConstraints, expected.stateInputIneqConstraints, tol));
+    EXPECT_EQ(fused.constraintsSize.stateInputEq, expected.constraintsSize.stateInputEq);
+    EXPECT_EQ(fused.constraintsSize.stateInputIneq, expected.constraintsSize.stateInputIneq);
+  }
+}
+
+TEST_F(TestLeggedRobotIntermediateNodeCppAd, benchmark) {
+  constexpr int numRepeats = 1000;
+  const scalar_t dt = 0.015;
+  const vector_t x = randomState();
+  const vector_t u = randomInput();
+
+  benchmark::RepeatedTimer separateTimer;
+  benchmark::RepeatedTimer fusedTimer;
+  for (int i = 0; i < numRepeats; ++i) {
+    separateTimer.startTimer();
+    const auto separate = multiple_shooting::setupIntermediateNode(problem, sensitivityDiscretizer, 0.1, dt, x, x, u);
+    separateTimer.endTimer();
+
+    fusedTimer.startTimer();
+    const auto fused = fusedNodePtr->setupIntermediateNode(0.1, dt, x, x, u, targetTrajectories);
+    fusedTimer.endTimer();
+  }
+
+  std::cerr << "[LeggedRobotIntermediateNodeCppAd] per node, separate: " << separateTimer.getAverageInMilliseconds() * 1e3
+            << " [us], fused: " << fusedTimer.getAverageInMilliseconds() * 1e3 << " [us]\n";
+}
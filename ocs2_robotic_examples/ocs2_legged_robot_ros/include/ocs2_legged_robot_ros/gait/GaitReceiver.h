@@ -53,6 +53,8 @@ class GaitReceiver : public SolverSynchronizedModule {
 
   void postSolverRun(const PrimalSolution& primalSolution) override{};
 
+  bool modifiesProblem() const override { return false; }
+
  private:
   void mpcModeSequenceCallback(const ocs2_msgs::mode_schedule::ConstPtr& msg);
 
@@ -70,6 +70,9 @@ int main(int argc, char** argv) {
   SqpMpc mpc(interface.mpcSettings(), interface.sqpSettings(), interface.getOptimalControlProblem(), interface.getInitializer());
   mpc.getSolverPtr()->setReferenceManager(rosReferenceManagerPtr);
   mpc.getSolverPtr()->addSynchronizedModule(gaitReceiverPtr);
+  if (interface.getIntermediateNodeCppAdPtr() != nullptr) {
+    mpc.getSolverPtr()->setIntermediateNodeCppAd(*interface.getIntermediateNodeCppAdPtr());
+  }
 
   // observer for zero velocity constraints (only add this for debugging as it slows down the solver)
   if (multiplot) {
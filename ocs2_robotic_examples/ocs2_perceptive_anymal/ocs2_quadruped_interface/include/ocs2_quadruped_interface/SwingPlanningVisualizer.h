@@ -29,6 +29,8 @@ class SwingPlanningVisualizer : public ocs2::SolverSynchronizedModule {
 
   void postSolverRun(const ocs2::PrimalSolution& primalSolution) override{};
 
+  bool modifiesProblem() const override { return false; }
+
  private:
   const SwingTrajectoryPlanner* swingTrajectoryPlannerPtr_;
   feet_array_t<ros::Publisher> nominalFootholdPublishers_;
@@ -43,6 +43,8 @@ class TerrainPlaneVisualizerSynchronizedModule : public ocs2::SolverSynchronized
 
   void postSolverRun(const ocs2::PrimalSolution& primalSolution) override;
 
+  bool modifiesProblem() const override { return false; }
+
  private:
   const SwingTrajectoryPlanner* swingTrajectoryPlanner_;
   TerrainPlaneVisualizer planeVisualizer_;
@@ -18,6 +18,11 @@ namespace switched_model {
 
 class TerrainReceiverSynchronizedModule : public ocs2::SolverSynchronizedModule {
  public:
+  /**
+   * @param terrainModel : The terrain model that is updated before each solver run.
+   * @param nodeHandle : ROS node handle. The ROS parameter "/incrementalSignedDistanceField" (default false) selects the incremental
+   * signed distance field of the terrain (see SegmentedPlanesTerrainModelRos).
+   */
   TerrainReceiverSynchronizedModule(ocs2::Synchronized<TerrainModel>& terrainModel, ros::NodeHandle& nodeHandle);
   ~TerrainReceiverSynchronizedModule() override = default;
 
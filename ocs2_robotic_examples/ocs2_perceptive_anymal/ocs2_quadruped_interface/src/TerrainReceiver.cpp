@@ -6,9 +6,19 @@
 
 namespace switched_model {
 
+namespace {
+bool readIncrementalSignedDistanceFieldParameter(const ros::NodeHandle& nodeHandle) {
+  bool incrementalSignedDistanceField = false;
+  nodeHandle.getParam("/incrementalSignedDistanceField", incrementalSignedDistanceField);
+  return incrementalSignedDistanceField;
+}
+}  // namespace
+
 TerrainReceiverSynchronizedModule::TerrainReceiverSynchronizedModule(ocs2::Synchronized<TerrainModel>& terrainModel,
                                                                      ros::NodeHandle& nodeHandle)
-    : terrainModelPtr_(&terrainModel), segmentedPlanesRos_(new switched_model::SegmentedPlanesTerrainModelRos(nodeHandle)) {}
+    : terrainModelPtr_(&terrainModel),
+      segmentedPlanesRos_(new switched_model::SegmentedPlanesTerrainModelRos(nodeHandle,
+                                                                             readIncrementalSignedDistanceFieldParameter(nodeHandle))) {}
 
 void TerrainReceiverSynchronizedModule::preSolverRun(scalar_t initTime, scalar_t finalTime, const vector_t& currentState,
                                                      const ocs2::ReferenceManagerInterface& referenceManager) {
@@ -0,0 +1,46 @@
+//
+// Created on 17.10.26.
+//
+
+#pragma once
+
+#include <memory>
+
+#include <ocs2_switched_model_interface/terrain/SignedDistanceField.h>
+
+#include <ocs2_perceptive/distance_transform/IncrementalSignedDistanceField.h>
+
+namespace switched_model {
+
+/**
+ * Wrapper class to implement the switched_model::SignedDistanceField interface with an ocs2::IncrementalSignedDistanceField.
+ * The field is immutable once computed, such that clones and the next incremental update can share it.
+ */
+class SegmentedPlanesIncrementalSignedDistanceField : public SignedDistanceField {
+ public:
+  explicit SegmentedPlanesIncrementalSignedDistanceField(std::shared_ptr<const ocs2::IncrementalSignedDistanceField> sdfPtr)
+      : sdfPtr_(std::move(sdfPtr)) {}
+
+  ~SegmentedPlanesIncrementalSignedDistanceField() override = default;
+  SegmentedPlanesIncrementalSignedDistanceField* clone() const override {
+    return new SegmentedPlanesIncrementalSignedDistanceField(sdfPtr_);
+  }
+
+  switched_model::scalar_t value(const switched_model::vector3_t& position) const override { return sdfPtr_->getValue(position); }
+
+  switched_model::vector3_t derivative(const switched_model::vector3_t& position) const override {
+    return sdfPtr_->getLinearApproximation(position).second;
+  }
+
+  std::pair<switched_model::scalar_t, switched_model::vector3_t> valueAndDerivative(
+      const switched_model::vector3_t& position) const override {
+    return sdfPtr_->getLinearApproximation(position);
+  }
+
+  const std::shared_ptr<const ocs2::IncrementalSignedDistanceField>& getSharedField() const { return sdfPtr_; }
+
+ private:
+  std::shared_ptr<const ocs2::IncrementalSignedDistanceField> sdfPtr_;
+};
+
+}  // namespace switched_model
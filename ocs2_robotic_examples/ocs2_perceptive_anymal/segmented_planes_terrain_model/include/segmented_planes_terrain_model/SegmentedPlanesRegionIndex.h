@@ -0,0 +1,65 @@
+//
+// Created on 17.10.26.
+//
+
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include <ocs2_switched_model_interface/core/SwitchedModel.h>
+
+#include <convex_plane_decomposition/PlanarRegion.h>
+#include <convex_plane_decomposition/SegmentedPlaneProjection.h>
+
+namespace switched_model {
+
+/**
+ * Uniform 2D grid over the world-frame XY bounding boxes of a set of planar regions.
+ *
+ * The grid answers the same query as convex_plane_decomposition::getBestPlanarRegionAtPositionInWorld, but visits the cells in rings
+ * around the query point and stops as soon as the XY distance to the next ring exceeds the best cost found so far. Only regions near the
+ * query are projected, instead of all regions of the terrain. Like the bounding box pruning of the original function, this assumes a
+ * non-negative penalty.
+ *
+ * The index only stores region indices, the regions themselves are passed to the query and must be the ones it was built from.
+ */
+class SegmentedPlanesRegionIndex {
+ public:
+  explicit SegmentedPlanesRegionIndex(const std::vector<convex_plane_decomposition::PlanarRegion>& planarRegions);
+
+  /** Returns the projection onto the region with the lowest squared distance plus penalty, regionPtr is nullptr if there are no regions. */
+  convex_plane_decomposition::RegionProjection getBestPlanarRegionAtPositionInWorld(
+      const vector3_t& positionInWorld, const std::vector<convex_plane_decomposition::PlanarRegion>& planarRegions,
+      const std::function<scalar_t(const vector3_t&)>& penaltyFunction) const;
+
+  scalar_t getCellSize() const { return cellSize_; }
+  int getNumCells() const { return numCellsX_ * numCellsY_; }
+
+ private:
+  /** Range of cells covered by a region, bounds included */
+  struct CellRange {
+    int minX;
+    int maxX;
+    int minY;
+    int maxY;
+  };
+
+  int cellIndexX(scalar_t x) const;
+  int cellIndexY(scalar_t y) const;
+
+  /** Chebyshev distance in cells between a cell and a range of cells */
+  static int ringDistance(int cellX, int cellY, const CellRange& cellRange);
+
+  scalar_t originX_ = 0.0;
+  scalar_t originY_ = 0.0;
+  scalar_t cellSize_ = 1.0;
+  int numCellsX_ = 0;
+  int numCellsY_ = 0;
+
+  std::vector<CellRange> regionCellRanges_;
+  std::vector<int> cellBegin_;    // Cell c holds the regions cellRegions_[cellBegin_[c]] ... cellRegions_[cellBegin_[c + 1] - 1]
+  std::vector<int> cellRegions_;  // Region indices, ordered by cell
+};
+
+}  // namespace switched_model
@@ -8,6 +8,8 @@
 
 #include <convex_plane_decomposition/PlanarRegion.h>
 
+#include "segmented_planes_terrain_model/SegmentedPlanesIncrementalSignedDistanceField.h"
+#include "segmented_planes_terrain_model/SegmentedPlanesRegionIndex.h"
 #include "segmented_planes_terrain_model/SegmentedPlanesSignedDistanceField.h"
 
 namespace switched_model {
@@ -25,7 +27,21 @@ class SegmentedPlanesTerrainModel : public switched_model::TerrainModel {
 
   void createSignedDistanceBetween(const Eigen::Vector3d& minCoordinates, const Eigen::Vector3d& maxCoordinates);
 
-  const SegmentedPlanesSignedDistanceField* getSignedDistanceField() const override { return signedDistanceField_.get(); }
+  /**
+   * Alternative to createSignedDistanceBetween that computes an ocs2::IncrementalSignedDistanceField, truncated at maxDistance. When the
+   * field of a previous terrain is given, only the part that changed with respect to the previous map is recomputed.
+   */
+  void createIncrementalSignedDistanceBetween(const Eigen::Vector3d& minCoordinates, const Eigen::Vector3d& maxCoordinates,
+                                              scalar_t maxDistance,
+                                              const std::shared_ptr<const ocs2::IncrementalSignedDistanceField>& previousSdfPtr);
+
+  const SignedDistanceField* getSignedDistanceField() const override;
+
+  /** The field created by createSignedDistanceBetween, nullptr if there is none. */
+  const SegmentedPlanesSignedDistanceField* getGridmapSignedDistanceField() const { return signedDistanceField_.get(); }
+
+  /** The field created by createIncrementalSignedDistanceBetween, nullptr if there is none. */
+  std::shared_ptr<const ocs2::IncrementalSignedDistanceField> getIncrementalSignedDistanceField() const;
 
   vector3_t getHighestObstacleAlongLine(const vector3_t& position1InWorld, const vector3_t& position2InWorld) const override;
 
@@ -35,7 +51,9 @@ class SegmentedPlanesTerrainModel : public switched_model::TerrainModel {
 
  private:
   const convex_plane_decomposition::PlanarTerrain planarTerrain_;
+  const SegmentedPlanesRegionIndex regionIndex_;
   std::unique_ptr<SegmentedPlanesSignedDistanceField> signedDistanceField_;
+  std::unique_ptr<SegmentedPlanesIncrementalSignedDistanceField> incrementalSignedDistanceField_;
   const grid_map::Matrix* const elevationData_;
 };
 
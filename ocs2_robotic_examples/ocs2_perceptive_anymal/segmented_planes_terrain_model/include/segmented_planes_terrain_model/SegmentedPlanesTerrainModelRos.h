@@ -20,7 +20,11 @@ namespace switched_model {
 
 class SegmentedPlanesTerrainModelRos {
  public:
-  SegmentedPlanesTerrainModelRos(ros::NodeHandle& nodehandle);
+  /**
+   * @param nodehandle : ROS node handle.
+   * @param incrementalSignedDistanceField : Compute the signed distance field of each terrain incrementally from the previous one.
+   */
+  SegmentedPlanesTerrainModelRos(ros::NodeHandle& nodehandle, bool incrementalSignedDistanceField = false);
 
   ~SegmentedPlanesTerrainModelRos();
 
@@ -43,6 +47,9 @@ class SegmentedPlanesTerrainModelRos {
   std::atomic_bool terrainUpdated_;
   std::unique_ptr<SegmentedPlanesTerrainModel> terrainPtr_;
 
+  const bool incrementalSignedDistanceField_;
+  std::shared_ptr<const ocs2::IncrementalSignedDistanceField> previousSignedDistanceFieldPtr_;
+
   std::mutex updateCoordinatesMutex_;
   Eigen::Vector3d minCoordinates_;
   Eigen::Vector3d maxCoordinates_;
@@ -4,9 +4,11 @@
 
 #pragma once
 
+#include <sensor_msgs/PointCloud2.h>
 #include <visualization_msgs/Marker.h>
 #include <visualization_msgs/MarkerArray.h>
 
+#include <ocs2_perceptive/distance_transform/IncrementalSignedDistanceField.h>
 #include <ocs2_ros_interfaces/visualization/VisualizationColors.h>
 #include <ocs2_switched_model_interface/terrain/ConvexTerrain.h>
 
@@ -15,4 +17,7 @@ namespace switched_model {
 visualization_msgs::MarkerArray getConvexTerrainMarkers(const ConvexTerrain& convexTerrain, ocs2::Color color, double linewidth,
                                                         double normalLength);
 
+/** Point cloud with the samples of the signed distance field that have a value in [minValue, maxValue]. */
+sensor_msgs::PointCloud2 getSignedDistancePointCloud(const ocs2::IncrementalSignedDistanceField& sdf, scalar_t minValue, scalar_t maxValue);
+
 }  // namespace switched_model
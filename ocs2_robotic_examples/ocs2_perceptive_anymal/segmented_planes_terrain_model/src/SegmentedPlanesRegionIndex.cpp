@@ -0,0 +1,222 @@
+//
+// Created on 17.10.26.
+//
+
+#include "segmented_planes_terrain_model/SegmentedPlanesRegionIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace switched_model {
+
+namespace {
+// Lower bound on the cell size, avoids an unbounded number of cells for degenerate maps
+const scalar_t minCellSize = 1e-3;
+// Query indices are clamped to this range before the conversion to int
+const scalar_t maxCellIndex = 1e6;
+
+struct RegionCandidate {
+  int regionIndex;
+  vector3_t positionInTerrainFrame;
+  scalar_t lowerBound;
+};
+
+scalar_t squaredDistanceToBoundingBox(scalar_t x, scalar_t y, const convex_plane_decomposition::CgalBbox2d& boundingBox) {
+  const scalar_t dx = std::max({boundingBox.xmin() - x, 0.0, x - boundingBox.xmax()});
+  const scalar_t dy = std::max({boundingBox.ymin() - y, 0.0, y - boundingBox.ymax()});
+  return dx * dx + dy * dy;
+}
+}  // namespace
+
+SegmentedPlanesRegionIndex::SegmentedPlanesRegionIndex(const std::vector<convex_plane_decomposition::PlanarRegion>& planarRegions) {
+  if (planarRegions.empty()) {
+    return;
+  }
+
+  // World frame XY bounding box of each region: the bounding box in the plane mapped to the world contains the region boundary.
+  std::vector<Eigen::Vector4d> worldBoxes;  // (minX, minY, maxX, maxY)
+  worldBoxes.reserve(planarRegions.size());
+  for (const auto& planarRegion : planarRegions) {
+    const auto& bbox = planarRegion.bbox2d;
+    Eigen::Vector4d worldBox(std::numeric_limits<scalar_t>::max(), std::numeric_limits<scalar_t>::max(),
+                             std::numeric_limits<scalar_t>::lowest(), std::numeric_limits<scalar_t>::lowest());
+    for (const auto x : {bbox.xmin(), bbox.xmax()}) {
+      for (const auto y : {bbox.ymin(), bbox.ymax()}) {
+        const vector3_t cornerInWorld = planarRegion.transformPlaneToWorld * vector3_t(x, y, 0.0);
+        worldBox.head<2>() = worldBox.head<2>().cwiseMin(cornerInWorld.head<2>());
+        worldBox.tail<2>() = worldBox.tail<2>().cwiseMax(cornerInWorld.head<2>());
+      }
+    }
+    worldBoxes.push_back(worldBox);
+  }
+
+  // Grid over the union of the boxes, with about one region per cell
+  Eigen::Vector4d terrainBox = worldBoxes.front();
+  for (const auto& worldBox : worldBoxes) {
+    terrainBox.head<2>() = terrainBox.head<2>().cwiseMin(worldBox.head<2>());
+    terrainBox.tail<2>() = terrainBox.tail<2>().cwiseMax(worldBox.tail<2>());
+  }
+  const scalar_t lengthX = terrainBox(2) - terrainBox(0);
+  const scalar_t lengthY = terrainBox(3) - terrainBox(1);
+  originX_ = terrainBox(0);
+  originY_ = terrainBox(1);
+  const auto numRegions = static_cast<scalar_t>(planarRegions.size());
+  cellSize_ = std::max({std::sqrt(lengthX * lengthY / numRegions), lengthX / numRegions, lengthY / numRegions, minCellSize});
+  numCellsX_ = static_cast<int>(lengthX / cellSize_) + 1;
+  numCellsY_ = static_cast<int>(lengthY / cellSize_) + 1;
+
+  regionCellRanges_.reserve(planarRegions.size());
+  for (const auto& worldBox : worldBoxes) {
+    regionCellRanges_.push_back({cellIndexX(worldBox(0)), cellIndexX(worldBox(2)), cellIndexY(worldBox(1)), cellIndexY(worldBox(3))});
+  }
+
+  // Count regions per cell, then fill cellRegions_ back to front to keep the regions of a cell in increasing order.
+  const int numCells = numCellsX_ * numCellsY_;
+  cellBegin_.assign(numCells + 1, 0);
+  for (const auto& cellRange : regionCellRanges_) {
+    for (int j = cellRange.minY; j <= cellRange.maxY; ++j) {
+      for (int i = cellRange.minX; i <= cellRange.maxX; ++i) {
+        ++cellBegin_[j * numCellsX_ + i + 1];
+      }
+    }
+  }
+  std::partial_sum(cellBegin_.begin(), cellBegin_.end(), cellBegin_.begin());
+
+  cellRegions_.resize(cellBegin_.back());
+  std::vector<int> cellEnd(cellBegin_.begin() + 1, cellBegin_.end());
+  for (int regionIndex = static_cast<int>(regionCellRanges_.size()) - 1; regionIndex >= 0; --regionIndex) {
+    const auto& cellRange = regionCellRanges_[regionIndex];
+    for (int j = cellRange.minY; j <= cellRange.maxY; ++j) {
+      for (int i = cellRange.minX; i <= cellRange.maxX; ++i) {
+        cellRegions_[--cellEnd[j * numCellsX_ + i]] = regionIndex;
+      }
+    }
+  }
+}
+
+convex_plane_decomposition::RegionProjection SegmentedPlanesRegionIndex::getBestPlanarRegionAtPositionInWorld(
+    const vector3_t& positionInWorld, const std::vector<convex_plane_decomposition::PlanarRegion>& planarRegions,
+    const std::function<scalar_t(const vector3_t&)>& penaltyFunction) const {
+  convex_plane_decomposition::RegionProjection projection;
+  projection.regionPtr = nullptr;
+  if (regionCellRanges_.empty()) {
+    return projection;
+  }
+
+  const auto clampedIndex = [](scalar_t index) {
+    return static_cast<int>(std::floor(std::max(std::min(index, maxCellIndex), -maxCellIndex)));
+  };
+  const int queryX = clampedIndex((positionInWorld.x() - originX_) / cellSize_);
+  const int queryY = clampedIndex((positionInWorld.y() - originY_) / cellSize_);
+
+  // Rings before firstRing contain no cells, after lastRing all cells have been visited.
+  const CellRange gridRange{0, numCellsX_ - 1, 0, numCellsY_ - 1};
+  const int firstRing = ringDistance(queryX, queryY, gridRange);
+  const int lastRing = std::max({queryX, numCellsX_ - 1 - queryX, queryY, numCellsY_ - 1 - queryY});
+
+  scalar_t minCost = std::numeric_limits<scalar_t>::max();
+  std::vector<RegionCandidate> candidates;
+  for (int ring = firstRing; ring <= lastRing; ++ring) {
+    // Regions that are first met in this ring lie outside the square of all previous rings.
+    if (ring > 0) {
+      const scalar_t distanceToRing = std::max({std::min({positionInWorld.x() - (originX_ + (queryX - ring + 1) * cellSize_),
+                                                          (originX_ + (queryX + ring) * cellSize_) - positionInWorld.x(),
+                                                          positionInWorld.y() - (originY_ + (queryY - ring + 1) * cellSize_),
+                                                          (originY_ + (queryY + ring) * cellSize_) - positionInWorld.y()}),
+                                                0.0});
+      if (distanceToRing * distanceToRing >= minCost) {
+        break;
+      }
+    }
+
+    // Collect the regions of this ring, a region is handled in the ring closest to the query that it overlaps.
+    candidates.clear();
+    const auto addCell = [&](int i, int j) {
+      const int cell = j * numCellsX_ + i;
+      for (int k = cellBegin_[cell]; k < cellBegin_[cell + 1]; ++k) {
+        const int regionIndex = cellRegions_[k];
+        if (ringDistance(queryX, queryY, regionCellRanges_[regionIndex]) == ring) {
+          candidates.push_back({regionIndex, vector3_t::Zero(), 0.0});
+        }
+      }
+    };
+    const int minX = std::max(queryX - ring, 0);
+    const int maxX = std::min(queryX + ring, numCellsX_ - 1);
+    for (int j = std::max(queryY - ring, 0); j <= std::min(queryY + ring, numCellsY_ - 1); ++j) {
+      if (std::abs(j - queryY) == ring) {
+        for (int i = minX; i <= maxX; ++i) {
+          addCell(i, j);
+        }
+      } else {
+        if (queryX - ring >= 0) {
+          addCell(queryX - ring, j);
+        }
+        if (queryX + ring < numCellsX_) {
+          addCell(queryX + ring, j);
+        }
+      }
+    }
+    if (candidates.empty()) {
+      continue;
+    }
+
+    // A region overlapping several cells of the ring is only projected once.
+    std::sort(candidates.begin(), candidates.end(),
+              [](const RegionCandidate& lhs, const RegionCandidate& rhs) { return lhs.regionIndex < rhs.regionIndex; });
+    candidates.erase(std::unique(candidates.begin(), candidates.end(),
+                                 [](const RegionCandidate& lhs, const RegionCandidate& rhs) { return lhs.regionIndex == rhs.regionIndex; }),
+                     candidates.end());
+
+    // Same lower bound as the full search: distance to the bounding box in the plane, plus the distance to the plane.
+    for (auto& candidate : candidates) {
+      const auto& planarRegion = planarRegions[candidate.regionIndex];
+      candidate.positionInTerrainFrame = planarRegion.transformPlaneToWorld.inverse() * positionInWorld;
+      const scalar_t dz = candidate.positionInTerrainFrame.z();
+      candidate.lowerBound =
+          squaredDistanceToBoundingBox(candidate.positionInTerrainFrame.x(), candidate.positionInTerrainFrame.y(), planarRegion.bbox2d) +
+          dz * dz;
+    }
+    std::sort(candidates.begin(), candidates.end(),
+              [](const RegionCandidate& lhs, const RegionCandidate& rhs) { return lhs.lowerBound < rhs.lowerBound; });
+
+    for (const auto& candidate : candidates) {
+      if (candidate.lowerBound > minCost) {
+        break;
+      }
+
+      const auto& planarRegion = planarRegions[candidate.regionIndex];
+      const auto projectedPointInTerrainFrame = convex_plane_decomposition::projectToPlanarRegion(
+          {candidate.positionInTerrainFrame.x(), candidate.positionInTerrainFrame.y()}, planarRegion);
+      const vector3_t projectedPointInWorld =
+          planarRegion.transformPlaneToWorld * vector3_t(projectedPointInTerrainFrame.x(), projectedPointInTerrainFrame.y(), 0.0);
+      const scalar_t cost = (projectedPointInWorld - positionInWorld).squaredNorm() + penaltyFunction(projectedPointInWorld);
+
+      if (cost < minCost) {
+        minCost = cost;
+        projection.regionPtr = &planarRegion;
+        projection.positionInTerrainFrame = projectedPointInTerrainFrame;
+        projection.positionInWorld = projectedPointInWorld;
+      }
+    }
+  }
+
+  return projection;
+}
+
+int SegmentedPlanesRegionIndex::cellIndexX(scalar_t x) const {
+  return std::min(std::max(static_cast<int>((x - originX_) / cellSize_), 0), numCellsX_ - 1);
+}
+
+int SegmentedPlanesRegionIndex::cellIndexY(scalar_t y) const {
+  return std::min(std::max(static_cast<int>((y - originY_) / cellSize_), 0), numCellsY_ - 1);
+}
+
+int SegmentedPlanesRegionIndex::ringDistance(int cellX, int cellY, const CellRange& cellRange) {
+  const int dx = std::max({cellRange.minX - cellX, 0, cellX - cellRange.maxX});
+  const int dy = std::max({cellRange.minY - cellY, 0, cellY - cellRange.maxY});
+  return std::max(dx, dy);
+}
+
+}  // namespace switched_model
@@ -15,16 +15,28 @@ namespace switched_model {
 
 namespace {
 const std::string elevationLayerName = "elevation";
+
+grid_map::GridMap getSubmapBetween(const grid_map::GridMap& gridMap, const Eigen::Vector3d& minCoordinates,
+                                   const Eigen::Vector3d& maxCoordinates, bool& success) {
+  // Compute coordinates of submap
+  const auto minXY = grid_map::lookup::projectToMapWithMargin(gridMap, grid_map::Position(minCoordinates.x(), minCoordinates.y()));
+  const auto maxXY = grid_map::lookup::projectToMapWithMargin(gridMap, grid_map::Position(maxCoordinates.x(), maxCoordinates.y()));
+  const auto centerXY = 0.5 * (minXY + maxXY);
+  const auto lengths = maxXY - minXY;
+
+  return gridMap.getSubmap(centerXY, lengths, success);
+}
 }  // namespace
 
 SegmentedPlanesTerrainModel::SegmentedPlanesTerrainModel(convex_plane_decomposition::PlanarTerrain planarTerrain)
     : planarTerrain_(std::move(planarTerrain)),
+      regionIndex_(planarTerrain_.planarRegions),
       signedDistanceField_(nullptr),
       elevationData_(&planarTerrain_.gridMap.get(elevationLayerName)) {}
 
 TerrainPlane SegmentedPlanesTerrainModel::getLocalTerrainAtPositionInWorldAlongGravity(
     const vector3_t& positionInWorld, std::function<scalar_t(const vector3_t&)> penaltyFunction) const {
-  const auto projection = getBestPlanarRegionAtPositionInWorld(positionInWorld, planarTerrain_.planarRegions, std::move(penaltyFunction));
+  const auto projection = regionIndex_.getBestPlanarRegionAtPositionInWorld(positionInWorld, planarTerrain_.planarRegions, penaltyFunction);
   if (projection.regionPtr == nullptr) {
     throw std::runtime_error("[SegmentedPlanesTerrainModel] no region found");
   }
@@ -34,7 +46,7 @@ TerrainPlane SegmentedPlanesTerrainModel::getLocalTerrainAtPositionInWorldAlongG
 
 ConvexTerrain SegmentedPlanesTerrainModel::getConvexTerrainAtPositionInWorld(
     const vector3_t& positionInWorld, std::function<scalar_t(const vector3_t&)> penaltyFunction) const {
-  const auto projection = getBestPlanarRegionAtPositionInWorld(positionInWorld, planarTerrain_.planarRegions, std::move(penaltyFunction));
+  const auto projection = regionIndex_.getBestPlanarRegionAtPositionInWorld(positionInWorld, planarTerrain_.planarRegions, penaltyFunction);
   if (projection.regionPtr == nullptr) {
     throw std::runtime_error("[SegmentedPlanesTerrainModel] no region found");
   }
@@ -59,24 +71,60 @@ ConvexTerrain SegmentedPlanesTerrainModel::getConvexTerrainAtPositionInWorld(
 
 void SegmentedPlanesTerrainModel::createSignedDistanceBetween(const Eigen::Vector3d& minCoordinates,
                                                               const Eigen::Vector3d& maxCoordinates) {
-  // Compute coordinates of submap
-  const auto minXY =
-      grid_map::lookup::projectToMapWithMargin(planarTerrain_.gridMap, grid_map::Position(minCoordinates.x(), minCoordinates.y()));
-  const auto maxXY =
-      grid_map::lookup::projectToMapWithMargin(planarTerrain_.gridMap, grid_map::Position(maxCoordinates.x(), maxCoordinates.y()));
-  const auto centerXY = 0.5 * (minXY + maxXY);
-  const auto lengths = maxXY - minXY;
-
   bool success = true;
-  grid_map::GridMap subMap = planarTerrain_.gridMap.getSubmap(centerXY, lengths, success);
+  grid_map::GridMap subMap = getSubmapBetween(planarTerrain_.gridMap, minCoordinates, maxCoordinates, success);
   if (success) {
     signedDistanceField_ =
         std::make_unique<SegmentedPlanesSignedDistanceField>(subMap, elevationLayerName, minCoordinates.z(), maxCoordinates.z());
+    incrementalSignedDistanceField_.reset();
   } else {
     std::cerr << "[SegmentedPlanesTerrainModel] Failed to get subMap" << std::endl;
   }
 }
 
+void SegmentedPlanesTerrainModel::createIncrementalSignedDistanceBetween(
+    const Eigen::Vector3d& minCoordinates, const Eigen::Vector3d& maxCoordinates, scalar_t maxDistance,
+    const std::shared_ptr<const ocs2::IncrementalSignedDistanceField>& previousSdfPtr) {
+  bool success = true;
+  grid_map::GridMap subMap = getSubmapBetween(planarTerrain_.gridMap, minCoordinates, maxCoordinates, success);
+  if (success) {
+    subMap.convertToDefaultStartIndex();
+    grid_map::Position firstCellPosition;
+    subMap.getPosition(grid_map::Index(0, 0), firstCellPosition);
+    const auto& elevation = subMap.get(elevationLayerName);
+
+    std::shared_ptr<const ocs2::IncrementalSignedDistanceField> sdfPtr;
+    if (previousSdfPtr != nullptr) {
+      sdfPtr = std::make_shared<const ocs2::IncrementalSignedDistanceField>(elevation, subMap.getResolution(), firstCellPosition,
+                                                                            minCoordinates.z(), maxCoordinates.z(), maxDistance,
+                                                                            *previousSdfPtr);
+    } else {
+      sdfPtr = std::make_shared<const ocs2::IncrementalSignedDistanceField>(elevation, subMap.getResolution(), firstCellPosition,
+                                                                            minCoordinates.z(), maxCoordinates.z(), maxDistance);
+    }
+    incrementalSignedDistanceField_ = std::make_unique<SegmentedPlanesIncrementalSignedDistanceField>(std::move(sdfPtr));
+    signedDistanceField_.reset();
+  } else {
+    std::cerr << "[SegmentedPlanesTerrainModel] Failed to get subMap" << std::endl;
+  }
+}
+
+const SignedDistanceField* SegmentedPlanesTerrainModel::getSignedDistanceField() const {
+  if (incrementalSignedDistanceField_ != nullptr) {
+    return incrementalSignedDistanceField_.get();
+  } else {
+    return signedDistanceField_.get();
+  }
+}
+
+std::shared_ptr<const ocs2::IncrementalSignedDistanceField> SegmentedPlanesTerrainModel::getIncrementalSignedDistanceField() const {
+  if (incrementalSignedDistanceField_ != nullptr) {
+    return incrementalSignedDistanceField_->getSharedField();
+  } else {
+    return nullptr;
+  }
+}
+
 vector3_t SegmentedPlanesTerrainModel::getHighestObstacleAlongLine(const vector3_t& position1InWorld,
                                                                    const vector3_t& position2InWorld) const {
   const auto result = grid_map::lookup::maxValueBetweenLocations(
@@ -10,10 +10,18 @@
 
 #include <grid_map_filters_rsl/lookup.hpp>
 
+#include "segmented_planes_terrain_model/SegmentedPlanesTerrainVisualization.h"
+
 namespace switched_model {
 
-SegmentedPlanesTerrainModelRos::SegmentedPlanesTerrainModelRos(ros::NodeHandle& nodehandle)
+namespace {
+// Truncation distance of the incremental signed distance field, larger than the clearances it is used for.
+const scalar_t incrementalSignedDistanceMaxDistance = 0.5;
+}  // namespace
+
+SegmentedPlanesTerrainModelRos::SegmentedPlanesTerrainModelRos(ros::NodeHandle& nodehandle, bool incrementalSignedDistanceField)
     : terrainUpdated_(false),
+      incrementalSignedDistanceField_(incrementalSignedDistanceField),
       minCoordinates_(Eigen::Vector3d::Zero()),
       maxCoordinates_(Eigen::Vector3d::Zero()),
       externalCoordinatesGiven_(false) {
@@ -69,15 +77,27 @@ void SegmentedPlanesTerrainModelRos::callback(const convex_plane_decomposition_m
   const std::string elevationLayer = "elevation";
   if (terrainPtr->planarTerrain().gridMap.exists(elevationLayer)) {
     const auto sdfRange = getSignedDistanceRange(terrainPtr->planarTerrain().gridMap, elevationLayer);
-    terrainPtr->createSignedDistanceBetween(sdfRange.first, sdfRange.second);
+    if (incrementalSignedDistanceField_) {
+      terrainPtr->createIncrementalSignedDistanceBetween(sdfRange.first, sdfRange.second, incrementalSignedDistanceMaxDistance,
+                                                         previousSignedDistanceFieldPtr_);
+      previousSignedDistanceFieldPtr_ = terrainPtr->getIncrementalSignedDistanceField();
+    } else {
+      terrainPtr->createSignedDistanceBetween(sdfRange.first, sdfRange.second);
+    }
   }
 
   // Create pointcloud for visualization
-  const auto* sdfPtr = terrainPtr->getSignedDistanceField();
-  if (sdfPtr != nullptr) {
+  std::unique_ptr<sensor_msgs::PointCloud2> pointCloud2MsgPtr;
+  if (const auto* sdfPtr = terrainPtr->getGridmapSignedDistanceField()) {
     const auto& sdf = sdfPtr->asGridmapSdf();
-    std::unique_ptr<sensor_msgs::PointCloud2> pointCloud2MsgPtr(new sensor_msgs::PointCloud2());
+    pointCloud2MsgPtr.reset(new sensor_msgs::PointCloud2());
     grid_map::GridMapRosConverter::toPointCloud(sdf, *pointCloud2MsgPtr, 1, [](float val) { return -0.05F <= val && val <= 0.0F; });
+  } else if (const auto incrementalSdfPtr = terrainPtr->getIncrementalSignedDistanceField()) {
+    pointCloud2MsgPtr.reset(new sensor_msgs::PointCloud2(getSignedDistancePointCloud(*incrementalSdfPtr, -0.05, 0.0)));
+    pointCloud2MsgPtr->header.frame_id = terrainPtr->planarTerrain().gridMap.getFrameId();
+    pointCloud2MsgPtr->header.stamp.fromNSec(terrainPtr->planarTerrain().gridMap.getTimestamp());
+  }
+  if (pointCloud2MsgPtr != nullptr) {
     std::lock_guard<std::mutex> lock(pointCloudMutex_);
     pointCloud2MsgPtr_.swap(pointCloud2MsgPtr);
   }
@@ -4,6 +4,10 @@
 
 #include "segmented_planes_terrain_model/SegmentedPlanesTerrainVisualization.h"
 
+#include <functional>
+
+#include <sensor_msgs/point_cloud2_iterator.h>
+
 #include <ocs2_ros_interfaces/visualization/VisualizationHelpers.h>
 
 namespace switched_model {
@@ -36,4 +40,47 @@ visualization_msgs::MarkerArray getConvexTerrainMarkers(const ConvexTerrain& con
   return markerArray;
 }
 
+sensor_msgs::PointCloud2 getSignedDistancePointCloud(const ocs2::IncrementalSignedDistanceField& sdf, scalar_t minValue,
+                                                     scalar_t maxValue) {
+  const auto forEachPoint = [&](const std::function<void(size_t, size_t, size_t, scalar_t)>& f) {
+    for (size_t layer = 0; layer < sdf.getNumLayers(); ++layer) {
+      for (size_t col = 0; col < sdf.getNumCols(); ++col) {
+        for (size_t row = 0; row < sdf.getNumRows(); ++row) {
+          const scalar_t value = sdf.getSampleValue(row, col, layer);
+          if (minValue <= value && value <= maxValue) {
+            f(row, col, layer, value);
+          }
+        }
+      }
+    }
+  };
+
+  size_t numPoints = 0;
+  forEachPoint([&](size_t, size_t, size_t, scalar_t) { ++numPoints; });
+
+  sensor_msgs::PointCloud2 pointCloud;
+  sensor_msgs::PointCloud2Modifier modifier(pointCloud);
+  modifier.setPointCloud2Fields(4, "x", 1, sensor_msgs::PointField::FLOAT32, "y", 1, sensor_msgs::PointField::FLOAT32, "z", 1,
+                                sensor_msgs::PointField::FLOAT32, "signed_distance", 1, sensor_msgs::PointField::FLOAT32);
+  modifier.resize(numPoints);
+
+  sensor_msgs::PointCloud2Iterator<float> iterX(pointCloud, "x");
+  sensor_msgs::PointCloud2Iterator<float> iterY(pointCloud, "y");
+  sensor_msgs::PointCloud2Iterator<float> iterZ(pointCloud, "z");
+  sensor_msgs::PointCloud2Iterator<float> iterValue(pointCloud, "signed_distance");
+  forEachPoint([&](size_t row, size_t col, size_t layer, scalar_t value) {
+    const vector3_t position = sdf.getSamplePosition(row, col, layer);
+    *iterX = position.x();
+    *iterY = position.y();
+    *iterZ = position.z();
+    *iterValue = value;
+    ++iterX;
+    ++iterY;
+    ++iterZ;
+    ++iterValue;
+  });
+
+  return pointCloud;
+}
+
 }  // namespace switched_model
@@ -0,0 +1,140 @@
+//
+// Created on 17.10.26.
+//
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <iostream>
+#include <random>
+
+#include <ocs2_core/misc/Benchmark.h>
+
+#include "segmented_planes_terrain_model/SegmentedPlanesRegionIndex.h"
+
+using namespace switched_model;
+using namespace convex_plane_decomposition;
+
+namespace {
+
+/** Square patches of random size, height, yaw and tilt on a lattice, similar to a map of stepping stones or gravel. */
+std::vector<PlanarRegion> getRandomPlanarRegions(int numRegions, std::mt19937& generator) {
+  std::uniform_real_distribution<scalar_t> sizeDistribution(0.05, 0.3);
+  std::uniform_real_distribution<scalar_t> heightDistribution(0.0, 0.3);
+  std::uniform_real_distribution<scalar_t> angleDistribution(-0.3, 0.3);
+  std::uniform_real_distribution<scalar_t> yawDistribution(-M_PI, M_PI);
+
+  const scalar_t spacing = 0.4;
+  const int numRegionsPerRow = static_cast<int>(std::ceil(std::sqrt(numRegions)));
+
+  std::vector<PlanarRegion> planarRegions(numRegions);
+  for (int i = 0; i < numRegions; ++i) {
+    const scalar_t halfLength = sizeDistribution(generator);
+    const scalar_t halfWidth = sizeDistribution(generator);
+    CgalPolygon2d outline;
+    outline.push_back({-halfLength, -halfWidth});
+    outline.push_back({halfLength, -halfWidth});
+    outline.push_back({halfLength, halfWidth});
+    outline.push_back({-halfLength, halfWidth});
+
+    auto& planarRegion = planarRegions[i];
+    planarRegion.boundaryWithInset.boundary = CgalPolygonWithHoles2d(outline);
+    planarRegion.boundaryWithInset.insets.push_back(planarRegion.boundaryWithInset.boundary);
+    planarRegion.bbox2d = outline.bbox();
+    planarRegion.transformPlaneToWorld.setIdentity();
+    planarRegion.transformPlaneToWorld.translation() << (i % numRegionsPerRow) * spacing, (i / numRegionsPerRow) * spacing,
+        heightDistribution(generator);
+    planarRegion.transformPlaneToWorld.linear() = (Eigen::AngleAxisd(yawDistribution(generator), vector3_t::UnitZ()) *
+                                                   Eigen::AngleAxisd(angleDistribution(generator), vector3_t::UnitX()) *
+                                                   Eigen::AngleAxisd(angleDistribution(generator), vector3_t::UnitY()))
+                                                      .toRotationMatrix();
+  }
+  return planarRegions;
+}
+
+/** Query points above the map and in a margin around it. */
+std::vector<vector3_t> getRandomQueries(const std::vector<PlanarRegion>& planarRegions, int numQueries, std::mt19937& generator) {
+  vector3_t minPosition = planarRegions.front().transformPlaneToWorld.translation();
+  vector3_t maxPosition = minPosition;
+  for (const auto& planarRegion : planarRegions) {
+    minPosition = minPosition.cwiseMin(planarRegion.transformPlaneToWorld.translation());
+    maxPosition = maxPosition.cwiseMax(planarRegion.transformPlaneToWorld.translation());
+  }
+  const vector3_t margin(1.0, 1.0, 0.5);
+  std::uniform_real_distribution<scalar_t> uniformDistribution(0.0, 1.0);
+
+  std::vector<vector3_t> queries(numQueries);
+  for (auto& query : queries) {
+    for (int i = 0; i < 3; ++i) {
+      query(i) = minPosition(i) - margin(i) + uniformDistribution(generator) * (maxPosition(i) - minPosition(i) + 2.0 * margin(i));
+    }
+  }
+  return queries;
+}
+
+const std::function<scalar_t(const vector3_t&)> zeroPenalty = [](const vector3_t&) { return 0.0; };
+const std::function<scalar_t(const vector3_t&)> heightPenalty = [](const vector3_t& position) {
+  return 0.1 * position.z() * position.z();
+};
+
+}  // unnamed namespace
+
+TEST(testSegmentedPlanesRegionIndex, emptyTerrain) {
+  const std::vector<PlanarRegion> planarRegions;
+  const SegmentedPlanesRegionIndex regionIndex(planarRegions);
+  const auto projection = regionIndex.getBestPlanarRegionAtPositionInWorld(vector3_t::Zero(), planarRegions, zeroPenalty);
+  ASSERT_EQ(projection.regionPtr, nullptr);
+}
+
+TEST(testSegmentedPlanesRegionIndex, sameAsFullSearch) {
+  std::mt19937 generator(0);
+  for (const int numRegions : {1, 2, 10, 100, 500}) {
+    const auto planarRegions = getRandomPlanarRegions(numRegions, generator);
+    const SegmentedPlanesRegionIndex regionIndex(planarRegions);
+
+    for (const auto& penaltyFunction : {zeroPenalty, heightPenalty}) {
+      for (const auto& query : getRandomQueries(planarRegions, 200, generator)) {
+        const auto expected = getBestPlanarRegionAtPositionInWorld(query, planarRegions, penaltyFunction);
+        const auto projection = regionIndex.getBestPlanarRegionAtPositionInWorld(query, planarRegions, penaltyFunction);
+        ASSERT_EQ(projection.regionPtr, expected.regionPtr) << "numRegions: " << numRegions << ", query: " << query.transpose();
+        ASSERT_TRUE(projection.positionInWorld.isApprox(expected.positionInWorld));
+        ASSERT_DOUBLE_EQ(projection.positionInTerrainFrame.x(), expected.positionInTerrainFrame.x());
+        ASSERT_DOUBLE_EQ(projection.positionInTerrainFrame.y(), expected.positionInTerrainFrame.y());
+      }
+    }
+  }
+}
+
+TEST(testSegmentedPlanesRegionIndex, benchmark) {
+  std::mt19937 generator(0);
+  const int numQueries = 1000;
+  for (const int numRegions : {10, 100, 500, 2000}) {
+    const auto planarRegions = getRandomPlanarRegions(numRegions, generator);
+    const auto queries = getRandomQueries(planarRegions, numQueries, generator);
+
+    ocs2::benchmark::RepeatedTimer buildTimer;
+    buildTimer.startTimer();
+    const SegmentedPlanesRegionIndex regionIndex(planarRegions);
+    buildTimer.endTimer();
+
+    ocs2::benchmark::RepeatedTimer fullSearchTimer;
+    ocs2::benchmark::RepeatedTimer indexTimer;
+    scalar_t fullSearchSum = 0.0;
+    scalar_t indexSum = 0.0;
+    for (const auto& query : queries) {
+      fullSearchTimer.startTimer();
+      fullSearchSum += getBestPlanarRegionAtPositionInWorld(query, planarRegions, heightPenalty).positionInWorld.z();
+      fullSearchTimer.endTimer();
+
+      indexTimer.startTimer();
+      indexSum += regionIndex.getBestPlanarRegionAtPositionInWorld(query, planarRegions, heightPenalty).positionInWorld.z();
+      indexTimer.endTimer();
+    }
+    ASSERT_NEAR(indexSum, fullSearchSum, 1e-9 * numQueries);
+
+    std::cerr << "[testSegmentedPlanesRegionIndex] regions: " << numRegions << ", cells: " << regionIndex.getNumCells()
+              << ", build: " << buildTimer.getTotalInMilliseconds() << " [ms]"
+              << ", full search: " << 1e3 * fullSearchTimer.getAverageInMilliseconds() << " [us]"
+              << ", index: " << 1e3 * indexTimer.getAverageInMilliseconds() << " [us]\n";
+  }
+}
@@ -33,8 +33,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ocs2_quadrotor/QuadrotorInterface.h"
 #include "ocs2_quadrotor/dynamics/QuadrotorSystemDynamics.h"
 
-#include <ocs2_core/cost/QuadraticStateCost.h>
-#include <ocs2_core/cost/QuadraticStateInputCost.h>
+#include <ocs2_core/cost/FixedSizeQuadraticCost.h>
 #include <ocs2_core/initialization/OperatingPoints.h>
 #include <ocs2_core/misc/LoadData.h>
 
@@ -88,8 +87,8 @@ QuadrotorInterface::QuadrotorInterface(const std::string& taskFile, const std::s
   std::cerr << "R:  \n" << R << "\n";
   std::cerr << "Q_final:\n" << Qf << "\n";
 
-  problem_.costPtr->add("cost", std::make_unique<QuadraticStateInputCost>(Q, R));
-  problem_.finalCostPtr->add("finalCost", std::make_unique<QuadraticStateCost>(Qf));
+  problem_.costPtr->add("cost", std::make_unique<FixedSizeQuadraticStateInputCost<STATE_DIM, INPUT_DIM>>(Q, R));
+  problem_.finalCostPtr->add("finalCost", std::make_unique<FixedSizeQuadraticStateCost<STATE_DIM>>(Qf));
 
   // Dynamics
   auto quadrotorParameters = quadrotor::loadSettings(taskFile, "QuadrotorParameters", true);
@@ -39,10 +39,12 @@ namespace slp {
 
 /** Multiple-shooting SLP (Successive Linear Programming) settings */
 struct Settings {
-  size_t slpIteration = 10;     // Maximum number of SLP iterations
-  size_t scalingIteration = 3;  // Number of pre-conditioning iterations
-  scalar_t deltaTol = 1e-6;     // Termination condition : RMS update of x(t) and u(t) are both below this value
-  scalar_t costTol = 1e-4;      // Termination condition : (cost{i+1} - (cost{i}) < costTol AND constraints{i+1} < g_min
+  size_t slpIteration = 10;          // Maximum number of SLP iterations
+  size_t scalingIteration = 3;       // Maximum number of pre-conditioning iterations
+  scalar_t scalingTolerance = 0.0;   // Pre-conditioning stops once all scaling factors of an iteration are within this tolerance of 1
+  bool scalingWarmStart = false;     // Start the pre-conditioning from the scaling of the previous QP
+  scalar_t deltaTol = 1e-6;          // Termination condition : RMS update of x(t) and u(t) are both below this value
+  scalar_t costTol = 1e-4;           // Termination condition : (cost{i+1} - (cost{i}) < costTol AND constraints{i+1} < g_min
 
   // Linesearch - step size rules
   scalar_t alpha_decay = 0.5;  // multiply the step size by this factor every time a linesearch step is rejected.
@@ -55,8 +57,14 @@ struct Settings {
   scalar_t gamma_c = 1e-6;       // (3): ELSE REQUIRE c{i+1} < (c{i} - gamma_c * g{i}) OR g{i+1} < (1-gamma_c) * g{i}
 
   // Discretization method
-  scalar_t dt = 0.01;  // user-defined time discretization
+  scalar_t dt = 0.01;                 // user-defined time discretization
+  scalar_array_t dtSwitchingTimes;    // multi-rate horizon: times since the initial time at which the next entry of dtSchedule is used
+                                      // as the time step, dt is used before the first one
+  scalar_array_t dtSchedule;          // time steps after each of the dtSwitchingTimes
+  scalar_t dtGrowthFactor = 1.0;      // geometric growth of the time step per node after the last switching time
+  scalar_t dtGrowthMax = 0.1;         // upper bound of the growing time step
   SensitivityIntegratorType integratorType = SensitivityIntegratorType::RK2;
+  scalar_t integratorMaxStep = 0.0;  // intervals longer than this are integrated in sub-steps, e.g. for a coarse tail. 0 to disable.
 
   // Inequality penalty relaxed barrier parameters
   scalar_t inequalityConstraintMu = 0.0;
@@ -73,6 +81,8 @@ struct Settings {
   // Threading
   size_t nThreads = 4;
   int threadPriority = 50;
+  int parallelForGrainSize = 1;  // Number of consecutive nodes a worker takes at once. If <= 0, it is adapted to the horizon.
+  size_t threadSpinCount = 0;    // Number of busy-wait iterations of an idle worker before it sleeps.
 
   // LP subproblem solver settings
   pipg::Settings pipgSettings = pipg::Settings();
@@ -112,8 +112,8 @@ class SlpSolver : public SolverBase {
     runImpl(initTime, initState, finalTime);
   }
 
-  /** Run a task in parallel with settings.nThreads */
-  void runParallel(std::function<void(int)> taskFunction);
+  /** Run a task for each index in [begin, end) in parallel with the thread pool. The task takes (workerId, index). */
+  void parallelFor(int begin, int end, std::function<void(int, int)> taskFunction);
 
   /** Get profiling information as a string */
   std::string getBenchmarkingInformation() const;
@@ -134,7 +134,13 @@ class SlpSolver : public SolverBase {
     vector_array_t deltaUSol;      // delta_u(t)
     scalar_t armijoDescentMetric;  // inner product of the cost gradient and decision variable step
   };
-  OcpSubproblemSolution getOCPSolution(const vector_t& delta_x0);
+  OcpSubproblemSolution getOCPSolution(const std::vector<AnnotatedTime>& time, const vector_t& delta_x0);
+
+  /**
+   * Sets the stored primal warm start of PIPG, shifted onto the given time discretization and scaled by the preconditioning D. The
+   * multipliers start from zero, the ones of the last solve are not converged well enough to be a good starting point.
+   */
+  void setPipgWarmStart(const std::vector<AnnotatedTime>& time, const vector_array_t& D);
 
   /** Constructs the primal solution based on the optimized state and input trajectories */
   PrimalSolution toPrimalSolution(const std::vector<AnnotatedTime>& time, vector_array_t&& x, vector_array_t&& u);
@@ -151,6 +157,7 @@ class SlpSolver : public SolverBase {
   const slp::Settings settings_;
   DynamicsDiscretizer discretizer_;
   DynamicsSensitivityDiscretizer sensitivityDiscretizer_;
+  HorizonStepSchedule horizonStepSchedule_;
   std::vector<OptimalControlProblem> ocpDefinitions_;
   std::unique_ptr<Initializer> initializerPtr_;
   FilterLinesearch filterLinesearch_;
@@ -175,6 +182,16 @@ class SlpSolver : public SolverBase {
   // Lagrange multipliers
   std::vector<multiple_shooting::ProjectionMultiplierCoefficients> projectionMultiplierCoefficients_;
 
+  // PIPG warm start: the part of the last QP step that was not taken (unscaled)
+  scalar_array_t warmStartTime_;
+  vector_array_t warmStartDeltaX_;
+  vector_array_t warmStartDeltaU_;
+
+  // Pre-conditioning {D, E, c} of the last QP, the starting point of the next one
+  vector_array_t preconditionD_;
+  vector_array_t preconditionE_;
+  scalar_t preconditionC_ = 1.0;
+
   // Iteration performance log
   std::vector<PerformanceIndex> performanceIndeces_;
 
@@ -195,6 +212,8 @@ class SlpSolver : public SolverBase {
   benchmark::RepeatedTimer sigmaEstimation_;
   benchmark::RepeatedTimer preConditioning_;
   benchmark::RepeatedTimer pipgSolverTimer_;
+  size_t totalNumPipgIterations_{0};
+  size_t totalNumPreconditioningIterations_{0};
 };
 
 }  // namespace ocs2
@@ -44,6 +44,12 @@ struct Settings {
   size_t checkTerminationInterval = 1;
   /** The static lower bound of the cost hessian H. **/
   scalar_t lowerBoundH = 5e-6;
+  /** Whether to start from the iterates of the previous solve (or the ones set by PipgSolver::setWarmStart), instead of zero. **/
+  bool warmStart = false;
+  /** The step size schedule of a warm started solve begins at this fraction of the number of iterations of the previous solve. **/
+  scalar_t warmStartIterationRatio = 0.5;
+  /** Number of busy-wait polls of a worker at the barrier between two iterations before it goes to sleep. **/
+  size_t barrierSpinCount = 10000;
   /** This value determines to display the a summary log. */
   bool displayShortSummary = false;
 };
@@ -81,6 +81,20 @@ class PipgSolver {
 
   void resize(const OcpSize& size);
 
+  /**
+   * Sets the initial primal and dual iterates of the next solve, which are otherwise the iterates of the previous solve. Only used if
+   * settings().warmStart is true. The trajectories are in the scaled variables of the problem passed to solve(). Elements with a size
+   * that does not match the problem start from zero.
+   *
+   * @param [in] xTrajectory : Initial state trajectory. The first element is ignored, it is set to x0.
+   * @param [in] uTrajectory : Initial input trajectory.
+   * @param [in] wTrajectory : Initial multipliers of the dynamics constraints.
+   */
+  void setWarmStart(vector_array_t xTrajectory, vector_array_t uTrajectory, vector_array_t wTrajectory);
+
+  /** The number of iterations of the last solve. */
+  size_t getNumIterations() const { return numIterations_; }
+
   int getNumDecisionVariables() const { return numDecisionVariables_; }
   int getNumDynamicsConstraints() const { return numDynamicsConstraints_; }
 
@@ -102,9 +116,13 @@ class PipgSolver {
   int numDecisionVariables_;
   int numDynamicsConstraints_;
 
+  // Number of iterations of the last solve
+  size_t numIterations_ = 0;
+
   // Data buffer for parallelized PIPG
   vector_array_t X_, W_, V_, U_;
   vector_array_t XNew_, UNew_, WNew_;
+  vector_array_t VNext_, primalResidual_;
 };
 
 }  // namespace ocs2
@@ -33,6 +33,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <iostream>
 #include <numeric>
 
+#include <ocs2_core/misc/LinearInterpolation.h>
+#include <ocs2_core/misc/Tracing.h>
 #include <ocs2_oc/multiple_shooting/Helpers.h>
 #include <ocs2_oc/multiple_shooting/Initialization.h>
 #include <ocs2_oc/multiple_shooting/MetricsComputation.h>
@@ -47,14 +49,16 @@ namespace ocs2 {
 
 SlpSolver::SlpSolver(slp::Settings settings, const OptimalControlProblem& optimalControlProblem, const Initializer& initializer)
     : settings_(std::move(settings)),
+      horizonStepSchedule_(createHorizonStepSchedule(settings_.dt, settings_.dtSwitchingTimes, settings_.dtSchedule,
+                                                     settings_.dtGrowthFactor, settings_.dtGrowthMax)),
       pipgSolver_(settings_.pipgSettings),
-      threadPool_(std::max(settings_.nThreads - 1, size_t(1)) - 1, settings_.threadPriority) {
+      threadPool_(std::max(settings_.nThreads - 1, size_t(1)) - 1, settings_.threadPriority, settings_.threadSpinCount) {
   Eigen::setNbThreads(1);  // No multithreading within Eigen.
   Eigen::initParallel();
 
   // Dynamics discretization
-  discretizer_ = selectDynamicsDiscretization(settings_.integratorType);
-  sensitivityDiscretizer_ = selectDynamicsSensitivityDiscretization(settings_.integratorType);
+  discretizer_ = selectDynamicsDiscretization(settings_.integratorType, settings_.integratorMaxStep);
+  sensitivityDiscretizer_ = selectDynamicsSensitivityDiscretization(settings_.integratorType, settings_.integratorMaxStep);
 
   // Clone objects to have one for each worker
   for (int w = 0; w < settings_.nThreads; w++) {
@@ -81,6 +85,12 @@ void SlpSolver::reset() {
   // Clear solution
   primalSolution_ = PrimalSolution();
   performanceIndeces_.clear();
+  warmStartTime_.clear();
+  warmStartDeltaX_.clear();
+  warmStartDeltaU_.clear();
+  preconditionD_.clear();
+  preconditionE_.clear();
+  preconditionC_ = 1.0;
 
   // reset timers
   numProblems_ = 0;
@@ -90,10 +100,15 @@ void SlpSolver::reset() {
   solveQpTimer_.reset();
   linesearchTimer_.reset();
   computeControllerTimer_.reset();
+  if (ocpDefinitions_.front().termProfilerPtr != nullptr) {
+    ocpDefinitions_.front().termProfilerPtr->reset();
+  }
   lambdaEstimation_.reset();
   sigmaEstimation_.reset();
   preConditioning_.reset();
   pipgSolverTimer_.reset();
+  totalNumPipgIterations_ = 0;
+  totalNumPreconditioningIterations_ = 0;
 }
 
 std::string SlpSolver::getBenchmarkingInformationPIPG() const {
@@ -112,23 +127,31 @@ std::string SlpSolver::getBenchmarkingInformationPIPG() const {
     infoStream << "PIPG Benchmarking\t       :\tAverage time [ms]   (% of total runtime)\n";
     infoStream << "\tpreConditioning        :\t" << std::setw(10) << preConditioning_.getAverageInMilliseconds() << " [ms] \t("
                << preConditioning / benchmarkTotal * inPercent << "%)\n";
+    infoStream << "\tpreConditioning iter.  :\t" << std::setw(10)
+               << static_cast<scalar_t>(totalNumPreconditioningIterations_) / static_cast<scalar_t>(preConditioning_.getNumTimedIntervals())
+               << "\n";
     infoStream << "\tlambdaEstimation       :\t" << std::setw(10) << lambdaEstimation_.getAverageInMilliseconds() << " [ms] \t("
                << lambdaEstimation / benchmarkTotal * inPercent << "%)\n";
     infoStream << "\tsigmaEstimation        :\t" << std::setw(10) << sigmaEstimation_.getAverageInMilliseconds() << " [ms] \t("
                << sigmaEstimation / benchmarkTotal * inPercent << "%)\n";
     infoStream << "\tPIPG runTime           :\t" << std::setw(10) << pipgSolverTimer_.getAverageInMilliseconds() << " [ms] \t("
                << pipgRuntime / benchmarkTotal * inPercent << "%)\n";
+    infoStream << "\tPIPG iterations        :\t" << std::setw(10)
+               << static_cast<scalar_t>(totalNumPipgIterations_) / static_cast<scalar_t>(pipgSolverTimer_.getNumTimedIntervals()) << "\n";
   }
   return infoStream.str();
 }
 
 std::string SlpSolver::getBenchmarkingInformation() const {
   const auto linearQuadraticApproximationTotal = linearQuadraticApproximationTimer_.getTotalInMilliseconds();
-  const auto solveQpTotal = solveQpTimer_.getTotalInMilliseconds();
+  // the pre-conditioning is part of solving the LP, but reported on its own
+  const auto preConditioningTotal = preConditioning_.getTotalInMilliseconds();
+  const auto solveQpTotal = solveQpTimer_.getTotalInMilliseconds() - preConditioningTotal;
   const auto linesearchTotal = linesearchTimer_.getTotalInMilliseconds();
   const auto computeControllerTotal = computeControllerTimer_.getTotalInMilliseconds();
 
-  const auto benchmarkTotal = linearQuadraticApproximationTotal + solveQpTotal + linesearchTotal + computeControllerTotal;
+  const auto benchmarkTotal =
+      linearQuadraticApproximationTotal + preConditioningTotal + solveQpTotal + linesearchTotal + computeControllerTotal;
 
   std::stringstream infoStream;
   if (benchmarkTotal > 0.0) {
@@ -138,12 +161,18 @@ std::string SlpSolver::getBenchmarkingInformation() const {
     infoStream << "SLP Benchmarking\t   :\tAverage time [ms]   (% of total runtime)\n";
     infoStream << "\tLQ Approximation   :\t" << std::setw(10) << linearQuadraticApproximationTimer_.getAverageInMilliseconds()
                << " [ms] \t(" << linearQuadraticApproximationTotal / benchmarkTotal * inPercent << "%)\n";
-    infoStream << "\tSolve LP           :\t" << std::setw(10) << solveQpTimer_.getAverageInMilliseconds() << " [ms] \t("
+    infoStream << "\tPreconditioning    :\t" << std::setw(10) << preConditioning_.getAverageInMilliseconds() << " [ms] \t("
+               << preConditioningTotal / benchmarkTotal * inPercent << "%)\n";
+    infoStream << "\tSolve LP           :\t" << std::setw(10)
+               << solveQpTotal / static_cast<scalar_t>(std::max(solveQpTimer_.getNumTimedIntervals(), 1)) << " [ms] \t("
                << solveQpTotal / benchmarkTotal * inPercent << "%)\n";
     infoStream << "\tLinesearch         :\t" << std::setw(10) << linesearchTimer_.getAverageInMilliseconds() << " [ms] \t("
                << linesearchTotal / benchmarkTotal * inPercent << "%)\n";
     infoStream << "\tCompute Controller :\t" << std::setw(10) << computeControllerTimer_.getAverageInMilliseconds() << " [ms] \t("
                << computeControllerTotal / benchmarkTotal * inPercent << "%)\n";
+    if (ocpDefinitions_.front().termProfilerPtr != nullptr) {
+      infoStream << ocpDefinitions_.front().termProfilerPtr->getReport();
+    }
   }
   return infoStream.str();
 }
@@ -157,6 +186,8 @@ const std::vector<PerformanceIndex>& SlpSolver::getIterationsLog() const {
 }
 
 void SlpSolver::runImpl(scalar_t initTime, const vector_t& initState, scalar_t finalTime) {
+  OCS2_TRACE_SCOPE("slp", "run");
+
   if (settings_.printSolverStatus || settings_.printLinesearch) {
     std::cerr << "\n++++++++++++++++++++++++++++++++++++++++++++++++++++++";
     std::cerr << "\n+++++++++++++ SLP solver is initialized ++++++++++++++";
@@ -165,7 +196,7 @@ void SlpSolver::runImpl(scalar_t initTime, const vector_t& initState, scalar_t f
 
   // Determine time discretization, taking into account event times.
   const auto& eventTimes = this->getReferenceManager().getModeSchedule().eventTimes;
-  const auto timeDiscretization = timeDiscretizationWithEvents(initTime, finalTime, settings_.dt, eventTimes);
+  const auto timeDiscretization = timeDiscretizationWithEvents(initTime, finalTime, horizonStepSchedule_, eventTimes);
 
   // Initialize references
   for (auto& ocpDefinition : ocpDefinitions_) {
@@ -189,6 +220,7 @@ void SlpSolver::runImpl(scalar_t initTime, const vector_t& initState, scalar_t f
   int iter = 0;
   slp::Convergence convergence = slp::Convergence::FALSE;
   while (convergence == slp::Convergence::FALSE) {
+    OCS2_TRACE_SCOPE_INDEX("slp", "iteration", iter);
     if (settings_.printSolverStatus || settings_.printLinesearch) {
       std::cerr << "\nPIPG iteration: " << iter << "\n";
     }
@@ -200,7 +232,7 @@ void SlpSolver::runImpl(scalar_t initTime, const vector_t& initState, scalar_t f
     // Solve LP
     solveQpTimer_.startTimer();
     const vector_t delta_x0 = initState - x[0];
-    const auto deltaSolution = getOCPSolution(delta_x0);
+    const auto deltaSolution = getOCPSolution(timeDiscretization, delta_x0);
     solveQpTimer_.endTimer();
 
     // Apply step
@@ -209,6 +241,17 @@ void SlpSolver::runImpl(scalar_t initTime, const vector_t& initState, scalar_t f
     performanceIndeces_.push_back(stepInfo.performanceAfterStep);
     linesearchTimer_.endTimer();
 
+    // The part of the step that was not taken is the primal warm start of the next QP
+    if (settings_.pipgSettings.warmStart) {
+      const scalar_t remainder = 1.0 - stepInfo.stepSize;
+      for (auto& dx : warmStartDeltaX_) {
+        dx *= remainder;
+      }
+      for (auto& du : warmStartDeltaU_) {
+        du *= remainder;
+      }
+    }
+
     // Check convergence
     convergence = checkConvergence(iter, baselinePerformance, stepInfo);
 
@@ -232,11 +275,13 @@ void SlpSolver::runImpl(scalar_t initTime, const vector_t& initState, scalar_t f
   }
 }
 
-void SlpSolver::runParallel(std::function<void(int)> taskFunction) {
-  threadPool_.runParallel(std::move(taskFunction), settings_.nThreads);
+void SlpSolver::parallelFor(int begin, int end, std::function<void(int, int)> taskFunction) {
+  threadPool_.parallelFor(begin, end, settings_.parallelForGrainSize, std::move(taskFunction));
 }
 
-SlpSolver::OcpSubproblemSolution SlpSolver::getOCPSolution(const vector_t& delta_x0) {
+SlpSolver::OcpSubproblemSolution SlpSolver::getOCPSolution(const std::vector<AnnotatedTime>& time, const vector_t& delta_x0) {
+  OCS2_TRACE_SCOPE("slp", "solveQp");
+
   // Solve the QP
   OcpSubproblemSolution solution;
   auto& deltaXSol = solution.deltaXSol;
@@ -245,13 +290,15 @@ SlpSolver::OcpSubproblemSolution SlpSolver::getOCPSolution(const vector_t& delta
   // without constraints, or when using projection, we have an unconstrained QP.
   pipgSolver_.resize(extractSizesFromProblem(dynamics_, cost_, nullptr));
 
-  // pre-condition the OCP
+  // pre-condition the OCP, starting from the scaling of the previous QP if enabled
   preConditioning_.startTimer();
-  scalar_t c;
-  vector_array_t D, E;
+  auto& D = preconditionD_;
+  auto& E = preconditionE_;
+  auto& c = preconditionC_;
   vector_array_t scalingVectors;
-  precondition::ocpDataInPlaceInParallel(threadPool_, delta_x0, pipgSolver_.size(), settings_.scalingIteration, dynamics_, cost_, D, E,
-                                         scalingVectors, c);
+  totalNumPreconditioningIterations_ += precondition::ocpDataInPlaceInParallel(
+      threadPool_, delta_x0, pipgSolver_.size(), settings_.scalingIteration, settings_.scalingTolerance, settings_.scalingWarmStart,
+      dynamics_, cost_, D, E, scalingVectors, c);
   preConditioning_.endTimer();
 
   // estimate mu and lambda: mu I < H < lambda I
@@ -278,28 +325,69 @@ SlpSolver::OcpSubproblemSolution SlpSolver::getOCPSolution(const vector_t& delta
   vector_array_t EInv(E.size());
   std::transform(E.begin(), E.end(), EInv.begin(), [](const vector_t& v) { return v.cwiseInverse(); });
   const pipg::PipgBounds pipgBounds{muEstimated, lambdaScaled, sigmaScaled};
+  if (settings_.pipgSettings.warmStart) {
+    setPipgWarmStart(time, D);
+  }
   const auto pipgStatus =
       pipgSolver_.solve(threadPool_, delta_x0, dynamics_, cost_, nullptr, scalingVectors, &EInv, pipgBounds, deltaXSol, deltaUSol);
   pipgSolverTimer_.endTimer();
+  totalNumPipgIterations_ += pipgSolver_.getNumIterations();
 
   // to determine if the solution is a descent direction for the cost: compute gradient(cost)' * [dx; du]
   solution.armijoDescentMetric = armijoDescentMetric(cost_, deltaXSol, deltaUSol);
 
   precondition::descaleSolution(D, deltaXSol, deltaUSol);
 
+  if (settings_.pipgSettings.warmStart) {
+    // store the unscaled solution for the warm start of the next QP
+    warmStartTime_ = toTime(time);
+    warmStartDeltaX_ = deltaXSol;
+    warmStartDeltaU_ = deltaUSol;
+  }
+
   // remap the tilde delta u to real delta u
   multiple_shooting::remapProjectedInput(constraintsProjection_, deltaXSol, deltaUSol);
 
   return solution;
 }
 
+void SlpSolver::setPipgWarmStart(const std::vector<AnnotatedTime>& time, const vector_array_t& D) {
+  // Interpolates the stored trajectory and divides it by the scaling. Returns an empty vector, i.e. a cold start of the element, if the
+  // sizes do not match.
+  auto interpolateScaled = [&](scalar_t t, const scalar_array_t& timeTrajectory, const vector_array_t& trajectory,
+                               const vector_t& scaling) -> vector_t {
+    if (trajectory.empty()) {
+      return vector_t();
+    }
+    const vector_t value = LinearInterpolation::interpolate(t, timeTrajectory, trajectory);
+    return (value.size() == scaling.size()) ? vector_t(value.cwiseQuotient(scaling)) : vector_t();
+  };
+
+  // the inputs are defined on the intervals, i.e. at all but the last node
+  scalar_array_t intervalStartTime = warmStartTime_;
+  if (!intervalStartTime.empty()) {
+    intervalStartTime.pop_back();
+  }
+
+  const int N = static_cast<int>(time.size()) - 1;
+  vector_array_t xTrajectory(N + 1), uTrajectory(N);
+  for (int i = 0; i < N; i++) {
+    uTrajectory[i] = interpolateScaled(time[i].time, intervalStartTime, warmStartDeltaU_, D[2 * i]);
+    xTrajectory[i + 1] = interpolateScaled(time[i + 1].time, warmStartTime_, warmStartDeltaX_, D[2 * i + 1]);
+  }
+  pipgSolver_.setWarmStart(std::move(xTrajectory), std::move(uTrajectory), vector_array_t(N));
+}
+
 PrimalSolution SlpSolver::toPrimalSolution(const std::vector<AnnotatedTime>& time, vector_array_t&& x, vector_array_t&& u) {
+  OCS2_TRACE_SCOPE("slp", "computeController");
   ModeSchedule modeSchedule = this->getReferenceManager().getModeSchedule();
   return multiple_shooting::toPrimalSolution(time, std::move(modeSchedule), std::move(x), std::move(u));
 }
 
 PerformanceIndex SlpSolver::setupQuadraticSubproblem(const std::vector<AnnotatedTime>& time, const vector_t& initState,
                                                      const vector_array_t& x, const vector_array_t& u, std::vector<Metrics>& metrics) {
+  OCS2_TRACE_SCOPE("slp", "lqApproximation");
+
   // Problem horizon
   const int N = static_cast<int>(time.size()) - 1;
 
@@ -313,14 +401,14 @@ PerformanceIndex SlpSolver::setupQuadraticSubproblem(const std::vector<Annotated
   projectionMultiplierCoefficients_.resize(N);
   metrics.resize(N + 1);
 
-  std::atomic_int timeIndex{0};
-  auto parallelTask = [&](int workerId) {
+  auto parallelTask = [&](int workerId, int i) {
+    OCS2_TRACE_SCOPE_INDEX("slp", "node", i);
+
     // Get worker specific resources
     OptimalControlProblem& ocpDefinition = ocpDefinitions_[workerId];
-    PerformanceIndex workerPerformance;  // Accumulate performance in local variable
+    PerformanceIndex& workerPerformance = performance[workerId];  // A worker ID is never used concurrently
 
-    int i = timeIndex++;
-    while (i < N) {
+    if (i < N) {
       if (time[i].event == AnnotatedTime::Event::PreEvent) {
         // Event node
         auto result = multiple_shooting::setupEventNode(ocpDefinition, time[i].time, x[i], x[i + 1]);
@@ -349,11 +437,7 @@ PerformanceIndex SlpSolver::setupQuadraticSubproblem(const std::vector<Annotated
         constraintsProjection_[i] = std::move(result.constraintsProjection);
         projectionMultiplierCoefficients_[i] = std::move(result.projectionMultiplierCoefficients);
       }
-
-      i = timeIndex++;
-    }
-
-    if (i == N) {  // Only one worker will execute this
+    } else {  // Terminal node
       const scalar_t tN = getIntervalStart(time[N]);
       auto result = multiple_shooting::setupTerminalNode(ocpDefinition, tN, x[N]);
       metrics[i] = multiple_shooting::computeMetrics(result);
@@ -361,11 +445,8 @@ PerformanceIndex SlpSolver::setupQuadraticSubproblem(const std::vector<Annotated
       cost_[i] = std::move(result.cost);
       stateIneqConstraints_[i] = std::move(result.ineqConstraints);
     }
-
-    // Accumulate! Same worker might run multiple tasks
-    performance[workerId] += workerPerformance;
   };
-  runParallel(std::move(parallelTask));
+  parallelFor(0, N + 1, std::move(parallelTask));
 
   // Account for init state in performance
   performance.front().dynamicsViolationSSE += (initState - x.front()).squaredNorm();
@@ -384,13 +465,11 @@ PerformanceIndex SlpSolver::computePerformance(const std::vector<AnnotatedTime>&
   metrics.resize(N + 1);
 
   std::vector<PerformanceIndex> performance(settings_.nThreads, PerformanceIndex());
-  std::atomic_int timeIndex{0};
-  auto parallelTask = [&](int workerId) {
+  auto parallelTask = [&](int workerId, int i) {
     // Get worker specific resources
     OptimalControlProblem& ocpDefinition = ocpDefinitions_[workerId];
 
-    int i = timeIndex++;
-    while (i < N) {
+    if (i < N) {
       if (time[i].event == AnnotatedTime::Event::PreEvent) {
         // Event node
         metrics[i] = multiple_shooting::computeEventMetrics(ocpDefinition, time[i].time, x[i], x[i + 1]);
@@ -402,17 +481,13 @@ PerformanceIndex SlpSolver::computePerformance(const std::vector<AnnotatedTime>&
         metrics[i] = multiple_shooting::computeIntermediateMetrics(ocpDefinition, discretizer_, ti, dt, x[i], x[i + 1], u[i]);
         performance[workerId] += toPerformanceIndex(metrics[i], dt);
       }
-
-      i = timeIndex++;
-    }
-
-    if (i == N) {  // Only one worker will execute this
+    } else {  // Terminal node
       const scalar_t tN = getIntervalStart(time[N]);
       metrics[N] = multiple_shooting::computeTerminalMetrics(ocpDefinition, tN, x[N]);
       performance[workerId] += toPerformanceIndex(metrics[N]);
     }
   };
-  runParallel(std::move(parallelTask));
+  parallelFor(0, N + 1, std::move(parallelTask));
 
   // Account for initial state in performance
   const vector_t initDynamicsViolation = initState - x.front();
@@ -428,6 +503,7 @@ PerformanceIndex SlpSolver::computePerformance(const std::vector<AnnotatedTime>&
 slp::StepInfo SlpSolver::takeStep(const PerformanceIndex& baseline, const std::vector<AnnotatedTime>& timeDiscretization,
                                   const vector_t& initState, const OcpSubproblemSolution& subproblemSolution, vector_array_t& x,
                                   vector_array_t& u, std::vector<Metrics>& metrics) {
+  OCS2_TRACE_SCOPE("slp", "linesearch");
   using StepType = FilterLinesearch::StepType;
 
   /*
@@ -55,7 +55,11 @@ Settings loadSettings(const std::string& filename, const std::string& fieldName,
 
   loadData::loadPtreeValue(pt, settings.lowerBoundH, fieldName + ".lowerBoundH", verbose);
 
+  loadData::loadPtreeValue(pt, settings.warmStart, fieldName + ".warmStart", verbose);
+  loadData::loadPtreeValue(pt, settings.warmStartIterationRatio, fieldName + ".warmStartIterationRatio", verbose);
+
   loadData::loadPtreeValue(pt, settings.checkTerminationInterval, fieldName + ".checkTerminationInterval", verbose);
+  loadData::loadPtreeValue(pt, settings.barrierSpinCount, fieldName + ".barrierSpinCount", verbose);
   loadData::loadPtreeValue(pt, settings.displayShortSummary, fieldName + ".displayShortSummary", verbose);
 
   if (verbose) {
@@ -29,11 +29,11 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "ocs2_slp/pipg/PipgSolver.h"
 
-#include <condition_variable>
 #include <iostream>
-#include <mutex>
 #include <numeric>
 
+#include <ocs2_core/thread_support/SpinBarrier.h>
+
 namespace ocs2 {
 
 /******************************************************************************************************/
@@ -63,7 +63,9 @@ pipg::SolverStatus PipgSolver::solve(ThreadPool& threadPool, const vector_t& x0,
   // Disable Eigen's internal multithreading
   Eigen::setNbThreads(1);
 
-  vector_array_t primalResidualArray(N);
+  benchmark::RepeatedTimer solveTimer;
+  solveTimer.startTimer();
+
   scalar_array_t constraintsViolationInfNormArray(N);
   scalar_t constraintsViolationInfNorm;
 
@@ -74,164 +76,161 @@ pipg::SolverStatus PipgSolver::solve(ThreadPool& threadPool, const vector_t& x0,
   // initial state
   X_[0] = x0;
   XNew_[0] = x0;
-  // cold start
+  // warm start from the current iterates where their sizes are consistent, otherwise cold start
+  const bool warmStart = settings().warmStart;
   for (int t = 0; t < N; t++) {
-    X_[t + 1].setZero(dynamics[t].dfdx.rows());
-    U_[t].setZero(dynamics[t].dfdu.cols());
-    W_[t].setZero(dynamics[t].dfdx.rows());
+    const auto nx = dynamics[t].dfdx.rows();
+    const auto nu = dynamics[t].dfdu.cols();
+    if (!warmStart || X_[t + 1].size() != nx) {
+      X_[t + 1].setZero(nx);
+    }
+    if (!warmStart || U_[t].size() != nu) {
+      U_[t].setZero(nu);
+    }
+    if (!warmStart || W_[t].size() != nx) {
+      W_[t].setZero(nx);
+    }
     // WNew_ will NOT be filled, but will be swapped to W_ in iteration 0. Thus, initialize WNew_ here.
-    WNew_[t].setZero(dynamics[t].dfdx.rows());
+    WNew_[t] = W_[t];
   }
 
-  scalar_t alpha = pipgBounds.primalStepSize(0);
-  scalar_t beta = pipgBounds.primalStepSize(0);
+  // a warm started solve skips the beginning of the step size schedule, the more so the longer the previous solve took
+  const size_t k0 = warmStart ? static_cast<size_t>(settings().warmStartIterationRatio * numIterations_) : 0;
+  scalar_t alpha = pipgBounds.primalStepSize(k0);
+  scalar_t beta = pipgBounds.primalStepSize(k0);
   scalar_t betaLast = 0;
 
   size_t k = 0;
-  std::atomic_int timeIndex{1}, finishedTaskCounter{0};
-  std::atomic_bool keepRunning{true}, shouldWait{true};
+  std::atomic_int timeIndex{1};
+  bool keepRunning = true;
   bool isConverged = false;
 
-  std::mutex mux;
-  std::condition_variable iterationFinished;
-  std::vector<int> threadsWorkloadCounter(threadPool.numThreads() + 1U, 0);
+  const size_t numWorkers = threadPool.numThreads() + 1U;
+  SpinBarrier iterationBarrier(numWorkers, settings().barrierSpinCount);
+  std::vector<int> threadsWorkloadCounter(numWorkers, 0);
+
+  // PIPG algorithm for stage t in [1, N]. The dual update of the previous iteration and the primal update share the primal residual.
+  auto updateStage = [&](int t) {
+    const auto& A = dynamics[t - 1].dfdx;
+    const auto& B = dynamics[t - 1].dfdu;
+    const auto& C = scalingVectors[t - 1];
+    const auto& b = dynamics[t - 1].f;
+
+    const auto& R = cost[t - 1].dfduu;
+    const auto& Q = cost[t].dfdxx;
+    const auto& P = cost[t - 1].dfdux;
+    const auto& q = cost[t].dfdx;
+    const auto& r = cost[t - 1].dfdu;
+
+    // primalResidual = C * X_[t] - A * X_[t - 1] - B * U_[t - 1] - b
+    auto& primalResidual = primalResidual_[t - 1];
+    primalResidual = -b;
+    primalResidual.array() += C.array() * X_[t].array();
+    primalResidual.noalias() -= A * X_[t - 1];
+    primalResidual.noalias() -= B * U_[t - 1];
+
+    if (k != 0) {
+      // Update W of the iteration k - 1. Move the update of W to the front of the calculation of V to prevent data race.
+      if (EInv != nullptr) {
+        constraintsViolationInfNormArray[t - 1] = (*EInv)[t - 1].cwiseProduct(primalResidual).lpNorm<Eigen::Infinity>();
+      } else {
+        constraintsViolationInfNormArray[t - 1] = primalResidual.lpNorm<Eigen::Infinity>();
+      }
 
-  auto updateVariablesTask = [&](int workerId) {
-    int t;
-    int workerOrder;
+      WNew_[t - 1] = W_[t - 1] + betaLast * primalResidual;
+
+      // What stored in UNew and XNew is the solution of iteration k - 2 and what stored in U and X is the solution of iteration k
+      // - 1. By convention, iteration starts from 0 and the solution of iteration -1 is the initial value. Reuse UNew and XNew
+      // memory to store the difference between the last solution and the one before last solution.
+      UNew_[t - 1] -= U_[t - 1];
+      XNew_[t] -= X_[t];
+
+      solutionSEArray[t - 1] = UNew_[t - 1].squaredNorm() + XNew_[t].squaredNorm();
+      solutionSquaredNormArray[t - 1] = U_[t - 1].squaredNorm() + X_[t].squaredNorm();
+    }
+
+    // V_[t - 1] = W_[t - 1] + (beta + betaLast) * primalResidual
+    V_[t - 1] = W_[t - 1] + (beta + betaLast) * primalResidual;
+
+    // UNew_[t - 1] = U_[t - 1] - alpha * (R * U_[t - 1] + P * X_[t - 1] + r - B.transpose() * V_[t - 1]);
+    UNew_[t - 1] = U_[t - 1] - alpha * r;
+    UNew_[t - 1].noalias() -= alpha * (R * U_[t - 1]);
+    UNew_[t - 1].noalias() -= alpha * (P * X_[t - 1]);
+    UNew_[t - 1].noalias() += alpha * (B.transpose() * V_[t - 1]);
+
+    // XNew_[t] = X_[t] - alpha * (Q * X_[t] + q + C * V_[t - 1]);
+    XNew_[t] = X_[t] - alpha * q;
+    XNew_[t].array() -= alpha * C.array() * V_[t - 1].array();
+    XNew_[t].noalias() -= alpha * (Q * X_[t]);
+
+    if (t != N) {
+      const auto& ANext = dynamics[t].dfdx;
+      const auto& BNext = dynamics[t].dfdu;
+      const auto& CNext = scalingVectors[t];
+      const auto& bNext = dynamics[t].f;
+
+      // dfdux
+      const auto& PNext = cost[t].dfdux;
+
+      // VNext = W_[t] + (beta + betaLast) * (CNext * X_[t + 1] - ANext * X_[t] - BNext * U_[t] - bNext);
+      auto& VNext = VNext_[t];
+      VNext = W_[t] - (beta + betaLast) * bNext;
+      VNext.array() += (beta + betaLast) * CNext.array() * X_[t + 1].array();
+      VNext.noalias() -= (beta + betaLast) * (ANext * X_[t]);
+      VNext.noalias() -= (beta + betaLast) * (BNext * U_[t]);
+
+      XNew_[t].noalias() += alpha * (ANext.transpose() * VNext);
+      // Add dfdxu * du if it is not the final state.
+      XNew_[t].noalias() -= alpha * (PNext.transpose() * U_[t]);
+    }
+  };
+
+  // Serial part between two iterations, executed by the last worker that arrives at the barrier while the others wait.
+  auto finishIteration = [&]() {
+    betaLast = beta;
+    // Adaptive step size
+    beta = pipgBounds.dualStepSize(k0 + k);
+    alpha = pipgBounds.primalStepSize(k0 + k);
+
+    if (k != 0 && k % settings().checkTerminationInterval == 0) {
+      constraintsViolationInfNorm = *(std::max_element(constraintsViolationInfNormArray.begin(), constraintsViolationInfNormArray.end()));
+
+      solutionSSE = std::accumulate(solutionSEArray.begin(), solutionSEArray.end(), 0.0);
+      solutionSquaredNorm = std::accumulate(solutionSquaredNormArray.begin(), solutionSquaredNormArray.end(), 0.0);
+
+      isConverged = constraintsViolationInfNorm <= settings().absoluteTolerance &&
+                    (solutionSSE <= settings().relativeTolerance * settings().relativeTolerance * solutionSquaredNorm ||
+                     solutionSSE <= settings().absoluteTolerance);
 
+      keepRunning = k < settings().maxNumIterations && !isConverged;
+    }
+
+    XNew_.swap(X_);
+    UNew_.swap(U_);
+    WNew_.swap(W_);
+
+    ++k;
+    timeIndex = 1;
+  };
+
+  auto updateVariablesTask = [&](int workerId) {
+    bool localSense = false;
     while (keepRunning) {
-      // Reset workerOrder in case all tasks have been assigned and some workers cannot enter the following while loop, keeping the
-      // workerOrder from previous iterations.
-      workerOrder = 0;
+      int t;
       while ((t = timeIndex++) <= N) {
-        if (t == N) {
-          std::lock_guard<std::mutex> lk(mux);
-          shouldWait = true;
-        }
         // Multi-thread performance analysis
         ++threadsWorkloadCounter[workerId];
-
-        // PIPG algorithm
-        const auto& A = dynamics[t - 1].dfdx;
-        const auto& B = dynamics[t - 1].dfdu;
-        const auto& C = scalingVectors[t - 1];
-        const auto& b = dynamics[t - 1].f;
-
-        const auto& R = cost[t - 1].dfduu;
-        const auto& Q = cost[t].dfdxx;
-        const auto& P = cost[t - 1].dfdux;
-        const auto& q = cost[t].dfdx;
-        const auto& r = cost[t - 1].dfdu;
-
-        if (k != 0) {
-          // Update W of the iteration k - 1. Move the update of W to the front of the calculation of V to prevent data race.
-          // vector_t primalResidual = C * X_[t] - A * X_[t - 1] - B * U_[t - 1] - b;
-          primalResidualArray[t - 1] = -b;
-          primalResidualArray[t - 1].array() += C.array() * X_[t].array();
-          primalResidualArray[t - 1].noalias() -= A * X_[t - 1];
-          primalResidualArray[t - 1].noalias() -= B * U_[t - 1];
-          if (EInv != nullptr) {
-            constraintsViolationInfNormArray[t - 1] = (*EInv)[t - 1].cwiseProduct(primalResidualArray[t - 1]).lpNorm<Eigen::Infinity>();
-          } else {
-            constraintsViolationInfNormArray[t - 1] = primalResidualArray[t - 1].lpNorm<Eigen::Infinity>();
-          }
-
-          WNew_[t - 1] = W_[t - 1] + betaLast * primalResidualArray[t - 1];
-
-          // What stored in UNew and XNew is the solution of iteration k - 2 and what stored in U and X is the solution of iteration k
-          // - 1. By convention, iteration starts from 0 and the solution of iteration -1 is the initial value. Reuse UNew and XNew
-          // memory to store the difference between the last solution and the one before last solution.
-          UNew_[t - 1] -= U_[t - 1];
-          XNew_[t] -= X_[t];
-
-          solutionSEArray[t - 1] = UNew_[t - 1].squaredNorm() + XNew_[t].squaredNorm();
-          solutionSquaredNormArray[t - 1] = U_[t - 1].squaredNorm() + X_[t].squaredNorm();
-        }
-
-        // V_[t - 1] = W_[t - 1] + (beta + betaLast) * (C * X_[t] - A * X_[t - 1] - B * U_[t - 1] - b);
-        V_[t - 1] = W_[t - 1] - (beta + betaLast) * b;
-        V_[t - 1].array() += (beta + betaLast) * C.array() * X_[t].array();
-        V_[t - 1].noalias() -= (beta + betaLast) * (A * X_[t - 1]);
-        V_[t - 1].noalias() -= (beta + betaLast) * (B * U_[t - 1]);
-
-        // UNew_[t - 1] = U_[t - 1] - alpha * (R * U_[t - 1] + P * X_[t - 1] + r - B.transpose() * V_[t - 1]);
-        UNew_[t - 1] = U_[t - 1] - alpha * r;
-        UNew_[t - 1].noalias() -= alpha * (R * U_[t - 1]);
-        UNew_[t - 1].noalias() -= alpha * (P * X_[t - 1]);
-        UNew_[t - 1].noalias() += alpha * (B.transpose() * V_[t - 1]);
-
-        // XNew_[t] = X_[t] - alpha * (Q * X_[t] + q + C * V_[t - 1]);
-        XNew_[t] = X_[t] - alpha * q;
-        XNew_[t].array() -= alpha * C.array() * V_[t - 1].array();
-        XNew_[t].noalias() -= alpha * (Q * X_[t]);
-
-        if (t != N) {
-          const auto& ANext = dynamics[t].dfdx;
-          const auto& BNext = dynamics[t].dfdu;
-          const auto& CNext = scalingVectors[t];
-          const auto& bNext = dynamics[t].f;
-
-          // dfdux
-          const auto& PNext = cost[t].dfdux;
-
-          // vector_t VNext = W_[t] + (beta + betaLast) * (CNext * X_[t + 1] - ANext * X_[t] - BNext * U_[t] - bNext);
-          vector_t VNext = W_[t] - (beta + betaLast) * bNext;
-          VNext.array() += (beta + betaLast) * CNext.array() * X_[t + 1].array();
-          VNext.noalias() -= (beta + betaLast) * (ANext * X_[t]);
-          VNext.noalias() -= (beta + betaLast) * (BNext * U_[t]);
-
-          XNew_[t].noalias() += alpha * (ANext.transpose() * VNext);
-          // Add dfdxu * du if it is not the final state.
-          XNew_[t].noalias() -= alpha * (PNext.transpose() * U_[t]);
-        }
-
-        workerOrder = ++finishedTaskCounter;
-      }
-
-      if (workerOrder != N) {
-        std::unique_lock<std::mutex> lk(mux);
-        iterationFinished.wait(lk, [&shouldWait] { return !shouldWait; });
-        lk.unlock();
-      } else {
-        betaLast = beta;
-        // Adaptive step size
-        beta = pipgBounds.dualStepSize(k);
-        alpha = pipgBounds.primalStepSize(k);
-
-        if (k != 0 && k % settings().checkTerminationInterval == 0) {
-          constraintsViolationInfNorm =
-              *(std::max_element(constraintsViolationInfNormArray.begin(), constraintsViolationInfNormArray.end()));
-
-          solutionSSE = std::accumulate(solutionSEArray.begin(), solutionSEArray.end(), 0.0);
-          solutionSquaredNorm = std::accumulate(solutionSquaredNormArray.begin(), solutionSquaredNormArray.end(), 0.0);
-
-          isConverged = constraintsViolationInfNorm <= settings().absoluteTolerance &&
-                        (solutionSSE <= settings().relativeTolerance * settings().relativeTolerance * solutionSquaredNorm ||
-                         solutionSSE <= settings().absoluteTolerance);
-
-          keepRunning = k < settings().maxNumIterations && !isConverged;
-        }
-
-        XNew_.swap(X_);
-        UNew_.swap(U_);
-        WNew_.swap(W_);
-
-        ++k;
-        finishedTaskCounter = 0;
-        timeIndex = 1;
-        {
-          std::lock_guard<std::mutex> lk(mux);
-          shouldWait = false;
-        }
-        iterationFinished.notify_all();
+        updateStage(t);
       }
+      iterationBarrier.arriveAndWait(localSense, finishIteration);
     }
   };
-  threadPool.runParallel(std::move(updateVariablesTask), threadPool.numThreads() + 1U);
+  threadPool.runParallel(std::move(updateVariablesTask), numWorkers);
 
+  numIterations_ = k;
   xTrajectory = X_;
   uTrajectory = U_;
+  solveTimer.endTimer();
   const auto status = isConverged ? pipg::SolverStatus::SUCCESS : pipg::SolverStatus::MAX_ITER;
 
   if (settings().displayShortSummary) {
@@ -241,6 +240,10 @@ pipg::SolverStatus PipgSolver::solve(ThreadPool& threadPool, const vector_t& x0,
     std::cerr << "\n+++++++++++++++++++++++++++++++++++++++++++++\n";
     std::cerr << "Solver status: " << pipg::toString(status) << "\n";
     std::cerr << "Number of Iterations: " << k << " out of " << settings().maxNumIterations << "\n";
+    std::cerr << "Iterations per second: " << static_cast<scalar_t>(k) / (1e-3 * solveTimer.getTotalInMilliseconds()) << "\n";
+    if (warmStart) {
+      std::cerr << "Warm start: step size schedule started at iteration " << k0 << "\n";
+    }
     std::cerr << "Norm of delta primal solution: " << std::sqrt(solutionSSE) << "\n";
     std::cerr << "Constraints violation : " << constraintsViolationInfNorm << "\n";
     std::cerr << "Thread workload(ID: # of finished tasks): ";
@@ -278,6 +281,21 @@ void PipgSolver::resize(const OcpSize& ocpSize) {
   XNew_.resize(N + 1);
   UNew_.resize(N);
   WNew_.resize(N);
+  VNext_.resize(N);
+  primalResidual_.resize(N);
+}
+
+/******************************************************************************************************/
+/******************************************************************************************************/
+/******************************************************************************************************/
+void PipgSolver::setWarmStart(vector_array_t xTrajectory, vector_array_t uTrajectory, vector_array_t wTrajectory) {
+  const int N = ocpSize_.numStages;
+  if (xTrajectory.size() != N + 1 || uTrajectory.size() != N || wTrajectory.size() != N) {
+    throw std::runtime_error("[PipgSolver::setWarmStart] The size of the warm start trajectories doesn't match the number of stages.");
+  }
+  X_.swap(xTrajectory);
+  U_.swap(uTrajectory);
+  W_.swap(wTrajectory);
 }
 
 /******************************************************************************************************/
@@ -183,4 +183,43 @@ TEST_F(PIPGSolverTest, correctness) {
   ASSERT_TRUE(std::abs(PIPGConstraintViolation) < solver.settings().absoluteTolerance);
   EXPECT_TRUE(std::abs(QPConstraintViolation - PIPGConstraintViolation) < solver.settings().absoluteTolerance * 10.0);
   EXPECT_TRUE(std::abs(PIPGParallelCConstraintViolation - PIPGConstraintViolation) < solver.settings().absoluteTolerance * 10.0);
-}
\ No newline at end of file
+}
+TEST_F(PIPGSolverTest, warmStart) {
+  Eigen::JacobiSVD<ocs2::matrix_t> svd(costApproximation.dfdxx);
+  ocs2::vector_t s = svd.singularValues();
+  const ocs2::scalar_t lambda = s(0);
+  const ocs2::scalar_t mu = s(svd.rank() - 1);
+  Eigen::JacobiSVD<ocs2::matrix_t> svdGTG(constraintsApproximation.dfdx.transpose() * constraintsApproximation.dfdx);
+  const ocs2::scalar_t sigma = svdGTG.singularValues()(0);
+  const ocs2::pipg::PipgBounds pipgBounds{mu, lambda, sigma};
+  const ocs2::vector_array_t scalingVectors(N_, ocs2::vector_t::Ones(nx_));
+
+  auto warmStartSettings = solver.settings();
+  warmStartSettings.warmStart = true;
+  ocs2::PipgSolver warmStartSolver(warmStartSettings);
+  warmStartSolver.resize(solver.size());
+
+  // solve the nominal problem, which is a cold start for both solvers
+  ocs2::vector_array_t X, U;
+  std::ignore = warmStartSolver.solve(threadPool, x0, dynamicsArray, costArray, nullptr, scalingVectors, nullptr, pipgBounds, X, U);
+
+  // perturb the problem slightly, as between two consecutive MPC cycles
+  auto perturbedCostArray = costArray;
+  for (auto& cost : perturbedCostArray) {
+    cost.dfdx += 1e-3 * ocs2::vector_t::Random(cost.dfdx.size());
+  }
+
+  ocs2::vector_array_t XCold, UCold;
+  std::ignore = solver.solve(threadPool, x0, dynamicsArray, perturbedCostArray, nullptr, scalingVectors, nullptr, pipgBounds, XCold, UCold);
+  ocs2::vector_array_t XWarm, UWarm;
+  std::ignore =
+      warmStartSolver.solve(threadPool, x0, dynamicsArray, perturbedCostArray, nullptr, scalingVectors, nullptr, pipgBounds, XWarm, UWarm);
+
+  ocs2::vector_t primalSolutionCold, primalSolutionWarm;
+  ocs2::toKktSolution(XCold, UCold, primalSolutionCold);
+  ocs2::toKktSolution(XWarm, UWarm, primalSolutionWarm);
+
+  EXPECT_LT(warmStartSolver.getNumIterations(), solver.getNumIterations());
+  EXPECT_TRUE(primalSolutionWarm.isApprox(primalSolutionCold, solver.settings().absoluteTolerance * 10.0))
+      << "Inf-norm of (cold - warm): " << (primalSolutionCold - primalSolutionWarm).cwiseAbs().maxCoeff();
+}
@@ -121,3 +121,40 @@ TEST(testSlpSolver, test_unconstrained) {
   ASSERT_LE(result.second.size(), 2);
   ASSERT_LT(result.second.back().dynamicsViolationSSE, tol);
 }
+
+TEST(testSlpSolver, test_warmStartShiftedHorizon) {
+  int n = 3;
+  int m = 2;
+  const double tol = 1e-9;
+
+  ocs2::OptimalControlProblem problem;
+  problem.dynamicsPtr = ocs2::getOcs2Dynamics(ocs2::getRandomDynamics(n, m));
+  const auto costs = ocs2::getRandomCost(n, m);
+  problem.costPtr->add("intermediateCost", ocs2::getOcs2Cost(costs));
+  problem.finalCostPtr->add("finalCost", ocs2::getOcs2StateCost(costs));
+
+  ocs2::TargetTrajectories targetTrajectories({0.0}, {ocs2::vector_t::Ones(n)}, {ocs2::vector_t::Ones(m)});
+  std::shared_ptr<ocs2::ReferenceManager> referenceManagerPtr(new ocs2::ReferenceManager(targetTrajectories));
+  problem.targetTrajectoriesPtr = &referenceManagerPtr->getTargetTrajectories();
+
+  ocs2::DefaultInitializer zeroInitializer(m);
+
+  ocs2::slp::Settings settings;
+  settings.dt = 0.05;
+  settings.slpIteration = 3;
+  settings.printSolverStatistics = false;
+  settings.nThreads = 2;
+  settings.pipgSettings.maxNumIterations = 30000;
+  settings.pipgSettings.absoluteTolerance = tol;
+  settings.pipgSettings.relativeTolerance = 1e-2;
+  settings.pipgSettings.lowerBoundH = 1e-3;
+  settings.pipgSettings.warmStart = true;
+
+  ocs2::SlpSolver solver(settings, problem, zeroInitializer);
+  solver.setReferenceManager(referenceManagerPtr);
+
+  // the second solve starts from the solution of the first one, shifted onto a new time discretization
+  solver.run(0.0, ocs2::vector_t::Ones(n), 1.0);
+  solver.run(0.02, ocs2::vector_t::Ones(n), 1.02);
+  ASSERT_LT(solver.getIterationsLog().back().dynamicsViolationSSE, tol);
+}
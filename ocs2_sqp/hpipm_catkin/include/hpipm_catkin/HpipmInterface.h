@@ -45,11 +45,21 @@ namespace ocs2 {
 /**
  * This class implements the interface between Linear Quadratic optimal control problems defined in OCS2 and the HPIPM solver.
  * If the problem dimensions change, resize needs to be called to re-initialize HPIPM.
+ *
+ * The memory used by HPIPM is kept across calls and only grows. Resizing to a problem that fits in the current capacity re-initializes
+ * HPIPM without any allocation. Call reserve() upfront with the largest expected size to avoid allocations on the real-time path.
  */
 class HpipmInterface {
  public:
   using Settings = hpipm_interface::Settings;
 
+  /** Statistics on the memory management of the interface */
+  struct MemoryStatistics {
+    size_t numResizes = 0;        // Number of times HPIPM was re-initialized for a new problem size
+    size_t numReallocations = 0;  // Number of times the persistent memory had to grow
+    size_t allocatedBytes = 0;    // Total size of the persistent memory
+  };
+
   /**
    * Construct the Hpipm interface with given size and settings.
    * Can directly call solve() for a problem with consistent size.
@@ -62,6 +72,28 @@ class HpipmInterface {
   /** Resize the problem */
   void resize(OcpSize ocpSize);
 
+  /** Reserves memory for problems up to the given size, without changing the size of the current problem. */
+  void reserve(OcpSize ocpSize);
+
+  /**
+   * Sets the primal initial guess for the next call to solve(). Only used if Settings::warm_start > 0.
+   * Nodes for which the size of the guess does not match the current problem size are initialized with zero. Needs to be called after
+   * resize(), since resizing to a new problem size discards the previous guess.
+   *
+   * Without an explicit guess, the next solve is warm started from the primal and dual solution of the previous solve, as long as the
+   * problem size did not change in between.
+   *
+   * @param stateTrajectory : Initial guess for the state (deviation) trajectory. The initial state is not used.
+   * @param inputTrajectory : Initial guess for the input (deviation) trajectory.
+   */
+  void setWarmStart(const vector_array_t& stateTrajectory, const vector_array_t& inputTrajectory);
+
+  /** Returns statistics on the (re)allocation of the persistent memory */
+  const MemoryStatistics& getMemoryStatistics() const;
+
+  /** Returns the number of interior point iterations of the last call to solve() */
+  int getNumIterations() const;
+
   /**
    * Solves a discrete linear quadratic optimal control problem. The interface needs to be resized to a consistent OcpSize before calling
    * this function
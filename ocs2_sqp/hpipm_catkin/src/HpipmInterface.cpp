@@ -29,6 +29,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "hpipm_catkin/HpipmInterface.h"
 
+#include <algorithm>
+
 #include <ocs2_core/misc/LinearAlgebra.h>
 
 extern "C" {
@@ -53,22 +55,29 @@ class MemoryBlock {
    * Ensure a block of memory of at least the requested size.
    * Does nothing if the requested size is smaller than equal to the current size.
    * @param size : minimum size of the memory block.
+   * @return true if the block had to be reallocated, in which case the previous content is lost.
    */
-  void reserve(size_t size) {
+  bool reserve(size_t size) {
     if (size > size_) {
       free(ptr_);
       ptr_ = malloc(size);
       if (ptr_ == nullptr) {
+        size_ = 0;
         throw std::bad_alloc();
       } else {
         size_ = size;
+        return true;
       }
     }
+    return false;
   }
 
   /** Get pointer to the memory, might be nullptr */
   void* get() { return ptr_; };
 
+  /** Get the size of the memory block */
+  size_t size() const { return size_; }
+
   // Prevents copies
   MemoryBlock(const MemoryBlock&) = delete;
   MemoryBlock& operator=(const MemoryBlock&) = delete;
@@ -100,47 +109,134 @@ class HpipmInterface::Impl {
     }
 
     ocpSize_ = std::move(ocpSize);
+    ++memoryStatistics_.numResizes;
 
+    // The HPIPM structures are (re)created inside the persistent memory blocks. The blocks only grow, such that alternating between
+    // problem sizes, e.g. due to a changing number of events in the horizon, only allocates until the largest size has been seen.
     const int dim_size = d_ocp_qp_dim_memsize(ocpSize_.numStages);
-    dimMem_.reserve(dim_size);
+    reserveBlock(dimMem_, dim_size);
     d_ocp_qp_dim_create(ocpSize_.numStages, &dim_, dimMem_.get());
     d_ocp_qp_dim_set_all(ocpSize_.numStates.data(), ocpSize_.numInputs.data(), ocpSize_.numStateBoxConstraints.data(),
                          ocpSize_.numInputBoxConstraints.data(), ocpSize_.numIneqConstraints.data(), ocpSize_.numStateBoxSlack.data(),
                          ocpSize_.numInputBoxSlack.data(), ocpSize_.numIneqSlack.data(), &dim_);
 
     const int qp_size = d_ocp_qp_memsize(&dim_);
-    qpMem_.reserve(qp_size);
+    reserveBlock(qpMem_, qp_size);
     d_ocp_qp_create(&dim_, &qp_, qpMem_.get());
 
     const int qp_sol_size = d_ocp_qp_sol_memsize(&dim_);
-    qpSolMem_.reserve(qp_sol_size);
+    reserveBlock(qpSolMem_, qp_sol_size);
     d_ocp_qp_sol_create(&dim_, &qpSol_, qpSolMem_.get());
 
     const int ipm_arg_size = d_ocp_qp_ipm_arg_memsize(&dim_);
-    ipmArgMem_.reserve(ipm_arg_size);
+    reserveBlock(ipmArgMem_, ipm_arg_size);
     d_ocp_qp_ipm_arg_create(&dim_, &arg_, ipmArgMem_.get());
 
-    applySettings(settings_);
+    applySettings(settings_, arg_);
 
     // Setup workspace after applying the settings
     const int ipm_size = d_ocp_qp_ipm_ws_memsize(&dim_, &arg_);
-    ipmMem_.reserve(ipm_size);
+    reserveBlock(ipmMem_, ipm_size);
     d_ocp_qp_ipm_ws_create(&dim_, &arg_, &workspace_, ipmMem_.get());
+
+    // Stage-wise pointer buffers handed to HPIPM. Their capacity is kept when the horizon shrinks.
+    const size_t numNodes = ocpSize_.numStages + 1;
+    for (auto* buffer : {&AA_, &BB_, &bb_, &QQ_, &RR_, &SS_, &qq_, &rr_, &CC_, &DD_, &llg_, &uug_}) {
+      buffer->reserve(numNodes);
+    }
+    boundData_.resize(std::max(boundData_.size(), numNodes));
+
+    // The content of the solution structure is not meaningful after it has been recreated.
+    warmStartLevel_ = 0;
+  }
+
+  void reserve(OcpSize ocpSize) {
+    ocpSize.numStates[0] = 0;
+
+    // Compute the memory requirements of the given size in temporary structures.
+    MemoryBlock dimMem(d_ocp_qp_dim_memsize(ocpSize.numStages));
+    d_ocp_qp_dim dim;
+    d_ocp_qp_dim_create(ocpSize.numStages, &dim, dimMem.get());
+    d_ocp_qp_dim_set_all(ocpSize.numStates.data(), ocpSize.numInputs.data(), ocpSize.numStateBoxConstraints.data(),
+                         ocpSize.numInputBoxConstraints.data(), ocpSize.numIneqConstraints.data(), ocpSize.numStateBoxSlack.data(),
+                         ocpSize.numInputBoxSlack.data(), ocpSize.numIneqSlack.data(), &dim);
+
+    MemoryBlock argMem(d_ocp_qp_ipm_arg_memsize(&dim));
+    d_ocp_qp_ipm_arg arg;
+    d_ocp_qp_ipm_arg_create(&dim, &arg, argMem.get());
+    applySettings(settings_, arg);
+
+    bool grown = false;
+    grown |= reserveBlock(dimMem_, dimMem.size());
+    grown |= reserveBlock(qpMem_, d_ocp_qp_memsize(&dim));
+    grown |= reserveBlock(qpSolMem_, d_ocp_qp_sol_memsize(&dim));
+    grown |= reserveBlock(ipmArgMem_, argMem.size());
+    grown |= reserveBlock(ipmMem_, d_ocp_qp_ipm_ws_memsize(&dim, &arg));
+
+    const size_t numNodes = ocpSize.numStages + 1;
+    for (auto* buffer : {&AA_, &BB_, &bb_, &QQ_, &RR_, &SS_, &qq_, &rr_, &CC_, &DD_, &llg_, &uug_}) {
+      buffer->reserve(numNodes);
+    }
+    boundData_.resize(std::max(boundData_.size(), numNodes));
+
+    // Reallocated blocks invalidate the structures of the current size.
+    if (grown) {
+      initializeMemory(ocpSize_, true);
+    }
+  }
+
+  bool reserveBlock(MemoryBlock& block, size_t size) {
+    const size_t oldSize = block.size();
+    const bool reallocated = block.reserve(size);
+    if (reallocated) {
+      ++memoryStatistics_.numReallocations;
+      memoryStatistics_.allocatedBytes += block.size() - oldSize;
+    }
+    return reallocated;
+  }
+
+  const MemoryStatistics& getMemoryStatistics() const { return memoryStatistics_; }
+
+  int getNumIterations() const { return numIterations_; }
+
+  void setWarmStart(const vector_array_t& stateTrajectory, const vector_array_t& inputTrajectory) {
+    // The initial state is not a decision variable, k = 0 is skipped for the states.
+    // Nodes for which the provided guess does not match the problem size are initialized with zero.
+    const int N = ocpSize_.numStages;
+    for (int k = 1; k <= N; ++k) {
+      if (k < stateTrajectory.size() && stateTrajectory[k].size() == ocpSize_.numStates[k]) {
+        d_ocp_qp_sol_set_x(k, const_cast<scalar_t*>(stateTrajectory[k].data()), &qpSol_);
+      } else {
+        warmStartZeros_.setZero(ocpSize_.numStates[k]);
+        d_ocp_qp_sol_set_x(k, warmStartZeros_.data(), &qpSol_);
+      }
+    }
+    for (int k = 0; k < N; ++k) {
+      if (k < inputTrajectory.size() && inputTrajectory[k].size() == ocpSize_.numInputs[k]) {
+        d_ocp_qp_sol_set_u(k, const_cast<scalar_t*>(inputTrajectory[k].data()), &qpSol_);
+      } else {
+        warmStartZeros_.setZero(ocpSize_.numInputs[k]);
+        d_ocp_qp_sol_set_u(k, warmStartZeros_.data(), &qpSol_);
+      }
+    }
+
+    // Only the primal variables were provided, the dual variables in the workspace no longer correspond to them.
+    warmStartLevel_ = 1;
   }
 
-  void applySettings(Settings& settings) {
-    d_ocp_qp_ipm_arg_set_default(settings.hpipmMode, &arg_);
-    d_ocp_qp_ipm_arg_set_iter_max(&settings.iter_max, &arg_);
-    d_ocp_qp_ipm_arg_set_alpha_min(&settings.alpha_min, &arg_);
-    d_ocp_qp_ipm_arg_set_mu0(&settings.mu0, &arg_);
-    d_ocp_qp_ipm_arg_set_tol_stat(&settings.tol_stat, &arg_);
-    d_ocp_qp_ipm_arg_set_tol_eq(&settings.tol_eq, &arg_);
-    d_ocp_qp_ipm_arg_set_tol_ineq(&settings.tol_ineq, &arg_);
-    d_ocp_qp_ipm_arg_set_tol_comp(&settings.tol_comp, &arg_);
-    d_ocp_qp_ipm_arg_set_reg_prim(&settings.reg_prim, &arg_);
-    d_ocp_qp_ipm_arg_set_warm_start(&settings.warm_start, &arg_);
-    d_ocp_qp_ipm_arg_set_pred_corr(&settings.pred_corr, &arg_);
-    d_ocp_qp_ipm_arg_set_ric_alg(&settings.ric_alg, &arg_);
+  static void applySettings(Settings& settings, d_ocp_qp_ipm_arg& arg) {
+    d_ocp_qp_ipm_arg_set_default(settings.hpipmMode, &arg);
+    d_ocp_qp_ipm_arg_set_iter_max(&settings.iter_max, &arg);
+    d_ocp_qp_ipm_arg_set_alpha_min(&settings.alpha_min, &arg);
+    d_ocp_qp_ipm_arg_set_mu0(&settings.mu0, &arg);
+    d_ocp_qp_ipm_arg_set_tol_stat(&settings.tol_stat, &arg);
+    d_ocp_qp_ipm_arg_set_tol_eq(&settings.tol_eq, &arg);
+    d_ocp_qp_ipm_arg_set_tol_ineq(&settings.tol_ineq, &arg);
+    d_ocp_qp_ipm_arg_set_tol_comp(&settings.tol_comp, &arg);
+    d_ocp_qp_ipm_arg_set_reg_prim(&settings.reg_prim, &arg);
+    d_ocp_qp_ipm_arg_set_warm_start(&settings.warm_start, &arg);
+    d_ocp_qp_ipm_arg_set_pred_corr(&settings.pred_corr, &arg);
+    d_ocp_qp_ipm_arg_set_ric_alg(&settings.ric_alg, &arg);
   }
 
   void verifySizes(const vector_t& x0, std::vector<VectorFunctionLinearApproximation>& dynamics,
@@ -170,9 +266,12 @@ class HpipmInterface::Impl {
     verifySizes(x0, dynamics, cost, constraints);
 
     // === Dynamics ===
-    std::vector<scalar_t*> AA(N, nullptr);
-    std::vector<scalar_t*> BB(N, nullptr);
-    std::vector<scalar_t*> bb(N, nullptr);
+    auto& AA = AA_;
+    auto& BB = BB_;
+    auto& bb = bb_;
+    AA.assign(N, nullptr);
+    BB.assign(N, nullptr);
+    bb.assign(N, nullptr);
 
     // k = 0. Absorb initial state into dynamics
     // The initial state is removed from the decision variables
@@ -181,10 +280,10 @@ class HpipmInterface::Impl {
     //         = B[0]*u[0] + (b[0] + A[0]*x[0])
     //         = B[0]*u[0] + \tilde{b}[0]
     // numState[0] = 0 --> No need to specify A[0] here
-    vector_t b0 = dynamics[0].f;
-    b0.noalias() += dynamics[0].dfdx * x0;
+    b0_ = dynamics[0].f;
+    b0_.noalias() += dynamics[0].dfdx * x0;
     BB[0] = dynamics[0].dfdu.data();
-    bb[0] = b0.data();
+    bb[0] = b0_.data();
 
     // k = 1 -> N-1
     for (int k = 1; k < N; k++) {
@@ -194,18 +293,23 @@ class HpipmInterface::Impl {
     }
 
     // === Costs ===
-    std::vector<scalar_t*> QQ(N + 1, nullptr);
-    std::vector<scalar_t*> RR(N + 1, nullptr);
-    std::vector<scalar_t*> SS(N + 1, nullptr);
-    std::vector<scalar_t*> qq(N + 1, nullptr);
-    std::vector<scalar_t*> rr(N + 1, nullptr);
+    auto& QQ = QQ_;
+    auto& RR = RR_;
+    auto& SS = SS_;
+    auto& qq = qq_;
+    auto& rr = rr_;
+    QQ.assign(N + 1, nullptr);
+    RR.assign(N + 1, nullptr);
+    SS.assign(N + 1, nullptr);
+    qq.assign(N + 1, nullptr);
+    rr.assign(N + 1, nullptr);
 
     // k = 0. Elimination of initial state requires cost adaptation
     // numState[0] = 0 --> No need to specify Q[0], S[0], q[0] here
-    vector_t r0 = cost[0].dfdu;
-    r0 += cost[0].dfdux * x0;
+    r0_ = cost[0].dfdu;
+    r0_.noalias() += cost[0].dfdux * x0;
     RR[0] = cost[0].dfduu.data();
-    rr[0] = r0.data();
+    rr[0] = r0_.data();
 
     // k = 1 -> (N-1)
     for (int k = 1; k < N; k++) {
@@ -223,15 +327,18 @@ class HpipmInterface::Impl {
     // === Constraints ===
     // for ocs2 --> C*dx + D*du + e = 0
     // for hpipm --> ug >= C*dx + D*du >= lg
-    std::vector<scalar_t*> CC(N + 1, nullptr);
-    std::vector<scalar_t*> DD(N + 1, nullptr);
-    std::vector<scalar_t*> llg(N + 1, nullptr);
-    std::vector<scalar_t*> uug(N + 1, nullptr);
-    std::vector<ocs2::vector_t> boundData;  // Declare at this scope to keep the data alive while HPIPM has the pointers
+    auto& CC = CC_;
+    auto& DD = DD_;
+    auto& llg = llg_;
+    auto& uug = uug_;
+    auto& boundData = boundData_;  // Member, such that the data is kept alive while HPIPM has the pointers
+    CC.assign(N + 1, nullptr);
+    DD.assign(N + 1, nullptr);
+    llg.assign(N + 1, nullptr);
+    uug.assign(N + 1, nullptr);
 
     if (constraints != nullptr) {
       auto& constr = *constraints;
-      boundData.resize(N + 1);
 
       // k = 0, eliminate initial state
       // numState[0] = 0 --> No need to specify C[0] here
@@ -281,19 +388,29 @@ class HpipmInterface::Impl {
     // === Set and solve ===
     d_ocp_qp_set_all(AA.data(), BB.data(), bb.data(), QQ.data(), SS.data(), RR.data(), qq.data(), rr.data(), hidxbx, hlbx, hubx, hidxbu,
                      hlbu, hubu, CC.data(), DD.data(), llg.data(), uug.data(), hZl, hZu, hzl, hzu, hidxs, hlls, hlus, &qp_);
+
+    // Warm start only with the information that is actually available in the solution structure
+    int warmStart = std::min(settings_.warm_start, warmStartLevel_);
+    d_ocp_qp_ipm_arg_set_warm_start(&warmStart, &arg_);
     d_ocp_qp_ipm_solve(&qp_, &qpSol_, &arg_, &workspace_);
+    d_ocp_qp_ipm_get_iter(&workspace_, &numIterations_);
 
     if (verbose) {
       printStatus();
     }
 
     if (!getStateSolution(x0, stateTrajectory)) {
+      warmStartLevel_ = 0;
       return hpipm_status::NAN_SOL;
     }
     if (!getInputSolution(inputTrajectory)) {
+      warmStartLevel_ = 0;
       return hpipm_status::NAN_SOL;
     }
 
+    // Primal and dual solution are available to warm start the next problem of the same size
+    warmStartLevel_ = 2;
+
     // Return solver status
     int hpipmStatus = -1;
     d_ocp_qp_ipm_get_status(&workspace_, &hpipmStatus);
@@ -520,6 +637,19 @@ class HpipmInterface::Impl {
 
   MemoryBlock ipmMem_;
   d_ocp_qp_ipm_ws workspace_;
+
+  // Persistent buffers for the data passed to HPIPM
+  std::vector<scalar_t*> AA_, BB_, bb_;
+  std::vector<scalar_t*> QQ_, RR_, SS_, qq_, rr_;
+  std::vector<scalar_t*> CC_, DD_, llg_, uug_;
+  vector_t b0_, r0_;
+  vector_array_t boundData_;
+  vector_t warmStartZeros_;
+
+  // 0: cold start, 1: primal variables available, 2: primal and dual variables available
+  int warmStartLevel_ = 0;
+  int numIterations_ = 0;
+  MemoryStatistics memoryStatistics_;
 };
 
 HpipmInterface::HpipmInterface(OcpSize ocpSize, const Settings& settings)
@@ -531,6 +661,22 @@ void HpipmInterface::resize(OcpSize ocpSize) {
   pImpl_->initializeMemory(std::move(ocpSize));
 }
 
+void HpipmInterface::reserve(OcpSize ocpSize) {
+  pImpl_->reserve(std::move(ocpSize));
+}
+
+void HpipmInterface::setWarmStart(const vector_array_t& stateTrajectory, const vector_array_t& inputTrajectory) {
+  pImpl_->setWarmStart(stateTrajectory, inputTrajectory);
+}
+
+const HpipmInterface::MemoryStatistics& HpipmInterface::getMemoryStatistics() const {
+  return pImpl_->getMemoryStatistics();
+}
+
+int HpipmInterface::getNumIterations() const {
+  return pImpl_->getNumIterations();
+}
+
 hpipm_status HpipmInterface::solve(const vector_t& x0, std::vector<VectorFunctionLinearApproximation>& dynamics,
                                    std::vector<ScalarFunctionQuadraticApproximation>& cost,
                                    std::vector<VectorFunctionLinearApproximation>* constraints, vector_array_t& stateTrajectory,
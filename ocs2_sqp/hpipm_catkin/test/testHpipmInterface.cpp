@@ -29,6 +29,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <gtest/gtest.h>
 
+#include <iostream>
+
 #include "hpipm_catkin/HpipmInterface.h"
 
 #include <ocs2_core/test/testTools.h>
@@ -109,6 +111,164 @@ TEST(test_hpiphm_interface, solve_after_resize) {
   }
 }
 
+TEST(test_hpiphm_interface, reserveAvoidsReallocation) {
+  int nx = 3;
+  int nu = 2;
+  int N = 5;
+  int Nmax = 8;
+
+  auto generateProblem = [&](int numStages, std::vector<ocs2::VectorFunctionLinearApproximation>& system,
+                             std::vector<ocs2::ScalarFunctionQuadraticApproximation>& cost) {
+    system.clear();
+    cost.clear();
+    for (int k = 0; k < numStages; k++) {
+      system.emplace_back(ocs2::getRandomDynamics(nx, nu));
+      cost.emplace_back(ocs2::getRandomCost(nx, nu));
+    }
+    cost.emplace_back(ocs2::getRandomCost(nx, 0));
+  };
+
+  ocs2::HpipmInterface hpipmInterface(ocs2::OcpSize(N, nx, nu));
+  hpipmInterface.reserve(ocs2::OcpSize(Nmax, nx, nu));
+  const auto numReallocations = hpipmInterface.getMemoryStatistics().numReallocations;
+  const auto allocatedBytes = hpipmInterface.getMemoryStatistics().allocatedBytes;
+
+  // Alternate between problem sizes within the reserved capacity
+  const ocs2::vector_t x0 = ocs2::vector_t::Random(nx);
+  std::vector<ocs2::VectorFunctionLinearApproximation> system;
+  std::vector<ocs2::ScalarFunctionQuadraticApproximation> cost;
+  std::vector<ocs2::vector_t> xSol;
+  std::vector<ocs2::vector_t> uSol;
+  for (int numStages : {Nmax, N, Nmax - 1, N}) {
+    generateProblem(numStages, system, cost);
+    hpipmInterface.resize(ocs2::OcpSize(numStages, nx, nu));
+    const auto status = hpipmInterface.solve(x0, system, cost, nullptr, xSol, uSol);
+    ASSERT_EQ(status, hpipm_status::SUCCESS);
+    ASSERT_EQ(xSol.size(), numStages + 1);
+    for (int k = 0; k < numStages; k++) {
+      ASSERT_TRUE(xSol[k + 1].isApprox(system[k].dfdx * xSol[k] + system[k].dfdu * uSol[k] + system[k].f));
+    }
+  }
+
+  EXPECT_EQ(hpipmInterface.getMemoryStatistics().numReallocations, numReallocations);
+  EXPECT_EQ(hpipmInterface.getMemoryStatistics().allocatedBytes, allocatedBytes);
+}
+
+TEST(test_hpiphm_interface, warmStart) {
+  int nx = 3;
+  int nu = 2;
+  int N = 10;
+
+  // Problem setup
+  const ocs2::vector_t x0 = ocs2::vector_t::Random(nx);
+  std::vector<ocs2::VectorFunctionLinearApproximation> system;
+  std::vector<ocs2::ScalarFunctionQuadraticApproximation> cost;
+  for (int k = 0; k < N; k++) {
+    system.emplace_back(ocs2::getRandomDynamics(nx, nu));
+    cost.emplace_back(ocs2::getRandomCost(nx, nu));
+  }
+  cost.emplace_back(ocs2::getRandomCost(nx, 0));
+  const auto ocpSize = ocs2::extractSizesFromProblem(system, cost, nullptr);
+
+  // Cold start
+  ocs2::HpipmInterface::Settings settings;
+  std::vector<ocs2::vector_t> xSolCold;
+  std::vector<ocs2::vector_t> uSolCold;
+  ocs2::HpipmInterface coldInterface(ocpSize, settings);
+  ASSERT_EQ(coldInterface.solve(x0, system, cost, nullptr, xSolCold, uSolCold), hpipm_status::SUCCESS);
+
+  // Warm start from a (shifted) guess
+  settings.warm_start = 1;
+  std::vector<ocs2::vector_t> xSolWarm;
+  std::vector<ocs2::vector_t> uSolWarm;
+  ocs2::HpipmInterface warmInterface(ocpSize, settings);
+  std::vector<ocs2::vector_t> xGuess(std::next(xSolCold.begin()), xSolCold.end());
+  std::vector<ocs2::vector_t> uGuess(std::next(uSolCold.begin()), uSolCold.end());
+  xGuess.push_back(xGuess.back());
+  uGuess.push_back(uGuess.back());
+  warmInterface.setWarmStart(xGuess, uGuess);
+  ASSERT_EQ(warmInterface.solve(x0, system, cost, nullptr, xSolWarm, uSolWarm), hpipm_status::SUCCESS);
+  ASSERT_TRUE(ocs2::isEqual(xSolCold, xSolWarm, 1e-9));
+  ASSERT_TRUE(ocs2::isEqual(uSolCold, uSolWarm, 1e-9));
+
+  // Warm start from the previous solution
+  ASSERT_EQ(warmInterface.solve(x0, system, cost, nullptr, xSolWarm, uSolWarm), hpipm_status::SUCCESS);
+  ASSERT_TRUE(ocs2::isEqual(xSolCold, xSolWarm, 1e-9));
+  ASSERT_TRUE(ocs2::isEqual(uSolCold, uSolWarm, 1e-9));
+}
+
+TEST(test_hpiphm_interface, warmStartAfterPartialStep) {
+  int nx = 3;
+  int nu = 2;
+  int nc = 1;
+  int N = 20;
+  const ocs2::scalar_t stepSize = 0.4;
+
+  // Problem setup, the constraints are passed to HPIPM as inequalities, such that it iterates
+  ocs2::vector_t x0 = ocs2::vector_t::Random(nx);
+  std::vector<ocs2::VectorFunctionLinearApproximation> system;
+  std::vector<ocs2::VectorFunctionLinearApproximation> constraints;
+  std::vector<ocs2::ScalarFunctionQuadraticApproximation> cost;
+  for (int k = 0; k < N; k++) {
+    system.emplace_back(ocs2::getRandomDynamics(nx, nu));
+    cost.emplace_back(ocs2::getRandomCost(nx, nu));
+    constraints.emplace_back(ocs2::getRandomConstraints(nx, nu, nc));
+  }
+  cost.emplace_back(ocs2::getRandomCost(nx, 0));
+  constraints.emplace_back(ocs2::getRandomConstraints(nx, 0, nc));
+  const auto ocpSize = ocs2::extractSizesFromProblem(system, cost, &constraints);
+
+  ocs2::HpipmInterface::Settings settings;
+  settings.warm_start = 1;
+  ocs2::HpipmInterface hpipmInterface(ocpSize, settings);
+  std::vector<ocs2::vector_t> xSol;
+  std::vector<ocs2::vector_t> uSol;
+  ASSERT_EQ(hpipmInterface.solve(x0, system, cost, &constraints, xSol, uSol), hpipm_status::SUCCESS);
+
+  // The QP in delta coordinates around the iterate after a step of stepSize along the solution, as an SQP iteration on a linear
+  // quadratic problem would build it. Its solution is the remaining part of the step, (1 - stepSize) * solution.
+  x0 *= (1.0 - stepSize);
+  for (int k = 0; k < N; k++) {
+    system[k].f *= (1.0 - stepSize);
+    constraints[k].f *= (1.0 - stepSize);
+    cost[k].dfdx += stepSize * (cost[k].dfdxx * xSol[k] + cost[k].dfdux.transpose() * uSol[k]);
+    cost[k].dfdu += stepSize * (cost[k].dfduu * uSol[k] + cost[k].dfdux * xSol[k]);
+  }
+  constraints[N].f *= (1.0 - stepSize);
+  cost[N].dfdx += stepSize * cost[N].dfdxx * xSol[N];
+
+  std::vector<ocs2::vector_t> xRemaining;
+  std::vector<ocs2::vector_t> uRemaining;
+  for (const auto& x : xSol) {
+    xRemaining.push_back((1.0 - stepSize) * x);
+  }
+  for (const auto& u : uSol) {
+    uRemaining.push_back((1.0 - stepSize) * u);
+  }
+
+  auto solveWithGuess = [&](const std::vector<ocs2::vector_t>* xGuess, const std::vector<ocs2::vector_t>* uGuess) {
+    ocs2::HpipmInterface::Settings guessSettings = settings;
+    guessSettings.warm_start = (xGuess != nullptr) ? 1 : 0;
+    ocs2::HpipmInterface qpInterface(ocpSize, guessSettings);
+    if (xGuess != nullptr) {
+      qpInterface.setWarmStart(*xGuess, *uGuess);
+    }
+    std::vector<ocs2::vector_t> xSolNext;
+    std::vector<ocs2::vector_t> uSolNext;
+    EXPECT_EQ(qpInterface.solve(x0, system, cost, &constraints, xSolNext, uSolNext), hpipm_status::SUCCESS);
+    EXPECT_TRUE(ocs2::isEqual(xSolNext, xRemaining, 1e-6));
+    EXPECT_TRUE(ocs2::isEqual(uSolNext, uRemaining, 1e-6));
+    return qpInterface.getNumIterations();
+  };
+  const int coldIterations = solveWithGuess(nullptr, nullptr);
+  const int fullStepIterations = solveWithGuess(&xSol, &uSol);
+  const int remainingStepIterations = solveWithGuess(&xRemaining, &uRemaining);
+  std::cerr << "[warmStartAfterPartialStep] HPIPM iterations, cold start: " << coldIterations
+            << ", previous solution: " << fullStepIterations << ", remaining step: " << remainingStepIterations << "\n";
+  EXPECT_LE(remainingStepIterations, coldIterations);
+  EXPECT_LE(remainingStepIterations, fullStepIterations);
+}
+
 TEST(test_hpiphm_interface, knownSolution) {
   int nx = 3;
   int nu = 2;
@@ -0,0 +1,146 @@
+/******************************************************************************
+Copyright (c) 2020, Farbod Farshidian. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#pragma once
+
+#include <ocs2_core/Types.h>
+#include <ocs2_core/misc/BlockSparsity.h>
+#include <ocs2_core/thread_support/ThreadPool.h>
+
+namespace ocs2 {
+
+/**
+ * Parallel-in-time solver for unconstrained discrete linear quadratic optimal control problems:
+ *
+ *   min  sum_k 0.5 [x; u]' [Q P'; P R] [x; u] + [q; r]' [x; u] + 0.5 x_N' Q_N x_N + q_N' x_N
+ *   s.t. x_{k+1} = A_k x_k + B_k u_k + b_k,  x_0 given.
+ *
+ * The horizon is partitioned into K blocks, one per thread. The solve consists of three phases:
+ * (1) In parallel, each block runs a Riccati recursion with zero terminal cost. Along the way it condenses its interface to an affine
+ *     map between its initial state, its initial costate and the unknown costate at its end:
+ *       x_end = M x_start - W lambda_end + c,   lambda_start = P x_start + M' lambda_end + p.
+ *     The last block uses the terminal cost of the problem and is exact from the start.
+ * (2) Serially, the resulting block-tridiagonal Schur complement system of size K is solved by a reduced Riccati recursion. This gives
+ *     the exact cost-to-go and the optimal state at every interface node.
+ * (3) In parallel, each block reruns the Riccati recursion from its exact terminal cost-to-go and rolls out the optimal trajectory from
+ *     its exact initial state.
+ *
+ * The result is identical to a serial Riccati recursion up to numerical round-off. State-input equality constraints must be eliminated
+ * beforehand (e.g., by projection), and the input Hessian R + B' P B must be positive definite at every stage.
+ */
+class PartitionedRiccatiSolver {
+ public:
+  /**
+   * Sets the structural sparsity of the dynamics A_k, B_k of the stages with inputs. The Riccati recursion then only multiplies the
+   * non-zero blocks of A_k and B_k. Stages without inputs (e.g. event nodes) or with a different size are treated as dense.
+   *
+   * @param [in] ASparsity : Sparsity of A_k.
+   * @param [in] BSparsity : Sparsity of B_k.
+   */
+  void setDynamicsSparsity(BlockSparsity ASparsity, BlockSparsity BSparsity);
+
+  /**
+   * Solves the LQ problem. The number of partitions is the number of threads of the pool plus the calling thread.
+   *
+   * @param [in] threadPool : The thread pool used for the parallel phases.
+   * @param [in] x0 : Initial state (deviation).
+   * @param [in] dynamics : Linearized approximation of the discrete dynamics, size N.
+   * @param [in] cost : Quadratic approximation of the cost, size N + 1.
+   * @param [out] stateTrajectory : Solution state (deviation) trajectory, size N + 1.
+   * @param [out] inputTrajectory : Solution input (deviation) trajectory, size N.
+   */
+  void solve(ThreadPool& threadPool, const vector_t& x0, const std::vector<VectorFunctionLinearApproximation>& dynamics,
+             const std::vector<ScalarFunctionQuadraticApproximation>& cost, vector_array_t& stateTrajectory,
+             vector_array_t& inputTrajectory);
+
+  /**
+   * Return the Riccati cost-to-go for the previously solved problem.
+   *
+   * Cost-to-go at a node is: V_k(x) = 0.5 * x' * dfdxx * x + x' * dfdx + f
+   * For the moment, the value for f is set to 0.0 because it is expensive to compute and often not needed.
+   *
+   * @return Sequence of N + 1 quadratic cost-to-go's.
+   */
+  std::vector<ScalarFunctionQuadraticApproximation> getRiccatiCostToGo() const;
+
+  /** Return the sequence of N feedback matrices K of the optimal solution u = K x + k for the previously solved problem. */
+  const matrix_array_t& getRiccatiFeedback() const { return feedback_; }
+
+  /** Return the sequence of N feedforward vectors k of the optimal solution u = K x + k for the previously solved problem. */
+  const vector_array_t& getRiccatiFeedforward() const { return feedforward_; }
+
+ private:
+  /** Condensed interface of a block, see the class description */
+  struct BlockInterface {
+    matrix_t M;
+    matrix_t W;
+    vector_t c;
+    matrix_t P;
+    vector_t p;
+    matrix_t SIplusWSinv;  // S_end * (I + W * S_end)^-1, where S_end is the exact cost-to-go Hessian at the end of the block.
+  };
+
+  /**
+   * Riccati recursion over the stages [begin, end), starting from the given cost-to-go at node 'end'. Writes the cost-to-go, feedback
+   * and feedforward of the nodes [begin, end). If interfacePtr is not null, the condensed block interface is computed as well.
+   */
+  void riccatiRecursion(int begin, int end, const matrix_t& terminalHessian, const vector_t& terminalGradient,
+                        const std::vector<VectorFunctionLinearApproximation>& dynamics,
+                        const std::vector<ScalarFunctionQuadraticApproximation>& cost, BlockInterface* interfacePtr);
+
+  /**
+   * Forward rollout of the optimal policy over the stages [begin, end), starting from stateTrajectory[begin]. The state at node 'end'
+   * is only written if writeEndState is true.
+   */
+  void forwardRollout(int begin, int end, bool writeEndState, const std::vector<VectorFunctionLinearApproximation>& dynamics,
+                      vector_array_t& stateTrajectory, vector_array_t& inputTrajectory) const;
+
+  /** Whether the sparsity of the dynamics applies to the given stage */
+  bool hasSparseDynamics(const VectorFunctionLinearApproximation& dynamics) const;
+
+  // Structural sparsity of the dynamics
+  BlockSparsity ASparsity_;
+  BlockSparsity BSparsity_;
+  bool useSparseA_ = false;
+  bool useSparseB_ = false;
+
+  // Riccati solution
+  matrix_array_t costToGoHessian_;
+  vector_array_t costToGoGradient_;
+  matrix_array_t feedback_;
+  vector_array_t feedforward_;
+
+  // Partitioning
+  std::vector<int> partitionStart_;                     // first node of each partition, and N at the end
+  std::vector<BlockInterface> blockInterfaces_;         // condensed interface of each partition
+  matrix_array_t interfaceHessian_;                     // exact cost-to-go Hessian at the first node of each partition
+  vector_array_t interfaceGradient_;                    // exact cost-to-go gradient at the first node of each partition
+};
+
+}  // namespace ocs2
@@ -0,0 +1,183 @@
+/******************************************************************************
+Copyright (c) 2020, Farbod Farshidian. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#pragma once
+
+#include <memory>
+
+#include <ocs2_core/initialization/Initializer.h>
+#include <ocs2_core/integration/SensitivityIntegrator.h>
+#include <ocs2_core/misc/Benchmark.h>
+#include <ocs2_core/reference/ModeSchedule.h>
+#include <ocs2_core/reference/TargetTrajectories.h>
+#include <ocs2_core/thread_support/ThreadPool.h>
+
+#include <ocs2_oc/oc_data/PerformanceIndex.h>
+#include <ocs2_oc/oc_data/PrimalSolution.h>
+#include <ocs2_oc/oc_data/TimeDiscretization.h>
+#include <ocs2_oc/oc_problem/OptimalControlProblem.h>
+#include <ocs2_oc/search_strategy/FilterLinesearch.h>
+
+#include "ocs2_sqp/SqpSettings.h"
+#include "ocs2_sqp/SqpSolverStatus.h"
+
+namespace ocs2 {
+
+/**
+ * Multiple shooting SQP solver for a batch of independent optimal control problems which share the same formulation, e.g. for
+ * Monte-Carlo evaluations or data generation, see mpcnet::MpcnetBatchDataGeneration. The problems may differ in the initial time and
+ * state, the final time and the target trajectories. All problems of a batch share the mode schedule, which has to match the mode
+ * schedule that the terms of the optimal control problem see, e.g. through a reference manager.
+ *
+ * Compared to running one SqpSolver per problem, the batch solver keeps a single thread pool and a single copy of the optimal control
+ * problem per worker. The SQP iterations of all unconverged problems run in lockstep: the nodes of all problems are flattened into one
+ * parallel loop for the LQ approximation and the line search, and the QP subproblems are solved in parallel over the problems. This
+ * keeps all workers busy even when the individual horizons are short.
+ *
+ * @note The terms of the optimal control problem may only depend on the problem through the target trajectories, which are set per
+ * problem. Terms that read shared state, such as a mode schedule of a reference manager, see the same data for all problems. This is
+ * why run() rejects batches with different mode schedules.
+ * @note The QP subproblems are always solved with HPIPM. The parallel Riccati solver, the QP warm start, CppAD intermediate nodes and
+ * the value function are not supported.
+ */
+class SqpBatchSolver {
+ public:
+  /** The definition of a single problem of the batch. */
+  struct Problem {
+    scalar_t initTime = 0.0;
+    vector_t initState;
+    scalar_t finalTime = 0.0;
+    ModeSchedule modeSchedule;
+    TargetTrajectories targetTrajectories;
+    PrimalSolution initialGuess;  // Optional, replaces the previous solution of the problem if not empty
+  };
+
+  /**
+   * Constructor
+   *
+   * @param settings : settings for the multiple shooting SQP solver.
+   * @param [in] optimalControlProblem: The optimal control problem formulation shared by all problems of the batch.
+   * @param [in] initializer: This class initializes the state-input for the time steps that no solution is available.
+   */
+  SqpBatchSolver(sqp::Settings settings, const OptimalControlProblem& optimalControlProblem, const Initializer& initializer);
+
+  ~SqpBatchSolver();
+
+  /** Clears the solutions and the timers. */
+  void reset();
+
+  /**
+   * Solves all the problems of the batch. A problem is initialized with its initial guess. Without one, problem k is initialized with
+   * the previous solution of problem k if the previous call had the same number of problems.
+   *
+   * @param [in] problems : The problems of the batch, they all need the same mode schedule.
+   */
+  void run(std::vector<Problem> problems);
+
+  /** Number of problems solved in the last call to run(). */
+  size_t getNumProblems() const { return problems_.size(); }
+
+  /** The primal solution of problem k. */
+  const PrimalSolution& primalSolution(size_t k) const;
+
+  /** The performance index after each SQP iteration of problem k. */
+  const std::vector<PerformanceIndex>& getIterationsLog(size_t k) const;
+
+  /** The convergence type of problem k. */
+  sqp::Convergence getConvergence(size_t k) const;
+
+  /**
+   * The quadratic approximation of the value function of problem k at the given time and state, see SqpSolver::getValueFunction().
+   * Requires the createValueFunction setting.
+   */
+  ScalarFunctionQuadraticApproximation getValueFunction(size_t k, scalar_t time, const vector_t& state) const;
+
+  /**
+   * The quadratic approximation of the Hamiltonian of problem k at the given time, state and input, i.e. the cost plus the costate of the
+   * value function times the flow map, see SolverBase::getHamiltonian(). Requires the createValueFunction setting.
+   * @note As for the other multiple shooting solvers, the Lagrangian of the state-input equality constraints is not available and is not
+   * part of the Hamiltonian.
+   */
+  ScalarFunctionQuadraticApproximation getHamiltonian(size_t k, scalar_t time, const vector_t& state, const vector_t& input);
+
+  /** Number of lockstep iterations over all calls to run(). */
+  size_t getNumIterations() const { return totalNumIterations_; }
+
+  std::string getBenchmarkingInformation() const;
+
+ private:
+  /** Data of a single problem of the batch. */
+  struct ProblemData;
+
+  /** Runs a parallel loop over all nodes of the given problems, taskFunction(workerId, problem, node). */
+  void parallelForNodes(const std::vector<size_t>& problemIndices, const std::function<void(int, ProblemData&, int)>& taskFunction);
+
+  /** Creates the LQ approximations of the given problems and sets their baseline performance. */
+  void setupQuadraticSubproblems(const std::vector<size_t>& problemIndices);
+
+  /** Solves the QP subproblems of the given problems. */
+  void solveQuadraticSubproblems(const std::vector<size_t>& problemIndices);
+
+  /** Runs the filter line search of the given problems in lockstep. */
+  void takeSteps(const std::vector<size_t>& problemIndices);
+
+  /** Computes the performance and metrics of the candidate steps of the given problems. */
+  void computeCandidatePerformance(const std::vector<size_t>& problemIndices);
+
+  /** Constructs the primal solution of the given problem from its final iterate. */
+  void computePrimalSolution(ProblemData& problem);
+
+  /** Throws if problem k is not part of the batch. */
+  const ProblemData& getProblemData(size_t k) const;
+
+  // Problem definition
+  const sqp::Settings settings_;
+  DynamicsDiscretizer discretizer_;
+  DynamicsSensitivityDiscretizer sensitivityDiscretizer_;
+  HorizonStepSchedule horizonStepSchedule_;
+  std::vector<OptimalControlProblem> ocpDefinitions_;
+  std::unique_ptr<Initializer> initializerPtr_;
+  FilterLinesearch filterLinesearch_;
+
+  // Threading
+  ThreadPool threadPool_;
+
+  // Problems of the batch
+  std::vector<std::unique_ptr<ProblemData>> problems_;
+
+  // Benchmarking
+  size_t numBatches_ = 0;
+  size_t totalNumIterations_ = 0;
+  benchmark::RepeatedTimer linearQuadraticApproximationTimer_;
+  benchmark::RepeatedTimer solveQpTimer_;
+  benchmark::RepeatedTimer linesearchTimer_;
+  benchmark::RepeatedTimer computeControllerTimer_;
+};
+
+}  // namespace ocs2
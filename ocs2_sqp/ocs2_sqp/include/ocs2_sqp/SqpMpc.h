@@ -65,6 +65,12 @@ class SqpMpc final : public MPC_BASE {
     solverPtr_->run(initTime, initState, finalTime);
   }
 
+  void prepareController(scalar_t initTime, scalar_t finalTime) override {
+    if (solverPtr_->settings().useRealTimeIteration && !settings().coldStart_) {
+      solverPtr_->prepare(initTime, finalTime);
+    }
+  }
+
  private:
   std::unique_ptr<SqpSolver> solverPtr_;
 };
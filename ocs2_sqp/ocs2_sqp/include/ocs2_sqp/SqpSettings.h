@@ -43,6 +43,11 @@ struct Settings {
   scalar_t deltaTol = 1e-6;  // Termination condition : RMS update of x(t) and u(t) are both below this value
   scalar_t costTol = 1e-4;   // Termination condition : (cost{i+1} - (cost{i}) < costTol AND constraints{i+1} < g_min
 
+  // Real-time iteration: a single full SQP step per problem. The LQ approximation is made around the previous solution in a
+  // preparation phase (SqpSolver::prepare) before the state is measured, such that run() only solves the QP (feedback phase).
+  // The QP is not warm started, since the full step leaves a zero warm start for the next problem.
+  bool useRealTimeIteration = false;
+
   // Linesearch - step size rules
   scalar_t alpha_decay = 0.5;  // multiply the step size by this factor every time a linesearch step is rejected.
   scalar_t alpha_min = 1e-4;   // terminate linesearch if the attempted step size is below this threshold
@@ -58,11 +63,24 @@ struct Settings {
   bool createValueFunction = false;  // true to store the value function, false to ignore it
 
   // QP subproblem solver settings
-  hpipm_interface::Settings hpipmSettings = hpipm_interface::Settings();
+  hpipm_interface::Settings hpipmSettings = hpipm_interface::Settings();  // warm_start is loaded from "hpipmWarmStart"
+  bool useParallelRiccatiSolver = false;  // Solve the QP with the partitioned Riccati solver instead of HPIPM. Requires projection of the
+                                          // state-input equality constraints.
 
   // Discretization method
-  scalar_t dt = 0.01;  // user-defined time discretization
+  scalar_t dt = 0.01;                           // user-defined time discretization
+  scalar_array_t dtSwitchingTimes;              // multi-rate horizon: times since the initial time at which the next entry of dtSchedule
+                                                // is used as the time step, dt is used before the first one
+  scalar_array_t dtSchedule;                    // time steps after each of the dtSwitchingTimes
+  scalar_t dtGrowthFactor = 1.0;                // geometric growth of the time step per node after the last switching time
+  scalar_t dtGrowthMax = 0.1;                   // upper bound of the growing time step
+  bool useAdaptiveTimeDiscretization = false;   // Refine or coarsen the grid of the next problem based on the previous solution
+  scalar_t adaptiveDtMin = 0.0025;              // lower bound of the adapted time step
+  scalar_t adaptiveDtMax = 0.04;                // upper bound of the adapted time step
+  scalar_t adaptiveRefinementTolerance = 1e-3;  // intervals with a larger local integration error are refined
+  scalar_t adaptiveCoarseningTolerance = 1e-5;  // intervals with a smaller local integration error are coarsened
   SensitivityIntegratorType integratorType = SensitivityIntegratorType::RK2;
+  scalar_t integratorMaxStep = 0.0;  // intervals longer than this are integrated in sub-steps, e.g. for a coarse tail. 0 to disable.
 
   // Inequality penalty relaxed barrier parameters
   scalar_t inequalityConstraintMu = 0.0;
@@ -71,6 +89,13 @@ struct Settings {
   bool projectStateInputEqualityConstraints = true;  // Use a projection method to resolve the state-input constraint Cx+Du+e
   bool extractProjectionMultiplier = false;          // Extract the Lagrange multiplier of the projected state-input constraint Cx+Du+e
 
+  // Incremental re-linearization: the derivatives of an intermediate node are reused while its state and input stay within this distance
+  // (max-norm) of the point where they were evaluated. The values of the node are always re-evaluated. Zero disables the reuse.
+  // Nodes are matched by the start and duration of their interval, i.e. derivatives are reused across the iterations of a problem and
+  // across problems whose grids overlap, such as a shifted MPC horizon. The reuse restarts when the target trajectories, the mode schedule
+  // or the problem epoch (see SolverBase::getProblemEpoch) change.
+  scalar_t relinearizationTolerance = 0.0;
+
   // Printing
   bool printSolverStatus = false;      // Print HPIPM status after solving the QP subproblem
   bool printSolverStatistics = false;  // Print benchmarking of the multiple shooting method
@@ -84,6 +109,8 @@ struct Settings {
   // Threading
   size_t nThreads = 4;
   int threadPriority = 50;
+  int parallelForGrainSize = 1;  // Number of consecutive nodes a worker takes at once. If <= 0, it is adapted to the horizon.
+  size_t threadSpinCount = 0;    // Number of busy-wait iterations of an idle worker before it sleeps.
 };
 
 /**
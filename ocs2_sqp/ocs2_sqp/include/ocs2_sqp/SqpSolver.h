@@ -34,7 +34,10 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <ocs2_core/misc/Benchmark.h>
 #include <ocs2_core/thread_support/ThreadPool.h>
 
+#include <ocs2_oc/multiple_shooting/IntermediateNodeCppAd.h>
 #include <ocs2_oc/multiple_shooting/ProjectionMultiplierCoefficients.h>
+#include <ocs2_oc/multiple_shooting/Transcription.h>
+#include <ocs2_oc/oc_data/AdaptiveTimeDiscretization.h>
 #include <ocs2_oc/oc_data/TimeDiscretization.h>
 #include <ocs2_oc/oc_problem/OptimalControlProblem.h>
 #include <ocs2_oc/oc_solver/SolverBase.h>
@@ -42,6 +45,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <hpipm_catkin/HpipmInterface.h>
 
+#include "ocs2_sqp/PartitionedRiccatiSolver.h"
 #include "ocs2_sqp/SqpLogging.h"
 #include "ocs2_sqp/SqpSettings.h"
 #include "ocs2_sqp/SqpSolverStatus.h"
@@ -79,6 +83,42 @@ class SqpSolver : public SolverBase {
 
   ScalarFunctionQuadraticApproximation getValueFunction(scalar_t time, const vector_t& state) const override;
 
+  /**
+   * Transcribes the intermediate nodes with a fused CppAD model instead of evaluating the dynamics, costs, and constraints of the
+   * optimal control problem separately. The model has to describe the same intermediate terms as the optimal control problem, which is
+   * still used for the event and terminal nodes and for the performance evaluation during the line search. The model integrates each
+   * interval in a single step, hence it requires settings integratorMaxStep = 0.
+   *
+   * @param [in] intermediateNode: The fused model of an intermediate node, copied for each worker.
+   */
+  void setIntermediateNodeCppAd(const multiple_shooting::IntermediateNodeCppAd& intermediateNode);
+
+  /**
+   * Preparation phase of the real-time iteration (see sqp::Settings::useRealTimeIteration). Makes the LQ approximation of the next
+   * problem around the previous solution, such that the next call to run() only solves the QP with the measured state. The first node
+   * is moved to the actual initial time. The prepared approximation is discarded by run() if the problem changed in between, i.e. the
+   * initial time moved by more than sqp::Settings::dt or beyond the first node, the targets or the modes changed, or the solver has
+   * synchronized modules. Does nothing if there is no previous solution.
+   *
+   * @param [in] initTime: The expected initial time of the next problem.
+   * @param [in] finalTime: The expected final time of the next problem.
+   */
+  void prepare(scalar_t initTime, scalar_t finalTime);
+
+  /** Benchmark of the feedback phase of the real-time iteration, i.e. the latency from the measured state to the new policy. */
+  const benchmark::RepeatedTimer& getFeedbackPhaseTimer() const { return feedbackPhaseTimer_; }
+
+  /** Benchmark of the preparation phase of the real-time iteration. */
+  const benchmark::RepeatedTimer& getPreparationPhaseTimer() const { return preparationPhaseTimer_; }
+
+  const sqp::Settings& settings() const { return settings_; }
+
+  /** Number of intermediate nodes whose derivatives were reused, see sqp::Settings::relinearizationTolerance. */
+  size_t getNumRelinearizationCacheHits() const { return numRelinearizationCacheHits_; }
+
+  /** Number of intermediate nodes that were looked up in the linearization cache. */
+  size_t getNumRelinearizationCacheQueries() const { return numRelinearizationCacheQueries_; }
+
   ScalarFunctionQuadraticApproximation getHamiltonian(scalar_t time, const vector_t& state, const vector_t& input) override {
     throw std::runtime_error("[SqpSolver] getHamiltonian() not available yet.");
   }
@@ -109,11 +149,24 @@ class SqpSolver : public SolverBase {
     primalSolution_.inputTrajectory_ = primalSolution.inputTrajectory_;
     primalSolution_.postEventIndices_ = primalSolution.postEventIndices_;
     primalSolution_.modeSchedule_ = primalSolution.modeSchedule_;
+    rtiPreparation_.isValid = false;
     runImpl(initTime, initState, finalTime);
   }
 
-  /** Run a task in parallel with settings.nThreads */
-  void runParallel(std::function<void(int)> taskFunction);
+  /** Feedback phase of the real-time iteration, prepares the problem first if there is no valid preparation. */
+  void runRealTimeIteration(scalar_t initTime, const vector_t& initState, scalar_t finalTime);
+
+  /** Makes the LQ approximation of the real-time iteration around the previous solution, starting from the given state. */
+  void prepareRealTimeIteration(scalar_t initTime, const vector_t& initState, scalar_t finalTime);
+
+  /** Moves the first node of the prepared problem to the actual initial time and approximates its interval again. */
+  void setupFirstIntermediateNode(scalar_t initTime, const vector_t& initState);
+
+  /** Decides on the time discretization of the given horizon, taking into account the event times. */
+  std::vector<AnnotatedTime> getTimeDiscretization(scalar_t initTime, scalar_t finalTime, const scalar_array_t& eventTimes) const;
+
+  /** Run a task for each index in [begin, end) in parallel with the thread pool. The task takes (workerId, index). */
+  void parallelFor(int begin, int end, std::function<void(int, int)> taskFunction);
 
   /** Get profiling information as a string */
   std::string getBenchmarkingInformation() const;
@@ -122,6 +175,25 @@ class SqpSolver : public SolverBase {
   PerformanceIndex setupQuadraticSubproblem(const std::vector<AnnotatedTime>& time, const vector_t& initState, const vector_array_t& x,
                                             const vector_array_t& u, std::vector<Metrics>& metrics);
 
+  /** Unprojected linearization of an intermediate node and the point it was evaluated at */
+  struct LinearizationCacheEntry {
+    bool isValid = false;
+    scalar_t time = 0.0;
+    scalar_t dt = 0.0;
+    vector_t x;
+    vector_t u;
+    multiple_shooting::Transcription transcription;
+  };
+
+  /** Clears the linearization cache if the target trajectories, the mode schedule or the problem epoch changed since it was filled */
+  void checkLinearizationCache();
+
+  /**
+   * Looks up the cached linearization of the interval {t, dt} by a binary search on the times of the previous linearization. Returns the
+   * entry if it was made close enough to {x, u}, nullptr otherwise.
+   */
+  LinearizationCacheEntry* findCachedLinearization(scalar_t t, scalar_t dt, const vector_t& x, const vector_t& u);
+
   /** Computes only the performance metrics at the current {t, x(t), u(t)} */
   PerformanceIndex computePerformance(const std::vector<AnnotatedTime>& time, const vector_t& initState, const vector_array_t& x,
                                       const vector_array_t& u, std::vector<Metrics>& metrics);
@@ -134,6 +206,12 @@ class SqpSolver : public SolverBase {
   };
   OcpSubproblemSolution getOCPSolution(const vector_t& delta_x0);
 
+  /** Shifts the last QP solution of the previous problem to the given time discretization to warm start the first QP */
+  void shiftQpWarmStart(const std::vector<AnnotatedTime>& time);
+
+  /** Keeps the part of the last QP solution that a step of the given size did not apply, to warm start the next QP */
+  void updateQpWarmStart(scalar_t stepSize);
+
   /** Extract the value function based on the last solved QP */
   void extractValueFunction(const std::vector<AnnotatedTime>& time, const vector_array_t& x);
 
@@ -145,19 +223,20 @@ class SqpSolver : public SolverBase {
                          const OcpSubproblemSolution& subproblemSolution, vector_array_t& x, vector_array_t& u,
                          std::vector<Metrics>& metrics);
 
-  /** Determine convergence after a step */
-  sqp::Convergence checkConvergence(int iteration, const PerformanceIndex& baseline, const sqp::StepInfo& stepInfo) const;
-
   // Problem definition
   const sqp::Settings settings_;
   DynamicsDiscretizer discretizer_;
   DynamicsSensitivityDiscretizer sensitivityDiscretizer_;
+  HorizonStepSchedule horizonStepSchedule_;
+  AdaptiveTimeDiscretization adaptiveTimeDiscretization_;
   std::vector<OptimalControlProblem> ocpDefinitions_;
+  std::vector<std::unique_ptr<multiple_shooting::IntermediateNodeCppAd>> intermediateNodes_;
   std::unique_ptr<Initializer> initializerPtr_;
   FilterLinesearch filterLinesearch_;
 
   // Solver interface
   HpipmInterface hpipmInterface_;
+  PartitionedRiccatiSolver partitionedRiccatiSolver_;
 
   // Threading
   ThreadPool threadPool_;
@@ -165,6 +244,12 @@ class SqpSolver : public SolverBase {
   // Solution
   PrimalSolution primalSolution_;
 
+  // Primal guess for the next QP in QP coordinates, used for warm starting HPIPM
+  scalar_array_t qpWarmStartTime_;
+  vector_array_t qpWarmStartDeltaX_;
+  vector_array_t qpWarmStartDeltaU_;
+  bool qpWarmStartPending_ = false;
+
   // Value function in absolute state coordinates (without the constant value)
   std::vector<ScalarFunctionQuadraticApproximation> valueFunction_;
 
@@ -185,15 +270,40 @@ class SqpSolver : public SolverBase {
   // The ProblemMetrics associated to primalSolution_
   ProblemMetrics problemMetrics_;
 
+  // Linearization point of the prepared real-time iteration, the LQ approximation is stored in the members above
+  struct RealTimeIterationPreparation {
+    bool isValid = false;
+    scalar_t finalTime = 0.0;
+    ModeSchedule modeSchedule;
+    TargetTrajectories targetTrajectories;
+    std::vector<AnnotatedTime> timeDiscretization;
+    vector_array_t x;
+    vector_array_t u;
+    std::vector<Metrics> metrics;
+    PerformanceIndex performance;
+  };
+  RealTimeIterationPreparation rtiPreparation_;
+
+  // Linearization cache of the intermediate nodes, see sqp::Settings::relinearizationTolerance
+  std::vector<LinearizationCacheEntry> linearizationCache_;      // one entry per node of the previous time discretization, sorted by time
+  std::vector<LinearizationCacheEntry> nextLinearizationCache_;  // filled while linearizing, then swapped with linearizationCache_
+  TargetTrajectories linearizationCacheTargetTrajectories_;
+  ModeSchedule linearizationCacheModeSchedule_;
+  size_t linearizationCacheProblemEpoch_{0};
+
   // Benchmarking
   size_t numProblems_{0};
   size_t totalNumIterations_{0};
+  size_t numRelinearizationCacheHits_{0};
+  size_t numRelinearizationCacheQueries_{0};
   sqp::Logger<sqp::LogEntry> logger_;
   benchmark::RepeatedTimer initializationTimer_;
   benchmark::RepeatedTimer linearQuadraticApproximationTimer_;
   benchmark::RepeatedTimer solveQpTimer_;
   benchmark::RepeatedTimer linesearchTimer_;
   benchmark::RepeatedTimer computeControllerTimer_;
+  benchmark::RepeatedTimer preparationPhaseTimer_;
+  benchmark::RepeatedTimer feedbackPhaseTimer_;
 };
 
 }  // namespace ocs2
@@ -35,6 +35,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <ocs2_oc/oc_data/PerformanceIndex.h>
 #include <ocs2_oc/search_strategy/FilterLinesearch.h>
 
+#include "ocs2_sqp/SqpSettings.h"
+
 namespace ocs2 {
 namespace sqp {
 
@@ -56,6 +58,17 @@ struct StepInfo {
   scalar_t totalConstraintViolationAfterStep;  // constraint metric used in the line search
 };
 
+/**
+ * Determines convergence after a step.
+ *
+ * @param [in] settings : The SQP settings holding the termination tolerances.
+ * @param [in] iteration : The current SQP iteration, starting at zero.
+ * @param [in] baseline : The performance index before the step.
+ * @param [in] stepInfo : The result of the line search.
+ * @return The convergence type, Convergence::FALSE if not converged.
+ */
+Convergence checkConvergence(const Settings& settings, int iteration, const PerformanceIndex& baseline, const StepInfo& stepInfo);
+
 /** Transforms sqp::Convergence to string */
 inline std::string toString(const Convergence& convergence) {
   switch (convergence) {
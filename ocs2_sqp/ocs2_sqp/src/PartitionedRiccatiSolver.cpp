@@ -0,0 +1,274 @@
+/******************************************************************************
+Copyright (c) 2020, Farbod Farshidian. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#include "ocs2_sqp/PartitionedRiccatiSolver.h"
+
+namespace ocs2 {
+
+namespace {
+// Sparse kernels only pay off if a sufficient part of the matrix is skipped
+constexpr scalar_t kMaxSparseDensity = 0.5;
+}  // namespace
+
+void PartitionedRiccatiSolver::setDynamicsSparsity(BlockSparsity ASparsity, BlockSparsity BSparsity) {
+  if (ASparsity.rows() != ASparsity.cols() || BSparsity.rows() != ASparsity.rows()) {
+    throw std::runtime_error("[PartitionedRiccatiSolver] Inconsistent size of the dynamics sparsity.");
+  }
+  ASparsity_ = std::move(ASparsity);
+  BSparsity_ = std::move(BSparsity);
+  useSparseA_ = ASparsity_.density() < kMaxSparseDensity;
+  useSparseB_ = BSparsity_.density() < kMaxSparseDensity;
+}
+
+bool PartitionedRiccatiSolver::hasSparseDynamics(const VectorFunctionLinearApproximation& dynamics) const {
+  return dynamics.dfdu.cols() > 0 && dynamics.dfdx.rows() == ASparsity_.rows() && dynamics.dfdx.cols() == ASparsity_.cols() &&
+         dynamics.dfdu.cols() == BSparsity_.cols();
+}
+
+void PartitionedRiccatiSolver::solve(ThreadPool& threadPool, const vector_t& x0,
+                                     const std::vector<VectorFunctionLinearApproximation>& dynamics,
+                                     const std::vector<ScalarFunctionQuadraticApproximation>& cost, vector_array_t& stateTrajectory,
+                                     vector_array_t& inputTrajectory) {
+  const int N = static_cast<int>(dynamics.size());
+  if (cost.size() != N + 1) {
+    throw std::runtime_error("[PartitionedRiccatiSolver] The cost needs to be of size N + 1.");
+  }
+
+  costToGoHessian_.resize(N + 1);
+  costToGoGradient_.resize(N + 1);
+  feedback_.resize(N);
+  feedforward_.resize(N);
+  stateTrajectory.resize(N + 1);
+  inputTrajectory.resize(N);
+  stateTrajectory.front() = x0;
+  costToGoHessian_.back() = cost.back().dfdxx;
+  costToGoGradient_.back() = cost.back().dfdx;
+
+  // Equal partitioning of the stages
+  const int numPartitions = std::max(1, std::min(static_cast<int>(threadPool.numThreads()) + 1, N));
+  partitionStart_.resize(numPartitions + 1);
+  for (int j = 0; j <= numPartitions; ++j) {
+    partitionStart_[j] = j * N / numPartitions;
+  }
+  blockInterfaces_.resize(numPartitions);
+  interfaceHessian_.resize(numPartitions);
+  interfaceGradient_.resize(numPartitions);
+
+  // Phase 1: condense each block with zero terminal cost. The last block is exact.
+  threadPool.parallelFor(0, numPartitions, 1, [&](int, int j) {
+    const int begin = partitionStart_[j];
+    const int end = partitionStart_[j + 1];
+    if (j + 1 == numPartitions) {
+      riccatiRecursion(begin, end, cost.back().dfdxx, cost.back().dfdx, dynamics, cost, nullptr);
+      interfaceHessian_[j] = costToGoHessian_[begin];
+      interfaceGradient_[j] = costToGoGradient_[begin];
+    } else {
+      const auto nxEnd = dynamics[end - 1].dfdx.rows();
+      riccatiRecursion(begin, end, matrix_t::Zero(nxEnd, nxEnd), vector_t::Zero(nxEnd), dynamics, cost, &blockInterfaces_[j]);
+    }
+  });
+
+  // Phase 2: reduced Riccati recursion over the block interfaces
+  for (int j = numPartitions - 2; j >= 0; --j) {
+    auto& block = blockInterfaces_[j];
+    const matrix_t& S = interfaceHessian_[j + 1];
+    const vector_t& s = interfaceGradient_[j + 1];
+
+    // S * (I + W * S)^-1 = (I + S * W)^-1 * S
+    matrix_t IplusSW = S * block.W;
+    IplusSW.diagonal().array() += 1.0;
+    block.SIplusWSinv = IplusSW.partialPivLu().solve(S);
+
+    if (j > 0) {  // The cost-to-go of the first node is computed in phase 3
+      const matrix_t SIplusWSinvM = block.SIplusWSinv * block.M;
+      interfaceHessian_[j] = block.P;
+      interfaceHessian_[j].noalias() += block.M.transpose() * SIplusWSinvM;
+      interfaceHessian_[j] = (0.5 * (interfaceHessian_[j] + interfaceHessian_[j].transpose())).eval();
+
+      vector_t cMinusWs = block.c;
+      cMinusWs.noalias() -= block.W * s;
+      vector_t lambdaEnd = s;
+      lambdaEnd.noalias() += block.SIplusWSinv * cMinusWs;
+      interfaceGradient_[j] = block.p;
+      interfaceGradient_[j].noalias() += block.M.transpose() * lambdaEnd;
+    }
+  }
+
+  // Forward pass over the interfaces: x_end = (I + W * S)^-1 * y = y - W * S * (I + W * S)^-1 * y, with y = M * x_start - W * s + c
+  for (int j = 0; j + 1 < numPartitions; ++j) {
+    const auto& block = blockInterfaces_[j];
+    vector_t y = block.c;
+    y.noalias() += block.M * stateTrajectory[partitionStart_[j]];
+    y.noalias() -= block.W * interfaceGradient_[j + 1];
+    vector_t& xEnd = stateTrajectory[partitionStart_[j + 1]];
+    xEnd = y;
+    xEnd.noalias() -= block.W * (block.SIplusWSinv * y);
+  }
+
+  // Phase 3: exact Riccati recursion of each block and rollout from the exact initial state
+  threadPool.parallelFor(0, numPartitions, 1, [&](int, int j) {
+    const int begin = partitionStart_[j];
+    const int end = partitionStart_[j + 1];
+    const bool isLastBlock = (j + 1 == numPartitions);
+    if (!isLastBlock) {
+      riccatiRecursion(begin, end, interfaceHessian_[j + 1], interfaceGradient_[j + 1], dynamics, cost, nullptr);
+    }
+    forwardRollout(begin, end, isLastBlock, dynamics, stateTrajectory, inputTrajectory);
+  });
+}
+
+std::vector<ScalarFunctionQuadraticApproximation> PartitionedRiccatiSolver::getRiccatiCostToGo() const {
+  std::vector<ScalarFunctionQuadraticApproximation> costToGo(costToGoHessian_.size());
+  for (int k = 0; k < costToGo.size(); ++k) {
+    costToGo[k].f = 0.0;
+    costToGo[k].dfdx = costToGoGradient_[k];
+    costToGo[k].dfdxx = costToGoHessian_[k];
+  }
+  return costToGo;
+}
+
+void PartitionedRiccatiSolver::riccatiRecursion(int begin, int end, const matrix_t& terminalHessian, const vector_t& terminalGradient,
+                                                const std::vector<VectorFunctionLinearApproximation>& dynamics,
+                                                const std::vector<ScalarFunctionQuadraticApproximation>& cost,
+                                                BlockInterface* interfacePtr) {
+  // Sensitivity of the costate with respect to the costate at the end of the block: G_k = (A_k + B_k * K_k)' * G_{k+1}
+  matrix_t G;
+  if (interfacePtr != nullptr) {
+    G.setIdentity(terminalHessian.rows(), terminalHessian.rows());
+    interfacePtr->W.setZero(terminalHessian.rows(), terminalHessian.rows());
+    interfacePtr->c.setZero(terminalHessian.rows());
+  }
+
+  for (int k = end - 1; k >= begin; --k) {
+    const matrix_t& P = (k + 1 == end) ? terminalHessian : costToGoHessian_[k + 1];
+    const vector_t& p = (k + 1 == end) ? terminalGradient : costToGoGradient_[k + 1];
+    const matrix_t& A = dynamics[k].dfdx;
+    const matrix_t& B = dynamics[k].dfdu;
+    const vector_t& b = dynamics[k].f;
+
+    const bool sparseStage = hasSparseDynamics(dynamics[k]);
+    const bool sparseA = sparseStage && useSparseA_;
+    const bool sparseB = sparseStage && useSparseB_;
+
+    matrix_t PA;
+    if (sparseA) {
+      PA.setZero(P.rows(), A.cols());
+      block_sparse::addRightProduct(P, ASparsity_, A, PA);
+    } else {
+      PA.noalias() = P * A;
+    }
+    vector_t Pbp = p;
+    Pbp.noalias() += P * b;
+
+    matrix_t& Pk = costToGoHessian_[k];
+    vector_t& pk = costToGoGradient_[k];
+    Pk = cost[k].dfdxx;
+    if (sparseA) {
+      block_sparse::addTransposeProduct(ASparsity_, A, PA, Pk);
+    } else {
+      Pk.noalias() += A.transpose() * PA;
+    }
+    pk = cost[k].dfdx;
+    pk.noalias() += A.transpose() * Pbp;
+
+    if (B.cols() > 0) {
+      matrix_t PB;
+      matrix_t H = cost[k].dfduu;
+      if (sparseB) {
+        PB.setZero(P.rows(), B.cols());
+        block_sparse::addRightProduct(P, BSparsity_, B, PB);
+        block_sparse::addTransposeProduct(BSparsity_, B, PB, H);
+      } else {
+        PB.noalias() = P * B;
+        H.noalias() += B.transpose() * PB;
+      }
+      matrix_t Gux = cost[k].dfdux;
+      if (sparseA) {
+        matrix_t AtPB = matrix_t::Zero(A.cols(), B.cols());
+        block_sparse::addTransposeProduct(ASparsity_, A, PB, AtPB);
+        Gux += AtPB.transpose();
+      } else {
+        Gux.noalias() += PB.transpose() * A;
+      }
+      vector_t gu = cost[k].dfdu;
+      gu.noalias() += B.transpose() * Pbp;
+
+      const Eigen::LLT<matrix_t> HLlt(H);
+      if (HLlt.info() != Eigen::Success) {
+        throw std::runtime_error("[PartitionedRiccatiSolver] The input Hessian is not positive definite at stage " + std::to_string(k));
+      }
+      feedback_[k] = -HLlt.solve(Gux);
+      feedforward_[k] = -HLlt.solve(gu);
+      Pk.noalias() += Gux.transpose() * feedback_[k];
+      pk.noalias() += Gux.transpose() * feedforward_[k];
+
+      if (interfacePtr != nullptr) {
+        const matrix_t BtG = B.transpose() * G;
+        interfacePtr->W.noalias() += BtG.transpose() * HLlt.solve(BtG);
+        vector_t BkPlusb = b;
+        BkPlusb.noalias() += B * feedforward_[k];
+        interfacePtr->c.noalias() += G.transpose() * BkPlusb;
+        matrix_t closedLoopA = A;
+        closedLoopA.noalias() += B * feedback_[k];
+        G = (closedLoopA.transpose() * G).eval();
+      }
+    } else {  // no inputs, e.g. at an event node
+      feedback_[k].setZero(0, A.cols());
+      feedforward_[k].setZero(0);
+      if (interfacePtr != nullptr) {
+        interfacePtr->c.noalias() += G.transpose() * b;
+        G = (A.transpose() * G).eval();
+      }
+    }
+
+    Pk = (0.5 * (Pk + Pk.transpose())).eval();
+  }
+
+  if (interfacePtr != nullptr) {
+    interfacePtr->M = G.transpose();
+    interfacePtr->P = costToGoHessian_[begin];
+    interfacePtr->p = costToGoGradient_[begin];
+  }
+}
+
+void PartitionedRiccatiSolver::forwardRollout(int begin, int end, bool writeEndState,
+                                              const std::vector<VectorFunctionLinearApproximation>& dynamics,
+                                              vector_array_t& stateTrajectory, vector_array_t& inputTrajectory) const {
+  for (int k = begin; k < end; ++k) {
+    inputTrajectory[k] = feedforward_[k];
+    inputTrajectory[k].noalias() += feedback_[k] * stateTrajectory[k];
+    if (k + 1 < end || writeEndState) {
+      stateTrajectory[k + 1] = dynamics[k].f;
+      stateTrajectory[k + 1].noalias() += dynamics[k].dfdx * stateTrajectory[k];
+      stateTrajectory[k + 1].noalias() += dynamics[k].dfdu * inputTrajectory[k];
+    }
+  }
+}
+
+}  // namespace ocs2
@@ -0,0 +1,602 @@
+/******************************************************************************
+Copyright (c) 2020, Farbod Farshidian. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#include "ocs2_sqp/SqpBatchSolver.h"
+
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+
+#include <ocs2_core/misc/LinearInterpolation.h>
+#include <ocs2_core/misc/Tracing.h>
+#include <ocs2_oc/approximate_model/LinearQuadraticApproximator.h>
+#include <ocs2_oc/multiple_shooting/Helpers.h>
+#include <ocs2_oc/multiple_shooting/Initialization.h>
+#include <ocs2_oc/multiple_shooting/MetricsComputation.h>
+#include <ocs2_oc/multiple_shooting/PerformanceIndexComputation.h>
+#include <ocs2_oc/multiple_shooting/ProjectionMultiplierCoefficients.h>
+#include <ocs2_oc/multiple_shooting/Transcription.h>
+#include <ocs2_oc/oc_problem/OcpSize.h>
+#include <ocs2_oc/trajectory_adjustment/TrajectorySpreadingHelperFunctions.h>
+
+#include <hpipm_catkin/HpipmInterface.h>
+
+namespace ocs2 {
+
+namespace {
+sqp::Settings rectifySettings(const OptimalControlProblem& ocp, sqp::Settings&& settings) {
+  // True does not make sense if there are no constraints.
+  if (ocp.equalityConstraintPtr->empty()) {
+    settings.projectStateInputEqualityConstraints = false;
+  }
+  if (settings.useParallelRiccatiSolver) {
+    throw std::runtime_error("[SqpBatchSolver] The parallel Riccati solver is not supported by the batch solver.");
+  }
+  // The calling thread is always a worker
+  settings.nThreads = std::max(settings.nThreads, size_t(1));
+  return settings;
+}
+
+/** Sums the performance of the workers and accounts for the initial state constraint. */
+PerformanceIndex sumPerformance(const std::vector<PerformanceIndex>& performance, const vector_t& initState, const vector_t& x0,
+                                std::vector<Metrics>& metrics) {
+  const vector_t initDynamicsViolation = initState - x0;
+  metrics.front().dynamicsViolation += initDynamicsViolation;
+
+  PerformanceIndex totalPerformance = std::accumulate(std::next(performance.begin()), performance.end(), performance.front());
+  totalPerformance.dynamicsViolationSSE += initDynamicsViolation.squaredNorm();
+  totalPerformance.merit = totalPerformance.cost + totalPerformance.equalityLagrangian + totalPerformance.inequalityLagrangian;
+  return totalPerformance;
+}
+
+}  // anonymous namespace
+
+struct SqpBatchSolver::ProblemData {
+  explicit ProblemData(const hpipm_interface::Settings& hpipmSettings) : hpipmInterface(OcpSize(), hpipmSettings) {}
+
+  // Problem and iterate
+  Problem problem;
+  std::vector<AnnotatedTime> time;
+  vector_array_t x;
+  vector_array_t u;
+  std::vector<Metrics> metrics;
+
+  // LQ approximation
+  std::vector<VectorFunctionLinearApproximation> dynamics;
+  std::vector<ScalarFunctionQuadraticApproximation> cost;
+  std::vector<VectorFunctionLinearApproximation> stateInputEqConstraints;
+  std::vector<VectorFunctionLinearApproximation> stateIneqConstraints;
+  std::vector<VectorFunctionLinearApproximation> stateInputIneqConstraints;
+  std::vector<VectorFunctionLinearApproximation> constraintsProjection;
+  std::vector<multiple_shooting::ProjectionMultiplierCoefficients> projectionMultiplierCoefficients;
+  PerformanceIndex baseline;
+  std::vector<PerformanceIndex> workerPerformance;  // A worker ID is never used concurrently
+
+  // QP solution
+  HpipmInterface hpipmInterface;
+  vector_array_t deltaX;
+  vector_array_t deltaU;
+  scalar_t armijoDescentMetric = 0.0;
+  scalar_t deltaXnorm = 0.0;
+  scalar_t deltaUnorm = 0.0;
+
+  // Linesearch
+  scalar_t alpha = 1.0;
+  vector_array_t xNew;
+  vector_array_t uNew;
+  std::vector<Metrics> metricsNew;
+  sqp::StepInfo stepInfo;
+
+  // Result
+  int iteration = 0;
+  sqp::Convergence convergence = sqp::Convergence::FALSE;
+  std::vector<PerformanceIndex> performanceIndeces;
+  PrimalSolution primalSolution;
+  std::vector<ScalarFunctionQuadraticApproximation> valueFunction;
+};
+
+SqpBatchSolver::SqpBatchSolver(sqp::Settings settings, const OptimalControlProblem& optimalControlProblem, const Initializer& initializer)
+    : settings_(rectifySettings(optimalControlProblem, std::move(settings))),
+      horizonStepSchedule_(createHorizonStepSchedule(settings_.dt, settings_.dtSwitchingTimes, settings_.dtSchedule,
+                                                     settings_.dtGrowthFactor, settings_.dtGrowthMax)),
+      threadPool_(settings_.nThreads - 1, settings_.threadPriority, settings_.threadSpinCount) {
+  Eigen::setNbThreads(1);  // No multithreading within Eigen.
+  Eigen::initParallel();
+
+  // Dynamics discretization
+  discretizer_ = selectDynamicsDiscretization(settings_.integratorType, settings_.integratorMaxStep);
+  sensitivityDiscretizer_ = selectDynamicsSensitivityDiscretization(settings_.integratorType, settings_.integratorMaxStep);
+
+  // Clone objects to have one for each worker, shared by all problems of the batch
+  for (int w = 0; w < settings_.nThreads; w++) {
+    ocpDefinitions_.push_back(optimalControlProblem);
+  }
+
+  // Operating points
+  initializerPtr_.reset(initializer.clone());
+
+  // Linesearch
+  filterLinesearch_.g_max = settings_.g_max;
+  filterLinesearch_.g_min = settings_.g_min;
+  filterLinesearch_.gamma_c = settings_.gamma_c;
+  filterLinesearch_.armijoFactor = settings_.armijoFactor;
+}
+
+SqpBatchSolver::~SqpBatchSolver() {
+  if (settings_.printSolverStatistics) {
+    std::cerr << getBenchmarkingInformation() << std::endl;
+  }
+}
+
+void SqpBatchSolver::reset() {
+  problems_.clear();
+
+  // reset timers
+  numBatches_ = 0;
+  totalNumIterations_ = 0;
+  linearQuadraticApproximationTimer_.reset();
+  solveQpTimer_.reset();
+  linesearchTimer_.reset();
+  computeControllerTimer_.reset();
+}
+
+const SqpBatchSolver::ProblemData& SqpBatchSolver::getProblemData(size_t k) const {
+  if (k >= problems_.size()) {
+    throw std::runtime_error("[SqpBatchSolver] Problem " + std::to_string(k) + " is not part of the batch.");
+  }
+  return *problems_[k];
+}
+
+const PrimalSolution& SqpBatchSolver::primalSolution(size_t k) const {
+  return getProblemData(k).primalSolution;
+}
+
+const std::vector<PerformanceIndex>& SqpBatchSolver::getIterationsLog(size_t k) const {
+  if (k >= problems_.size() || problems_[k]->performanceIndeces.empty()) {
+    throw std::runtime_error("[SqpBatchSolver] No performance log for problem " + std::to_string(k) + ", no batch solved yet?");
+  }
+  return problems_[k]->performanceIndeces;
+}
+
+sqp::Convergence SqpBatchSolver::getConvergence(size_t k) const {
+  return getProblemData(k).convergence;
+}
+
+ScalarFunctionQuadraticApproximation SqpBatchSolver::getValueFunction(size_t k, scalar_t time, const vector_t& state) const {
+  const auto& data = getProblemData(k);
+  if (data.valueFunction.empty()) {
+    throw std::runtime_error("[SqpBatchSolver] Value function is empty! Is createValueFunction true and did the solver run?");
+  }
+
+  // Interpolation
+  const auto indexAlpha = LinearInterpolation::timeSegment(time, data.primalSolution.timeTrajectory_);
+
+  ScalarFunctionQuadraticApproximation valueFunction;
+  using T = std::vector<ocs2::ScalarFunctionQuadraticApproximation>;
+  using LinearInterpolation::interpolate;
+  valueFunction.f = 0.0;
+  valueFunction.dfdx = interpolate(indexAlpha, data.valueFunction, [](const T& v, size_t ind) -> const vector_t& { return v[ind].dfdx; });
+  valueFunction.dfdxx =
+      interpolate(indexAlpha, data.valueFunction, [](const T& v, size_t ind) -> const matrix_t& { return v[ind].dfdxx; });
+
+  // Re-center around query state
+  valueFunction.dfdx.noalias() += valueFunction.dfdxx * state;
+
+  return valueFunction;
+}
+
+ScalarFunctionQuadraticApproximation SqpBatchSolver::getHamiltonian(size_t k, scalar_t time, const vector_t& state, const vector_t& input) {
+  const auto& data = getProblemData(k);
+  const ScalarFunctionQuadraticApproximation V = getValueFunction(k, time, state);
+
+  // the cost includes the soft constraints
+  auto& ocpDefinition = ocpDefinitions_.front();
+  ocpDefinition.targetTrajectoriesPtr = &data.problem.targetTrajectories;
+  const ModelData modelData = approximateIntermediateLQ(ocpDefinition, time, state, input, MultiplierCollection());
+
+  // add the "future cost" dVdx(x) * f(x,u) to the cost, see GaussNewtonDDP::getHamiltonian
+  ScalarFunctionQuadraticApproximation hamiltonian(modelData.cost);
+  const matrix_t dVdxx_dfdx = V.dfdxx.transpose() * modelData.dynamics.dfdx;
+  hamiltonian.f += V.dfdx.dot(modelData.dynamics.f);
+  hamiltonian.dfdx.noalias() += V.dfdxx.transpose() * modelData.dynamics.f + modelData.dynamics.dfdx.transpose() * V.dfdx;
+  hamiltonian.dfdu.noalias() += modelData.dynamics.dfdu.transpose() * V.dfdx;
+  hamiltonian.dfdxx.noalias() += dVdxx_dfdx + dVdxx_dfdx.transpose();
+  hamiltonian.dfdux.noalias() += modelData.dynamics.dfdu.transpose() * V.dfdxx;
+
+  return hamiltonian;
+}
+
+std::string SqpBatchSolver::getBenchmarkingInformation() const {
+  const auto linearQuadraticApproximationTotal = linearQuadraticApproximationTimer_.getTotalInMilliseconds();
+  const auto solveQpTotal = solveQpTimer_.getTotalInMilliseconds();
+  const auto linesearchTotal = linesearchTimer_.getTotalInMilliseconds();
+  const auto computeControllerTotal = computeControllerTimer_.getTotalInMilliseconds();
+
+  const auto benchmarkTotal = linearQuadraticApproximationTotal + solveQpTotal + linesearchTotal + computeControllerTotal;
+
+  std::stringstream infoStream;
+  if (benchmarkTotal > 0.0) {
+    const scalar_t inPercent = 100.0;
+    infoStream << "\n########################################################################\n";
+    infoStream << "The benchmarking is computed over " << numBatches_ << " batches and " << totalNumIterations_ << " iterations. \n";
+    infoStream << "SQP Batch Benchmarking\t   :\tAverage time [ms]   (% of total runtime)\n";
+    infoStream << "\tLQ Approximation   :\t" << linearQuadraticApproximationTimer_.getAverageInMilliseconds() << " [ms] \t\t("
+               << linearQuadraticApproximationTotal / benchmarkTotal * inPercent << "%)\n";
+    infoStream << "\tSolve QP           :\t" << solveQpTimer_.getAverageInMilliseconds() << " [ms] \t\t("
+               << solveQpTotal / benchmarkTotal * inPercent << "%)\n";
+    infoStream << "\tLinesearch         :\t" << linesearchTimer_.getAverageInMilliseconds() << " [ms] \t\t("
+               << linesearchTotal / benchmarkTotal * inPercent << "%)\n";
+    infoStream << "\tCompute Controller :\t" << computeControllerTimer_.getAverageInMilliseconds() << " [ms] \t\t("
+               << computeControllerTotal / benchmarkTotal * inPercent << "%)\n";
+  }
+  return infoStream.str();
+}
+
+void SqpBatchSolver::run(std::vector<Problem> problems) {
+  OCS2_TRACE_SCOPE("sqp", "runBatch");
+
+  // The terms of the shared optimal control problem cannot tell the problems apart by their mode schedule
+  for (size_t k = 1; k < problems.size(); ++k) {
+    const auto& modeSchedule = problems[k].modeSchedule;
+    if (modeSchedule.eventTimes != problems.front().modeSchedule.eventTimes ||
+        modeSchedule.modeSequence != problems.front().modeSchedule.modeSequence) {
+      throw std::runtime_error("[SqpBatchSolver] Problem " + std::to_string(k) + " has a different mode schedule than problem 0.");
+    }
+  }
+
+  // Keep the previous solutions as initial guess if the batch has the same size
+  if (problems.size() != problems_.size()) {
+    problems_.clear();
+    for (size_t k = 0; k < problems.size(); ++k) {
+      problems_.emplace_back(new ProblemData(settings_.hpipmSettings));
+    }
+  }
+
+  std::vector<size_t> activeProblems(problems.size());
+  for (size_t k = 0; k < problems.size(); ++k) {
+    auto& data = *problems_[k];
+    data.problem = std::move(problems[k]);
+    if (!data.problem.initialGuess.timeTrajectory_.empty()) {
+      data.primalSolution = std::move(data.problem.initialGuess);
+      data.problem.initialGuess.clear();
+    }
+
+    // Determine time discretization, taking into account event times.
+    const auto& problem = data.problem;
+    data.time = timeDiscretizationWithEvents(problem.initTime, problem.finalTime, horizonStepSchedule_, problem.modeSchedule.eventTimes);
+
+    // Initialize the state and input
+    if (!data.primalSolution.timeTrajectory_.empty()) {
+      std::ignore = trajectorySpread(data.primalSolution.modeSchedule_, data.problem.modeSchedule, data.primalSolution);
+    }
+    multiple_shooting::initializeStateInputTrajectories(data.problem.initState, data.time, data.primalSolution, *initializerPtr_, data.x,
+                                                        data.u);
+
+    // Bookkeeping
+    data.iteration = 0;
+    data.convergence = sqp::Convergence::FALSE;
+    data.performanceIndeces.clear();
+    data.valueFunction.clear();
+    activeProblems[k] = k;
+  }
+
+  // SQP iterations in lockstep, converged problems drop out of the batch
+  while (!activeProblems.empty()) {
+    OCS2_TRACE_SCOPE_INDEX("sqp", "batchIteration", totalNumIterations_);
+
+    linearQuadraticApproximationTimer_.startTimer();
+    setupQuadraticSubproblems(activeProblems);
+    linearQuadraticApproximationTimer_.endTimer();
+
+    solveQpTimer_.startTimer();
+    solveQuadraticSubproblems(activeProblems);
+    solveQpTimer_.endTimer();
+
+    linesearchTimer_.startTimer();
+    takeSteps(activeProblems);
+    linesearchTimer_.endTimer();
+
+    std::vector<size_t> unconvergedProblems;
+    unconvergedProblems.reserve(activeProblems.size());
+    for (const auto k : activeProblems) {
+      auto& data = *problems_[k];
+      data.performanceIndeces.push_back(data.stepInfo.performanceAfterStep);
+      data.convergence = sqp::checkConvergence(settings_, data.iteration, data.baseline, data.stepInfo);
+      ++data.iteration;
+      if (data.convergence == sqp::Convergence::FALSE) {
+        unconvergedProblems.push_back(k);
+      }
+    }
+    activeProblems.swap(unconvergedProblems);
+    ++totalNumIterations_;
+  }
+
+  computeControllerTimer_.startTimer();
+  threadPool_.parallelFor(0, static_cast<int>(problems_.size()), 1,
+                          [&](int workerId, int k) { computePrimalSolution(*problems_[k]); });
+  computeControllerTimer_.endTimer();
+
+  ++numBatches_;
+
+  if (settings_.printSolverStatus) {
+    for (size_t k = 0; k < problems_.size(); ++k) {
+      std::cerr << "[SqpBatchSolver] Problem " << k << ": " << toString(problems_[k]->convergence) << " after "
+                << problems_[k]->iteration << " iterations\n";
+    }
+  }
+}
+
+void SqpBatchSolver::parallelForNodes(const std::vector<size_t>& problemIndices,
+                                      const std::function<void(int, ProblemData&, int)>& taskFunction) {
+  // offsets[j] is the flat index of the first node of problem problemIndices[j]
+  std::vector<int> offsets;
+  offsets.reserve(problemIndices.size() + 1);
+  offsets.push_back(0);
+  for (const auto k : problemIndices) {
+    offsets.push_back(offsets.back() + static_cast<int>(problems_[k]->time.size()));
+  }
+
+  auto flatTask = [&](int workerId, int flatIndex) {
+    const auto j = std::distance(offsets.cbegin(), std::upper_bound(offsets.cbegin(), offsets.cend(), flatIndex)) - 1;
+    auto& data = *problems_[problemIndices[j]];
+    ocpDefinitions_[workerId].targetTrajectoriesPtr = &data.problem.targetTrajectories;
+    taskFunction(workerId, data, flatIndex - offsets[j]);
+  };
+  threadPool_.parallelFor(0, offsets.back(), settings_.parallelForGrainSize, flatTask);
+}
+
+void SqpBatchSolver::setupQuadraticSubproblems(const std::vector<size_t>& problemIndices) {
+  OCS2_TRACE_SCOPE("sqp", "lqApproximation");
+
+  for (const auto k : problemIndices) {
+    auto& data = *problems_[k];
+    const int N = static_cast<int>(data.time.size()) - 1;
+    data.workerPerformance.assign(settings_.nThreads, PerformanceIndex());
+    data.cost.resize(N + 1);
+    data.dynamics.resize(N);
+    data.stateInputEqConstraints.resize(N + 1);  // +1 because of HpipmInterface size check
+    data.stateIneqConstraints.resize(N + 1);
+    data.stateInputIneqConstraints.resize(N);
+    data.constraintsProjection.resize(N);
+    data.projectionMultiplierCoefficients.resize(N);
+    data.metrics.resize(N + 1);
+  }
+
+  auto nodeTask = [&](int workerId, ProblemData& data, int i) {
+    OptimalControlProblem& ocpDefinition = ocpDefinitions_[workerId];
+    PerformanceIndex& workerPerformance = data.workerPerformance[workerId];
+    const auto& time = data.time;
+    const auto& x = data.x;
+    const int N = static_cast<int>(time.size()) - 1;
+
+    if (i < N) {
+      if (time[i].event == AnnotatedTime::Event::PreEvent) {
+        // Event node
+        auto result = multiple_shooting::setupEventNode(ocpDefinition, time[i].time, x[i], x[i + 1]);
+        data.metrics[i] = multiple_shooting::computeMetrics(result);
+        workerPerformance += multiple_shooting::computePerformanceIndex(result);
+        data.cost[i] = std::move(result.cost);
+        data.dynamics[i] = std::move(result.dynamics);
+        data.stateInputEqConstraints[i].resize(0, x[i].size());
+        data.stateIneqConstraints[i] = std::move(result.ineqConstraints);
+        data.stateInputIneqConstraints[i].resize(0, x[i].size());
+        data.constraintsProjection[i].resize(0, x[i].size());
+        data.projectionMultiplierCoefficients[i] = multiple_shooting::ProjectionMultiplierCoefficients();
+      } else {
+        // Normal, intermediate node
+        const scalar_t ti = getIntervalStart(time[i]);
+        const scalar_t dt = getIntervalDuration(time[i], time[i + 1]);
+        auto result = multiple_shooting::setupIntermediateNode(ocpDefinition, sensitivityDiscretizer_, ti, dt, x[i], x[i + 1], data.u[i]);
+        data.metrics[i] = multiple_shooting::computeMetrics(result);
+        workerPerformance += multiple_shooting::computePerformanceIndex(result, dt);
+        if (settings_.projectStateInputEqualityConstraints) {
+          multiple_shooting::projectTranscription(result, settings_.extractProjectionMultiplier);
+        }
+        data.cost[i] = std::move(result.cost);
+        data.dynamics[i] = std::move(result.dynamics);
+        data.stateInputEqConstraints[i] = std::move(result.stateInputEqConstraints);
+        data.stateIneqConstraints[i] = std::move(result.stateIneqConstraints);
+        data.stateInputIneqConstraints[i] = std::move(result.stateInputIneqConstraints);
+        data.constraintsProjection[i] = std::move(result.constraintsProjection);
+        data.projectionMultiplierCoefficients[i] = std::move(result.projectionMultiplierCoefficients);
+      }
+    } else {  // Terminal node
+      const scalar_t tN = getIntervalStart(time[N]);
+      auto result = multiple_shooting::setupTerminalNode(ocpDefinition, tN, x[N]);
+      data.metrics[i] = multiple_shooting::computeMetrics(result);
+      workerPerformance += multiple_shooting::computePerformanceIndex(result);
+      data.cost[i] = std::move(result.cost);
+      data.stateInputEqConstraints[i].resize(0, x[i].size());
+      data.stateIneqConstraints[i] = std::move(result.ineqConstraints);
+    }
+  };
+  parallelForNodes(problemIndices, nodeTask);
+
+  for (const auto k : problemIndices) {
+    auto& data = *problems_[k];
+    data.baseline = sumPerformance(data.workerPerformance, data.problem.initState, data.x.front(), data.metrics);
+  }
+}
+
+void SqpBatchSolver::solveQuadraticSubproblems(const std::vector<size_t>& problemIndices) {
+  OCS2_TRACE_SCOPE("sqp", "solveQp");
+
+  const bool hasStateInputConstraints = !ocpDefinitions_.front().equalityConstraintPtr->empty();
+  auto solveTask = [&](int workerId, int j) {
+    const auto k = problemIndices[j];
+    auto& data = *problems_[k];
+
+    // without constraints, or when using projection, we have an unconstrained QP.
+    auto* constraintsPtr =
+        (hasStateInputConstraints && !settings_.projectStateInputEqualityConstraints) ? &data.stateInputEqConstraints : nullptr;
+    data.hpipmInterface.resize(extractSizesFromProblem(data.dynamics, data.cost, constraintsPtr));
+    const vector_t delta_x0 = data.problem.initState - data.x[0];
+    const auto status = data.hpipmInterface.solve(delta_x0, data.dynamics, data.cost, constraintsPtr, data.deltaX, data.deltaU, false);
+    if (status != hpipm_status::SUCCESS) {
+      throw std::runtime_error("[SqpBatchSolver] Failed to solve QP of problem " + std::to_string(k));
+    }
+
+    if (settings_.createValueFunction) {
+      data.valueFunction = data.hpipmInterface.getRiccatiCostToGo(data.dynamics[0], data.cost[0]);
+      // Correct for linearization state
+      for (size_t i = 0; i < data.valueFunction.size(); ++i) {
+        data.valueFunction[i].dfdx.noalias() -= data.valueFunction[i].dfdxx * data.x[i];
+      }
+    }
+
+    // to determine if the solution is a descent direction for the cost: compute gradient(cost)' * [dx; du]
+    data.armijoDescentMetric = armijoDescentMetric(data.cost, data.deltaX, data.deltaU);
+
+    // remap the tilde delta u to real delta u
+    if (settings_.projectStateInputEqualityConstraints) {
+      multiple_shooting::remapProjectedInput(data.constraintsProjection, data.deltaX, data.deltaU);
+    }
+
+    data.deltaXnorm = multiple_shooting::trajectoryNorm(data.deltaX);
+    data.deltaUnorm = multiple_shooting::trajectoryNorm(data.deltaU);
+  };
+  threadPool_.parallelFor(0, static_cast<int>(problemIndices.size()), 1, solveTask);
+}
+
+void SqpBatchSolver::computeCandidatePerformance(const std::vector<size_t>& problemIndices) {
+  for (const auto k : problemIndices) {
+    auto& data = *problems_[k];
+    data.workerPerformance.assign(settings_.nThreads, PerformanceIndex());
+    data.metricsNew.resize(data.time.size());
+  }
+
+  auto nodeTask = [&](int workerId, ProblemData& data, int i) {
+    OptimalControlProblem& ocpDefinition = ocpDefinitions_[workerId];
+    PerformanceIndex& workerPerformance = data.workerPerformance[workerId];
+    const auto& time = data.time;
+    const auto& x = data.xNew;
+    const int N = static_cast<int>(time.size()) - 1;
+
+    if (i < N) {
+      if (time[i].event == AnnotatedTime::Event::PreEvent) {
+        // Event node
+        data.metricsNew[i] = multiple_shooting::computeEventMetrics(ocpDefinition, time[i].time, x[i], x[i + 1]);
+        workerPerformance += toPerformanceIndex(data.metricsNew[i]);
+      } else {
+        // Normal, intermediate node
+        const scalar_t ti = getIntervalStart(time[i]);
+        const scalar_t dt = getIntervalDuration(time[i], time[i + 1]);
+        data.metricsNew[i] =
+            multiple_shooting::computeIntermediateMetrics(ocpDefinition, discretizer_, ti, dt, x[i], x[i + 1], data.uNew[i]);
+        workerPerformance += toPerformanceIndex(data.metricsNew[i], dt);
+      }
+    } else {  // Terminal node
+      const scalar_t tN = getIntervalStart(time[N]);
+      data.metricsNew[N] = multiple_shooting::computeTerminalMetrics(ocpDefinition, tN, x[N]);
+      workerPerformance += toPerformanceIndex(data.metricsNew[N]);
+    }
+  };
+  parallelForNodes(problemIndices, nodeTask);
+}
+
+void SqpBatchSolver::takeSteps(const std::vector<size_t>& problemIndices) {
+  OCS2_TRACE_SCOPE("sqp", "linesearch");
+  using StepType = FilterLinesearch::StepType;
+
+  // Rejects the step of a problem, the iterate is kept
+  auto zeroStep = [](ProblemData& data) {
+    data.stepInfo = sqp::StepInfo();
+    data.stepInfo.stepType = StepType::ZERO;
+    data.stepInfo.performanceAfterStep = data.baseline;
+    data.stepInfo.totalConstraintViolationAfterStep = FilterLinesearch::totalConstraintViolation(data.baseline);
+  };
+
+  for (const auto k : problemIndices) {
+    problems_[k]->alpha = 1.0;
+  }
+
+  // Backtracking of all problems in lockstep, see SqpSolver::takeStep
+  std::vector<size_t> searchingProblems = problemIndices;
+  while (!searchingProblems.empty()) {
+    for (const auto k : searchingProblems) {
+      auto& data = *problems_[k];
+      multiple_shooting::incrementTrajectory(data.u, data.deltaU, data.alpha, data.uNew);
+      multiple_shooting::incrementTrajectory(data.x, data.deltaX, data.alpha, data.xNew);
+    }
+
+    computeCandidatePerformance(searchingProblems);
+
+    std::vector<size_t> stillSearchingProblems;
+    for (const auto k : searchingProblems) {
+      auto& data = *problems_[k];
+      const auto performanceNew = sumPerformance(data.workerPerformance, data.problem.initState, data.xNew.front(), data.metricsNew);
+
+      bool stepAccepted;
+      StepType stepType;
+      std::tie(stepAccepted, stepType) = filterLinesearch_.acceptStep(data.baseline, performanceNew, data.alpha * data.armijoDescentMetric);
+
+      if (stepAccepted) {
+        data.x.swap(data.xNew);
+        data.u.swap(data.uNew);
+        data.metrics.swap(data.metricsNew);
+
+        data.stepInfo.stepSize = data.alpha;
+        data.stepInfo.stepType = stepType;
+        data.stepInfo.dx_norm = data.alpha * data.deltaXnorm;
+        data.stepInfo.du_norm = data.alpha * data.deltaUnorm;
+        data.stepInfo.performanceAfterStep = performanceNew;
+        data.stepInfo.totalConstraintViolationAfterStep = FilterLinesearch::totalConstraintViolation(performanceNew);
+        continue;
+      }
+
+      // Try smaller step, or escape early when the primal steps become too small
+      data.alpha *= settings_.alpha_decay;
+      const bool tooSmallStep = data.alpha * data.deltaXnorm < settings_.deltaTol && data.alpha * data.deltaUnorm < settings_.deltaTol;
+      if (tooSmallStep || data.alpha < settings_.alpha_min) {
+        zeroStep(data);
+      } else {
+        stillSearchingProblems.push_back(k);
+      }
+    }
+    searchingProblems.swap(stillSearchingProblems);
+  }
+}
+
+void SqpBatchSolver::computePrimalSolution(ProblemData& data) {
+  OCS2_TRACE_SCOPE("sqp", "computeController");
+
+  ModeSchedule modeSchedule = data.problem.modeSchedule;
+  if (settings_.useFeedbackPolicy) {
+    matrix_array_t KMatrices = data.hpipmInterface.getRiccatiFeedback(data.dynamics[0], data.cost[0]);
+    if (settings_.projectStateInputEqualityConstraints) {
+      multiple_shooting::remapProjectedGain(data.constraintsProjection, KMatrices);
+    }
+    data.primalSolution =
+        multiple_shooting::toPrimalSolution(data.time, std::move(modeSchedule), std::move(data.x), std::move(data.u), std::move(KMatrices));
+  } else {
+    data.primalSolution = multiple_shooting::toPrimalSolution(data.time, std::move(modeSchedule), std::move(data.x), std::move(data.u));
+  }
+}
+
+}  // namespace ocs2
@@ -50,6 +50,7 @@ Settings loadSettings(const std::string& filename, const std::string& fieldName,
 
   loadData::loadPtreeValue(pt, settings.sqpIteration, fieldName + ".sqpIteration", verbose);
   loadData::loadPtreeValue(pt, settings.deltaTol, fieldName + ".deltaTol", verbose);
+  loadData::loadPtreeValue(pt, settings.useRealTimeIteration, fieldName + ".useRealTimeIteration", verbose);
   loadData::loadPtreeValue(pt, settings.alpha_decay, fieldName + ".alpha_decay", verbose);
   loadData::loadPtreeValue(pt, settings.alpha_min, fieldName + ".alpha_min", verbose);
   loadData::loadPtreeValue(pt, settings.gamma_c, fieldName + ".gamma_c", verbose);
@@ -58,15 +59,27 @@ Settings loadSettings(const std::string& filename, const std::string& fieldName,
   loadData::loadPtreeValue(pt, settings.armijoFactor, fieldName + ".armijoFactor", verbose);
   loadData::loadPtreeValue(pt, settings.costTol, fieldName + ".costTol", verbose);
   loadData::loadPtreeValue(pt, settings.dt, fieldName + ".dt", verbose);
+  loadData::loadStdVector(filename, fieldName + ".dtSwitchingTimes", settings.dtSwitchingTimes, verbose);
+  loadData::loadStdVector(filename, fieldName + ".dtSchedule", settings.dtSchedule, verbose);
+  loadData::loadPtreeValue(pt, settings.dtGrowthFactor, fieldName + ".dtGrowthFactor", verbose);
+  loadData::loadPtreeValue(pt, settings.dtGrowthMax, fieldName + ".dtGrowthMax", verbose);
+  loadData::loadPtreeValue(pt, settings.useAdaptiveTimeDiscretization, fieldName + ".useAdaptiveTimeDiscretization", verbose);
+  loadData::loadPtreeValue(pt, settings.adaptiveDtMin, fieldName + ".adaptiveDtMin", verbose);
+  loadData::loadPtreeValue(pt, settings.adaptiveDtMax, fieldName + ".adaptiveDtMax", verbose);
+  loadData::loadPtreeValue(pt, settings.adaptiveRefinementTolerance, fieldName + ".adaptiveRefinementTolerance", verbose);
+  loadData::loadPtreeValue(pt, settings.adaptiveCoarseningTolerance, fieldName + ".adaptiveCoarseningTolerance", verbose);
   loadData::loadPtreeValue(pt, settings.useFeedbackPolicy, fieldName + ".useFeedbackPolicy", verbose);
   loadData::loadPtreeValue(pt, settings.createValueFunction, fieldName + ".createValueFunction", verbose);
+  loadData::loadPtreeValue(pt, settings.useParallelRiccatiSolver, fieldName + ".useParallelRiccatiSolver", verbose);
   auto integratorName = sensitivity_integrator::toString(settings.integratorType);
   loadData::loadPtreeValue(pt, integratorName, fieldName + ".integratorType", verbose);
   settings.integratorType = sensitivity_integrator::fromString(integratorName);
+  loadData::loadPtreeValue(pt, settings.integratorMaxStep, fieldName + ".integratorMaxStep", verbose);
   loadData::loadPtreeValue(pt, settings.inequalityConstraintMu, fieldName + ".inequalityConstraintMu", verbose);
   loadData::loadPtreeValue(pt, settings.inequalityConstraintDelta, fieldName + ".inequalityConstraintDelta", verbose);
   loadData::loadPtreeValue(pt, settings.projectStateInputEqualityConstraints, fieldName + ".projectStateInputEqualityConstraints", verbose);
   loadData::loadPtreeValue(pt, settings.extractProjectionMultiplier, fieldName + ".extractProjectionMultiplier", verbose);
+  loadData::loadPtreeValue(pt, settings.relinearizationTolerance, fieldName + ".relinearizationTolerance", verbose);
   loadData::loadPtreeValue(pt, settings.printSolverStatus, fieldName + ".printSolverStatus", verbose);
   loadData::loadPtreeValue(pt, settings.printSolverStatistics, fieldName + ".printSolverStatistics", verbose);
   loadData::loadPtreeValue(pt, settings.printLinesearch, fieldName + ".printLinesearch", verbose);
@@ -75,6 +88,9 @@ Settings loadSettings(const std::string& filename, const std::string& fieldName,
   loadData::loadPtreeValue(pt, settings.logFilePath, fieldName + ".logFilePath", verbose);
   loadData::loadPtreeValue(pt, settings.nThreads, fieldName + ".nThreads", verbose);
   loadData::loadPtreeValue(pt, settings.threadPriority, fieldName + ".threadPriority", verbose);
+  loadData::loadPtreeValue(pt, settings.parallelForGrainSize, fieldName + ".parallelForGrainSize", verbose);
+  loadData::loadPtreeValue(pt, settings.threadSpinCount, fieldName + ".threadSpinCount", verbose);
+  loadData::loadPtreeValue(pt, settings.hpipmSettings.warm_start, fieldName + ".hpipmWarmStart", verbose);
 
   if (verbose) {
     std::cerr << settings.hpipmSettings;
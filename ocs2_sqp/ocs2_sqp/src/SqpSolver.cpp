@@ -29,12 +29,14 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "ocs2_sqp/SqpSolver.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
 #include <numeric>
 
 #include <boost/filesystem.hpp>
 
+#include <ocs2_core/misc/Tracing.h>
 #include <ocs2_oc/multiple_shooting/Helpers.h>
 #include <ocs2_oc/multiple_shooting/Initialization.h>
 #include <ocs2_oc/multiple_shooting/MetricsComputation.h>
@@ -50,22 +52,56 @@ sqp::Settings rectifySettings(const OptimalControlProblem& ocp, sqp::Settings&&
   // True does not make sense if there are no constraints.
   if (ocp.equalityConstraintPtr->empty()) {
     settings.projectStateInputEqualityConstraints = false;
+  } else if (settings.useParallelRiccatiSolver && !settings.projectStateInputEqualityConstraints) {
+    throw std::runtime_error("[SqpSolver] The parallel Riccati solver requires projectStateInputEqualityConstraints to be true.");
+  }
+  // The real-time iteration takes the full step, which leaves nothing to warm start the next QP from.
+  if (settings.useRealTimeIteration) {
+    settings.hpipmSettings.warm_start = 0;
   }
   return settings;
 }
+
+AdaptiveTimeDiscretization::Settings adaptiveTimeDiscretizationSettings(const sqp::Settings& settings) {
+  AdaptiveTimeDiscretization::Settings adaptiveSettings;
+  adaptiveSettings.dt = settings.dt;
+  adaptiveSettings.dtMin = settings.adaptiveDtMin;
+  adaptiveSettings.dtMax = settings.adaptiveDtMax;
+  adaptiveSettings.refinementTolerance = settings.adaptiveRefinementTolerance;
+  adaptiveSettings.coarseningTolerance = settings.adaptiveCoarseningTolerance;
+  return adaptiveSettings;
+}
 }  // anonymous namespace
 
 SqpSolver::SqpSolver(sqp::Settings settings, const OptimalControlProblem& optimalControlProblem, const Initializer& initializer)
     : settings_(rectifySettings(optimalControlProblem, std::move(settings))),
+      horizonStepSchedule_(createHorizonStepSchedule(settings_.dt, settings_.dtSwitchingTimes, settings_.dtSchedule,
+                                                     settings_.dtGrowthFactor, settings_.dtGrowthMax)),
+      adaptiveTimeDiscretization_(adaptiveTimeDiscretizationSettings(settings_)),
       hpipmInterface_(OcpSize(), settings_.hpipmSettings),
-      threadPool_(std::max(settings_.nThreads, size_t(1)) - 1, settings_.threadPriority),
+      threadPool_(std::max(settings_.nThreads, size_t(1)) - 1, settings_.threadPriority, settings_.threadSpinCount),
       logger_(settings_.logSize) {
   Eigen::setNbThreads(1);  // No multithreading within Eigen.
   Eigen::initParallel();
 
   // Dynamics discretization
-  discretizer_ = selectDynamicsDiscretization(settings_.integratorType);
-  sensitivityDiscretizer_ = selectDynamicsSensitivityDiscretization(settings_.integratorType);
+  discretizer_ = selectDynamicsDiscretization(settings_.integratorType, settings_.integratorMaxStep);
+  sensitivityDiscretizer_ = selectDynamicsSensitivityDiscretization(settings_.integratorType, settings_.integratorMaxStep);
+
+  // Structural sparsity of the discretized dynamics, exploited by the partitioned Riccati solver. The projection of state-input
+  // equality constraints mixes the inputs, and sub-steps of the integrator fill in the sensitivities, in which case the dynamics are
+  // treated as dense. HPIPM takes dense stage matrices, so the sparsity is not used there. Problems with state-input equality constraints,
+  // such as the legged robot, therefore always run dense.
+  if (settings_.useParallelRiccatiSolver && optimalControlProblem.equalityConstraintPtr->empty() && settings_.integratorMaxStep <= 0.0) {
+    BlockSparsity dfdxSparsity;
+    BlockSparsity dfduSparsity;
+    if (optimalControlProblem.dynamicsPtr->getFlowMapSparsity(dfdxSparsity, dfduSparsity)) {
+      BlockSparsity ASparsity;
+      BlockSparsity BSparsity;
+      getDynamicsSensitivityDiscretizationSparsity(settings_.integratorType, dfdxSparsity, dfduSparsity, ASparsity, BSparsity);
+      partitionedRiccatiSolver_.setDynamicsSparsity(std::move(ASparsity), std::move(BSparsity));
+    }
+  }
 
   // Clone objects to have one for each worker
   for (int w = 0; w < settings_.nThreads; w++) {
@@ -114,15 +150,30 @@ void SqpSolver::reset() {
   primalSolution_ = PrimalSolution();
   valueFunction_.clear();
   performanceIndeces_.clear();
+  qpWarmStartTime_.clear();
+  qpWarmStartDeltaX_.clear();
+  qpWarmStartDeltaU_.clear();
+  qpWarmStartPending_ = false;
+  adaptiveTimeDiscretization_.reset();
+  rtiPreparation_ = RealTimeIterationPreparation();
+  linearizationCache_.clear();
+  nextLinearizationCache_.clear();
 
   // reset timers
   numProblems_ = 0;
   totalNumIterations_ = 0;
+  numRelinearizationCacheHits_ = 0;
+  numRelinearizationCacheQueries_ = 0;
   logger_ = sqp::Logger<sqp::LogEntry>(settings_.logSize);
   linearQuadraticApproximationTimer_.reset();
   solveQpTimer_.reset();
   linesearchTimer_.reset();
   computeControllerTimer_.reset();
+  preparationPhaseTimer_.reset();
+  feedbackPhaseTimer_.reset();
+  if (ocpDefinitions_.front().termProfilerPtr != nullptr) {
+    ocpDefinitions_.front().termProfilerPtr->reset();
+  }
 }
 
 std::string SqpSolver::getBenchmarkingInformation() const {
@@ -147,6 +198,24 @@ std::string SqpSolver::getBenchmarkingInformation() const {
                << linesearchTotal / benchmarkTotal * inPercent << "%)\n";
     infoStream << "\tCompute Controller :\t" << computeControllerTimer_.getAverageInMilliseconds() << " [ms] \t\t("
                << computeControllerTotal / benchmarkTotal * inPercent << "%)\n";
+    if (feedbackPhaseTimer_.getNumTimedIntervals() > 0) {
+      infoStream << "Real-time iteration  :\tAverage time [ms]   (maximum [ms])\n";
+      infoStream << "\tPreparation phase  :\t" << preparationPhaseTimer_.getAverageInMilliseconds() << " [ms] \t\t("
+                 << preparationPhaseTimer_.getMaxIntervalInMilliseconds() << " [ms])\n";
+      infoStream << "\tFeedback phase     :\t" << feedbackPhaseTimer_.getAverageInMilliseconds() << " [ms] \t\t("
+                 << feedbackPhaseTimer_.getMaxIntervalInMilliseconds() << " [ms])\n";
+    }
+    if (numRelinearizationCacheQueries_ > 0) {
+      infoStream << "Relinearization cache:\t" << numRelinearizationCacheHits_ << " hits in " << numRelinearizationCacheQueries_
+                 << " queries (" << static_cast<scalar_t>(numRelinearizationCacheHits_) / numRelinearizationCacheQueries_ * inPercent
+                 << "%)\n";
+    }
+    const auto& hpipmMemory = hpipmInterface_.getMemoryStatistics();
+    infoStream << "HPIPM memory         :\t" << hpipmMemory.numResizes << " resizes, " << hpipmMemory.numReallocations
+               << " reallocations, " << hpipmMemory.allocatedBytes << " [bytes]\n";
+    if (ocpDefinitions_.front().termProfilerPtr != nullptr) {
+      infoStream << ocpDefinitions_.front().termProfilerPtr->getReport();
+    }
   }
   return infoStream.str();
 }
@@ -180,7 +249,183 @@ ScalarFunctionQuadraticApproximation SqpSolver::getValueFunction(scalar_t time,
   }
 }
 
+void SqpSolver::setIntermediateNodeCppAd(const multiple_shooting::IntermediateNodeCppAd& intermediateNode) {
+  if (intermediateNode.getIntegratorType() != settings_.integratorType) {
+    throw std::runtime_error("[SqpSolver] The intermediate node is discretized with " +
+                             sensitivity_integrator::toString(intermediateNode.getIntegratorType()) + " while the solver uses " +
+                             sensitivity_integrator::toString(settings_.integratorType) + ".");
+  }
+  // The fused model integrates each interval in a single step, so it can not honor the sub-steps of integratorMaxStep.
+  if (settings_.integratorMaxStep > 0.0) {
+    throw std::runtime_error("[SqpSolver] The intermediate node integrates each interval in a single step, set integratorMaxStep to 0.");
+  }
+
+  intermediateNodes_.clear();
+  intermediateNodes_.reserve(settings_.nThreads);
+  for (int w = 0; w < settings_.nThreads; w++) {
+    intermediateNodes_.emplace_back(intermediateNode.clone());
+  }
+}
+
+void SqpSolver::prepare(scalar_t initTime, scalar_t finalTime) {
+  if (primalSolution_.timeTrajectory_.empty()) {
+    return;
+  }
+
+  preparationPhaseTimer_.startTimer();
+  // Predict the initial state with the previous solution
+  const vector_t predictedState =
+      LinearInterpolation::interpolate(initTime, primalSolution_.timeTrajectory_, primalSolution_.stateTrajectory_);
+  prepareRealTimeIteration(initTime, predictedState, finalTime);
+  preparationPhaseTimer_.endTimer();
+}
+
+std::vector<AnnotatedTime> SqpSolver::getTimeDiscretization(scalar_t initTime, scalar_t finalTime, const scalar_array_t& eventTimes) const {
+  return settings_.useAdaptiveTimeDiscretization ? adaptiveTimeDiscretization_.getTimeDiscretization(initTime, finalTime, eventTimes)
+                                                 : timeDiscretizationWithEvents(initTime, finalTime, horizonStepSchedule_, eventTimes);
+}
+
+void SqpSolver::prepareRealTimeIteration(scalar_t initTime, const vector_t& initState, scalar_t finalTime) {
+  OCS2_TRACE_SCOPE("sqp", "preparationPhase");
+  auto& preparation = rtiPreparation_;
+  const auto& modeSchedule = this->getReferenceManager().getModeSchedule();
+
+  const auto& targetTrajectories = this->getReferenceManager().getTargetTrajectories();
+
+  // Determine time discretization, taking into account event times.
+  preparation.finalTime = finalTime;
+  preparation.modeSchedule = modeSchedule;
+  preparation.targetTrajectories = targetTrajectories;
+  preparation.timeDiscretization = getTimeDiscretization(initTime, finalTime, modeSchedule.eventTimes);
+
+  // Initialize references
+  for (auto& ocpDefinition : ocpDefinitions_) {
+    ocpDefinition.targetTrajectoriesPtr = &targetTrajectories;
+  }
+
+  // Initialize the state and input around the previous solution
+  if (!primalSolution_.timeTrajectory_.empty()) {
+    std::ignore = trajectorySpread(primalSolution_.modeSchedule_, modeSchedule, primalSolution_);
+  }
+  multiple_shooting::initializeStateInputTrajectories(initState, preparation.timeDiscretization, primalSolution_, *initializerPtr_,
+                                                      preparation.x, preparation.u);
+
+  // Make QP approximation
+  linearQuadraticApproximationTimer_.startTimer();
+  preparation.performance =
+      setupQuadraticSubproblem(preparation.timeDiscretization, initState, preparation.x, preparation.u, preparation.metrics);
+  linearQuadraticApproximationTimer_.endTimer();
+
+  preparation.isValid = true;
+}
+
+void SqpSolver::setupFirstIntermediateNode(scalar_t initTime, const vector_t& initState) {
+  auto& preparation = rtiPreparation_;
+  auto& time = preparation.timeDiscretization;
+  const auto& x = preparation.x;
+  const auto& u = preparation.u;
+  auto& ocpDefinition = ocpDefinitions_.front();
+
+  time.front().time = initTime;
+  const scalar_t dt = getIntervalDuration(time[0], time[1]);
+  const auto& targetTrajectories = *ocpDefinition.targetTrajectoriesPtr;
+  auto result = intermediateNodes_.empty()
+                    ? multiple_shooting::setupIntermediateNode(ocpDefinition, sensitivityDiscretizer_, initTime, dt, x[0], x[1], u[0])
+                    : intermediateNodes_.front()->setupIntermediateNode(initTime, dt, x[0], x[1], u[0], targetTrajectories);
+  preparation.metrics.front() = multiple_shooting::computeMetrics(result);
+  preparation.metrics.front().dynamicsViolation += initState - x.front();
+  if (settings_.projectStateInputEqualityConstraints) {
+    multiple_shooting::projectTranscription(result, settings_.extractProjectionMultiplier);
+  }
+  cost_[0] = std::move(result.cost);
+  dynamics_[0] = std::move(result.dynamics);
+  stateInputEqConstraints_[0] = std::move(result.stateInputEqConstraints);
+  stateIneqConstraints_[0] = std::move(result.stateIneqConstraints);
+  stateInputIneqConstraints_[0] = std::move(result.stateInputIneqConstraints);
+  constraintsProjection_[0] = std::move(result.constraintsProjection);
+  projectionMultiplierCoefficients_[0] = std::move(result.projectionMultiplierCoefficients);
+
+  // The cached linearization of the first node belongs to the prepared interval
+  if (!linearizationCache_.empty()) {
+    linearizationCache_.front().isValid = false;
+  }
+}
+
+void SqpSolver::runRealTimeIteration(scalar_t initTime, const vector_t& initState, scalar_t finalTime) {
+  OCS2_TRACE_SCOPE("sqp", "feedbackPhase");
+  feedbackPhaseTimer_.startTimer();
+  auto& preparation = rtiPreparation_;
+
+  // The prepared approximation is kept if the horizon moved by less than a time step and the problem did not change in between, i.e. the
+  // targets and the modes within the horizon are the same. The state of synchronized modules is updated right before this call and can
+  // not be compared, such that the problem is always prepared again if there are any.
+  auto isPrepared = [&]() {
+    const auto& time = preparation.timeDiscretization;
+    if (!preparation.isValid || this->hasSynchronizedModules() || std::abs(initTime - time.front().time) > settings_.dt ||
+        std::abs(finalTime - preparation.finalTime) > settings_.dt) {
+      return false;
+    }
+    // The first interval is stretched or shrunk to the actual initial time
+    if (time.front().event == AnnotatedTime::Event::PreEvent || initTime >= time[1].time) {
+      return false;
+    }
+    if (preparation.targetTrajectories != this->getReferenceManager().getTargetTrajectories()) {
+      return false;
+    }
+    auto modesInHorizon = [&](const ModeSchedule& modeSchedule) {
+      const auto& eventTimes = modeSchedule.eventTimes;
+      const auto firstIt = std::upper_bound(eventTimes.cbegin(), eventTimes.cend(), time.front().time);
+      const auto lastIt = std::upper_bound(firstIt, eventTimes.cend(), preparation.finalTime);
+      const auto firstMode = modeSchedule.modeSequence.cbegin() + std::distance(eventTimes.cbegin(), firstIt);
+      return std::make_pair(scalar_array_t(firstIt, lastIt), size_array_t(firstMode, firstMode + std::distance(firstIt, lastIt) + 1));
+    };
+    return modesInHorizon(preparation.modeSchedule) == modesInHorizon(this->getReferenceManager().getModeSchedule());
+  };
+  if (!isPrepared()) {
+    prepareRealTimeIteration(initTime, initState, finalTime);
+  } else if (initTime != preparation.timeDiscretization.front().time) {
+    setupFirstIntermediateNode(initTime, initState);
+  }
+  const auto& timeDiscretization = preparation.timeDiscretization;
+  auto& x = preparation.x;
+  auto& u = preparation.u;
+
+  // Solve QP with the measured state
+  solveQpTimer_.startTimer();
+  const vector_t delta_x0 = initState - x[0];
+  const auto deltaSolution = getOCPSolution(delta_x0);
+  extractValueFunction(timeDiscretization, x);
+  solveQpTimer_.endTimer();
+
+  // Take the full step, there is no line search in the real-time iteration
+  multiple_shooting::incrementTrajectory(x, deltaSolution.deltaXSol, 1.0, x);
+  multiple_shooting::incrementTrajectory(u, deltaSolution.deltaUSol, 1.0, u);
+
+  // The performance is only known at the linearization point
+  performanceIndeces_.assign(1, preparation.performance);
+  ++numProblems_;
+  ++totalNumIterations_;
+
+  computeControllerTimer_.startTimer();
+  if (settings_.useAdaptiveTimeDiscretization) {
+    adaptiveTimeDiscretization_.update(timeDiscretization, x, u, *ocpDefinitions_.front().dynamicsPtr, discretizer_);
+  }
+  primalSolution_ = toPrimalSolution(timeDiscretization, std::move(x), std::move(u));
+  problemMetrics_ = multiple_shooting::toProblemMetrics(timeDiscretization, std::move(preparation.metrics));
+  computeControllerTimer_.endTimer();
+
+  preparation.isValid = false;
+  feedbackPhaseTimer_.endTimer();
+}
+
 void SqpSolver::runImpl(scalar_t initTime, const vector_t& initState, scalar_t finalTime) {
+  if (settings_.useRealTimeIteration) {
+    runRealTimeIteration(initTime, initState, finalTime);
+    return;
+  }
+
+  OCS2_TRACE_SCOPE("sqp", "run");
+
   if (settings_.printSolverStatus || settings_.printLinesearch) {
     std::cerr << "\n++++++++++++++++++++++++++++++++++++++++++++++++++++++";
     std::cerr << "\n+++++++++++++ SQP solver is initialized ++++++++++++++";
@@ -189,7 +434,7 @@ void SqpSolver::runImpl(scalar_t initTime, const vector_t& initState, scalar_t f
 
   // Determine time discretization, taking into account event times.
   const auto& eventTimes = this->getReferenceManager().getModeSchedule().eventTimes;
-  const auto timeDiscretization = timeDiscretizationWithEvents(initTime, finalTime, settings_.dt, eventTimes);
+  const auto timeDiscretization = getTimeDiscretization(initTime, finalTime, eventTimes);
 
   // Initialize references
   for (auto& ocpDefinition : ocpDefinitions_) {
@@ -206,6 +451,11 @@ void SqpSolver::runImpl(scalar_t initTime, const vector_t& initState, scalar_t f
   vector_array_t x, u;
   multiple_shooting::initializeStateInputTrajectories(initState, timeDiscretization, primalSolution_, *initializerPtr_, x, u);
 
+  // Initialize the QP solver with the shifted solution of the previous problem
+  if (settings_.hpipmSettings.warm_start > 0 && !settings_.useParallelRiccatiSolver && !qpWarmStartTime_.empty()) {
+    shiftQpWarmStart(timeDiscretization);
+  }
+
   // Bookkeeping
   performanceIndeces_.clear();
   std::vector<Metrics> metrics;
@@ -213,6 +463,7 @@ void SqpSolver::runImpl(scalar_t initTime, const vector_t& initState, scalar_t f
   int iter = 0;
   sqp::Convergence convergence = sqp::Convergence::FALSE;
   while (convergence == sqp::Convergence::FALSE) {
+    OCS2_TRACE_SCOPE_INDEX("sqp", "iteration", iter);
     if (settings_.printSolverStatus || settings_.printLinesearch) {
       std::cerr << "\nSQP iteration: " << iter << "\n";
     }
@@ -233,9 +484,12 @@ void SqpSolver::runImpl(scalar_t initTime, const vector_t& initState, scalar_t f
     const auto stepInfo = takeStep(baselinePerformance, timeDiscretization, initState, deltaSolution, x, u, metrics);
     performanceIndeces_.push_back(stepInfo.performanceAfterStep);
     linesearchTimer_.endTimer();
+    if (settings_.hpipmSettings.warm_start > 0 && !qpWarmStartDeltaX_.empty()) {
+      updateQpWarmStart(stepInfo.stepSize);
+    }
 
     // Check convergence
-    convergence = checkConvergence(iter, baselinePerformance, stepInfo);
+    convergence = sqp::checkConvergence(settings_, iter, baselinePerformance, stepInfo);
 
     // Logging
     if (settings_.enableLogging) {
@@ -261,10 +515,17 @@ void SqpSolver::runImpl(scalar_t initTime, const vector_t& initState, scalar_t f
   ++numProblems_;
 
   computeControllerTimer_.startTimer();
+  if (settings_.useAdaptiveTimeDiscretization) {
+    adaptiveTimeDiscretization_.update(timeDiscretization, x, u, *ocpDefinitions_.front().dynamicsPtr, discretizer_);
+  }
   primalSolution_ = toPrimalSolution(timeDiscretization, std::move(x), std::move(u));
   problemMetrics_ = multiple_shooting::toProblemMetrics(timeDiscretization, std::move(metrics));
   computeControllerTimer_.endTimer();
 
+  if (settings_.hpipmSettings.warm_start > 0 && !qpWarmStartDeltaX_.empty()) {
+    qpWarmStartTime_ = toTime(timeDiscretization);
+  }
+
   if (settings_.printSolverStatus || settings_.printLinesearch) {
     std::cerr << "\nConvergence : " << toString(convergence) << "\n";
     std::cerr << "\n++++++++++++++++++++++++++++++++++++++++++++++++++++++";
@@ -273,24 +534,69 @@ void SqpSolver::runImpl(scalar_t initTime, const vector_t& initState, scalar_t f
   }
 }
 
-void SqpSolver::runParallel(std::function<void(int)> taskFunction) {
-  threadPool_.runParallel(std::move(taskFunction), settings_.nThreads);
+void SqpSolver::parallelFor(int begin, int end, std::function<void(int, int)> taskFunction) {
+  threadPool_.parallelFor(begin, end, settings_.parallelForGrainSize, std::move(taskFunction));
+}
+
+void SqpSolver::shiftQpWarmStart(const std::vector<AnnotatedTime>& time) {
+  // Zero-order hold of the previous QP solution. Nodes with a mismatching size are initialized with zero by the HpipmInterface.
+  const int N = static_cast<int>(time.size()) - 1;
+  vector_array_t shiftedDeltaX(N + 1);
+  vector_array_t shiftedDeltaU(N);
+  for (int i = 0; i <= N; ++i) {
+    const scalar_t t = getInterpolationTime(time[i]);
+    const auto upperIt = std::upper_bound(qpWarmStartTime_.cbegin(), qpWarmStartTime_.cend(), t);
+    const int j = std::max(static_cast<int>(std::distance(qpWarmStartTime_.cbegin(), upperIt)) - 1, 0);
+    shiftedDeltaX[i] = qpWarmStartDeltaX_[std::min<int>(j, qpWarmStartDeltaX_.size() - 1)];
+    if (i < N && !qpWarmStartDeltaU_.empty()) {
+      shiftedDeltaU[i] = qpWarmStartDeltaU_[std::min<int>(j, qpWarmStartDeltaU_.size() - 1)];
+    }
+  }
+  qpWarmStartDeltaX_.swap(shiftedDeltaX);
+  qpWarmStartDeltaU_.swap(shiftedDeltaU);
+  qpWarmStartPending_ = true;
+}
+
+void SqpSolver::updateQpWarmStart(scalar_t stepSize) {
+  // The solution of the last QP is at (1 - stepSize) * delta in the delta coordinates around the new iterate.
+  const scalar_t remainingStep = 1.0 - stepSize;
+  for (auto& deltaX : qpWarmStartDeltaX_) {
+    deltaX *= remainingStep;
+  }
+  for (auto& deltaU : qpWarmStartDeltaU_) {
+    deltaU *= remainingStep;
+  }
+  qpWarmStartPending_ = true;
 }
 
 SqpSolver::OcpSubproblemSolution SqpSolver::getOCPSolution(const vector_t& delta_x0) {
+  OCS2_TRACE_SCOPE("sqp", "solveQp");
+
   // Solve the QP
   OcpSubproblemSolution solution;
   auto& deltaXSol = solution.deltaXSol;
   auto& deltaUSol = solution.deltaUSol;
   hpipm_status status;
   const bool hasStateInputConstraints = !ocpDefinitions_.front().equalityConstraintPtr->empty();
-  if (hasStateInputConstraints && !settings_.projectStateInputEqualityConstraints) {
-    hpipmInterface_.resize(extractSizesFromProblem(dynamics_, cost_, &stateInputEqConstraints_));
-    status =
-        hpipmInterface_.solve(delta_x0, dynamics_, cost_, &stateInputEqConstraints_, deltaXSol, deltaUSol, settings_.printSolverStatus);
-  } else {  // without constraints, or when using projection, we have an unconstrained QP.
-    hpipmInterface_.resize(extractSizesFromProblem(dynamics_, cost_, nullptr));
-    status = hpipmInterface_.solve(delta_x0, dynamics_, cost_, nullptr, deltaXSol, deltaUSol, settings_.printSolverStatus);
+  if (settings_.useParallelRiccatiSolver) {  // unconstrained QP, guaranteed by rectifySettings
+    partitionedRiccatiSolver_.solve(threadPool_, delta_x0, dynamics_, cost_, deltaXSol, deltaUSol);
+    status = hpipm_status::SUCCESS;
+  } else {
+    // without constraints, or when using projection, we have an unconstrained QP.
+    auto* constraintsPtr =
+        (hasStateInputConstraints && !settings_.projectStateInputEqualityConstraints) ? &stateInputEqConstraints_ : nullptr;
+    hpipmInterface_.resize(extractSizesFromProblem(dynamics_, cost_, constraintsPtr));
+    if (qpWarmStartPending_) {
+      hpipmInterface_.setWarmStart(qpWarmStartDeltaX_, qpWarmStartDeltaU_);
+      qpWarmStartPending_ = false;
+    }
+    status = hpipmInterface_.solve(delta_x0, dynamics_, cost_, constraintsPtr, deltaXSol, deltaUSol, settings_.printSolverStatus);
+
+    // Keep the solution in QP coordinates, updateQpWarmStart() reduces it to the part that the step does not apply
+    if (settings_.hpipmSettings.warm_start > 0) {
+      qpWarmStartDeltaX_ = deltaXSol;
+      qpWarmStartDeltaU_ = deltaUSol;
+    }
   }
 
   if (status != hpipm_status::SUCCESS) {
@@ -310,7 +616,8 @@ SqpSolver::OcpSubproblemSolution SqpSolver::getOCPSolution(const vector_t& delta
 
 void SqpSolver::extractValueFunction(const std::vector<AnnotatedTime>& time, const vector_array_t& x) {
   if (settings_.createValueFunction) {
-    valueFunction_ = hpipmInterface_.getRiccatiCostToGo(dynamics_[0], cost_[0]);
+    valueFunction_ = settings_.useParallelRiccatiSolver ? partitionedRiccatiSolver_.getRiccatiCostToGo()
+                                                        : hpipmInterface_.getRiccatiCostToGo(dynamics_[0], cost_[0]);
     // Correct for linearization state
     for (int i = 0; i < time.size(); ++i) {
       valueFunction_[i].dfdx.noalias() -= valueFunction_[i].dfdxx * x[i];
@@ -319,9 +626,12 @@ void SqpSolver::extractValueFunction(const std::vector<AnnotatedTime>& time, con
 }
 
 PrimalSolution SqpSolver::toPrimalSolution(const std::vector<AnnotatedTime>& time, vector_array_t&& x, vector_array_t&& u) {
+  OCS2_TRACE_SCOPE("sqp", "computeController");
+
   if (settings_.useFeedbackPolicy) {
     ModeSchedule modeSchedule = this->getReferenceManager().getModeSchedule();
-    matrix_array_t KMatrices = hpipmInterface_.getRiccatiFeedback(dynamics_[0], cost_[0]);
+    matrix_array_t KMatrices = settings_.useParallelRiccatiSolver ? partitionedRiccatiSolver_.getRiccatiFeedback()
+                                                                  : hpipmInterface_.getRiccatiFeedback(dynamics_[0], cost_[0]);
     if (settings_.projectStateInputEqualityConstraints) {
       multiple_shooting::remapProjectedGain(constraintsProjection_, KMatrices);
     }
@@ -335,10 +645,19 @@ PrimalSolution SqpSolver::toPrimalSolution(const std::vector<AnnotatedTime>& tim
 
 PerformanceIndex SqpSolver::setupQuadraticSubproblem(const std::vector<AnnotatedTime>& time, const vector_t& initState,
                                                      const vector_array_t& x, const vector_array_t& u, std::vector<Metrics>& metrics) {
+  OCS2_TRACE_SCOPE("sqp", "lqApproximation");
+
   // Problem horizon
   const int N = static_cast<int>(time.size()) - 1;
 
+  const bool useLinearizationCache = settings_.relinearizationTolerance > 0.0;
+  if (useLinearizationCache) {
+    checkLinearizationCache();
+    nextLinearizationCache_.resize(N);
+  }
+
   std::vector<PerformanceIndex> performance(settings_.nThreads, PerformanceIndex());
+  std::vector<size_t> cacheHits(settings_.nThreads, 0);
   cost_.resize(N + 1);
   dynamics_.resize(N);
   stateInputEqConstraints_.resize(N + 1);  // +1 because of HpipmInterface size check
@@ -348,14 +667,14 @@ PerformanceIndex SqpSolver::setupQuadraticSubproblem(const std::vector<Annotated
   projectionMultiplierCoefficients_.resize(N);
   metrics.resize(N + 1);
 
-  std::atomic_int timeIndex{0};
-  auto parallelTask = [&](int workerId) {
+  auto parallelTask = [&](int workerId, int i) {
+    OCS2_TRACE_SCOPE_INDEX("sqp", "node", i);
+
     // Get worker specific resources
     OptimalControlProblem& ocpDefinition = ocpDefinitions_[workerId];
-    PerformanceIndex workerPerformance;  // Accumulate performance in local variable
+    PerformanceIndex& workerPerformance = performance[workerId];  // A worker ID is never used concurrently
 
-    int i = timeIndex++;
-    while (i < N) {
+    if (i < N) {
       if (time[i].event == AnnotatedTime::Event::PreEvent) {
         // Event node
         auto result = multiple_shooting::setupEventNode(ocpDefinition, time[i].time, x[i], x[i + 1]);
@@ -368,13 +687,45 @@ PerformanceIndex SqpSolver::setupQuadraticSubproblem(const std::vector<Annotated
         stateInputIneqConstraints_[i].resize(0, x[i].size());
         constraintsProjection_[i].resize(0, x[i].size());
         projectionMultiplierCoefficients_[i] = multiple_shooting::ProjectionMultiplierCoefficients();
+        if (useLinearizationCache) {
+          nextLinearizationCache_[i].isValid = false;
+          nextLinearizationCache_[i].time = time[i].time;
+        }
       } else {
         // Normal, intermediate node
         const scalar_t ti = getIntervalStart(time[i]);
         const scalar_t dt = getIntervalDuration(time[i], time[i + 1]);
-        auto result = multiple_shooting::setupIntermediateNode(ocpDefinition, sensitivityDiscretizer_, ti, dt, x[i], x[i + 1], u[i]);
-        metrics[i] = multiple_shooting::computeMetrics(result);
-        workerPerformance += multiple_shooting::computePerformanceIndex(result, dt);
+        auto* cacheEntryPtr = useLinearizationCache ? &nextLinearizationCache_[i] : nullptr;
+        auto* cachedEntryPtr = useLinearizationCache ? findCachedLinearization(ti, dt, x[i], u[i]) : nullptr;
+        multiple_shooting::Transcription result;
+        if (cachedEntryPtr != nullptr) {
+          // Reuse the derivatives and only evaluate the values. The cache keeps the original linearization point to bound the drift.
+          // The intervals of the grid are distinct, hence no other node matches the cached entry and it can be taken over. The working
+          // copy is needed, since the projection and the LQ approximation below take over its memory.
+          metrics[i] = multiple_shooting::computeIntermediateMetrics(ocpDefinition, discretizer_, ti, dt, x[i], x[i + 1], u[i]);
+          workerPerformance += toPerformanceIndex(metrics[i], dt);
+          *cacheEntryPtr = std::move(*cachedEntryPtr);
+          cachedEntryPtr->isValid = false;
+          result = cacheEntryPtr->transcription;
+          multiple_shooting::updateIntermediateNode(result, x[i] - cacheEntryPtr->x, u[i] - cacheEntryPtr->u, metrics[i]);
+          ++cacheHits[workerId];
+        } else {
+          result = intermediateNodes_.empty()
+                       ? multiple_shooting::setupIntermediateNode(ocpDefinition, sensitivityDiscretizer_, ti, dt, x[i], x[i + 1], u[i])
+                       : intermediateNodes_[workerId]->setupIntermediateNode(ti, dt, x[i], x[i + 1], u[i],
+                                                                             *ocpDefinition.targetTrajectoriesPtr);
+          metrics[i] = multiple_shooting::computeMetrics(result);
+          workerPerformance += multiple_shooting::computePerformanceIndex(result, dt);
+          if (cacheEntryPtr != nullptr) {
+            // Assigned in place, such that the entry reuses its memory once the problem size settled
+            cacheEntryPtr->isValid = true;
+            cacheEntryPtr->time = ti;
+            cacheEntryPtr->dt = dt;
+            cacheEntryPtr->x = x[i];
+            cacheEntryPtr->u = u[i];
+            cacheEntryPtr->transcription = result;
+          }
+        }
         if (settings_.projectStateInputEqualityConstraints) {
           multiple_shooting::projectTranscription(result, settings_.extractProjectionMultiplier);
         }
@@ -386,11 +737,7 @@ PerformanceIndex SqpSolver::setupQuadraticSubproblem(const std::vector<Annotated
         constraintsProjection_[i] = std::move(result.constraintsProjection);
         projectionMultiplierCoefficients_[i] = std::move(result.projectionMultiplierCoefficients);
       }
-
-      i = timeIndex++;
-    }
-
-    if (i == N) {  // Only one worker will execute this
+    } else {  // Terminal node
       const scalar_t tN = getIntervalStart(time[N]);
       auto result = multiple_shooting::setupTerminalNode(ocpDefinition, tN, x[N]);
       metrics[i] = multiple_shooting::computeMetrics(result);
@@ -399,11 +746,15 @@ PerformanceIndex SqpSolver::setupQuadraticSubproblem(const std::vector<Annotated
       stateInputEqConstraints_[i].resize(0, x[i].size());
       stateIneqConstraints_[i] = std::move(result.ineqConstraints);
     }
-
-    // Accumulate! Same worker might run multiple tasks
-    performance[workerId] += workerPerformance;
   };
-  runParallel(std::move(parallelTask));
+  parallelFor(0, N + 1, std::move(parallelTask));
+
+  if (useLinearizationCache) {
+    linearizationCache_.swap(nextLinearizationCache_);
+    numRelinearizationCacheHits_ += std::accumulate(cacheHits.begin(), cacheHits.end(), size_t(0));
+    numRelinearizationCacheQueries_ += std::count_if(time.begin(), std::prev(time.end()),
+                                                     [](const AnnotatedTime& t) { return t.event != AnnotatedTime::Event::PreEvent; });
+  }
 
   // Account for initial state in performance
   const vector_t initDynamicsViolation = initState - x.front();
@@ -417,6 +768,36 @@ PerformanceIndex SqpSolver::setupQuadraticSubproblem(const std::vector<Annotated
   return totalPerformance;
 }
 
+void SqpSolver::checkLinearizationCache() {
+  const auto& targetTrajectories = *ocpDefinitions_.front().targetTrajectoriesPtr;
+  const auto& modeSchedule = this->getReferenceManager().getModeSchedule();
+  const bool sameModeSchedule = modeSchedule.eventTimes == linearizationCacheModeSchedule_.eventTimes &&
+                                modeSchedule.modeSequence == linearizationCacheModeSchedule_.modeSequence;
+  const auto problemEpoch = this->getProblemEpoch();
+  if (!sameModeSchedule || linearizationCacheTargetTrajectories_ != targetTrajectories || linearizationCacheProblemEpoch_ != problemEpoch) {
+    linearizationCache_.clear();
+    linearizationCacheTargetTrajectories_ = targetTrajectories;
+    linearizationCacheModeSchedule_ = modeSchedule;
+    linearizationCacheProblemEpoch_ = problemEpoch;
+  }
+}
+
+SqpSolver::LinearizationCacheEntry* SqpSolver::findCachedLinearization(scalar_t t, scalar_t dt, const vector_t& x, const vector_t& u) {
+  constexpr scalar_t timeTolerance = 1e-9;
+  const auto tol = settings_.relinearizationTolerance;
+
+  // An event node and the interval after it start within the time tolerance, only the latter can be valid
+  auto entryItr = std::lower_bound(linearizationCache_.begin(), linearizationCache_.end(), t - timeTolerance,
+                                   [](const LinearizationCacheEntry& entry, scalar_t time) { return entry.time < time; });
+  for (; entryItr != linearizationCache_.end() && entryItr->time <= t + timeTolerance; ++entryItr) {
+    if (entryItr->isValid && std::abs(entryItr->dt - dt) <= timeTolerance) {
+      const bool isClose = (x - entryItr->x).lpNorm<Eigen::Infinity>() <= tol && (u - entryItr->u).lpNorm<Eigen::Infinity>() <= tol;
+      return isClose ? &(*entryItr) : nullptr;
+    }
+  }
+  return nullptr;
+}
+
 PerformanceIndex SqpSolver::computePerformance(const std::vector<AnnotatedTime>& time, const vector_t& initState, const vector_array_t& x,
                                                const vector_array_t& u, std::vector<Metrics>& metrics) {
   // Problem size
@@ -424,13 +805,11 @@ PerformanceIndex SqpSolver::computePerformance(const std::vector<AnnotatedTime>&
   metrics.resize(N + 1);
 
   std::vector<PerformanceIndex> performance(settings_.nThreads, PerformanceIndex());
-  std::atomic_int timeIndex{0};
-  auto parallelTask = [&](int workerId) {
+  auto parallelTask = [&](int workerId, int i) {
     // Get worker specific resources
     OptimalControlProblem& ocpDefinition = ocpDefinitions_[workerId];
 
-    int i = timeIndex++;
-    while (i < N) {
+    if (i < N) {
       if (time[i].event == AnnotatedTime::Event::PreEvent) {
         // Event node
         metrics[i] = multiple_shooting::computeEventMetrics(ocpDefinition, time[i].time, x[i], x[i + 1]);
@@ -442,17 +821,13 @@ PerformanceIndex SqpSolver::computePerformance(const std::vector<AnnotatedTime>&
         metrics[i] = multiple_shooting::computeIntermediateMetrics(ocpDefinition, discretizer_, ti, dt, x[i], x[i + 1], u[i]);
         performance[workerId] += toPerformanceIndex(metrics[i], dt);
       }
-
-      i = timeIndex++;
-    }
-
-    if (i == N) {  // Only one worker will execute this
+    } else {  // Terminal node
       const scalar_t tN = getIntervalStart(time[N]);
       metrics[N] = multiple_shooting::computeTerminalMetrics(ocpDefinition, tN, x[N]);
       performance[workerId] += toPerformanceIndex(metrics[N]);
     }
   };
-  runParallel(std::move(parallelTask));
+  parallelFor(0, N + 1, std::move(parallelTask));
 
   // Account for initial state in performance
   const vector_t initDynamicsViolation = initState - x.front();
@@ -468,6 +843,7 @@ PerformanceIndex SqpSolver::computePerformance(const std::vector<AnnotatedTime>&
 sqp::StepInfo SqpSolver::takeStep(const PerformanceIndex& baseline, const std::vector<AnnotatedTime>& timeDiscretization,
                                   const vector_t& initState, const OcpSubproblemSolution& subproblemSolution, vector_array_t& x,
                                   vector_array_t& u, std::vector<Metrics>& metrics) {
+  OCS2_TRACE_SCOPE("sqp", "linesearch");
   using StepType = FilterLinesearch::StepType;
 
   /*
@@ -560,19 +936,20 @@ sqp::StepInfo SqpSolver::takeStep(const PerformanceIndex& baseline, const std::v
   return stepInfo;
 }
 
-sqp::Convergence SqpSolver::checkConvergence(int iteration, const PerformanceIndex& baseline, const sqp::StepInfo& stepInfo) const {
-  using Convergence = sqp::Convergence;
-  if ((iteration + 1) >= settings_.sqpIteration) {
+namespace sqp {
+
+Convergence checkConvergence(const Settings& settings, int iteration, const PerformanceIndex& baseline, const StepInfo& stepInfo) {
+  if ((iteration + 1) >= settings.sqpIteration) {
     // Converged because the next iteration would exceed the specified number of iterations
     return Convergence::ITERATIONS;
-  } else if (stepInfo.stepSize < settings_.alpha_min) {
+  } else if (stepInfo.stepSize < settings.alpha_min) {
     // Converged because step size is below the specified minimum
     return Convergence::STEPSIZE;
-  } else if (std::abs(stepInfo.performanceAfterStep.merit - baseline.merit) < settings_.costTol &&
-             FilterLinesearch::totalConstraintViolation(stepInfo.performanceAfterStep) < settings_.g_min) {
+  } else if (std::abs(stepInfo.performanceAfterStep.merit - baseline.merit) < settings.costTol &&
+             FilterLinesearch::totalConstraintViolation(stepInfo.performanceAfterStep) < settings.g_min) {
     // Converged because the change in merit is below the specified tolerance while the constraint violation is below the minimum
     return Convergence::METRICS;
-  } else if (stepInfo.dx_norm < settings_.deltaTol && stepInfo.du_norm < settings_.deltaTol) {
+  } else if (stepInfo.dx_norm < settings.deltaTol && stepInfo.du_norm < settings.deltaTol) {
     // Converged because the change in primal variables is below the specified tolerance
     return Convergence::PRIMAL;
   } else {
@@ -581,4 +958,5 @@ sqp::Convergence SqpSolver::checkConvergence(int iteration, const PerformanceInd
   }
 }
 
+}  // namespace sqp
 }  // namespace ocs2
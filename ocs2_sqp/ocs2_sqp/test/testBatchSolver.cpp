@@ -0,0 +1,229 @@
+/******************************************************************************
+Copyright (c) 2020, Farbod Farshidian. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include "ocs2_sqp/SqpBatchSolver.h"
+#include "ocs2_sqp/SqpSolver.h"
+
+#include <ocs2_core/initialization/DefaultInitializer.h>
+#include <ocs2_core/misc/Benchmark.h>
+
+#include <ocs2_oc/synchronized_module/ReferenceManager.h>
+#include <ocs2_oc/test/testProblemsGeneration.h>
+
+namespace {
+
+constexpr int n = 3;
+constexpr int m = 2;
+constexpr int numProblems = 8;
+
+ocs2::sqp::Settings getSettings(size_t nThreads) {
+  ocs2::sqp::Settings settings;
+  settings.dt = 0.05;
+  settings.sqpIteration = 10;
+  settings.useFeedbackPolicy = true;
+  settings.createValueFunction = true;
+  settings.printSolverStatistics = false;
+  settings.printSolverStatus = false;
+  settings.printLinesearch = false;
+  settings.nThreads = nThreads;
+  return settings;
+}
+
+std::vector<ocs2::SqpBatchSolver::Problem> getRandomProblems() {
+  std::vector<ocs2::SqpBatchSolver::Problem> problems(numProblems);
+  for (int k = 0; k < numProblems; ++k) {
+    auto& problem = problems[k];
+    problem.initTime = 0.1 * k;
+    problem.finalTime = problem.initTime + 1.0 + 0.05 * k;
+    problem.initState = ocs2::vector_t::Random(n);
+    problem.modeSchedule = ocs2::ModeSchedule({0.6}, {0, 1});
+    problem.targetTrajectories = ocs2::TargetTrajectories({problem.initTime}, {ocs2::vector_t::Random(n)}, {ocs2::vector_t::Random(m)});
+  }
+  return problems;
+}
+
+class BatchSolverTest : public testing::TestWithParam<size_t> {
+ protected:
+  BatchSolverTest() : initializer(m) {
+    ocp.dynamicsPtr = ocs2::getOcs2Dynamics(ocs2::getRandomDynamics(n, m));
+    const auto costMatrices = ocs2::getRandomCost(n, m);
+    ocp.costPtr->add("intermediateCost", ocs2::getOcs2Cost(costMatrices));
+    ocp.finalCostPtr->add("finalCost", ocs2::getOcs2StateCost(costMatrices));
+    ocp.targetTrajectoriesPtr = &emptyTarget;
+  }
+
+  ocs2::PrimalSolution solveIndividually(const ocs2::SqpBatchSolver::Problem& problem, std::vector<ocs2::PerformanceIndex>& log,
+                                         ocs2::ScalarFunctionQuadraticApproximation& valueFunction) const {
+    ocs2::SqpSolver solver(getSettings(GetParam()), ocp, initializer);
+    solver.setReferenceManager(std::make_shared<ocs2::ReferenceManager>(problem.targetTrajectories, problem.modeSchedule));
+    solver.run(problem.initTime, problem.initState, problem.finalTime);
+    log = solver.getIterationsLog();
+    valueFunction = solver.getValueFunction(problem.initTime, problem.initState);
+    return solver.primalSolution(problem.finalTime);
+  }
+
+  ocs2::OptimalControlProblem ocp;
+  ocs2::DefaultInitializer initializer;
+  ocs2::TargetTrajectories emptyTarget;
+};
+
+}  // unnamed namespace
+
+TEST_P(BatchSolverTest, sameAsIndividualSolves) {
+  const ocs2::scalar_t tol = 1e-9;
+  const auto problems = getRandomProblems();
+
+  ocs2::SqpBatchSolver batchSolver(getSettings(GetParam()), ocp, initializer);
+  batchSolver.run(problems);
+  ASSERT_EQ(batchSolver.getNumProblems(), problems.size());
+
+  for (int k = 0; k < numProblems; ++k) {
+    std::vector<ocs2::PerformanceIndex> log;
+    ocs2::ScalarFunctionQuadraticApproximation valueFunction;
+    const auto expected = solveIndividually(problems[k], log, valueFunction);
+    const auto& actual = batchSolver.primalSolution(k);
+
+    const auto actualValueFunction = batchSolver.getValueFunction(k, problems[k].initTime, problems[k].initState);
+    ASSERT_TRUE(actualValueFunction.dfdx.isApprox(valueFunction.dfdx, tol));
+    ASSERT_TRUE(actualValueFunction.dfdxx.isApprox(valueFunction.dfdxx, tol));
+
+    ASSERT_EQ(batchSolver.getIterationsLog(k).size(), log.size());
+    ASSERT_NEAR(batchSolver.getIterationsLog(k).back().merit, log.back().merit, tol);
+    ASSERT_EQ(actual.timeTrajectory_.size(), expected.timeTrajectory_.size());
+    for (size_t i = 0; i < expected.timeTrajectory_.size(); ++i) {
+      const auto t = expected.timeTrajectory_[i];
+      const auto& x = expected.stateTrajectory_[i];
+      ASSERT_DOUBLE_EQ(actual.timeTrajectory_[i], t);
+      ASSERT_TRUE(actual.stateTrajectory_[i].isApprox(x, tol));
+      ASSERT_TRUE(actual.inputTrajectory_[i].isApprox(expected.inputTrajectory_[i], tol));
+      ASSERT_TRUE(actual.controllerPtr_->computeInput(t, x).isApprox(expected.controllerPtr_->computeInput(t, x), tol));
+    }
+  }
+}
+
+TEST_P(BatchSolverTest, warmStart) {
+  const auto problems = getRandomProblems();
+
+  ocs2::SqpBatchSolver batchSolver(getSettings(GetParam()), ocp, initializer);
+  batchSolver.run(problems);
+  batchSolver.run(problems);
+
+  // The LQ problems are solved in a single step, the warm started problems are already at the optimum
+  for (int k = 0; k < numProblems; ++k) {
+    ASSERT_LE(batchSolver.getIterationsLog(k).size(), 2);
+    ASSERT_LT(batchSolver.getIterationsLog(k).back().dynamicsViolationSSE, 1e-9);
+  }
+}
+
+TEST_P(BatchSolverTest, rejectDifferentModeSchedules) {
+  auto problems = getRandomProblems();
+  problems.back().modeSchedule = ocs2::ModeSchedule({0.7}, {0, 1});
+
+  ocs2::SqpBatchSolver batchSolver(getSettings(GetParam()), ocp, initializer);
+  ASSERT_THROW(batchSolver.run(problems), std::runtime_error);
+}
+
+TEST_P(BatchSolverTest, hamiltonian) {
+  const auto problems = getRandomProblems();
+  ocs2::SqpBatchSolver batchSolver(getSettings(GetParam()), ocp, initializer);
+  batchSolver.run(problems);
+
+  // H = L + dVdx * f, for the LQ problem without constraints
+  const auto& problem = problems.front();
+  const auto t = problem.initTime;
+  const auto& x = problem.initState;
+  const ocs2::vector_t u = batchSolver.primalSolution(0).controllerPtr_->computeInput(t, x);
+  const auto hamiltonian = batchSolver.getHamiltonian(0, t, x, u);
+
+  auto ocpCopy = ocp;
+  ocpCopy.targetTrajectoriesPtr = &problem.targetTrajectories;
+  const ocs2::scalar_t cost = ocpCopy.costPtr->getValue(t, x, u, problem.targetTrajectories, *ocpCopy.preComputationPtr);
+  const ocs2::vector_t flowMap = ocpCopy.dynamicsPtr->computeFlowMap(t, x, u, *ocpCopy.preComputationPtr);
+  const auto valueFunction = batchSolver.getValueFunction(0, t, x);
+  ASSERT_NEAR(hamiltonian.f, cost + valueFunction.dfdx.dot(flowMap), 1e-9);
+}
+
+/** Compares the throughput of one batch solver with one SqpSolver per problem, as MPC-Net ran them before. */
+TEST_P(BatchSolverTest, samplesPerSecond) {
+  constexpr int numRepetitions = 20;
+  const auto problems = getRandomProblems();
+
+  std::vector<std::unique_ptr<ocs2::SqpSolver>> solvers;
+  for (const auto& problem : problems) {
+    solvers.emplace_back(new ocs2::SqpSolver(getSettings(GetParam()), ocp, initializer));
+    solvers.back()->setReferenceManager(std::make_shared<ocs2::ReferenceManager>(problem.targetTrajectories, problem.modeSchedule));
+  }
+  ocs2::benchmark::RepeatedTimer individualTimer;
+  for (int r = 0; r < numRepetitions; ++r) {
+    individualTimer.startTimer();
+    for (int k = 0; k < numProblems; ++k) {
+      solvers[k]->reset();
+      solvers[k]->run(problems[k].initTime, problems[k].initState, problems[k].finalTime);
+    }
+    individualTimer.endTimer();
+  }
+
+  ocs2::SqpBatchSolver batchSolver(getSettings(GetParam()), ocp, initializer);
+  ocs2::benchmark::RepeatedTimer batchTimer;
+  for (int r = 0; r < numRepetitions; ++r) {
+    batchSolver.reset();
+    batchTimer.startTimer();
+    batchSolver.run(problems);
+    batchTimer.endTimer();
+  }
+
+  const auto samplesPerSecond = [](const ocs2::benchmark::RepeatedTimer& timer) {
+    return 1000.0 * numProblems / timer.getAverageInMilliseconds();
+  };
+  std::cerr << "[BatchSolverTest] " << numProblems << " problems, " << GetParam() << " threads, " << numRepetitions << " repetitions\n"
+            << "  " << numProblems << " x SqpSolver : " << samplesPerSecond(individualTimer) << " [samples/s]\n"
+            << "  SqpBatchSolver  : " << samplesPerSecond(batchTimer) << " [samples/s]\n";
+}
+
+TEST(BatchSolverSettingsTest, zeroThreads) {
+  ocs2::OptimalControlProblem ocp;
+  ocp.dynamicsPtr = ocs2::getOcs2Dynamics(ocs2::getRandomDynamics(n, m));
+  const auto costMatrices = ocs2::getRandomCost(n, m);
+  ocp.costPtr->add("intermediateCost", ocs2::getOcs2Cost(costMatrices));
+  ocp.finalCostPtr->add("finalCost", ocs2::getOcs2StateCost(costMatrices));
+  ocs2::TargetTrajectories emptyTarget;
+  ocp.targetTrajectoriesPtr = &emptyTarget;
+
+  // nThreads = 0 runs on the calling thread
+  ocs2::SqpBatchSolver batchSolver(getSettings(0), ocp, ocs2::DefaultInitializer(m));
+  batchSolver.run(getRandomProblems());
+  for (int k = 0; k < numProblems; ++k) {
+    ASSERT_NE(batchSolver.getConvergence(k), ocs2::sqp::Convergence::FALSE);
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(BatchSolverTestCase, BatchSolverTest, testing::Values(1, 3),
+                        [](const testing::TestParamInfo<size_t>& info) { return "nThreads" + std::to_string(info.param); });
@@ -32,6 +32,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ocs2_sqp/SqpSolver.h"
 
 #include <ocs2_core/initialization/DefaultInitializer.h>
+#include <ocs2_core/misc/LinearInterpolation.h>
 
 #include <ocs2_oc/test/circular_kinematics.h>
 
@@ -141,3 +142,115 @@ TEST(test_circular_kinematics, solve_EqConstraints_inQPSubproblem) {
     ASSERT_TRUE(u.isApprox(primalSolution.controllerPtr_->computeInput(t, x)));
   }
 }
+
+TEST(test_circular_kinematics, solve_relinearizationCache) {
+  // optimal control problem
+  ocs2::OptimalControlProblem problem = ocs2::createCircularKinematicsProblem("/tmp/sqp_test_generated");
+
+  // Initializer
+  ocs2::DefaultInitializer zeroInitializer(2);
+
+  // Solver settings
+  ocs2::sqp::Settings settings;
+  settings.dt = 0.01;
+  settings.sqpIteration = 20;
+  settings.projectStateInputEqualityConstraints = true;
+  settings.useFeedbackPolicy = true;
+  settings.printSolverStatistics = true;
+  settings.relinearizationTolerance = 1e-3;  // <- reuse the derivatives of nodes that barely moved
+
+  // Additional problem definitions
+  const ocs2::scalar_t startTime = 0.0;
+  const ocs2::scalar_t finalTime = 1.0;
+  const ocs2::vector_t initState = (ocs2::vector_t(2) << 1.0, 0.0).finished();  // radius 1.0
+
+  // Solve twice, the second problem starts at the previous solution
+  ocs2::SqpSolver solver(settings, problem, zeroInitializer);
+  solver.run(startTime, initState, finalTime);
+  const size_t numQueries = solver.getNumRelinearizationCacheQueries();
+  solver.run(startTime, initState, finalTime);
+
+  // Nodes that did not move since the last linearization are reused
+  ASSERT_GT(solver.getNumRelinearizationCacheQueries(), numQueries);
+  ASSERT_GT(solver.getNumRelinearizationCacheHits(), 0);
+
+  // Same problems without the cache
+  settings.relinearizationTolerance = 0.0;
+  ocs2::SqpSolver referenceSolver(settings, problem, zeroInitializer);
+  referenceSolver.run(startTime, initState, finalTime);
+  referenceSolver.run(startTime, initState, finalTime);
+  ASSERT_EQ(referenceSolver.getNumRelinearizationCacheQueries(), 0);
+
+  // The reused derivatives are off by at most the tolerance, which moves the solution by a comparable amount
+  const auto primalSolution = solver.primalSolution(finalTime);
+  const auto referenceSolution = referenceSolver.primalSolution(finalTime);
+  ASSERT_EQ(primalSolution.timeTrajectory_.size(), referenceSolution.timeTrajectory_.size());
+  for (size_t i = 0; i < referenceSolution.timeTrajectory_.size(); ++i) {
+    ASSERT_LT((primalSolution.stateTrajectory_[i] - referenceSolution.stateTrajectory_[i]).lpNorm<Eigen::Infinity>(),
+              10.0 * solver.settings().relinearizationTolerance);
+    ASSERT_LT((primalSolution.inputTrajectory_[i] - referenceSolution.inputTrajectory_[i]).lpNorm<Eigen::Infinity>(),
+              10.0 * solver.settings().relinearizationTolerance);
+  }
+  const auto performance = solver.getPerformanceIndeces();
+  const auto referencePerformance = referenceSolver.getPerformanceIndeces();
+  ASSERT_NEAR(performance.cost, referencePerformance.cost, 1e-3 * std::abs(referencePerformance.cost));
+
+  // Check initial condition
+  ASSERT_TRUE(primalSolution.stateTrajectory_.front().isApprox(initState));
+
+  // Check constraint satisfaction.
+  ASSERT_LT(performance.dynamicsViolationSSE, 1e-6);
+  ASSERT_LT(performance.equalityConstraintsSSE, 1e-6);
+}
+
+TEST(test_circular_kinematics, solve_relinearizationCacheShiftedHorizon) {
+  // optimal control problem
+  ocs2::OptimalControlProblem problem = ocs2::createCircularKinematicsProblem("/tmp/sqp_test_generated");
+
+  // Initializer
+  ocs2::DefaultInitializer zeroInitializer(2);
+
+  // Solver settings
+  ocs2::sqp::Settings settings;
+  settings.dt = 0.01;
+  settings.sqpIteration = 20;
+  settings.projectStateInputEqualityConstraints = true;
+  settings.useFeedbackPolicy = true;
+  settings.relinearizationTolerance = 1e-3;
+
+  // Additional problem definitions
+  const ocs2::scalar_t startTime = 0.0;
+  const ocs2::scalar_t finalTime = 1.0;
+  const ocs2::scalar_t shift = 10 * settings.dt;  // the MPC moved on by ten nodes
+  const ocs2::vector_t initState = (ocs2::vector_t(2) << 1.0, 0.0).finished();  // radius 1.0
+
+  // Solves the problem, then the problem on the shifted horizon that starts on the previous solution. Returns the cache hits of the latter.
+  auto solveShifted = [&](const std::function<void(ocs2::SqpSolver&)>& beforeShift) {
+    ocs2::SqpSolver solver(settings, problem, zeroInitializer);
+    solver.run(startTime, initState, finalTime);
+    const auto primalSolution = solver.primalSolution(finalTime);
+    const ocs2::vector_t shiftedInitState =
+        ocs2::LinearInterpolation::interpolate(startTime + shift, primalSolution.timeTrajectory_, primalSolution.stateTrajectory_);
+    beforeShift(solver);
+    const size_t numHits = solver.getNumRelinearizationCacheHits();
+    solver.run(startTime + shift, shiftedInitState, finalTime + shift);
+    return solver.getNumRelinearizationCacheHits() - numHits;
+  };
+
+  // The derivatives of the previous horizon are found by the time of their nodes
+  const size_t numHits = solveShifted([](ocs2::SqpSolver&) {});
+  ASSERT_GT(numHits, 0);
+
+  // A modified problem invalidates the cache, such that only the hits within the shifted problem remain
+  const size_t numHitsModified = solveShifted([](ocs2::SqpSolver& solver) { solver.markProblemModified(); });
+  ASSERT_LT(numHitsModified, numHits);
+
+  // Same for a synchronized module that may modify the problem
+  struct ParameterModule : public ocs2::SolverSynchronizedModule {
+    void preSolverRun(ocs2::scalar_t, ocs2::scalar_t, const ocs2::vector_t&, const ocs2::ReferenceManagerInterface&) override {}
+    void postSolverRun(const ocs2::PrimalSolution&) override {}
+  };
+  const size_t numHitsSynchronized =
+      solveShifted([](ocs2::SqpSolver& solver) { solver.addSynchronizedModule(std::make_shared<ParameterModule>()); });
+  ASSERT_EQ(numHitsSynchronized, numHitsModified);
+}
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+
+#include <iostream>
+
+#include "ocs2_sqp/PartitionedRiccatiSolver.h"
+
+#include <hpipm_catkin/HpipmInterface.h>
+#include <ocs2_core/misc/Benchmark.h>
+#include <ocs2_oc/test/testProblemsGeneration.h>
+
+namespace {
+
+struct LqProblem {
+  ocs2::vector_t x0;
+  std::vector<ocs2::VectorFunctionLinearApproximation> dynamics;
+  std::vector<ocs2::ScalarFunctionQuadraticApproximation> cost;
+};
+
+/** Random, but well conditioned, LQ problem with an event node (no inputs) in the middle */
+LqProblem getRandomLqProblem(int N, int nx, int nu) {
+  LqProblem problem;
+  problem.x0 = ocs2::vector_t::Random(nx);
+  for (int k = 0; k < N; k++) {
+    const int nuk = (k == N / 2) ? 0 : nu;
+    auto dynamics = ocs2::getRandomDynamics(nx, nuk);
+    dynamics.dfdx = ocs2::matrix_t::Identity(nx, nx) + 0.1 * dynamics.dfdx;
+    auto cost = ocs2::getRandomCost(nx, nuk);
+    cost.dfduu.diagonal().array() += 1.0;
+    problem.dynamics.push_back(std::move(dynamics));
+    problem.cost.push_back(std::move(cost));
+  }
+  problem.cost.push_back(ocs2::getRandomCost(nx, 0));
+  return problem;
+}
+
+}  // namespace
+
+TEST(test_partitioned_riccati, compareToHpipm) {
+  constexpr int N = 50;
+  constexpr int nx = 6;
+  constexpr int nu = 3;
+  auto problem = getRandomLqProblem(N, nx, nu);
+
+  // HPIPM
+  ocs2::HpipmInterface hpipmInterface;
+  hpipmInterface.resize(ocs2::extractSizesFromProblem(problem.dynamics, problem.cost, nullptr));
+  ocs2::vector_array_t xHpipm, uHpipm;
+  const auto status = hpipmInterface.solve(problem.x0, problem.dynamics, problem.cost, nullptr, xHpipm, uHpipm);
+  ASSERT_EQ(status, hpipm_status::SUCCESS);
+  const auto costToGoHpipm = hpipmInterface.getRiccatiCostToGo(problem.dynamics[0], problem.cost[0]);
+  const auto feedbackHpipm = hpipmInterface.getRiccatiFeedback(problem.dynamics[0], problem.cost[0]);
+
+  for (size_t numThreads : {0, 1, 3, 7}) {
+    ocs2::ThreadPool threadPool(numThreads);
+    ocs2::PartitionedRiccatiSolver riccatiSolver;
+    ocs2::vector_array_t x, u;
+    riccatiSolver.solve(threadPool, problem.x0, problem.dynamics, problem.cost, x, u);
+    const auto costToGo = riccatiSolver.getRiccatiCostToGo();
+    const auto& feedback = riccatiSolver.getRiccatiFeedback();
+
+    ASSERT_EQ(x.size(), N + 1);
+    ASSERT_EQ(u.size(), N);
+    for (int k = 0; k < N; k++) {
+      EXPECT_TRUE(x[k].isApprox(xHpipm[k], 1e-6)) << "numThreads: " << numThreads << ", k: " << k;
+      EXPECT_TRUE(u[k].isApprox(uHpipm[k], 1e-6)) << "numThreads: " << numThreads << ", k: " << k;
+      EXPECT_TRUE(x[k + 1].isApprox(problem.dynamics[k].dfdx * x[k] + problem.dynamics[k].dfdu * u[k] + problem.dynamics[k].f));
+      EXPECT_TRUE(feedback[k].isApprox(feedbackHpipm[k], 1e-6)) << "numThreads: " << numThreads << ", k: " << k;
+    }
+    for (int k = 0; k <= N; k++) {
+      EXPECT_TRUE(costToGo[k].dfdxx.isApprox(costToGoHpipm[k].dfdxx, 1e-6)) << "numThreads: " << numThreads << ", k: " << k;
+      EXPECT_TRUE(costToGo[k].dfdx.isApprox(costToGoHpipm[k].dfdx, 1e-6)) << "numThreads: " << numThreads << ", k: " << k;
+    }
+  }
+}
+
+TEST(test_partitioned_riccati, benchmarkAgainstHpipm) {
+  // Sizes of the legged robot (centroidal model) and mobile manipulator examples
+  const std::vector<std::pair<int, int>> stateInputSizes{{24, 24}, {9, 9}};
+  constexpr size_t numThreads = 3;
+  constexpr int numRepeats = 20;
+  ocs2::ThreadPool threadPool(numThreads);
+
+  for (const auto& nxnu : stateInputSizes) {
+    for (int N : {50, 100, 200, 400}) {
+      auto problem = getRandomLqProblem(N, nxnu.first, nxnu.second);
+      ocs2::HpipmInterface hpipmInterface;
+      ocs2::PartitionedRiccatiSolver riccatiSolver;
+      ocs2::vector_array_t x, u;
+
+      ocs2::benchmark::RepeatedTimer hpipmTimer;
+      ocs2::benchmark::RepeatedTimer riccatiTimer;
+      for (int i = 0; i < numRepeats; i++) {
+        hpipmTimer.startTimer();
+        hpipmInterface.resize(ocs2::extractSizesFromProblem(problem.dynamics, problem.cost, nullptr));
+        hpipmInterface.solve(problem.x0, problem.dynamics, problem.cost, nullptr, x, u);
+        hpipmTimer.endTimer();
+
+        riccatiTimer.startTimer();
+        riccatiSolver.solve(threadPool, problem.x0, problem.dynamics, problem.cost, x, u);
+        riccatiTimer.endTimer();
+      }
+      std::cout << "nx: " << nxnu.first << ", nu: " << nxnu.second << ", N: " << N << "\t| HPIPM: " << hpipmTimer.getAverageInMilliseconds()
+                << " [ms], partitioned Riccati (" << numThreads + 1 << " threads): " << riccatiTimer.getAverageInMilliseconds()
+                << " [ms]\n";
+    }
+  }
+}
+
+TEST(test_partitioned_riccati, sparseDynamics) {
+  // Block structure similar to the centroidal model: momentum (6), base pose (6), joints (12); forces (12), joint velocities (12)
+  constexpr int N = 100;
+  constexpr int nx = 24;
+  constexpr int nu = 24;
+  constexpr int numRepeats = 20;
+  auto problem = getRandomLqProblem(N, nx, nu);
+
+  ocs2::matrix_t ASparsityMask = ocs2::matrix_t::Identity(nx, nx);
+  ASparsityMask.block(0, 6, 6, 6).setOnes();   // momentum <- base pose
+  ASparsityMask.block(6, 0, 6, 18).setOnes();  // base pose <- momentum, base pose, joints
+  ocs2::matrix_t BSparsityMask = ocs2::matrix_t::Zero(nx, nu);
+  BSparsityMask.block(0, 0, 6, 12).setOnes();    // momentum <- forces
+  BSparsityMask.block(6, 12, 6, 12).setOnes();   // base pose <- joint velocities
+  BSparsityMask.block(12, 12, 12, 12).setOnes();  // joints <- joint velocities
+  for (auto& dynamics : problem.dynamics) {
+    if (dynamics.dfdu.cols() > 0) {
+      dynamics.dfdx = dynamics.dfdx.cwiseProduct(ASparsityMask);
+      dynamics.dfdu = dynamics.dfdu.cwiseProduct(BSparsityMask);
+    }
+  }
+
+  ocs2::ThreadPool threadPool(1);
+  ocs2::PartitionedRiccatiSolver denseSolver;
+  ocs2::PartitionedRiccatiSolver sparseSolver;
+  sparseSolver.setDynamicsSparsity(ocs2::BlockSparsity::fromMatrix(ASparsityMask), ocs2::BlockSparsity::fromMatrix(BSparsityMask));
+
+  ocs2::vector_array_t xDense, uDense, xSparse, uSparse;
+  ocs2::benchmark::RepeatedTimer denseTimer;
+  ocs2::benchmark::RepeatedTimer sparseTimer;
+  for (int i = 0; i < numRepeats; i++) {
+    denseTimer.startTimer();
+    denseSolver.solve(threadPool, problem.x0, problem.dynamics, problem.cost, xDense, uDense);
+    denseTimer.endTimer();
+
+    sparseTimer.startTimer();
+    sparseSolver.solve(threadPool, problem.x0, problem.dynamics, problem.cost, xSparse, uSparse);
+    sparseTimer.endTimer();
+  }
+  std::cout << "nx: " << nx << ", nu: " << nu << ", N: " << N << "\t| dense dynamics: " << denseTimer.getAverageInMilliseconds()
+            << " [ms], block-sparse dynamics: " << sparseTimer.getAverageInMilliseconds() << " [ms]\n";
+
+  for (int k = 0; k < N; k++) {
+    EXPECT_TRUE(xSparse[k].isApprox(xDense[k], 1e-9)) << "k: " << k;
+    EXPECT_TRUE(uSparse[k].isApprox(uDense[k], 1e-9)) << "k: " << k;
+    EXPECT_TRUE(sparseSolver.getRiccatiFeedback()[k].isApprox(denseSolver.getRiccatiFeedback()[k], 1e-9)) << "k: " << k;
+  }
+}
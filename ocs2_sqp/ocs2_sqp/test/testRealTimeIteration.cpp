@@ -0,0 +1,159 @@
+/******************************************************************************
+Copyright (c) 2020, Farbod Farshidian. All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include "ocs2_sqp/SqpSolver.h"
+
+#include <ocs2_core/initialization/DefaultInitializer.h>
+#include <ocs2_core/integration/SensitivityIntegrator.h>
+
+#include <ocs2_oc/synchronized_module/ReferenceManager.h>
+#include <ocs2_oc/test/testProblemsGeneration.h>
+
+namespace {
+
+constexpr int n = 3;
+constexpr int m = 2;
+constexpr ocs2::scalar_t tol = 1e-9;
+
+ocs2::sqp::Settings getSettings(bool useRealTimeIteration) {
+  ocs2::sqp::Settings settings;
+  settings.dt = 0.05;
+  settings.sqpIteration = 10;
+  settings.useRealTimeIteration = useRealTimeIteration;
+  settings.useFeedbackPolicy = true;
+  settings.printSolverStatistics = true;
+  settings.nThreads = 2;
+  return settings;
+}
+
+/** Linear dynamics and quadratic costs are solved exactly by a single full step, from any linearization point */
+ocs2::OptimalControlProblem getLinearQuadraticProblem() {
+  ocs2::OptimalControlProblem problem;
+  problem.dynamicsPtr = ocs2::getOcs2Dynamics(ocs2::getRandomDynamics(n, m));
+  const auto costMatrices = ocs2::getRandomCost(n, m);
+  problem.costPtr->add("intermediateCost", ocs2::getOcs2Cost(costMatrices));
+  problem.finalCostPtr->add("finalCost", ocs2::getOcs2StateCost(costMatrices));
+  return problem;
+}
+
+void compareSolutions(const ocs2::PrimalSolution& rtiSolution, const ocs2::PrimalSolution& sqpSolution) {
+  ASSERT_EQ(rtiSolution.timeTrajectory_.size(), sqpSolution.timeTrajectory_.size());
+  for (size_t i = 0; i < sqpSolution.timeTrajectory_.size(); ++i) {
+    const auto t = sqpSolution.timeTrajectory_[i];
+    const auto& x = sqpSolution.stateTrajectory_[i];
+    ASSERT_DOUBLE_EQ(rtiSolution.timeTrajectory_[i], t);
+    ASSERT_TRUE(rtiSolution.stateTrajectory_[i].isApprox(x, tol));
+    ASSERT_TRUE(rtiSolution.inputTrajectory_[i].isApprox(sqpSolution.inputTrajectory_[i], tol));
+    ASSERT_TRUE(rtiSolution.controllerPtr_->computeInput(t, x).isApprox(sqpSolution.controllerPtr_->computeInput(t, x), tol));
+  }
+}
+
+}  // unnamed namespace
+
+TEST(test_real_time_iteration, linearQuadraticProblem) {
+  const auto problem = getLinearQuadraticProblem();
+  const ocs2::TargetTrajectories targetTrajectories({0.0}, {ocs2::vector_t::Ones(n)}, {ocs2::vector_t::Zero(m)});
+  const ocs2::ModeSchedule modeSchedule({0.42}, {0, 1});
+  ocs2::DefaultInitializer zeroInitializer(m);
+
+  ocs2::SqpSolver rtiSolver(getSettings(true), problem, zeroInitializer);
+  rtiSolver.setReferenceManager(std::make_shared<ocs2::ReferenceManager>(targetTrajectories, modeSchedule));
+  ocs2::SqpSolver sqpSolver(getSettings(false), problem, zeroInitializer);
+  sqpSolver.setReferenceManager(std::make_shared<ocs2::ReferenceManager>(targetTrajectories, modeSchedule));
+
+  // First problem, prepared within the feedback phase
+  rtiSolver.run(0.0, ocs2::vector_t::Zero(n), 1.0);
+  ASSERT_EQ(rtiSolver.getFeedbackPhaseTimer().getNumTimedIntervals(), 1);
+  ASSERT_EQ(rtiSolver.getPreparationPhaseTimer().getNumTimedIntervals(), 0);
+
+  // Second problem, prepared at the expected time, run with a perturbed state
+  rtiSolver.prepare(0.1, 1.1);
+  ASSERT_EQ(rtiSolver.getPreparationPhaseTimer().getNumTimedIntervals(), 1);
+  const ocs2::vector_t initState = ocs2::vector_t::Random(n);
+  rtiSolver.run(0.1, initState, 1.1);
+  ASSERT_EQ(rtiSolver.getFeedbackPhaseTimer().getNumTimedIntervals(), 2);
+  ASSERT_EQ(rtiSolver.getIterationsLog().size(), 1);
+
+  sqpSolver.run(0.1, initState, 1.1);
+  compareSolutions(rtiSolver.primalSolution(1.1), sqpSolver.primalSolution(1.1));
+}
+
+TEST(test_real_time_iteration, shiftedInitialTime) {
+  const auto problem = getLinearQuadraticProblem();
+  const ocs2::TargetTrajectories targetTrajectories({0.0}, {ocs2::vector_t::Ones(n)}, {ocs2::vector_t::Zero(m)});
+  ocs2::DefaultInitializer zeroInitializer(m);
+  const auto settings = getSettings(true);
+
+  ocs2::SqpSolver rtiSolver(settings, problem, zeroInitializer);
+  rtiSolver.setReferenceManager(std::make_shared<ocs2::ReferenceManager>(targetTrajectories));
+  rtiSolver.run(0.0, ocs2::vector_t::Zero(n), 1.0);
+
+  // Prepared at the expected time, run slightly later
+  const ocs2::scalar_t initTime = 0.11;
+  const ocs2::vector_t initState = ocs2::vector_t::Random(n);
+  rtiSolver.prepare(0.1, 1.1);
+  rtiSolver.run(initTime, initState, 1.1);
+  const auto& solution = rtiSolver.primalSolution(1.1);
+
+  // The policy starts at the actual initial time, the other nodes stay on the prepared grid
+  ASSERT_DOUBLE_EQ(solution.timeTrajectory_[0], initTime);
+  ASSERT_DOUBLE_EQ(solution.timeTrajectory_[1], 0.15);
+  ASSERT_TRUE(solution.stateTrajectory_[0].isApprox(initState, tol));
+
+  // The first interval is linearized again over its actual duration: the linear dynamics are satisfied exactly
+  auto discretizer = ocs2::selectDynamicsDiscretization(settings.integratorType);
+  const ocs2::vector_t x1 = discretizer(*problem.dynamicsPtr, initTime, solution.stateTrajectory_[0], solution.inputTrajectory_[0],
+                                        solution.timeTrajectory_[1] - initTime);
+  ASSERT_TRUE(solution.stateTrajectory_[1].isApprox(x1, tol));
+}
+
+TEST(test_real_time_iteration, changedTargetTrajectories) {
+  const auto problem = getLinearQuadraticProblem();
+  const ocs2::TargetTrajectories targetTrajectories({0.0}, {ocs2::vector_t::Ones(n)}, {ocs2::vector_t::Zero(m)});
+  const ocs2::TargetTrajectories newTargetTrajectories({0.0}, {-ocs2::vector_t::Ones(n)}, {ocs2::vector_t::Zero(m)});
+  ocs2::DefaultInitializer zeroInitializer(m);
+
+  auto referenceManagerPtr = std::make_shared<ocs2::ReferenceManager>(targetTrajectories);
+  ocs2::SqpSolver rtiSolver(getSettings(true), problem, zeroInitializer);
+  rtiSolver.setReferenceManager(referenceManagerPtr);
+  ocs2::SqpSolver sqpSolver(getSettings(false), problem, zeroInitializer);
+  sqpSolver.setReferenceManager(std::make_shared<ocs2::ReferenceManager>(newTargetTrajectories));
+  rtiSolver.run(0.0, ocs2::vector_t::Zero(n), 1.0);
+
+  // The targets arrive after the preparation and are applied right before the feedback phase, which has to prepare again
+  const ocs2::vector_t initState = ocs2::vector_t::Random(n);
+  rtiSolver.prepare(0.1, 1.1);
+  referenceManagerPtr->setTargetTrajectories(newTargetTrajectories);
+  rtiSolver.run(0.1, initState, 1.1);
+
+  sqpSolver.run(0.1, initState, 1.1);
+  compareSolutions(rtiSolver.primalSolution(1.1), sqpSolver.primalSolution(1.1));
+}